@@ -46,10 +46,11 @@ namespace Surge
         ImGui::PopID();
     }
 
-    static void DrawMatTexControl(const char* mapName, Ref<Material>& material)
+    // Edits go to the entity's own copy of the material, the Mesh's material is shared by every entity using the same file
+    static void DrawMatTexControl(const char* mapName, MeshComponent& meshComponent, Uint materialIndex)
     {
         ImGui::PushID(mapName);
-        Ref<Texture2D>& texture = material->Get<Ref<Texture2D>>(mapName);
+        const Ref<Texture2D>& texture = meshComponent.GetMaterial(materialIndex)->Get<Ref<Texture2D>>(mapName);
         if (ImGuiAux::TButton(mapName, "Open"))
         {
             String path = FileDialog::OpenFile("");
@@ -57,14 +58,14 @@ namespace Surge
             {
                 TextureSpecification spec;
                 spec.UseMips = true;
-                Ref<Texture2D> tex = Texture2D::Create(path, spec);
-                material->Set<Ref<Texture2D>>(mapName, tex);
+                Ref<Texture2D> tex = Core::GetAssetManager()->LoadTexture(path, spec);
+                meshComponent.GetUniqueMaterial(materialIndex)->Set<Ref<Texture2D>>(mapName, tex);
             }
         }
 
         ImGui::SameLine();
         if (ImGuiAux::Button("Remove"))
-            material->RemoveTexture(mapName);
+            meshComponent.GetUniqueMaterial(materialIndex)->RemoveTexture(mapName);
 
         ImGui::SameLine();
         float fontSize = ImGui::GetIO().FontDefault->FontSize + 6;
@@ -117,19 +118,21 @@ namespace Surge
         if (selectedEntity && selectedEntity.HasComponent<MeshComponent>())
         {
             static Uint selectedMatIndex = 0;
-            Ref<Mesh>& mesh = selectedEntity.GetComponent<MeshComponent>().Mesh;
-            if (mesh)
+            MeshComponent& meshComponent = selectedEntity.GetComponent<MeshComponent>();
+            Ref<Mesh>& mesh = meshComponent.Mesh;
+            if (mesh && mesh->IsReady())
             {
-                Vector<Ref<Material>>& materials = mesh->GetMaterials();
+                const Uint materialCount = static_cast<Uint>(mesh->GetMaterials().size());
                 if (ImGui::BeginTable("MatTable", 1))
                 {
-                    for (Uint i = 0; i < materials.size(); i++)
+                    for (Uint i = 0; i < materialCount; i++)
                     {
+                        const Ref<Material>& listedMaterial = meshComponent.GetMaterial(i);
                         ImGuiTreeNodeFlags flags = ((i == selectedMatIndex) ? ImGuiTreeNodeFlags_Selected : 0);
                         flags |= ImGuiTreeNodeFlags_SpanFullWidth;
 
                         // TODO: remove std::to_string hack
-                        bool open = ImGuiAux::TSelectable(fmt::format("{0} ({1})", materials[i]->GetName(), std::to_string(glm::abs(*(int*)&materials[i]))).c_str());
+                        bool open = ImGuiAux::TSelectable(fmt::format("{0} ({1})", listedMaterial->GetName(), std::to_string(glm::abs(*(int*)&listedMaterial))).c_str());
 
                         if (selectedMatIndex == i)
                             ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg0, ImGui::GetColorU32({0.1f, 0.1f, 0.1f, 1.0f}));
@@ -139,21 +142,36 @@ namespace Surge
                     }
                     ImGui::EndTable();
                 }
-                if (materials.size() <= selectedMatIndex)
+                if (materialCount <= selectedMatIndex)
                     selectedMatIndex = 0;
 
-                Ref<Material>& material = materials[selectedMatIndex];
+                // The values are edited on copies, the material is only made unique to the entity once something changes
+                const Ref<Material>& material = meshComponent.GetMaterial(selectedMatIndex);
+                glm::vec3 albedo = material->Get<glm::vec3>("Material.Albedo");
+                float metalness = material->Get<float>("Material.Metalness");
+                float roughness = material->Get<float>("Material.Roughness");
+                bool useNormalMap = material->Get<bool>("Material.UseNormalMap");
                 if (ImGui::BeginTable("MatEditTable", 2, ImGuiTableFlags_Resizable))
                 {
-                    ImGuiAux::TProperty<glm::vec3, ImGuiAux::CustomProprtyFlag::Color3>("Albedo", &material->Get<glm::vec3>("Material.Albedo"));
-                    ImGuiAux::TProperty<float>("Metalness", &material->Get<float>("Material.Metalness"), 0.0f, 1.0f);
-                    ImGuiAux::TProperty<float>("Roughness", &material->Get<float>("Material.Roughness"), 0.0f, 1.0f);
-                    ImGuiAux::TProperty<bool>("UseNormalMap", &material->Get<bool>("Material.UseNormalMap"));
+                    bool modified = false;
+                    modified |= ImGuiAux::TProperty<glm::vec3, ImGuiAux::CustomProprtyFlag::Color3>("Albedo", &albedo);
+                    modified |= ImGuiAux::TProperty<float>("Metalness", &metalness, 0.0f, 1.0f);
+                    modified |= ImGuiAux::TProperty<float>("Roughness", &roughness, 0.0f, 1.0f);
+                    modified |= ImGuiAux::TProperty<bool>("UseNormalMap", &useNormalMap);
+                    if (modified)
+                    {
+                        const Ref<Material>& uniqueMaterial = meshComponent.GetUniqueMaterial(selectedMatIndex);
+                        uniqueMaterial->Get<glm::vec3>("Material.Albedo") = albedo;
+                        uniqueMaterial->Get<float>("Material.Metalness") = metalness;
+                        uniqueMaterial->Get<float>("Material.Roughness") = roughness;
+                        uniqueMaterial->Get<bool>("Material.UseNormalMap") = useNormalMap;
+                        uniqueMaterial->MarkDirty();
+                    }
                     ImGui::Separator();
-                    DrawMatTexControl("AlbedoMap", material);
-                    DrawMatTexControl("NormalMap", material);
-                    DrawMatTexControl("MetalnessMap", material);
-                    DrawMatTexControl("RoughnessMap", material);
+                    DrawMatTexControl("AlbedoMap", meshComponent, selectedMatIndex);
+                    DrawMatTexControl("NormalMap", meshComponent, selectedMatIndex);
+                    DrawMatTexControl("MetalnessMap", meshComponent, selectedMatIndex);
+                    DrawMatTexControl("RoughnessMap", meshComponent, selectedMatIndex);
                     ImGui::EndTable();
                 }
             }
@@ -193,7 +211,10 @@ namespace Surge
                 {
                     String path = FileDialog::OpenFile("");
                     if (!path.empty())
-                        component.Mesh = Ref<Mesh>::Create(path);
+                    {
+                        component.Mesh = Core::GetAssetManager()->LoadMeshAsync(path);
+                        component.Materials.clear(); // Copies of the materials of the old mesh
+                    }
                 }
             });
         }
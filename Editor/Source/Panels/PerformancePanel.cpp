@@ -43,6 +43,38 @@ namespace Surge
                 ImGui::TreePop();
             }
 
+            if (ImGuiAux::PropertyGridHeader("Pipelines", false))
+            {
+                PipelineStats pipelineStats = renderContext->GetPipelineStats();
+                ImGui::Text("Created: %u", pipelineStats.PipelineCount);
+                ImGui::Text("Total Creation Time: %.2f ms", pipelineStats.TotalCreationTime);
+                ImGui::Text("Last Creation Time: %.2f ms", pipelineStats.LastCreationTime);
+                ImGui::Text("Slowest Creation Time: %.2f ms", pipelineStats.MaxCreationTime);
+                ImGui::Text("Loaded Cache: %.2f Kb", pipelineStats.InitialCacheSize / 1000.0f);
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Descriptors", false))
+            {
+                DescriptorStats descriptorStats = renderContext->GetDescriptorStats();
+                ImGui::Text("Allocated Sets: %u per frame", descriptorStats.AllocatedSets);
+                ImGui::Text("Written Descriptors: %u per frame", descriptorStats.WrittenDescriptors);
+                ImGui::Text("Cache: %u Hits, %u Misses per frame", descriptorStats.CacheHits, descriptorStats.CacheMisses);
+                ImGui::Text("Cached: %u Sets, %u Layouts", descriptorStats.CachedSets, descriptorStats.CachedLayouts);
+                ImGui::Text("Pools: %u", descriptorStats.PoolCount);
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Uploads", false))
+            {
+                UploadStats uploadStats = renderContext->GetUploadStats();
+                ImGui::Text("Uploads: %u per frame", uploadStats.UploadCount);
+                ImGui::Text("Uploaded: %.2f Kb per frame", uploadStats.UploadedBytes / 1000.0f);
+                ImGui::Text("Batches: %u submitted per frame, %u pending", uploadStats.SubmittedBatches, uploadStats.PendingBatches);
+                ImGui::Text("Staging: %.2f / %.2f Mb", uploadStats.StagingUsage / 1000000.0f, uploadStats.StagingSize / 1000000.0f);
+                ImGui::TreePop();
+            }
+
             if (ImGuiAux::PropertyGridHeader("Shaders", false))
             {
                 Vector<Ref<Shader>>& allAhaders = Core::GetRenderer()->GetData()->ShaderSet.GetAllShaders();
@@ -85,6 +117,201 @@ namespace Surge
                     }
                     ImGui::EndTable();
                 }
+
+                if (ImGui::Button("Run Compile Benchmark"))
+                    mShaderBenchmarkResult = Core::GetRenderer()->GetData()->ShaderSet.RunBenchmark();
+
+                if (mShaderBenchmarkResult.ShaderCount != 0 && ImGui::BeginTable("ShaderBenchmarkTable", 3, ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Mode");
+                    ImGui::TableSetupColumn("Cold");
+                    ImGui::TableSetupColumn("Warm");
+                    ImGui::TableHeadersRow();
+
+                    auto drawRow = [](const char* mode, float coldMillis, float warmMillis) {
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(mode);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", coldMillis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", warmMillis);
+                    };
+                    drawRow("Serial", mShaderBenchmarkResult.SerialColdMillis, mShaderBenchmarkResult.SerialWarmMillis);
+                    drawRow("Parallel", mShaderBenchmarkResult.ParallelColdMillis, mShaderBenchmarkResult.ParallelWarmMillis);
+                    ImGui::EndTable();
+                }
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Culling", false))
+            {
+                const RendererData* rendererData = Core::GetRenderer()->GetData();
+                if (rendererData->GPUDrivenRendering)
+                    ImGui::TextUnformatted("Culled on the GPU, turn off GPU Driven Rendering to see the CPU results");
+                else
+                {
+                    const CPUCuller& culler = rendererData->CPUCuller;
+                    ImGui::Text("Instances: %u", culler.GetInstanceCount());
+                    ImGui::Text("Visible (Camera): %u", culler.GetVisibleInstanceCount(GPU_SCENE_CAMERA_VIEW));
+                    for (Uint i = 0; i < MAX_CASCADE_COUNT; i++)
+                        ImGui::Text("Visible (Cascade %u): %u", i, culler.GetVisibleInstanceCount(GPU_SCENE_CAMERA_VIEW + 1 + i));
+                }
+
+                if (ImGui::Button("Run Benchmark"))
+                    mCullingThroughput = CPUCuller::RunBenchmark(100000, 100);
+                if (mCullingThroughput > 0.0f)
+                {
+                    ImGui::SameLine();
+                    ImGui::Text("%.0f boxes/ms", mCullingThroughput);
+                }
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Job System", false))
+            {
+                ThreadPool* threadPool = Core::GetThreadPool();
+                ImGui::Text("Worker Threads: %u", threadPool->GetThreadCount());
+                if (ImGui::Button("Run Benchmark"))
+                    mJobBenchmarkResults = ThreadPool::RunBenchmark(threadPool->GetThreadCount());
+
+                if (!mJobBenchmarkResults.empty() && ImGui::BeginTable("JobBenchmarkTable", 4, ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Job Length");
+                    ImGui::TableSetupColumn("Jobs");
+                    ImGui::TableSetupColumn("ThreadPool");
+                    ImGui::TableSetupColumn("Mutex Queue");
+                    ImGui::TableHeadersRow();
+                    for (const JobBenchmarkResult& result : mJobBenchmarkResults)
+                    {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.0f us", result.JobMicroseconds);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%u", result.JobCount);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", result.ThreadPoolMillis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", result.MutexQueueMillis);
+                    }
+                    ImGui::EndTable();
+                }
+
+                if (ImGui::Button("Run ParallelFor Benchmark"))
+                    mParallelForBenchmarkResults = ThreadPool::RunParallelForBenchmark(1000000, 10);
+
+                if (!mParallelForBenchmarkResults.empty() && ImGui::BeginTable("ParallelForBenchmarkTable", 3, ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Threads");
+                    ImGui::TableSetupColumn("Time");
+                    ImGui::TableSetupColumn("Speedup");
+                    ImGui::TableHeadersRow();
+                    for (const ParallelForBenchmarkResult& result : mParallelForBenchmarkResults)
+                    {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%u", result.ThreadCount);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", result.Millis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2fx", result.Speedup);
+                    }
+                    ImGui::EndTable();
+                }
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Scene Serialization", false))
+            {
+                Project& project = Core::GetClient()->GetActiveProject();
+                if (!project)
+                    ImGui::TextUnformatted("Open a project to run the benchmark");
+                else if (ImGui::Button("Run Benchmark (100k Entities)"))
+                    mSceneBenchmarkResult = Serializer::RunSceneBenchmark(&project, 100000);
+
+                if (mSceneBenchmarkResult.EntityCount != 0 && ImGui::BeginTable("SceneBenchmarkTable", 6, ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Format");
+                    ImGui::TableSetupColumn("Save");
+                    ImGui::TableSetupColumn("Load");
+                    ImGui::TableSetupColumn("File");
+                    ImGui::TableSetupColumn("Peak Save Memory");
+                    ImGui::TableSetupColumn("Peak Load Memory");
+                    ImGui::TableHeadersRow();
+
+                    auto drawRow = [](const char* format, const Serializer::SceneFormatBenchmarkResult& result) {
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(format);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", result.SaveMillis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", result.LoadMillis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f Mb", result.FileSize / 1000000.0f);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f Mb", result.SavePeakMemory / 1000000.0f);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f Mb", result.LoadPeakMemory / 1000000.0f);
+                    };
+                    drawRow("Json", mSceneBenchmarkResult.Json);
+                    drawRow("Binary", mSceneBenchmarkResult.Binary);
+                    ImGui::EndTable();
+                }
+
+                if (ImGui::Button("Run Type Dispatch Benchmark (100k Entities)"))
+                    mTypeDispatchBenchmarkResult = Serializer::RunTypeDispatchBenchmark(100000);
+
+                if (mTypeDispatchBenchmarkResult.EntityCount != 0)
+                {
+                    ImGui::Text("Fields: %.1f per entity", mTypeDispatchBenchmarkResult.FieldsPerEntity);
+                    ImGui::Text("By Name: %.2f ms, %.1f string allocations per entity", mTypeDispatchBenchmarkResult.NameDispatchMillis, mTypeDispatchBenchmarkResult.NameStringAllocationsPerEntity);
+                    ImGui::Text("By Type ID: %.2f ms, no string allocations", mTypeDispatchBenchmarkResult.TypeIDDispatchMillis);
+                }
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Mesh Loading", false))
+            {
+                if (ImGui::Button("Run Benchmark (8 Copies)"))
+                    mMeshBenchmarkResult = AssetManager::RunMeshBenchmark(8);
+
+                if (mMeshBenchmarkResult.MeshCount != 0 && ImGui::BeginTable("MeshBenchmarkTable", 3, ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Mode");
+                    ImGui::TableSetupColumn("Cold");
+                    ImGui::TableSetupColumn("Warm");
+                    ImGui::TableHeadersRow();
+
+                    auto drawRow = [](const char* mode, float coldMillis, float warmMillis) {
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(mode);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", coldMillis);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f ms", warmMillis);
+                    };
+                    drawRow("Sequential", mMeshBenchmarkResult.SequentialColdMillis, mMeshBenchmarkResult.SequentialWarmMillis);
+                    drawRow("Async", mMeshBenchmarkResult.AsyncColdMillis, mMeshBenchmarkResult.AsyncWarmMillis);
+                    ImGui::EndTable();
+                    ImGui::Text("Meshes: %u", mMeshBenchmarkResult.MeshCount);
+                }
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Materials", false))
+            {
+                const MaterialTableStats& materialStats = Core::GetRenderer()->GetData()->MaterialTable.GetStats();
+                ImGui::Text("Materials: %u", materialStats.MaterialCount);
+                ImGui::Text("Textures: %u / %u", materialStats.TextureCount, RUNTIME_DESCRIPTOR_ARRAY_SIZE);
+                ImGui::Text("Uploaded: %u bytes, %u textures this frame", materialStats.UploadedBytes, materialStats.WrittenTextures);
+                ImGui::TreePop();
+            }
+
+            if (ImGuiAux::PropertyGridHeader("Render Graph", false))
+            {
+                const RenderGraphStats& graphStats = Core::GetRenderer()->GetRenderProcManager()->GetRenderGraph().GetStats();
+                ImGui::Text("Passes: %u (%u Culled)", graphStats.PassCount, graphStats.CulledPassCount);
+                ImGui::Text("Barriers: %u per frame", graphStats.BarrierCount);
+                ImGui::Text("Images: %u in %u Memory Blocks", graphStats.TransientImageCount, graphStats.MemoryBlockCount);
+                ImGui::Text("Image Memory: %f Mb", graphStats.AllocatedMemory / 1000000.0f);
+                ImGui::Text("Without Aliasing: %f Mb", graphStats.TransientMemory / 1000000.0f);
                 ImGui::TreePop();
             }
 
@@ -1,6 +1,10 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
 #include "Panels/IPanel.hpp"
+#include "Surge/Asset/AssetManager.hpp"
+#include "Surge/Core/Thread/ThreadPool.hpp"
+#include "Surge/Graphics/Shader/ShaderSet.hpp"
+#include "Surge/Serializer/Serializer.hpp"
 
 namespace Surge
 {
@@ -20,6 +24,13 @@ namespace Surge
 
     private:
         PanelCode mCode;
+        ShaderBenchmarkResult mShaderBenchmarkResult = {};
+        float mCullingThroughput = 0.0f; // Result of the last culling benchmark, in boxes per millisecond
+        Vector<JobBenchmarkResult> mJobBenchmarkResults;
+        Vector<ParallelForBenchmarkResult> mParallelForBenchmarkResults;
+        Serializer::SceneBenchmarkResult mSceneBenchmarkResult = {};
+        Serializer::TypeDispatchBenchmarkResult mTypeDispatchBenchmarkResult = {};
+        MeshBenchmarkResult mMeshBenchmarkResult = {};
     };
 
 } // namespace Surge
@@ -83,7 +83,7 @@ namespace Surge
                 if (ImGuiAux::ButtonCentered("Add Scene"))
                 {
                     // TODO: Don't hardcode the scene path in future
-                    Ref<Scene> newScene = activeProject.AddScene("NewScene", fmt::format("{0}/NewScene.surge", activeProject.GetMetadata().ProjPath));
+                    Ref<Scene> newScene = activeProject.AddScene("NewScene", fmt::format("{0}/NewScene.surgeb", activeProject.GetMetadata().ProjPath));
                     mSelectedSceneUUID = newScene->GetMetadata().SceneUUID;
                     mRenamingMech.SetRenamingState(true);
                 }
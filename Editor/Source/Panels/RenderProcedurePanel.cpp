@@ -73,12 +73,19 @@ namespace Surge
 
                 ImGuiAux::TProperty<bool>("Visualize Cascades", &internalData->VisualizeCascades);
                 ImGuiAux::TProperty<float>("Cascade Split Lambda", &internalData->CascadeSplitLambda);
+                ImGuiAux::TProperty<bool>("Cascade Caching", &internalData->CascadeCaching);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Rendered Cascades");
+                ImGui::TableNextColumn();
+                ImGui::Text("%u / %u", internalData->RenderedCascadeCount, CascadeCountToUInt(proc->GetCascadeCount()));
                 int shadowMapResolution = static_cast<int>(proc->GetShadowMapsResolution());
                 if (ImGuiAux::TProperty<int>("Shadow Map Resolution", &shadowMapResolution, 1024, 8192))
                     proc->SetShadowMapsResolution(shadowMapResolution);
             });
 
             PropertyRenderProcedure<GeometryProcedure>("Geometry Procedure", [](GeometryProcedure* proc, GeometryProcedure::InternalData* internalData) {
+                ImGuiAux::TProperty<bool>("GPU Driven Rendering", &Core::GetRenderer()->GetData()->GPUDrivenRendering);
+                ImGuiAux::TProperty<bool>("Parallel Command Recording", &Core::GetRenderer()->GetData()->ParallelRecording);
                 ImGui::TableNextColumn();
                 ImGui::TextUnformatted("Total PointLight Count");
                 ImGui::TableNextColumn();
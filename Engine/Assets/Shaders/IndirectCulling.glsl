@@ -0,0 +1,138 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+// SurgeEngine GPU driven culling shader
+// Dispatched twice per view (see GPUScene::Cull):
+// - CULL_INSTANCES: one thread per instance, tests the world space AABB against the frustum planes and copies the transforms
+//   of the visible instances to the view's region of the culled instance buffer, counting them per batch
+// - WRITE_COMMANDS: one thread per batch, writes a VkDrawIndexedIndirectCommand for every batch with visible instances,
+//   compacted per draw run, and counts the commands of every run for vkCmdDrawIndexedIndirectCount
+
+[SurgeShader: Compute]
+#version 450 core
+#define WORKGROUP_SIZE 64
+#define CULL_INSTANCES 0
+#define WRITE_COMMANDS 1
+
+struct Batch
+{
+    vec3 BoundsMin; // Local space AABB of the submesh
+    uint IndexCount;
+    vec3 BoundsMax;
+    uint FirstIndex;
+
+    int VertexOffset;
+    uint FirstInstance; // Into uInstances, the same offset is used in the region of the view in sCulledInstances
+    uint RunIndex;
+    uint FirstCommand;  // Index of the first command of the run, inside the region of the view
+};
+
+struct DrawIndexedIndirectCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceTransforms
+{
+    mat4 Transforms[];
+
+} uInstances;
+layout(std430, set = 0, binding = 1) readonly buffer InstanceBatches
+{
+    uint Indices[];
+
+} uInstanceBatches;
+layout(std430, set = 0, binding = 2) readonly buffer Batches
+{
+    Batch Data[];
+
+} uBatches;
+
+// [ViewCount * BatchCount] visible instance counts, followed by [ViewCount * RunCount] command counts. Zeroed by the CPU every frame
+layout(std430, set = 0, binding = 3) buffer Counters
+{
+    uint Data[];
+
+} sCounters;
+layout(std430, set = 0, binding = 4) writeonly buffer DrawCommands
+{
+    DrawIndexedIndirectCommand Data[];
+
+} sCommands;
+layout(std430, set = 0, binding = 5) writeonly buffer CulledInstanceTransforms
+{
+    mat4 Transforms[];
+
+} sCulledInstances;
+
+layout(push_constant) uniform CullData
+{
+    vec4 FrustumPlanes[6]; // World space, pointing inwards
+    uint Mode;
+    uint View;
+    uint InstanceCount;
+    uint BatchCount;
+    uint RunCount;
+    uint RunCountersOffset; // Index of the first command count in sCounters
+
+} uCullData;
+
+bool IsVisible(mat4 transform, vec3 boundsMin, vec3 boundsMax)
+{
+    // Transform the AABB to world space, the extents are rotated into a new axis aligned box
+    vec3 center = vec3(transform * vec4((boundsMin + boundsMax) * 0.5, 1.0));
+    vec3 localExtents = (boundsMax - boundsMin) * 0.5;
+    vec3 extents = abs(transform[0].xyz) * localExtents.x + abs(transform[1].xyz) * localExtents.y + abs(transform[2].xyz) * localExtents.z;
+
+    for (uint i = 0; i < 6; i++)
+    {
+        vec4 plane = uCullData.FrustumPlanes[i];
+        float radius = dot(abs(plane.xyz), extents);
+        if (dot(plane.xyz, center) + plane.w + radius < 0.0) // Completely behind the plane
+            return false;
+    }
+    return true;
+}
+
+layout(local_size_x = WORKGROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (uCullData.Mode == CULL_INSTANCES)
+    {
+        if (index >= uCullData.InstanceCount)
+            return;
+
+        uint batchIndex = uInstanceBatches.Indices[index];
+        mat4 transform = uInstances.Transforms[index];
+        if (!IsVisible(transform, uBatches.Data[batchIndex].BoundsMin, uBatches.Data[batchIndex].BoundsMax))
+            return;
+
+        uint slot = atomicAdd(sCounters.Data[uCullData.View * uCullData.BatchCount + batchIndex], 1);
+        uint viewBase = uCullData.View * uCullData.InstanceCount;
+        sCulledInstances.Transforms[viewBase + uBatches.Data[batchIndex].FirstInstance + slot] = transform;
+    }
+    else // WRITE_COMMANDS
+    {
+        if (index >= uCullData.BatchCount)
+            return;
+
+        uint instanceCount = sCounters.Data[uCullData.View * uCullData.BatchCount + index];
+        if (instanceCount == 0)
+            return;
+
+        Batch batch = uBatches.Data[index];
+        uint runCounter = uCullData.View * uCullData.RunCount + batch.RunIndex;
+        uint commandIndex = atomicAdd(sCounters.Data[uCullData.RunCountersOffset + runCounter], 1);
+
+        DrawIndexedIndirectCommand command;
+        command.IndexCount = batch.IndexCount;
+        command.InstanceCount = instanceCount;
+        command.FirstIndex = batch.FirstIndex;
+        command.VertexOffset = batch.VertexOffset;
+        command.FirstInstance = uCullData.View * uCullData.InstanceCount + batch.FirstInstance;
+        sCommands.Data[uCullData.View * uCullData.BatchCount + batch.FirstCommand + commandIndex] = command;
+    }
+}
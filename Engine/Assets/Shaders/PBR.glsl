@@ -9,13 +9,21 @@ layout(location = 2) in vec3 aTangent;
 layout(location = 3) in vec3 aBiTangent;
 layout(location = 4) in vec2 aTexCoord;
 
+// Must be the same in every stage, MaterialIndex is used by the pixel shader
 layout(push_constant) uniform PushConstants
 {
-    mat4 Transform;
     mat4 ViewProjectionMatrix;
+    uint MaterialIndex;
 
 } uMesh;
 
+// Set 0, binding 5 belongs to the renderer: transforms of all the instances drawn this frame, indexed by gl_InstanceIndex
+layout(set = 0, binding = 5) readonly buffer InstanceTransforms
+{
+    mat4 Transforms[];
+
+} uInstances;
+
 // Set 0 belongs to the renderer
 layout(set = 0, binding = 0) uniform Camera
 {
@@ -59,12 +67,13 @@ layout(set = 3, binding = 0) uniform ShadowParams
 
 void main()
 {
+    mat4 transform = uInstances.Transforms[gl_InstanceIndex];
     vOutput.TexCoord = aTexCoord;
-    vOutput.Tangent   = mat3(uMesh.Transform) * normalize(aTangent);
-    vOutput.BiTangent = mat3(uMesh.Transform) * normalize(aBiTangent);
-    vOutput.Normal    = mat3(uMesh.Transform) * normalize(aNormal);
+    vOutput.Tangent   = mat3(transform) * normalize(aTangent);
+    vOutput.BiTangent = mat3(transform) * normalize(aBiTangent);
+    vOutput.Normal    = mat3(transform) * normalize(aNormal);
 
-    vOutput.WorldPos = vec3(uMesh.Transform * vec4(aPosition, 1.0));
+    vOutput.WorldPos = vec3(transform * vec4(aPosition, 1.0));
     vOutput.ViewSpacePos = vec3(uCameraData.ViewMatrix * vec4(vOutput.WorldPos, 1.0));
 
     for(uint i = 0; i < uShadowParams.CascadeCount; i++)
@@ -75,6 +84,7 @@ void main()
 
 [SurgeShader: Pixel]
 #version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
 
 const int MAX_CASCADE_COUNT = 4;
 
@@ -155,23 +165,36 @@ layout(set = 0, binding = 3) readonly buffer VisibleLightIndicesBuffer
 } sVisibleLightIndicesBuffer;
 layout(set = 0, binding = 4) uniform sampler2D uPreDepthMap;
 
-// Material - Set 1 and 2
-layout(set = 1, binding = 0) uniform Material
+layout(push_constant) uniform PushConstants
+{
+    mat4 ViewProjectionMatrix;
+    uint MaterialIndex;
+
+} uMesh;
+
+// Material - Set 1 belongs to the MaterialTable, it holds every material and every texture they use
+// The ...Map members are the indices of the textures in uTextures
+struct Material
 {
     vec3 Albedo;
     float Metalness;
 
     float Roughness;
     int UseNormalMap;
+    uint AlbedoMap;
+    uint NormalMap;
 
+    uint RoughnessMap;
+    uint MetalnessMap;
     int _Padding_;
     int _Padding_1;
+};
+layout(set = 1, binding = 0) readonly buffer Materials
+{
+    Material Data[];
 
-} uMaterial;
-layout(set = 2, binding = 0) uniform sampler2D AlbedoMap;
-layout(set = 2, binding = 1) uniform sampler2D NormalMap;
-layout(set = 2, binding = 2) uniform sampler2D RoughnessMap;
-layout(set = 2, binding = 3) uniform sampler2D MetalnessMap;
+} sMaterials;
+layout(set = 1, binding = 1) uniform sampler2D uTextures[];
 
 // Shadows - Set 3
 layout(set = 3, binding = 0) uniform ShadowParams
@@ -200,6 +223,7 @@ struct PBRParameters
     vec3 View;
 };
 PBRParameters gPBRParams;
+Material gMaterial;
 
 //------------------------------------------------------------------------------
 // The following BRDF has been adapted from the Filament material system
@@ -299,13 +323,13 @@ vec3 FilamentBRDF(vec3 l, vec3 v, vec3 n, float roughness, float metallic, vec3
 vec3 CalculateNormal()
 {
    vec3 newNormal;
-   if (uMaterial.UseNormalMap == 1)
+   if (gMaterial.UseNormalMap == 1)
    {
         vec3 normal = normalize(vInput.Normal);
         vec3 tangent = normalize(vInput.Tangent);
         vec3 bitangent = normalize(vInput.BiTangent);
 
-        vec3 bumpMapNormal = texture(NormalMap, vInput.TexCoord).xyz;
+        vec3 bumpMapNormal = texture(uTextures[gMaterial.NormalMap], vInput.TexCoord).xyz;
         bumpMapNormal = 2.0 * bumpMapNormal - vec3(1.0);
 
         mat3 TBN = mat3(tangent, bitangent, normal);
@@ -651,10 +675,12 @@ vec3 GetGradient(float value)
 
 void main()
 {
+    // The material index is a push constant, so it is the same for the whole draw
+    gMaterial = sMaterials.Data[uMesh.MaterialIndex];
     gPBRParams.Normal = CalculateNormal();
-    gPBRParams.Albedo = texture(AlbedoMap, vInput.TexCoord).rgb * uMaterial.Albedo;
-    gPBRParams.Metalness = texture(MetalnessMap, vInput.TexCoord).r * uMaterial.Metalness;
-    gPBRParams.Roughness = texture(RoughnessMap, vInput.TexCoord).r * uMaterial.Roughness;
+    gPBRParams.Albedo = texture(uTextures[gMaterial.AlbedoMap], vInput.TexCoord).rgb * gMaterial.Albedo;
+    gPBRParams.Metalness = texture(uTextures[gMaterial.MetalnessMap], vInput.TexCoord).r * gMaterial.Metalness;
+    gPBRParams.Roughness = texture(uTextures[gMaterial.RoughnessMap], vInput.TexCoord).r * gMaterial.Roughness;
     gPBRParams.View = normalize(uLights.CameraPosition - vInput.WorldPos);
 
     // Fresnel reflectance at normal incidence for metals. Had to separate the
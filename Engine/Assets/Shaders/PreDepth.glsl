@@ -26,15 +26,21 @@ layout(location = 4) in vec2 aTexCoord;  // Unused
 
 layout(push_constant) uniform PushConstants
 {
-    mat4 Transform;
     mat4 ViewProjectionMatrix;
 
 } uMesh;
+
+// Set 0, binding 5 belongs to the renderer: transforms of all the instances drawn this frame, indexed by gl_InstanceIndex
+layout(set = 0, binding = 5) readonly buffer InstanceTransforms
+{
+    mat4 Transforms[];
+
+} uInstances;
 //layout(location = 0) out float vLinearDepth;
 
 void main()
 {
-    vec4 worldPosition = uMesh.Transform * vec4(aPosition, 1.0);
+    vec4 worldPosition = uInstances.Transforms[gl_InstanceIndex] * vec4(aPosition, 1.0);
     //vLinearDepth = -(uCameraData.ViewMatrix * worldPosition).z;
 
     gl_Position = uMesh.ViewProjectionMatrix * worldPosition;
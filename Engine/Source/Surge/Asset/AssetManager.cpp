@@ -0,0 +1,386 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Asset/AssetManager.hpp"
+#include "Surge/Core/Hash.hpp"
+#include "Surge/Utility/Filesystem.hpp"
+#include <algorithm>
+
+// Default memory budget for the cached assets, unused assets are evicted once the usage goes above it
+#define ASSET_MEMORY_BUDGET (1024ull * 1024ull * 1024ull) // 1 GiB
+
+namespace Surge
+{
+    namespace
+    {
+        // Returns 0 if the file is empty or unreadable
+        uint64_t HashFileContents(const Path& path)
+        {
+            Filesystem::MappedFile file(path);
+            if (!file.IsValid())
+                return 0;
+
+            return Hash::GenerateFromBytes(file.GetData(), static_cast<size_t>(file.GetSize()));
+        }
+
+        // Key of an asset in AssetCache::Entries
+        uint64_t GetAssetKey(uint64_t contentHash, uint64_t parameterHash) { return Hash::Combine(contentHash, parameterHash); }
+
+        uint64_t HashTextureSpecification(const TextureSpecification& spec)
+        {
+            const uint64_t values[] = {
+                static_cast<uint64_t>(spec.Format),
+                static_cast<uint64_t>(spec.Usage),
+                static_cast<uint64_t>(spec.UseMips),
+                static_cast<uint64_t>(spec.Sampler.EnableAnisotropy),
+                static_cast<uint64_t>(spec.Sampler.EnableComparison),
+                static_cast<uint64_t>(spec.Sampler.SamplerCompareOp),
+                static_cast<uint64_t>(spec.Sampler.SamplerAddressMode),
+                static_cast<uint64_t>(spec.Sampler.SamplerFilter),
+            };
+            return Hash::GenerateFromBytes(values, sizeof(values));
+        }
+
+        String GetCanonicalPath(const std::filesystem::path& path)
+        {
+            std::error_code error;
+            std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+            String result = error ? path.lexically_normal().generic_string() : canonical.generic_string();
+#ifdef SURGE_WINDOWS
+            // Paths are case insensitive on Windows
+            std::transform(result.begin(), result.end(), result.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+#endif
+            return result;
+        }
+
+        Uint GetBytesPerPixel(ImageFormat format)
+        {
+            switch (format)
+            {
+                case ImageFormat::RED32F: return 4;
+                case ImageFormat::RGBA8: return 4;
+                case ImageFormat::RGBA16F: return 8;
+                case ImageFormat::RGBA32F: return 16;
+                case ImageFormat::Depth32: return 4;
+                case ImageFormat::Depth24Stencil8: return 4;
+            }
+            return 0;
+        }
+
+        uint64_t GetMemorySize(const Ref<Mesh>& mesh)
+        {
+            // Vertices and indices are kept on the CPU and also live in the GPU buffers
+            const uint64_t size = mesh->GetVertices().size() * sizeof(Vertex) + mesh->GetIndices().size() * sizeof(Index);
+            return size * 2;
+        }
+
+        uint64_t GetMemorySize(const Ref<Texture2D>& texture)
+        {
+            const TextureSpecification& spec = texture->GetSpecification();
+            const uint64_t size = static_cast<uint64_t>(texture->GetWidth()) * texture->GetHeight() * GetBytesPerPixel(spec.Format);
+            return spec.UseMips ? size * 4 / 3 : size; // A full mip chain adds a third
+        }
+    } // namespace
+
+    AssetManager::AssetManager()
+        : mMemoryBudget(ASSET_MEMORY_BUDGET)
+    {
+    }
+
+    AssetManager::~AssetManager()
+    {
+        Clear();
+    }
+
+    Ref<Mesh> AssetManager::LoadMesh(const Path& path)
+    {
+        SURGE_PROFILE_FUNC("AssetManager::LoadMesh");
+        auto load = [&path](uint64_t contentHash) {
+            // The contents were hashed already, the MeshCache key is made from the same hash
+            Ref<Mesh> mesh = Ref<Mesh>::Create(path, true);
+            mesh->Import(contentHash);
+            if (mesh->GetState() == MeshState::Imported)
+                mesh->Upload();
+            return mesh;
+        };
+
+        return Load(mMeshes, path, 0, load, [](const Ref<Mesh>& mesh) { return GetMemorySize(mesh); });
+    }
+
+    Ref<Texture2D> AssetManager::LoadTexture(const Path& path, const TextureSpecification& specification)
+    {
+        SURGE_PROFILE_FUNC("AssetManager::LoadTexture");
+        return Load(
+            mTextures, path, HashTextureSpecification(specification), [&](uint64_t) { return Texture2D::Create(path.Str(), specification); },
+            [](const Ref<Texture2D>& texture) { return GetMemorySize(texture); });
+    }
+
+    Ref<Texture2D> AssetManager::LoadTexture(const Path& path, const TextureData& data, const TextureSpecification& specification)
+    {
+        SURGE_PROFILE_FUNC("AssetManager::LoadTexture");
+        return Load(
+            mTextures, path, HashTextureSpecification(specification), [&](uint64_t) { return Texture2D::Create(data, specification); },
+            [](const Ref<Texture2D>& texture) { return GetMemorySize(texture); });
+    }
+
+    Ref<Mesh> AssetManager::LoadMeshAsync(const Path& path)
+    {
+        SURGE_PROFILE_FUNC("AssetManager::LoadMeshAsync");
+        std::error_code error;
+        const std::filesystem::path filepath = path.Str();
+        const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(filepath, error);
+        if (error)
+        {
+            Log<Severity::Error>("AssetManager: Cannot load {0}, file not found!", path);
+            return nullptr;
+        }
+        const String canonicalPath = GetCanonicalPath(filepath);
+
+        // The contents aren't read here, hashing a big file would stall the calling thread. Until the import job has hashed them
+        // the Mesh is registered under a key made from its path and write time, UploadPendingMesh then moves it to its content key
+        const uint64_t provisionalKey = Hash::Combine(Hash::GenerateFromBytes(canonicalPath.data(), canonicalPath.size()), lastWriteTime.time_since_epoch().count());
+        Ref<Mesh> mesh;
+        {
+            std::scoped_lock lock(mMutex);
+            if (Ref<Mesh> loaded = FindByPath(mMeshes, canonicalPath, lastWriteTime))
+                return loaded;
+
+            // The size is filled in once the Mesh is uploaded
+            mesh = Ref<Mesh>::Create(path, true);
+            AssetEntry<Mesh>& entry = mMeshes.Entries[provisionalKey];
+            entry.Asset = mesh;
+            entry.LastUsed = ++mUseCounter;
+            mMeshes.Paths[canonicalPath] = {provisionalKey, lastWriteTime};
+        }
+
+        // The job only gets the raw pointer, Ref isn't thread safe. 'mPendingMeshes' keeps the Mesh alive until the job is done
+        Mesh* rawMesh = mesh.Raw();
+        PendingMesh& pending = mPendingMeshes.emplace_back();
+        pending.Asset = mesh;
+        pending.ProvisionalKey = provisionalKey;
+        pending.ImportJob = Core::GetThreadPool()->Run([rawMesh]() { rawMesh->Import(); });
+        return mesh;
+    }
+
+    void AssetManager::Update()
+    {
+        SURGE_PROFILE_FUNC("AssetManager::Update");
+        for (auto itr = mPendingMeshes.begin(); itr != mPendingMeshes.end();)
+        {
+            if (!itr->ImportJob.IsFinished())
+            {
+                ++itr;
+                continue;
+            }
+
+            UploadPendingMesh(*itr);
+            itr = mPendingMeshes.erase(itr);
+        }
+    }
+
+    void AssetManager::WaitForPendingLoads()
+    {
+        ThreadPool* threadPool = Core::GetThreadPool();
+        for (PendingMesh& pending : mPendingMeshes)
+            threadPool->Wait(pending.ImportJob);
+
+        Update();
+    }
+
+    void AssetManager::UploadPendingMesh(PendingMesh& pending)
+    {
+        Ref<Mesh>& mesh = pending.Asset;
+        const bool imported = mesh->GetState() == MeshState::Imported; // If not, the failure is already logged
+        if (imported)
+            mesh->Upload();
+
+        std::scoped_lock lock(mMutex);
+        if (!imported)
+        {
+            RemoveEntry(mMeshes, pending.ProvisionalKey);
+            return;
+        }
+
+        // Files with the same contents share one Mesh. If another path got there first, its Mesh is the one returned from now on,
+        // this one stays alive for the callers that already have it
+        const uint64_t key = GetAssetKey(mesh->mSourceHash, 0);
+        auto [itr, inserted] = mMeshes.Entries.try_emplace(key);
+        AssetEntry<Mesh>& entry = itr->second;
+        if (inserted)
+        {
+            entry.Asset = mesh;
+            entry.MemorySize = GetMemorySize(mesh);
+            mMemoryUsage += entry.MemorySize;
+        }
+        entry.LastUsed = ++mUseCounter;
+
+        mMeshes.Entries.erase(pending.ProvisionalKey); // Its size was never counted
+        for (auto& [path, record] : mMeshes.Paths)
+        {
+            if (record.AssetKey == pending.ProvisionalKey)
+                record.AssetKey = key;
+        }
+        EvictUnused(false);
+    }
+
+    template <typename T>
+    Ref<T> AssetManager::FindByPath(AssetCache<T>& cache, const String& canonicalPath, std::filesystem::file_time_type lastWriteTime)
+    {
+        auto pathItr = cache.Paths.find(canonicalPath);
+        if (pathItr == cache.Paths.end() || pathItr->second.LastWriteTime != lastWriteTime)
+            return nullptr;
+
+        auto entryItr = cache.Entries.find(pathItr->second.AssetKey);
+        if (entryItr == cache.Entries.end())
+            return nullptr;
+
+        entryItr->second.LastUsed = ++mUseCounter;
+        return entryItr->second.Asset;
+    }
+
+    template <typename T, typename LoadFn, typename SizeFn>
+    Ref<T> AssetManager::Load(AssetCache<T>& cache, const Path& path, uint64_t parameterHash, const LoadFn& load, const SizeFn& getSize)
+    {
+        std::error_code error;
+        const std::filesystem::path filepath = path.Str();
+        const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(filepath, error);
+        if (error)
+        {
+            Log<Severity::Error>("AssetManager: Cannot load {0}, file not found!", path);
+            return nullptr;
+        }
+        const String canonicalPath = GetCanonicalPath(filepath);
+
+        // Fast path, the file was loaded before and didn't change since
+        std::unique_lock lock(mMutex);
+        if (Ref<T> loaded = FindByPath(cache, canonicalPath, lastWriteTime))
+            return loaded;
+        lock.unlock();
+
+        // New or modified file, look for an asset with the same contents. Empty or unreadable, the path is all we know about it
+        const uint64_t contentHash = HashFileContents(path);
+        const uint64_t key = GetAssetKey(contentHash ? contentHash : Hash::GenerateFromBytes(canonicalPath.data(), canonicalPath.size()), parameterHash);
+        lock.lock();
+        cache.Paths[canonicalPath] = {key, lastWriteTime};
+        auto entryItr = cache.Entries.find(key);
+        if (entryItr != cache.Entries.end())
+        {
+            entryItr->second.LastUsed = ++mUseCounter;
+            return entryItr->second.Asset;
+        }
+        lock.unlock();
+
+        // Importing can take a while and meshes load their textures through the AssetManager, so don't hold the lock
+        Ref<T> asset = load(contentHash);
+        if (!asset)
+            return nullptr;
+        const uint64_t memorySize = getSize(asset);
+
+        // Someone else might have loaded the same file in the meantime, the first one wins
+        lock.lock();
+        auto [itr, inserted] = cache.Entries.try_emplace(key);
+        AssetEntry<T>& entry = itr->second;
+        if (inserted)
+        {
+            entry.Asset = asset;
+            entry.MemorySize = memorySize;
+            mMemoryUsage += memorySize;
+        }
+        entry.LastUsed = ++mUseCounter;
+
+        Ref<T> result = entry.Asset;
+        EvictUnused(false);
+        return result;
+    }
+
+    template <typename T>
+    void AssetManager::RemoveEntry(AssetCache<T>& cache, uint64_t key)
+    {
+        auto itr = cache.Entries.find(key);
+        if (itr == cache.Entries.end())
+            return;
+
+        mMemoryUsage -= itr->second.MemorySize;
+        cache.Entries.erase(itr);
+
+        for (auto pathItr = cache.Paths.begin(); pathItr != cache.Paths.end();)
+        {
+            if (pathItr->second.AssetKey == key)
+                pathItr = cache.Paths.erase(pathItr);
+            else
+                ++pathItr;
+        }
+    }
+
+    void AssetManager::EvictUnused(bool force)
+    {
+        struct Candidate
+        {
+            uint64_t LastUsed;
+            uint64_t Key;
+            bool IsMesh;
+        };
+
+        Vector<Candidate> candidates;
+        auto gatherUnused = [&candidates](auto& cache, bool isMesh) {
+            for (auto& [key, entry] : cache.Entries)
+            {
+                // The AssetManager holds the only Ref
+                if (entry.Asset->GetRefCount() == 1)
+                    candidates.push_back({entry.LastUsed, key, isMesh});
+            }
+        };
+
+        // Evicting a Mesh can leave its textures unused, so keep going until nothing else can be evicted
+        bool evicted = true;
+        while (evicted && (force || mMemoryUsage > mMemoryBudget))
+        {
+            candidates.clear();
+            gatherUnused(mMeshes, true);
+            gatherUnused(mTextures, false);
+            std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.LastUsed < b.LastUsed; });
+
+            evicted = false;
+            for (const Candidate& candidate : candidates)
+            {
+                if (!force && mMemoryUsage <= mMemoryBudget)
+                    break;
+
+                if (candidate.IsMesh)
+                    RemoveEntry(mMeshes, candidate.Key);
+                else
+                    RemoveEntry(mTextures, candidate.Key);
+                evicted = true;
+            }
+        }
+    }
+
+    void AssetManager::CollectGarbage()
+    {
+        SURGE_PROFILE_FUNC("AssetManager::CollectGarbage");
+        std::scoped_lock lock(mMutex);
+        EvictUnused(true);
+    }
+
+    void AssetManager::Clear()
+    {
+        // Import jobs still use their Mesh
+        ThreadPool* threadPool = Core::GetThreadPool();
+        for (PendingMesh& pending : mPendingMeshes)
+            threadPool->Wait(pending.ImportJob);
+        mPendingMeshes.clear();
+
+        std::scoped_lock lock(mMutex);
+        mMeshes.Entries.clear();
+        mMeshes.Paths.clear();
+        mTextures.Entries.clear();
+        mTextures.Paths.clear();
+        mMemoryUsage = 0;
+    }
+
+    void AssetManager::SetMemoryBudget(uint64_t budget)
+    {
+        std::scoped_lock lock(mMutex);
+        mMemoryBudget = budget;
+        EvictUnused(false);
+    }
+
+} // namespace Surge
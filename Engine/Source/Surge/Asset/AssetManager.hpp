@@ -0,0 +1,123 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Defines.hpp"
+#include "Surge/Core/Thread/Job.hpp"
+#include "Surge/Graphics/Interface/Texture.hpp"
+#include "Surge/Graphics/Mesh.hpp"
+#include <filesystem>
+#include <mutex>
+
+namespace Surge
+{
+    struct MeshBenchmarkResult
+    {
+        Uint MeshCount;
+        float SequentialColdMillis; // Cold: no cooked mesh in the MeshCache, everything is imported with Assimp
+        float SequentialWarmMillis;
+        float AsyncColdMillis;
+        float AsyncWarmMillis;
+    };
+
+    // Owns every Mesh and Texture2D that is loaded from disk.
+    // Assets are looked up by their canonical path first and by the hash of the file contents second, so the same file
+    // (or a copy of it living somewhere else) is imported and uploaded to the GPU only once, everyone gets a shared Ref to it.
+    // An asset that is only referenced by the AssetManager is unused, unused assets are evicted (least recently used first)
+    // as soon as the memory used by all the assets goes over the budget
+    class SURGE_API AssetManager
+    {
+    public:
+        AssetManager();
+        ~AssetManager();
+        SURGE_DISABLE_COPY_AND_MOVE(AssetManager);
+
+        // All of them return nullptr if the file doesn't exist
+        Ref<Mesh> LoadMesh(const Path& path);
+        Ref<Texture2D> LoadTexture(const Path& path, const TextureSpecification& specification = {});
+
+        // Same as above, but creates the Texture2D from pixels that were already decoded (if it isn't cached yet)
+        Ref<Texture2D> LoadTexture(const Path& path, const TextureData& data, const TextureSpecification& specification = {});
+
+        // Returns right away, the file isn't even read on the calling thread: the Mesh is hashed and imported on the worker threads
+        // and uploaded to the GPU in Update(), where it is merged with any Mesh loaded from a file with the same contents.
+        // Until then Mesh::IsReady() returns false and the Renderer draws a placeholder instead. Main thread only
+        Ref<Mesh> LoadMeshAsync(const Path& path);
+
+        // Uploads the meshes that finished importing, called by Core once per frame
+        void Update();
+
+        // Blocks until every pending asynchronous load has been imported and uploaded
+        void WaitForPendingLoads();
+
+        // Evicts every unused asset, regardless of the budget
+        void CollectGarbage();
+
+        // Drops all the assets, assets that are still referenced somewhere else stay alive until their last Ref goes away
+        void Clear();
+
+        void SetMemoryBudget(uint64_t budget);
+        uint64_t GetMemoryBudget() const { return mMemoryBudget; }
+
+        // Approximate CPU + GPU memory in bytes used by all the cached assets
+        uint64_t GetMemoryUsage() const { return mMemoryUsage; }
+
+        // Loads 'copies' copies of every mesh in Engine/Assets/Mesh one after the other and then on the worker threads (like
+        // LoadMeshAsync), with and without their cooked meshes. Bypasses the cache, the copies are deleted afterwards. Main thread only
+        static MeshBenchmarkResult RunMeshBenchmark(Uint copies);
+
+    private:
+        template <typename T>
+        struct AssetEntry
+        {
+            Ref<T> Asset;
+            uint64_t MemorySize = 0;
+            uint64_t LastUsed = 0;
+        };
+
+        struct PathRecord
+        {
+            uint64_t AssetKey = 0; // Content hash of the file, combined with the load parameters (a key made from the path while LoadMeshAsync hashes it)
+            std::filesystem::file_time_type LastWriteTime;
+        };
+
+        template <typename T>
+        struct AssetCache
+        {
+            HashMap<uint64_t, AssetEntry<T>> Entries;
+            HashMap<String, PathRecord> Paths; // Canonical path -> key in 'Entries'
+        };
+
+        // Returns the asset loaded from 'canonicalPath' if the file didn't change since. mMutex must be held
+        template <typename T>
+        Ref<T> FindByPath(AssetCache<T>& cache, const String& canonicalPath, std::filesystem::file_time_type lastWriteTime);
+
+        // 'load' gets the hash of the file contents, 0 if the file is empty or unreadable
+        template <typename T, typename LoadFn, typename SizeFn>
+        Ref<T> Load(AssetCache<T>& cache, const Path& path, uint64_t parameterHash, const LoadFn& load, const SizeFn& getSize);
+
+        struct PendingMesh
+        {
+            Ref<Mesh> Asset; // Keeps the Mesh alive while the import job uses it
+            JobHandle ImportJob;
+            uint64_t ProvisionalKey; // Key of its entry until the contents are hashed
+        };
+
+        void UploadPendingMesh(PendingMesh& pending);
+
+        template <typename T>
+        void RemoveEntry(AssetCache<T>& cache, uint64_t key);
+
+        // Evicts unused assets until the memory usage is under the budget, or all of them if 'force' is true. mMutex must be held
+        void EvictUnused(bool force);
+
+    private:
+        std::mutex mMutex;
+        AssetCache<Mesh> mMeshes;
+        AssetCache<Texture2D> mTextures;
+        Vector<PendingMesh> mPendingMeshes; // Only touched on the main thread
+
+        uint64_t mMemoryBudget;
+        uint64_t mMemoryUsage = 0;
+        uint64_t mUseCounter = 0; // Bumped on every lookup, used for LRU ordering
+    };
+
+} // namespace Surge
@@ -0,0 +1,89 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Asset/AssetManager.hpp"
+#include "Surge/Graphics/MeshCache.hpp"
+#include "Surge/Graphics/Shader/ShaderSet.hpp"
+
+#define MESH_BENCHMARK_SOURCE_PATH "Engine/Assets/Mesh"
+#define MESH_BENCHMARK_PATH TEMP_ASSET_PATH "/MeshBenchmark"
+
+namespace Surge
+{
+    MeshBenchmarkResult AssetManager::RunMeshBenchmark(Uint copies)
+    {
+        SURGE_PROFILE_FUNC("AssetManager::RunMeshBenchmark");
+
+        // Every copy gets its own file, so that each one is imported (and cooked) instead of being shared by the AssetManager
+        // or read from the cooked mesh of another copy
+        Vector<Path> paths;
+        std::error_code error;
+        std::filesystem::create_directories(MESH_BENCHMARK_PATH, error);
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(MESH_BENCHMARK_SOURCE_PATH, error))
+        {
+            if (!entry.is_regular_file())
+                continue;
+
+            for (Uint i = 0; i < copies; i++)
+            {
+                const String path = fmt::format("{0}/{1}_{2}{3}", MESH_BENCHMARK_PATH, entry.path().stem().string(), i, entry.path().extension().string());
+                std::filesystem::copy_file(entry.path(), path, std::filesystem::copy_options::overwrite_existing, error);
+                paths.push_back(path);
+            }
+        }
+
+        // One mesh after the other on the calling thread, with the blocking Mesh constructor
+        auto loadSequential = [&paths]() {
+            Timer timer;
+            Vector<Ref<Mesh>> meshes;
+            meshes.reserve(paths.size());
+            for (const Path& path : paths)
+                meshes.push_back(Ref<Mesh>::Create(path));
+            return timer.ElapsedMillis();
+        };
+
+        // Like LoadMeshAsync: every mesh is imported on the worker threads at the same time, then uploaded in the order they were requested
+        auto loadAsync = [&paths]() {
+            Timer timer;
+            ThreadPool* threadPool = Core::GetThreadPool();
+            Vector<Ref<Mesh>> meshes;
+            Vector<JobHandle> importJobs;
+            meshes.reserve(paths.size());
+            importJobs.reserve(paths.size());
+            for (const Path& path : paths)
+            {
+                Mesh* mesh = meshes.emplace_back(Ref<Mesh>::Create(path, true)).Raw();
+                importJobs.push_back(threadPool->Run([mesh]() { mesh->Import(); }));
+            }
+
+            for (size_t i = 0; i < meshes.size(); i++)
+            {
+                threadPool->Wait(importJobs[i]);
+                if (meshes[i]->GetState() == MeshState::Imported)
+                    meshes[i]->Upload();
+            }
+            return timer.ElapsedMillis();
+        };
+
+        // Cold runs go through Assimp, warm runs read the meshes cooked by the cold run
+        auto removeCookedMeshes = [&paths]() {
+            for (const Path& path : paths)
+                MeshCache::Remove(path);
+        };
+
+        MeshBenchmarkResult result = {};
+        result.MeshCount = static_cast<Uint>(paths.size());
+        removeCookedMeshes();
+        result.SequentialColdMillis = loadSequential();
+        result.SequentialWarmMillis = loadSequential();
+        removeCookedMeshes();
+        result.AsyncColdMillis = loadAsync();
+        result.AsyncWarmMillis = loadAsync();
+
+        removeCookedMeshes();
+        std::filesystem::remove_all(MESH_BENCHMARK_PATH, error);
+
+        Log<Severity::Info>("Loaded {0} meshes ({1} copies of {2}), sequential: {3} ms cold, {4} ms warm. Async: {5} ms cold, {6} ms warm",
+                            result.MeshCount, copies, MESH_BENCHMARK_SOURCE_PATH, result.SequentialColdMillis, result.SequentialWarmMillis, result.AsyncColdMillis, result.AsyncWarmMillis);
+        return result;
+    }
+
+} // namespace Surge
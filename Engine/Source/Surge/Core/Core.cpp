@@ -37,6 +37,9 @@ namespace Surge::Core
         GCoreData.SurgeClient = application;
         const ClientOptions& clientOptions = GCoreData.SurgeClient->GeClientOptions();
 
+        // Job System, the main thread takes part in it as well, so leave one hardware thread for it
+        GCoreData.SurgeThreadPool = new ThreadPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+
         // Window
         GCoreData.SurgeWindow = new WindowsWindow(clientOptions.WindowDescription);
         GCoreData.SurgeWindow->RegisterEventCallback(OnEvent);
@@ -45,6 +48,9 @@ namespace Surge::Core
         GCoreData.SurgeRenderContext = new VulkanRenderContext();
         GCoreData.SurgeRenderContext->Initialize(GCoreData.SurgeWindow, clientOptions.EnableImGui);
 
+        // Asset Manager, before the Renderer since the Renderer loads a few assets itself
+        GCoreData.SurgeAssetManager = new AssetManager();
+
         // Renderer
         GCoreData.SurgeRenderer = new Renderer();
         GCoreData.SurgeRenderer->Initialize();
@@ -68,6 +74,7 @@ namespace Surge::Core
             SURGE_PROFILE_FRAME("Core::Frame");
             GCoreData.SurgeClock.Update();
             GCoreData.SurgeWindow->Update();
+            GCoreData.SurgeAssetManager->Update();
 
             if (GCoreData.SurgeWindow->GetWindowState() != WindowState::Minimized)
             {
@@ -97,6 +104,9 @@ namespace Surge::Core
         delete GCoreData.SurgeClient;
         GCoreData.SurgeClient = nullptr;
 
+        // Assets hold GPU resources, they must go before the renderer
+        delete GCoreData.SurgeAssetManager;
+
         GCoreData.SurgeRenderer->Shutdown();
         delete GCoreData.SurgeRenderer;
 
@@ -107,6 +117,8 @@ namespace Surge::Core
         GCoreData.SurgeRenderContext->Shutdown();
         delete GCoreData.SurgeRenderContext;
         SurgeReflect::Registry::Shutdown();
+
+        delete GCoreData.SurgeThreadPool;
     }
 
     void Core::AddFrameEndCallback(const std::function<void()>& func)
@@ -117,9 +129,11 @@ namespace Surge::Core
     Window* GetWindow() { return GCoreData.SurgeWindow; }
     RenderContext* GetRenderContext() { return GCoreData.SurgeRenderContext; }
     Renderer* GetRenderer() { return GCoreData.SurgeRenderer; }
+    AssetManager* GetAssetManager() { return GCoreData.SurgeAssetManager; }
     ScriptEngine* GetScriptEngine() { return GCoreData.SurgeScriptEngine; }
     CoreData* GetData() { return &GCoreData; }
     Client* GetClient() { return GCoreData.SurgeClient; }
     Surge::Clock& GetClock() { return GCoreData.SurgeClock; }
+    ThreadPool* GetThreadPool() { return GCoreData.SurgeThreadPool; }
 
 } // namespace Surge::Core
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "Surge/Graphics/Renderer/Renderer.hpp"
 #include "Surge/Scripting/ScriptEngine.hpp"
 #include "Surge/Core/Time/Clock.hpp"
+#include "Surge/Core/Thread/ThreadPool.hpp"
+#include "Surge/Asset/AssetManager.hpp"
 
 namespace Surge::Core
 {
@@ -16,8 +18,10 @@ namespace Surge::Core
 
         Clock SurgeClock;
         Window* SurgeWindow = nullptr;
+        ThreadPool* SurgeThreadPool = nullptr;
         RenderContext* SurgeRenderContext = nullptr;
         Renderer* SurgeRenderer = nullptr;
+        AssetManager* SurgeAssetManager = nullptr;
         ScriptEngine* SurgeScriptEngine = nullptr;
 
         bool Running = false;
@@ -33,10 +37,12 @@ namespace Surge::Core
     // Window should be a part of core
     SURGE_API Window* GetWindow();
     SURGE_API Clock& GetClock();
+    SURGE_API ThreadPool* GetThreadPool();
 
     // Part of renderer module
     SURGE_API RenderContext* GetRenderContext();
     SURGE_API Renderer* GetRenderer();
+    SURGE_API AssetManager* GetAssetManager();
 
     // Part of scripting module
     SURGE_API ScriptEngine* GetScriptEngine();
@@ -2,6 +2,7 @@
 #pragma once
 #include "Surge/Core/String.hpp"
 #include <cstdint>
+#include <cstring>
 
 namespace Surge
 {
@@ -11,6 +12,72 @@ namespace Surge
     public:
         template <typename T>
         inline HashCode Generate(const T& s);
+
+        // 64 bit xxHash (XXH64) of a block of memory, fast and well distributed enough to be used as a content hash for the caches
+        static uint64_t GenerateFromBytes(const void* data, size_t size, uint64_t seed = 0)
+        {
+            const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+            const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+            const uint64_t prime3 = 0x165667B19E3779F9ull;
+            const uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+            const uint64_t prime5 = 0x27D4EB2F165667C5ull;
+            auto round = [&](uint64_t acc, uint64_t input) { return Rotl(acc + input * prime2, 31) * prime1; };
+
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            const uint8_t* end = bytes + size;
+            uint64_t hash;
+            if (size >= 32)
+            {
+                // 4 independent lanes over 32 byte stripes
+                uint64_t lanes[4] = {seed + prime1 + prime2, seed + prime2, seed, seed - prime1};
+                for (; bytes + 32 <= end; bytes += 32)
+                {
+                    for (int i = 0; i < 4; i++)
+                        lanes[i] = round(lanes[i], Read<uint64_t>(bytes + i * 8));
+                }
+
+                hash = Rotl(lanes[0], 1) + Rotl(lanes[1], 7) + Rotl(lanes[2], 12) + Rotl(lanes[3], 18);
+                for (uint64_t lane : lanes)
+                    hash = (hash ^ round(0, lane)) * prime1 + prime4;
+            }
+            else
+                hash = seed + prime5;
+
+            hash += size;
+            for (; bytes + 8 <= end; bytes += 8)
+                hash = Rotl(hash ^ round(0, Read<uint64_t>(bytes)), 27) * prime1 + prime4;
+            if (bytes + 4 <= end)
+            {
+                hash = Rotl(hash ^ (Read<uint32_t>(bytes) * prime1), 23) * prime2 + prime3;
+                bytes += 4;
+            }
+            for (; bytes < end; bytes++)
+                hash = Rotl(hash ^ (*bytes * prime5), 11) * prime1;
+
+            // Avalanche
+            hash ^= hash >> 33;
+            hash *= prime2;
+            hash ^= hash >> 29;
+            hash *= prime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        static uint64_t Combine(uint64_t a, uint64_t b)
+        {
+            return a ^ (b + 0x9E3779B97F4A7C15ull + (a << 6) + (a >> 2));
+        }
+
+    private:
+        static uint64_t Rotl(uint64_t value, int shift) { return (value << shift) | (value >> (64 - shift)); }
+
+        template <typename T>
+        static T Read(const uint8_t* bytes)
+        {
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
     };
 
     template <typename T>
@@ -1,19 +1,25 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
+#include <atomic>
 
 namespace Surge
 {
+    // The count is atomic since Refs are copied on the job system too (command recording, for example)
     class SURGE_API RefCounted
     {
     public:
-        void IncRefCount() const { mRefCount++; }
-        void DecRefCount() const { mRefCount--; }
+        RefCounted() = default;
+        RefCounted(const RefCounted&) {} // A copy is a new object, it starts without references
+        RefCounted& operator=(const RefCounted&) { return *this; }
+
+        void IncRefCount() const { mRefCount.fetch_add(1, std::memory_order_relaxed); }
+        Uint DecRefCount() const { return mRefCount.fetch_sub(1, std::memory_order_acq_rel) - 1; } // Returns the new count
         void ZeroRefCount() const { mRefCount = 0; }
 
-        Uint GetRefCount() const { return mRefCount; }
+        Uint GetRefCount() const { return mRefCount.load(std::memory_order_relaxed); }
 
     private:
-        mutable Uint mRefCount = 0;
+        mutable std::atomic<Uint> mRefCount = 0;
     };
 
     template <typename T>
@@ -131,8 +137,7 @@ namespace Surge
         {
             if (mInstance)
             {
-                mInstance->DecRefCount();
-                if (mInstance->GetRefCount() == 0)
+                if (mInstance->DecRefCount() == 0)
                     delete mInstance;
             }
         }
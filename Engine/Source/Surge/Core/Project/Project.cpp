@@ -2,6 +2,7 @@
 #include "Project.hpp"
 #include "Surge/Utility/Filesystem.hpp"
 #include "Surge/Serializer/Serializer.hpp"
+#include <filesystem>
 
 namespace Surge
 {
@@ -36,7 +37,7 @@ namespace Surge
         Destroy();
         mMetadata = ProjectMetadata(name, path);
         // Add a default scene
-        Ref<Scene> scene = AddScene("Default", fmt::format("{0}", fmt::format("{0}/Default.surge", mMetadata.ProjPath)));
+        Ref<Scene> scene = AddScene("Default", fmt::format("{0}", fmt::format("{0}/Default.surgeb", mMetadata.ProjPath)));
         Serializer::Deserialize<Scene>("Engine/Assets/Scenes/Default.surge", scene.Raw());
         Serializer::Serialize<Scene>(scene->GetMetadata().ScenePath, scene.Raw());
         mIsValid = true;
@@ -54,7 +55,7 @@ namespace Surge
         if (metadata.SceneMetadatas.empty())
         {
             // Add a default scene if there is none
-            Ref<Scene> scene = AddScene("Default", fmt::format("{0}", fmt::format("{0}/Default.surge", mMetadata.ProjPath)));
+            Ref<Scene> scene = AddScene("Default", fmt::format("{0}", fmt::format("{0}/Default.surgeb", mMetadata.ProjPath)));
             Serializer::Deserialize<Scene>("Engine/Assets/Scenes/Default.surge", scene.Raw()); // Load the defaule scene to the new scene
             Serializer::Serialize<Scene>(scene->GetMetadata().ScenePath, scene.Raw());         // Save the new scene in the project path
         }
@@ -142,7 +143,8 @@ namespace Surge
 
         Filesystem::RemoveFile(metadata.ScenePath);
         metadata.Name = newName;
-        metadata.ScenePath = fmt::format("{0}/{1}.surge", Filesystem::GetParentPath(metadata.ScenePath), newName);
+        const String extension = std::filesystem::path(metadata.ScenePath.Str()).extension().string();
+        metadata.ScenePath = fmt::format("{0}/{1}{2}", Filesystem::GetParentPath(metadata.ScenePath), newName, extension);
 
         mMetadata.SceneMetadatas[index].Name = newName;
         mMetadata.SceneMetadatas[index].ScenePath = metadata.ScenePath;
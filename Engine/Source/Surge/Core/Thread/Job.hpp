@@ -0,0 +1,139 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Defines.hpp"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Surge
+{
+    class ThreadPool;
+    struct JobCache;
+
+    // A unit of work scheduled on the ThreadPool. The callable is stored inline (small buffer), so pushing a task
+    // does not heap allocate as long as its captures fit in JOB_STORAGE_SIZE bytes.
+    // Jobs are recycled by the ThreadPool, never create one directly, use ThreadPool::CreateJob instead
+    class alignas(64) Job
+    {
+    public:
+        static constexpr size_t JOB_STORAGE_SIZE = 64;
+
+        Job() = default;
+        ~Job() { DestroyCallable(); }
+        SURGE_DISABLE_COPY_AND_MOVE(Job);
+
+        bool IsFinished() const { return mFinished.load(std::memory_order_acquire); }
+
+    private:
+        template <typename F>
+        void Bind(F&& func)
+        {
+            using Fn = std::decay_t<F>;
+            if constexpr (sizeof(Fn) <= JOB_STORAGE_SIZE && alignof(Fn) <= alignof(std::max_align_t))
+            {
+                new (mStorage) Fn(std::forward<F>(func));
+                mInvoke = [](void* storage) { (*static_cast<Fn*>(storage))(); };
+                mDestroy = [](void* storage) { static_cast<Fn*>(storage)->~Fn(); };
+            }
+            else
+            {
+                // Callable too big for the inline storage, fall back to the heap
+                *reinterpret_cast<Fn**>(mStorage) = new Fn(std::forward<F>(func));
+                mInvoke = [](void* storage) { (**static_cast<Fn**>(storage))(); };
+                mDestroy = [](void* storage) { delete *static_cast<Fn**>(storage); };
+            }
+        }
+
+        void Execute() { mInvoke(mStorage); }
+
+        void DestroyCallable()
+        {
+            if (mDestroy)
+                mDestroy(mStorage);
+            mInvoke = nullptr;
+            mDestroy = nullptr;
+        }
+
+        void LockContinuations()
+        {
+            while (mContinuationLock.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        void UnlockContinuations() { mContinuationLock.clear(std::memory_order_release); }
+
+    private:
+        using InvokeFn = void (*)(void*);
+        using DestroyFn = void (*)(void*);
+
+        alignas(std::max_align_t) Byte mStorage[JOB_STORAGE_SIZE];
+        InvokeFn mInvoke = nullptr;
+        DestroyFn mDestroy = nullptr;
+
+        std::atomic<int32_t> mRefCount = 0;
+        std::atomic<int32_t> mPendingDependencies = 0; // +1 until the job is scheduled, +1 for every unfinished dependency
+        std::atomic<bool> mFinished = false;
+
+        std::atomic_flag mContinuationLock = ATOMIC_FLAG_INIT;
+        Vector<Job*> mContinuations; // Jobs waiting on this one to finish
+
+        JobCache* mOwner = nullptr; // Cache of the thread that allocated the job, it goes back there when released
+        Job* mNextFree = nullptr;   // Link in the remote free list of mOwner
+
+        friend class ThreadPool;
+        friend class JobHandle;
+        friend struct JobCache;
+    };
+
+    // Shared handle to a Job, keeps the Job alive (not recycled) as long as a handle refers to it
+    class SURGE_API JobHandle
+    {
+    public:
+        JobHandle() = default;
+        JobHandle(const JobHandle& other) : mJob(other.mJob) { IncRef(); }
+        JobHandle(JobHandle&& other) noexcept : mJob(other.mJob) { other.mJob = nullptr; }
+        ~JobHandle() { DecRef(); }
+
+        JobHandle& operator=(const JobHandle& other)
+        {
+            if (mJob != other.mJob)
+            {
+                other.IncRef();
+                DecRef();
+                mJob = other.mJob;
+            }
+            return *this;
+        }
+
+        JobHandle& operator=(JobHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                DecRef();
+                mJob = other.mJob;
+                other.mJob = nullptr;
+            }
+            return *this;
+        }
+
+        bool IsFinished() const { return !mJob || mJob->IsFinished(); }
+        operator bool() const { return mJob != nullptr; }
+
+    private:
+        explicit JobHandle(Job* job) : mJob(job) { IncRef(); }
+
+        void IncRef() const
+        {
+            if (mJob)
+                mJob->mRefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        void DecRef() const;
+
+    private:
+        Job* mJob = nullptr;
+        friend class ThreadPool;
+    };
+
+} // namespace Surge
@@ -1,84 +1,391 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "ThreadPool.hpp"
 
+// Number of failed attempts to find a job before a worker parks itself
+#define WORKER_SPIN_COUNT 64
+
+// Maximum number of recycled Jobs a thread keeps in its own free list
+#define MAX_CACHED_JOBS 1024
+
 namespace Surge
 {
+    // Recycled Jobs of one thread. A job is always returned to the cache that allocated it: the owner thread pushes it to
+    // FreeJobs directly, other threads push it to the lock-free RemoteFreeJobs list, which the owner takes over once FreeJobs is empty.
+    // Caches outlive their threads, a cache whose thread has exited is adopted by the next thread that needs one
+    struct JobCache
+    {
+        ~JobCache()
+        {
+            for (Job* job : FreeJobs)
+                delete job;
+            for (Job* job = RemoteFreeJobs.load(std::memory_order_acquire); job;)
+            {
+                Job* next = job->mNextFree;
+                delete job;
+                job = next;
+            }
+        }
+
+        Vector<Job*> FreeJobs;                      // Owner thread only
+        std::atomic<Job*> RemoteFreeJobs = nullptr; // Intrusive list through Job::mNextFree
+    };
+
+    namespace
+    {
+        // Caches of the exited threads, kept alive because their jobs may still be released
+        struct OrphanedJobCaches
+        {
+            ~OrphanedJobCaches()
+            {
+                for (JobCache* cache : Caches)
+                    delete cache;
+            }
+
+            std::mutex Mutex;
+            Vector<JobCache*> Caches;
+        };
+
+        OrphanedJobCaches& GetOrphanedJobCaches()
+        {
+            static OrphanedJobCaches orphanedCaches;
+            return orphanedCaches;
+        }
+
+        // Binds a JobCache to the lifetime of a thread
+        struct ThreadJobCache
+        {
+            ThreadJobCache()
+            {
+                OrphanedJobCaches& orphaned = GetOrphanedJobCaches();
+                std::scoped_lock lock(orphaned.Mutex);
+                if (!orphaned.Caches.empty())
+                {
+                    Cache = orphaned.Caches.back();
+                    orphaned.Caches.pop_back();
+                }
+                else
+                    Cache = new JobCache();
+            }
+
+            ~ThreadJobCache()
+            {
+                OrphanedJobCaches& orphaned = GetOrphanedJobCaches();
+                std::scoped_lock lock(orphaned.Mutex);
+                orphaned.Caches.push_back(Cache);
+            }
+
+            JobCache* Cache;
+        };
+
+        thread_local ThreadJobCache sJobCache;
+        thread_local ThreadPool* sCurrentPool = nullptr;
+        thread_local Uint sQueueIndex = 0;
+        thread_local Uint sRandomState = 0x9E3779B9;
+
+        // xorshift32, used for picking steal victims
+        Uint NextRandom()
+        {
+            Uint x = sRandomState;
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            sRandomState = x;
+            return x;
+        }
+    } // namespace
+
+    void JobHandle::DecRef() const
+    {
+        if (mJob && mJob->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ThreadPool::ReleaseJob(mJob);
+    }
+
     ThreadPool::ThreadPool(Uint threadCount)
-        : mThreadCount(std::max<Uint>(threadCount, 1)), mThreads(new std::thread[std::max<Uint>(threadCount, 1)])
+        : mThreadCount(threadCount)
     {
-        Log<Severity::Info>("Creating ThreadPool with {0} threads...", threadCount);
+        Log<Severity::Info>("Creating ThreadPool with {0} threads...", mThreadCount);
         CreateThreads();
     }
 
     ThreadPool::~ThreadPool()
     {
         WaitForTasks();
-        mRunning = false;
         DestroyThreads();
     }
 
     void ThreadPool::Reset(Uint threadCount)
     {
         WaitForTasks();
-        mRunning = false;
         DestroyThreads();
-        mThreadCount = std::max<Uint>(threadCount, 1);
-        mThreads.reset(new std::thread[std::max<Uint>(threadCount, 1)]);
-        mRunning = true;
+        mThreadCount = threadCount;
         CreateThreads();
     }
 
-    void ThreadPool::WaitForTasks()
+    void ThreadPool::CreateThreads()
+    {
+        mQueues.reset(new Scope<JobQueue>[mThreadCount + 1]);
+        for (Uint i = 0; i < mThreadCount + 1; i++)
+            mQueues[i] = CreateScope<JobQueue>();
+
+        // The creating thread owns the first deque
+        sCurrentPool = this;
+        sQueueIndex = 0;
+
+        mRunning = true;
+        mThreads.reset(new std::thread[mThreadCount]);
+        for (Uint i = 0; i < mThreadCount; i++)
+            mThreads[i] = std::thread(&ThreadPool::Worker, this, i + 1);
+    }
+
+    void ThreadPool::DestroyThreads()
     {
-        while (mTasksWaiting != 0)
         {
-            std::this_thread::yield();
+            std::scoped_lock lock(mSleepMutex);
+            mRunning = false;
         }
+        mSleepCondition.notify_all();
+
+        for (Uint i = 0; i < mThreadCount; i++)
+            mThreads[i].join();
+
+        if (sCurrentPool == this)
+            sCurrentPool = nullptr;
     }
 
-    void ThreadPool::CreateThreads()
+    Job* ThreadPool::AllocateJob()
     {
-        for (Uint i = 0; i < mThreadCount; i++)
+        JobCache* cache = sJobCache.Cache;
+        Vector<Job*>& freeJobs = cache->FreeJobs;
+        if (freeJobs.empty())
         {
-            mThreads[i] = std::thread(&ThreadPool::Worker, this);
+            // Take over the jobs that other threads released in the meantime
+            for (Job* remoteJob = cache->RemoteFreeJobs.exchange(nullptr, std::memory_order_acquire); remoteJob; remoteJob = remoteJob->mNextFree)
+                freeJobs.push_back(remoteJob);
         }
+
+        Job* job;
+        if (!freeJobs.empty())
+        {
+            job = freeJobs.back();
+            freeJobs.pop_back();
+        }
+        else
+        {
+            job = new Job();
+            job->mOwner = cache;
+        }
+
+        job->mRefCount.store(0, std::memory_order_relaxed);
+        job->mPendingDependencies.store(1, std::memory_order_relaxed); // Released by Schedule
+        job->mFinished.store(false, std::memory_order_relaxed);
+        return job;
     }
 
-    void ThreadPool::DestroyThreads()
+    void ThreadPool::ReleaseJob(Job* job)
     {
-        for (std::uint_fast32_t i = 0; i < mThreadCount; i++)
+        job->DestroyCallable();
+        job->mContinuations.clear();
+
+        JobCache* owner = job->mOwner;
+        if (owner == sJobCache.Cache)
         {
-            mThreads[i].join();
+            if (owner->FreeJobs.size() < MAX_CACHED_JOBS)
+                owner->FreeJobs.push_back(job);
+            else
+                delete job;
+            return;
         }
+
+        // Only the owner pops (all at once), so pushing can't run into ABA
+        Job* head = owner->RemoteFreeJobs.load(std::memory_order_relaxed);
+        do
+        {
+            job->mNextFree = head;
+        } while (!owner->RemoteFreeJobs.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
     }
 
-    bool ThreadPool::PopTask(std::function<void()>& task)
+    void ThreadPool::AddDependency(const JobHandle& job, const JobHandle& dependency)
     {
-        const std::scoped_lock lock(mQueueMutex);
-        if (mTasks.empty())
-            return false;
+        SG_ASSERT(job.mJob && dependency.mJob, "Invalid JobHandle!");
+        Job* dependent = job.mJob;
+        Job* target = dependency.mJob;
+
+        target->LockContinuations();
+        if (!target->IsFinished())
+        {
+            dependent->mPendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            dependent->mRefCount.fetch_add(1, std::memory_order_relaxed); // Held by 'target' until it resolves the dependency
+            target->mContinuations.push_back(dependent);
+        }
+        target->UnlockContinuations();
+    }
+
+    void ThreadPool::Schedule(const JobHandle& job)
+    {
+        SG_ASSERT(job.mJob, "Invalid JobHandle!");
+        job.mJob->mRefCount.fetch_add(1, std::memory_order_relaxed); // Held by the scheduler until the job has executed
+        mTasksWaiting.fetch_add(1, std::memory_order_relaxed);
+        ResolveDependency(job.mJob);
+    }
+
+    void ThreadPool::ResolveDependency(Job* job)
+    {
+        if (job->mPendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Enqueue(job);
+    }
+
+    void ThreadPool::Enqueue(Job* job)
+    {
+        // Without workers nothing would pick the job up unless someone waits, so it runs right away
+        if (mThreadCount == 0)
+        {
+            Execute(job);
+            return;
+        }
+
+        mQueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+        if (sCurrentPool == this)
+        {
+            if (!mQueues[sQueueIndex]->Push(job))
+            {
+                // Deque is full, no point in queuing more; run it right here
+                mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                Execute(job);
+                return;
+            }
+        }
         else
         {
-            task = std::move(mTasks.front());
-            mTasks.pop();
-            return true;
+            std::scoped_lock lock(mInjectionMutex);
+            mInjectionQueue.push_back(job);
         }
+
+        if (mSleepingThreads.load(std::memory_order_seq_cst) != 0)
+        {
+            // Taking the lock makes sure a worker that is about to sleep sees the new job
+            { std::scoped_lock lock(mSleepMutex); }
+            mSleepCondition.notify_one();
+        }
+    }
+
+    void ThreadPool::Execute(Job* job)
+    {
+        job->Execute();
+        job->DestroyCallable();
+
+        // Mark the job as finished and release everything that was waiting on it
+        job->LockContinuations();
+        job->mFinished.store(true, std::memory_order_release);
+        job->UnlockContinuations();
+
+        for (Job* continuation : job->mContinuations)
+        {
+            ResolveDependency(continuation);
+            if (continuation->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ReleaseJob(continuation);
+        }
+        job->mContinuations.clear();
+
+        mTasksWaiting.fetch_sub(1, std::memory_order_release);
+        if (job->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ReleaseJob(job);
     }
 
-    void ThreadPool::Worker()
+    Job* ThreadPool::FindJob()
     {
-        while (mRunning)
+        Job* job = nullptr;
+
+        // Own deque first (LIFO), this is the hot path
+        if (sCurrentPool == this)
+            job = mQueues[sQueueIndex]->Pop();
+
+        // Jobs pushed from foreign threads
+        if (!job && sCurrentPool == this)
         {
-            std::function<void()> task;
-            if (PopTask(task))
+            std::unique_lock lock(mInjectionMutex, std::try_to_lock);
+            if (lock.owns_lock() && !mInjectionQueue.empty())
             {
-                task();
-                mTasksWaiting--;
+                job = mInjectionQueue.front();
+                mInjectionQueue.pop_front();
             }
-            else
+        }
+
+        // Steal from a random victim
+        if (!job)
+        {
+            const Uint queueCount = mThreadCount + 1;
+            const Uint start = NextRandom() % queueCount;
+            for (Uint i = 0; i < queueCount && !job; i++)
             {
+                const Uint victim = (start + i) % queueCount;
+                if (sCurrentPool == this && victim == sQueueIndex)
+                    continue;
+                job = mQueues[victim]->Steal();
+            }
+        }
+
+        if (job)
+            mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        return job;
+    }
+
+    bool ThreadPool::RunPendingJob()
+    {
+        Job* job = FindJob();
+        if (!job)
+            return false;
+
+        Execute(job);
+        return true;
+    }
+
+    void ThreadPool::Wait(const JobHandle& job)
+    {
+        while (!job.IsFinished())
+        {
+            if (!RunPendingJob())
                 std::this_thread::yield();
+        }
+    }
+
+    void ThreadPool::WaitForTasks()
+    {
+        while (mTasksWaiting.load(std::memory_order_acquire) != 0)
+        {
+            if (!RunPendingJob())
+                std::this_thread::yield();
+        }
+    }
+
+    void ThreadPool::Worker(Uint index)
+    {
+        SURGE_PROFILE_THREAD("Surge Worker");
+        sCurrentPool = this;
+        sQueueIndex = index;
+        sRandomState = 0x9E3779B9 * (index + 1);
+
+        Uint spins = 0;
+        while (mRunning.load(std::memory_order_relaxed))
+        {
+            if (RunPendingJob())
+            {
+                spins = 0;
+                continue;
+            }
+
+            if (++spins < WORKER_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+                continue;
             }
+
+            // Nothing to do, park until someone pushes a job
+            std::unique_lock lock(mSleepMutex);
+            mSleepingThreads.fetch_add(1, std::memory_order_seq_cst);
+            mSleepCondition.wait(lock, [this] { return mQueuedJobs.load(std::memory_order_seq_cst) != 0 || !mRunning; });
+            mSleepingThreads.fetch_sub(1, std::memory_order_relaxed);
+            spins = 0;
         }
     }
 } // namespace Surge
@@ -1,69 +1,129 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
+#include "Surge/Core/Thread/Job.hpp"
+#include "Surge/Core/Thread/WorkStealingQueue.hpp"
 #include <algorithm>
 #include <atomic>
-#include <chrono>
-#include <functional>
+#include <condition_variable>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
 
 namespace Surge
 {
+    // One job duration of ThreadPool::RunBenchmark, the times are for the whole batch of jobs
+    struct JobBenchmarkResult
+    {
+        float JobMicroseconds;
+        Uint JobCount;
+        float ThreadPoolMillis;
+        float MutexQueueMillis; // The global-mutex std::queue the ThreadPool replaced
+    };
+
+    // One thread count of ThreadPool::RunParallelForBenchmark
+    struct ParallelForBenchmarkResult
+    {
+        Uint ThreadCount; // Including the calling thread
+        float Millis;     // Per ParallelFor
+        float Speedup;    // Compared to a single thread
+    };
+
+    // Work-stealing job system.
+    // Every worker owns a lock-free deque, the thread that creates the ThreadPool owns one too (slot 0) so that it can
+    // push jobs without locking and help while waiting. Jobs pushed from any other thread go through a small injection queue.
+    // Idle workers spin for a while and are then parked on a condition variable until new work arrives.
+    // With zero worker threads every job runs on the thread that schedules it.
     class SURGE_API ThreadPool
     {
     public:
         ThreadPool(Uint threadCount = std::thread::hardware_concurrency());
         ~ThreadPool();
+        SURGE_DISABLE_COPY_AND_MOVE(ThreadPool);
 
         Uint GetThreadCount() { return mThreadCount; }
 
+        // Calls 'func(index)' for every index in [first, last). The range is split into chunks which are handed out
+        // dynamically to the workers, the calling thread processes chunks as well instead of just waiting.
+        // If 'grainSize' is 0 the chunk size is picked from the range size and the thread count
         template <typename T, typename F>
-        void ParallelizeLoop(T firstIndex, T lastIndex, const F& loop, Uint numTasks = 0)
+        void ParallelFor(T first, T last, const F& func, T grainSize = 0)
         {
-            if (numTasks == 0)
-                numTasks = mThreadCount;
+            static_assert(std::is_integral_v<T>, "ParallelFor only works on integral ranges!");
+            if (last <= first)
+                return;
 
-            if (lastIndex < firstIndex)
-                std::swap(lastIndex, firstIndex);
+            const size_t count = static_cast<size_t>(last - first);
+            const size_t chunkSize = GetChunkSize(count, static_cast<size_t>(grainSize));
+            const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+            ForEachChunk(chunkCount, [&](size_t chunk) {
+                const T begin = first + static_cast<T>(chunk * chunkSize);
+                const T end = first + static_cast<T>(std::min(count, (chunk + 1) * chunkSize));
+                for (T i = begin; i < end; i++)
+                    func(i);
+            });
+        }
 
-            size_t totalSize = lastIndex - firstIndex + 1;
-            size_t blockSize = totalSize / numTasks;
-            if (blockSize == 0)
-            {
-                blockSize = 1;
-                numTasks = std::max((Uint)1, (Uint)totalSize);
-            }
+        // Computes reduce(...reduce(reduce(identity, map(first)), map(first + 1))..., map(last - 1)) in parallel.
+        // Every chunk is reduced on its own and the partial results are combined in chunk order on the calling thread,
+        // so for a given grain size the result is the same on every run, even for non-associative operations like float addition
+        template <typename T, typename R, typename MapFn, typename ReduceFn>
+        R ParallelReduce(T first, T last, const R& identity, const MapFn& map, const ReduceFn& reduce, T grainSize = 0)
+        {
+            static_assert(std::is_integral_v<T>, "ParallelReduce only works on integral ranges!");
+            if (last <= first)
+                return identity;
 
-            std::atomic<Uint> blocksRunning = 0;
-            for (Uint t = 0; t < numTasks; t++)
-            {
-                T start = (T)(t * blockSize + firstIndex);
-                T end = (t == numTasks - 1) ? lastIndex : (T)((t + 1) * blockSize + firstIndex - 1);
-                blocksRunning++;
-                PushTask([&start, &end, &loop, &blocksRunning] {
-                    for (T i = start; i <= end; i++)
-                        loop(i);
-                    blocksRunning--;
-                });
-                while (blocksRunning != 0)
-                {
-                    std::this_thread::yield();
-                }
-            }
+            const size_t count = static_cast<size_t>(last - first);
+            const size_t chunkSize = GetChunkSize(count, static_cast<size_t>(grainSize));
+            const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+            Vector<R> partials(chunkCount, identity);
+            ForEachChunk(chunkCount, [&](size_t chunk) {
+                const T begin = first + static_cast<T>(chunk * chunkSize);
+                const T end = first + static_cast<T>(std::min(count, (chunk + 1) * chunkSize));
+                R result = identity;
+                for (T i = begin; i < end; i++)
+                    result = reduce(result, map(i));
+                partials[chunk] = result;
+            });
+
+            R result = identity;
+            for (const R& partial : partials)
+                result = reduce(result, partial);
+            return result;
         }
 
+        // Creates a Job without scheduling it, so that dependencies can be added before calling Schedule
         template <typename F>
-        void PushTask(const F& task)
+        JobHandle CreateJob(F&& task)
         {
-            mTasksWaiting++;
-            {
-                const std::scoped_lock lock(mQueueMutex);
-                mTasks.push(std::function<void()>(task));
-            }
+            Job* job = AllocateJob();
+            job->Bind(std::forward<F>(task));
+            return JobHandle(job);
+        }
+
+        // 'job' will not start before 'dependency' has finished. Must be called before 'job' is scheduled
+        void AddDependency(const JobHandle& job, const JobHandle& dependency);
+        void Schedule(const JobHandle& job);
+
+        // Creates and schedules a Job in one go
+        template <typename F>
+        JobHandle Run(F&& task)
+        {
+            JobHandle handle = CreateJob(std::forward<F>(task));
+            Schedule(handle);
+            return handle;
+        }
+
+        // Executes other jobs on the calling thread until 'job' has finished
+        void Wait(const JobHandle& job);
+
+        template <typename F>
+        void PushTask(F&& task)
+        {
+            Schedule(CreateJob(std::forward<F>(task)));
         }
 
         template <typename F, typename... A>
@@ -93,21 +153,104 @@ namespace Surge
             return future;
         }
 
+        // Executes jobs on the calling thread until every scheduled job has finished
         void WaitForTasks();
         void Reset(Uint threadCount = std::thread::hardware_concurrency());
 
+        // Runs 100 ms worth of busy jobs, from 1 us to 1 ms long, on a new ThreadPool and on a mutex queue pool with 'threadCount' workers each
+        static Vector<JobBenchmarkResult> RunBenchmark(Uint threadCount);
+
+        // Composes 'elementCount' transforms with ParallelFor 'iterations' times, on 1, 2, 4... threads up to the hardware thread count
+        static Vector<ParallelForBenchmarkResult> RunParallelForBenchmark(Uint elementCount, Uint iterations);
+
     private:
+        using JobQueue = WorkStealingQueue<Job*>;
+
+        size_t GetChunkSize(size_t count, size_t grainSize) const
+        {
+            if (grainSize != 0)
+                return grainSize;
+
+            // A few chunks per thread, so that threads finishing early can pick up the slack
+            const size_t targetChunkCount = static_cast<size_t>(mThreadCount + 1) * 4;
+            return std::max<size_t>(count / targetChunkCount, 1);
+        }
+
+        // Calls 'chunkFunc(chunkIndex)' for every chunk in [0, chunkCount), chunks are claimed through an atomic counter
+        // by up to mThreadCount helper jobs and by the calling thread
+        template <typename F>
+        void ForEachChunk(size_t chunkCount, const F& chunkFunc)
+        {
+            if (chunkCount == 1)
+            {
+                chunkFunc(0);
+                return;
+            }
+
+            struct ChunkContext
+            {
+                ChunkContext(const F& func, size_t chunkCount, Uint helperCount)
+                    : Func(func), ChunkCount(chunkCount), PendingHelpers(helperCount) {}
+
+                void Drain()
+                {
+                    for (size_t chunk = NextChunk.fetch_add(1, std::memory_order_relaxed); chunk < ChunkCount; chunk = NextChunk.fetch_add(1, std::memory_order_relaxed))
+                        Func(chunk);
+                }
+
+                const F& Func;
+                const size_t ChunkCount;
+                std::atomic<size_t> NextChunk = 0;
+                std::atomic<Uint> PendingHelpers;
+            };
+
+            const Uint helperCount = static_cast<Uint>(std::min<size_t>(mThreadCount, chunkCount - 1));
+            ChunkContext context(chunkFunc, chunkCount, helperCount);
+            for (Uint i = 0; i < helperCount; i++)
+            {
+                PushTask([ctx = &context] {
+                    ctx->Drain();
+                    ctx->PendingHelpers.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            context.Drain();
+
+            // The helpers reference 'context', which lives on this stack frame
+            while (context.PendingHelpers.load(std::memory_order_acquire) != 0)
+            {
+                if (!RunPendingJob())
+                    std::this_thread::yield();
+            }
+        }
+
         void CreateThreads();
         void DestroyThreads();
 
-        bool PopTask(std::function<void()>& task);
-        void Worker();
+        static Job* AllocateJob();
+        static void ReleaseJob(Job* job);
+        void Enqueue(Job* job);
+        void ResolveDependency(Job* job);
+        void Execute(Job* job);
+        Job* FindJob();
+        bool RunPendingJob();
+        void Worker(Uint index);
 
-        std::atomic<bool> mRunning = true;
-        std::atomic<Uint> mTasksWaiting = 0;
-        mutable std::mutex mQueueMutex;
-        std::queue<std::function<void()>> mTasks;
         Uint mThreadCount;
         Scope<std::thread[]> mThreads;
+        Scope<Scope<JobQueue>[]> mQueues; // [0] belongs to the owner thread, [1..mThreadCount] to the workers
+
+        std::mutex mInjectionMutex;
+        Deque<Job*> mInjectionQueue; // Jobs pushed from threads that don't own a deque
+
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+        std::atomic<Uint> mSleepingThreads = 0;
+
+        std::atomic<bool> mRunning = true;
+        std::atomic<Uint> mQueuedJobs = 0;   // Jobs sitting in any queue
+        std::atomic<Uint> mTasksWaiting = 0; // Jobs scheduled but not yet finished
+
+        friend class JobHandle;
     };
-} // namespace Surge
\ No newline at end of file
+} // namespace Surge
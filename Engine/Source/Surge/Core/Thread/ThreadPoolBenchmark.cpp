@@ -0,0 +1,179 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "ThreadPool.hpp"
+#include <functional>
+#include <queue>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+// Amount of busy work in every batch of the job benchmark, the job count is picked from the job duration
+#define JOB_BENCHMARK_BATCH_MICROSECONDS 100000
+
+namespace Surge
+{
+    namespace
+    {
+        // What the ThreadPool used to be: one std::queue of std::function behind a mutex, idle workers spin on yield().
+        // Only kept as the baseline of the benchmark
+        class MutexQueuePool
+        {
+        public:
+            MutexQueuePool(Uint threadCount)
+                : mThreadCount(threadCount), mThreads(new std::thread[threadCount])
+            {
+                for (Uint i = 0; i < mThreadCount; i++)
+                    mThreads[i] = std::thread(&MutexQueuePool::Worker, this);
+            }
+
+            ~MutexQueuePool()
+            {
+                WaitForTasks();
+                mRunning = false;
+                for (Uint i = 0; i < mThreadCount; i++)
+                    mThreads[i].join();
+            }
+
+            template <typename F>
+            void PushTask(const F& task)
+            {
+                mTasksWaiting++;
+                const std::scoped_lock<std::mutex> lock(mQueueMutex);
+                mTasks.push(std::function<void()>(task));
+            }
+
+            void WaitForTasks()
+            {
+                while (mTasksWaiting != 0)
+                    std::this_thread::yield();
+            }
+
+        private:
+            bool PopTask(std::function<void()>& task)
+            {
+                const std::scoped_lock<std::mutex> lock(mQueueMutex);
+                if (mTasks.empty())
+                    return false;
+
+                task = std::move(mTasks.front());
+                mTasks.pop();
+                return true;
+            }
+
+            void Worker()
+            {
+                while (mRunning)
+                {
+                    std::function<void()> task;
+                    if (PopTask(task))
+                    {
+                        task();
+                        mTasksWaiting--;
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            }
+
+        private:
+            std::atomic<bool> mRunning = true;
+            std::atomic<Uint> mTasksWaiting = 0;
+            std::mutex mQueueMutex;
+            std::queue<std::function<void()>> mTasks;
+            Uint mThreadCount;
+            Scope<std::thread[]> mThreads;
+        };
+
+        // Busy work instead of sleeping, a sleeping job would hide the scheduling overhead
+        void Spin(float microseconds)
+        {
+            const auto end = std::chrono::high_resolution_clock::now() + std::chrono::duration<float, std::micro>(microseconds);
+            while (std::chrono::high_resolution_clock::now() < end)
+                ;
+        }
+
+        // Same math as TransformComponent::GetTransform, with values made up from the index
+        glm::mat4 ComposeTransform(Uint index)
+        {
+            const float value = static_cast<float>(index % 1024);
+            const glm::vec3 position = {value, value * 0.5f, -value};
+            const glm::vec3 rotation = {value * 0.1f, value * 0.2f, value * 0.3f};
+            const glm::vec3 scale = glm::vec3(1.0f + value * 0.001f);
+            return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(glm::quat(glm::radians(rotation))) * glm::scale(glm::mat4(1.0f), scale);
+        }
+
+        template <typename Pool>
+        float RunJobs(Pool& pool, Uint jobCount, float jobMicroseconds)
+        {
+            Timer timer;
+            for (Uint i = 0; i < jobCount; i++)
+                pool.PushTask([jobMicroseconds]() { Spin(jobMicroseconds); });
+            pool.WaitForTasks();
+            return timer.ElapsedMillis();
+        }
+    } // namespace
+
+    Vector<JobBenchmarkResult> ThreadPool::RunBenchmark(Uint threadCount)
+    {
+        SURGE_PROFILE_FUNC("ThreadPool::RunBenchmark");
+
+        // Both pools get the same number of worker threads, the thread that schedules the jobs only helps the ThreadPool.
+        // They never exist at the same time, the spinning workers of the mutex queue would slow the other one down.
+        // Runs on its own thread: the thread creating a ThreadPool owns its first deque, the calling thread keeps the one of Core's pool
+        Vector<JobBenchmarkResult> results;
+        std::thread benchmarkThread([&results, threadCount]() {
+            for (float jobMicroseconds : {1.0f, 10.0f, 100.0f, 1000.0f})
+            {
+                JobBenchmarkResult& result = results.emplace_back();
+                result.JobMicroseconds = jobMicroseconds;
+                result.JobCount = static_cast<Uint>(JOB_BENCHMARK_BATCH_MICROSECONDS / jobMicroseconds);
+                {
+                    ThreadPool threadPool(threadCount);
+                    result.ThreadPoolMillis = RunJobs(threadPool, result.JobCount, jobMicroseconds);
+                }
+                {
+                    MutexQueuePool mutexQueuePool(threadCount);
+                    result.MutexQueueMillis = RunJobs(mutexQueuePool, result.JobCount, jobMicroseconds);
+                }
+
+                Log<Severity::Info>("{0} jobs of {1} us on {2} threads: ThreadPool {3} ms, mutex queue {4} ms", result.JobCount, jobMicroseconds, threadCount, result.ThreadPoolMillis, result.MutexQueueMillis);
+            }
+        });
+        benchmarkThread.join();
+        return results;
+    }
+
+    Vector<ParallelForBenchmarkResult> ThreadPool::RunParallelForBenchmark(Uint elementCount, Uint iterations)
+    {
+        SURGE_PROFILE_FUNC("ThreadPool::RunParallelForBenchmark");
+
+        // 1, 2, 4... threads in total (the calling thread included), up to every hardware thread
+        const Uint maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+        Vector<Uint> threadCounts;
+        for (Uint threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+            threadCounts.push_back(threadCount);
+        threadCounts.push_back(maxThreadCount);
+
+        // On its own thread for the same reason as RunBenchmark
+        Vector<ParallelForBenchmarkResult> results;
+        std::thread benchmarkThread([&results, &threadCounts, elementCount, iterations]() {
+            Vector<glm::mat4> transforms(elementCount);
+            for (Uint threadCount : threadCounts)
+            {
+                ThreadPool threadPool(threadCount - 1);
+                Timer timer;
+                for (Uint i = 0; i < iterations; i++)
+                    threadPool.ParallelFor<Uint>(0, elementCount, [&](Uint element) { transforms[element] = ComposeTransform(element + i); });
+
+                ParallelForBenchmarkResult& result = results.emplace_back();
+                result.ThreadCount = threadCount;
+                result.Millis = timer.ElapsedMillis() / std::max(iterations, 1u);
+                result.Speedup = result.Millis > 0.0f ? results.front().Millis / result.Millis : 0.0f;
+
+                Log<Severity::Info>("ParallelFor over {0} transforms on {1} threads: {2} ms ({3}x)", elementCount, threadCount, result.Millis, result.Speedup);
+            }
+        });
+        benchmarkThread.join();
+        return results;
+    }
+
+} // namespace Surge
@@ -0,0 +1,91 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Defines.hpp"
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace Surge
+{
+    // Fixed capacity, lock-free Chase-Lev deque.
+    // The owning thread pushes and pops from the bottom (LIFO, cache friendly), other threads steal from the top (FIFO).
+    // Based on: "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli - 2013)
+    template <typename T, size_t Capacity = 4096>
+    class WorkStealingQueue
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "WorkStealingQueue capacity must be a power of two!");
+        static_assert(std::is_pointer_v<T>, "WorkStealingQueue only stores pointers!");
+
+    public:
+        WorkStealingQueue() = default;
+        ~WorkStealingQueue() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(WorkStealingQueue);
+
+        // Owner thread only. Returns false if the queue is full
+        bool Push(T item)
+        {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            const int64_t top = mTop.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<int64_t>(Capacity))
+                return false;
+
+            mBuffer[bottom & MASK].store(item, std::memory_order_relaxed);
+            mBottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner thread only. Returns nullptr if the queue is empty
+        T Pop()
+        {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+
+            T result = nullptr;
+            if (top <= bottom)
+            {
+                result = mBuffer[bottom & MASK].load(std::memory_order_relaxed);
+                if (top == bottom)
+                {
+                    // Last item, race against the thieves
+                    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        result = nullptr;
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return result;
+        }
+
+        // Any thread. Returns nullptr if the queue is empty or if another thread won the race
+        T Steal()
+        {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+            if (top < bottom)
+            {
+                T result = mBuffer[top & MASK].load(std::memory_order_relaxed);
+                if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+                return result;
+            }
+            return nullptr;
+        }
+
+        bool Empty() const { return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr int64_t MASK = static_cast<int64_t>(Capacity) - 1;
+
+        // Top and Bottom are on separate cache lines, thieves hammer Top while the owner works on Bottom
+        alignas(64) std::atomic<int64_t> mTop = 0;
+        alignas(64) std::atomic<int64_t> mBottom = 0;
+        alignas(64) std::atomic<T> mBuffer[Capacity] = {};
+    };
+
+} // namespace Surge
@@ -7,51 +7,38 @@
 // clang-format off
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::IDComponent)
-    .AddVariable<&Surge::IDComponent::ID>("ID")
+    .AddFields<Surge::IDComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::IDComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::ParentChildComponent)
-    .AddVariable<&Surge::ParentChildComponent::ParentID>("ParentID")
-    .AddVariable<&Surge::ParentChildComponent::ChildIDs>("ChildrenIDs")
+    .AddFields<Surge::ParentChildComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::ParentChildComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::NameComponent)
-    .AddVariable<&Surge::NameComponent::Name>("Name")
+    .AddFields<Surge::NameComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::NameComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::TransformComponent)
-    .AddVariable<&Surge::TransformComponent::Position>("Position")
-    .AddVariable<&Surge::TransformComponent::Rotation>("Rotation")
-    .AddVariable<&Surge::TransformComponent::Scale>("Scale")
+    .AddFields<Surge::TransformComponent>()
     .AddFunction<&Surge::TransformComponent::GetTransform>("GetTransform")
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::TransformComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::MeshComponent)
-    .AddVariable<&Surge::MeshComponent::Mesh>("Mesh")
+    .AddFields<Surge::MeshComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::MeshComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::CameraComponent)
-    .AddVariable<&Surge::CameraComponent::Camera>("Camera")
-    .AddVariable<&Surge::CameraComponent::Primary>("Primary")
-    .AddVariable<&Surge::CameraComponent::FixedAspectRatio>("FixedAspectRatio")
+    .AddFields<Surge::CameraComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::CameraComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::PointLightComponent)
-    .AddVariable<&Surge::PointLightComponent::Color>("Color")
-    .AddVariable<&Surge::PointLightComponent::Intensity>("Intensity")
-    .AddVariable<&Surge::PointLightComponent::Radius>("Radius")
-    .AddVariable<&Surge::PointLightComponent::Falloff>("Falloff")
+    .AddFields<Surge::PointLightComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::PointLightComponent)
 
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::DirectionalLightComponent)
-    .AddVariable<&Surge::DirectionalLightComponent::Direction>("Direction")
-    .AddVariable<&Surge::DirectionalLightComponent::Color>("Color")
-    .AddVariable<&Surge::DirectionalLightComponent::Intensity>("Intensity")
-    .AddVariable<&Surge::DirectionalLightComponent::Size>("Size")
+    .AddFields<Surge::DirectionalLightComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::DirectionalLightComponent)
 
-
 SURGE_REFLECT_CLASS_REGISTER_BEGIN(Surge::ScriptComponent)
-    .AddVariable<&Surge::ScriptComponent::ScriptPath>("ScriptPath")
-    .AddVariable<&Surge::ScriptComponent::ScriptEngineID>("ScriptEngineID")
+    .AddFields<Surge::ScriptComponent>()
 SURGE_REFLECT_CLASS_REGISTER_END(Surge::ScriptComponent)
@@ -66,6 +66,26 @@ namespace Surge
         SURGE_REFLECTION_ENABLE;
     };
 
+    // World space transform cache, kept up to date once per frame by the Scene (parents before children).
+    // Derived data, never serialized
+    struct SURGE_API WorldTransformComponent
+    {
+        WorldTransformComponent() = default;
+
+        glm::mat4 Transform = glm::mat4(1.0f);
+
+        // The local transform 'Transform' was built from, used to detect changes made to the TransformComponent
+        glm::vec3 LocalPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 LocalRotation = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 LocalScale = glm::vec3(1.0f, 1.0f, 1.0f);
+        bool Dirty = true;
+
+        bool IsOutdated(const TransformComponent& transform) const
+        {
+            return Dirty || transform.Position != LocalPosition || transform.Rotation != LocalRotation || transform.Scale != LocalScale;
+        }
+    };
+
     struct SURGE_API MeshComponent
     {
         MeshComponent() = default;
@@ -74,6 +94,27 @@ namespace Surge
 
         Ref<Surge::Mesh> Mesh;
 
+        // The materials belong to the Mesh, which is shared by every entity using the same file. An entity gets its own copy of a
+        // material the first time it is edited (copy-on-write), a null entry uses the material of the Mesh. Not serialized
+        Vector<Ref<Material>> Materials;
+
+        const Ref<Material>& GetMaterial(Uint index) const
+        {
+            if (index < Materials.size() && Materials[index])
+                return Materials[index];
+            return Mesh->GetMaterials()[index];
+        }
+
+        // Returns the material of this entity only, cloning the one of the Mesh if it is still shared
+        const Ref<Material>& GetUniqueMaterial(Uint index)
+        {
+            if (Materials.size() != Mesh->GetMaterials().size())
+                Materials.resize(Mesh->GetMaterials().size());
+            if (!Materials[index])
+                Materials[index] = Mesh->GetMaterials()[index]->Clone();
+            return Materials[index];
+        }
+
         SURGE_REFLECTION_ENABLE;
     };
 
@@ -134,4 +175,15 @@ namespace Surge
                              ::Surge::MeshComponent, ::Surge::CameraComponent, ::Surge::PointLightComponent, \
                              ::Surge::DirectionalLightComponent, ::Surge::ParentChildComponent, ::Surge::ScriptComponent
 
-} // namespace Surge
\ No newline at end of file
+} // namespace Surge
+
+// Field lists, in serialization order. The names are the keys used in the scene files
+SURGE_REFLECT_FIELDS(Surge::IDComponent, SURGE_REFLECT_FIELD(ID))
+SURGE_REFLECT_FIELDS(Surge::ParentChildComponent, SURGE_REFLECT_FIELD(ParentID), SURGE_REFLECT_NAMED_FIELD(ChildIDs, "ChildrenIDs"))
+SURGE_REFLECT_FIELDS(Surge::NameComponent, SURGE_REFLECT_FIELD(Name))
+SURGE_REFLECT_FIELDS(Surge::TransformComponent, SURGE_REFLECT_FIELD(Position), SURGE_REFLECT_FIELD(Rotation), SURGE_REFLECT_FIELD(Scale))
+SURGE_REFLECT_FIELDS(Surge::MeshComponent, SURGE_REFLECT_FIELD(Mesh))
+SURGE_REFLECT_FIELDS(Surge::CameraComponent, SURGE_REFLECT_FIELD(Camera), SURGE_REFLECT_FIELD(Primary), SURGE_REFLECT_FIELD(FixedAspectRatio))
+SURGE_REFLECT_FIELDS(Surge::PointLightComponent, SURGE_REFLECT_FIELD(Color), SURGE_REFLECT_FIELD(Intensity), SURGE_REFLECT_FIELD(Radius), SURGE_REFLECT_FIELD(Falloff))
+SURGE_REFLECT_FIELDS(Surge::DirectionalLightComponent, SURGE_REFLECT_FIELD(Direction), SURGE_REFLECT_FIELD(Color), SURGE_REFLECT_FIELD(Intensity), SURGE_REFLECT_FIELD(Size))
+SURGE_REFLECT_FIELDS(Surge::ScriptComponent, SURGE_REFLECT_FIELD(ScriptPath)) // ScriptEngineID is assigned by the ScriptEngine at load time
\ No newline at end of file
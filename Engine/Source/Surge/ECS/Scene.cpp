@@ -13,6 +13,11 @@ namespace Surge
         mMetadata.SceneUUID = UUID();
         mMetadata.ScenePath = path;
         mRegistry.on_destroy<ScriptComponent>().connect<&Scene::OnScriptComponentDestroy>(this);
+        mRegistry.on_construct<IDComponent>().connect<&Scene::OnIDComponentConstruct>(this);
+        mRegistry.on_destroy<IDComponent>().connect<&Scene::OnIDComponentDestroy>(this);
+        mRegistry.on_construct<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_update<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_destroy<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
     }
 
     Scene::Scene(Project* parentProject, const SceneMetadata& sceneMetadata, bool runtime)
@@ -21,11 +26,21 @@ namespace Surge
         mParentProject = parentProject;
         mMetadata = sceneMetadata;
         mRegistry.on_destroy<ScriptComponent>().connect<&Scene::OnScriptComponentDestroy>(this);
+        mRegistry.on_construct<IDComponent>().connect<&Scene::OnIDComponentConstruct>(this);
+        mRegistry.on_destroy<IDComponent>().connect<&Scene::OnIDComponentDestroy>(this);
+        mRegistry.on_construct<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_update<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_destroy<ParentChildComponent>().connect<&Scene::OnHierarchyChanged>(this);
     }
 
     Scene::~Scene()
     {
         mRegistry.on_destroy<ScriptComponent>().disconnect<&Scene::OnScriptComponentDestroy>(this);
+        mRegistry.on_construct<IDComponent>().disconnect<&Scene::OnIDComponentConstruct>(this);
+        mRegistry.on_destroy<IDComponent>().disconnect<&Scene::OnIDComponentDestroy>(this);
+        mRegistry.on_construct<ParentChildComponent>().disconnect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_update<ParentChildComponent>().disconnect<&Scene::OnHierarchyChanged>(this);
+        mRegistry.on_destroy<ParentChildComponent>().disconnect<&Scene::OnHierarchyChanged>(this);
         mRegistry.clear();
     }
 
@@ -42,29 +57,25 @@ namespace Surge
     void Scene::Update(EditorCamera& camera)
     {
         camera.OnUpdate();
+        UpdateWorldTransforms();
+
         Renderer* renderer = Core::GetRenderer();
         renderer->BeginFrame(camera);
         {
-            auto group = mRegistry.group<MeshComponent>(entt::get<TransformComponent>);
+            auto group = mRegistry.group<MeshComponent>(entt::get<WorldTransformComponent>);
             for (auto& entity : group)
             {
-                auto [mesh, transformComponent] = group.get<MeshComponent, TransformComponent>(entity);
+                auto [mesh, worldTransform] = group.get<MeshComponent, WorldTransformComponent>(entity);
                 if (mesh.Mesh)
-                {
-                    glm::mat4 transform = GetWorldSpaceTransformMatrix(Entity(entity, this));
-                    renderer->SubmitMesh(mesh, transform);
-                }
+                    renderer->SubmitMesh(mesh, worldTransform.Transform);
             }
         }
         {
-            auto view = mRegistry.view<PointLightComponent>();
+            auto view = mRegistry.view<PointLightComponent, WorldTransformComponent>();
             for (auto& entity : view)
             {
-                auto light = view.get<PointLightComponent>(entity);
-                glm::mat4 transformMatrix = GetWorldSpaceTransformMatrix(Entity(entity, this));
-                glm::vec3 position, rotation, scale;
-                Math::DecomposeTransform(transformMatrix, position, rotation, scale);
-                renderer->SubmitPointLight(light, position);
+                const auto& [light, worldTransform] = view.get<PointLightComponent, WorldTransformComponent>(entity);
+                renderer->SubmitPointLight(light, glm::vec3(worldTransform.Transform[3]));
             }
         }
         {
@@ -80,6 +91,7 @@ namespace Surge
 
     void Scene::Update()
     {
+        UpdateWorldTransforms();
         Pair<RuntimeCamera*, glm::mat4> camera = GetMainCameraEntity();
 
         if (camera.Data1)
@@ -87,26 +99,20 @@ namespace Surge
             Renderer* renderer = Core::GetRenderer();
             renderer->BeginFrame(*camera.Data1, camera.Data2);
             {
-                auto group = mRegistry.group<MeshComponent>(entt::get<TransformComponent>);
+                auto group = mRegistry.group<MeshComponent>(entt::get<WorldTransformComponent>);
                 for (auto& entity : group)
                 {
-                    auto [mesh, transformComponent] = group.get<MeshComponent, TransformComponent>(entity);
+                    auto [mesh, worldTransform] = group.get<MeshComponent, WorldTransformComponent>(entity);
                     if (mesh.Mesh)
-                    {
-                        glm::mat4 transform = GetWorldSpaceTransformMatrix(Entity(entity, this));
-                        renderer->SubmitMesh(mesh, transform);
-                    }
+                        renderer->SubmitMesh(mesh, worldTransform.Transform);
                 }
             }
             {
-                auto view = mRegistry.view<PointLightComponent>();
+                auto view = mRegistry.view<PointLightComponent, WorldTransformComponent>();
                 for (auto& entity : view)
                 {
-                    auto light = view.get<PointLightComponent>(entity);
-                    glm::mat4 transformMatrix = GetWorldSpaceTransformMatrix(Entity(entity, this));
-                    glm::vec3 position, rotation, scale;
-                    Math::DecomposeTransform(transformMatrix, position, rotation, scale);
-                    renderer->SubmitPointLight(light, position);
+                    const auto& [light, worldTransform] = view.get<PointLightComponent, WorldTransformComponent>(entity);
+                    renderer->SubmitPointLight(light, glm::vec3(worldTransform.Transform[3]));
                 }
             }
             renderer->EndFrame();
@@ -151,13 +157,9 @@ namespace Surge
 
     Surge::Entity Scene::FindEntityByUUID(UUID id)
     {
-        auto view = mRegistry.view<IDComponent>();
-        for (const auto& entity : view)
-        {
-            auto& idComponent = mRegistry.get<IDComponent>(entity);
-            if (idComponent.ID == id)
-                return Entity(entity, this);
-        }
+        auto it = mEntityMap.find(id);
+        if (it != mEntityMap.end())
+            return Entity(it->second, this);
 
         return Entity {};
     }
@@ -170,6 +172,7 @@ namespace Surge
         outEntity.AddComponent<NameComponent>(name);
         outEntity.AddComponent<TransformComponent>();
         outEntity.AddComponent<ParentChildComponent>();
+        outEntity.AddComponent<WorldTransformComponent>();
     }
 
     void Scene::CreateEntityWithID(Entity& outEntity, const UUID& id, const String& name)
@@ -180,6 +183,7 @@ namespace Surge
         outEntity.AddComponent<NameComponent>(name);
         outEntity.AddComponent<TransformComponent>();
         outEntity.AddComponent<ParentChildComponent>();
+        outEntity.AddComponent<WorldTransformComponent>();
     }
 
     void Scene::ParentEntity(Entity& entity, Entity& parent)
@@ -210,6 +214,7 @@ namespace Surge
         parentChildComponent.ParentID = parent.GetUUID();
         parent.GetComponent<ParentChildComponent>().ChildIDs.push_back(entity.GetUUID());
         ConvertToLocalSpace(entity);
+        mHierarchyDirty = true;
     }
 
     glm::mat4 Scene::GetWorldSpaceTransformMatrix(Entity entity)
@@ -223,6 +228,93 @@ namespace Surge
         return transform * entity.GetComponent<TransformComponent>().GetTransform();
     }
 
+    void Scene::RebuildTransformHierarchy()
+    {
+        SURGE_PROFILE_FUNC("Scene::RebuildTransformHierarchy");
+        mTransformNodes.clear();
+        mSubtreeOffsets.clear();
+
+        auto view = mRegistry.view<ParentChildComponent, TransformComponent, WorldTransformComponent>();
+        auto isTransformNode = [&](UUID id, entt::entity& outEntity) {
+            auto it = mEntityMap.find(id);
+            if (it == mEntityMap.end() || !view.contains(it->second))
+                return false;
+
+            outEntity = it->second;
+            return true;
+        };
+
+        Vector<TransformNode> stack;
+        for (entt::entity entity : view)
+        {
+            entt::entity parent;
+            const UUID parentID = view.get<ParentChildComponent>(entity).ParentID;
+            if (parentID != NULL_UUID && isTransformNode(parentID, parent))
+                continue; // Not a root, gets visited through its parent
+
+            mSubtreeOffsets.push_back(static_cast<Uint>(mTransformNodes.size()));
+            stack.push_back({entity, -1});
+            while (!stack.empty())
+            {
+                const TransformNode node = stack.back();
+                stack.pop_back();
+
+                const int32_t nodeIndex = static_cast<int32_t>(mTransformNodes.size());
+                mTransformNodes.push_back(node);
+                view.get<WorldTransformComponent>(node.Entity).Dirty = true;
+
+                for (UUID childID : view.get<ParentChildComponent>(node.Entity).ChildIDs)
+                {
+                    entt::entity child;
+                    if (isTransformNode(childID, child))
+                        stack.push_back({child, nodeIndex});
+                }
+            }
+        }
+        mSubtreeOffsets.push_back(static_cast<Uint>(mTransformNodes.size()));
+        mTransformUpdated.resize(mTransformNodes.size());
+        mHierarchyDirty = false;
+    }
+
+    void Scene::UpdateWorldTransforms()
+    {
+        SURGE_PROFILE_FUNC("Scene::UpdateWorldTransforms");
+        if (mHierarchyDirty)
+            RebuildTransformHierarchy();
+
+        // Fetch the storages up front, the registry itself must not be touched from multiple threads
+        auto& transforms = mRegistry.storage<TransformComponent>();
+        auto& worldTransforms = mRegistry.storage<WorldTransformComponent>();
+
+        // Subtrees are independent of each other, so they are updated in parallel
+        const Uint subtreeCount = static_cast<Uint>(mSubtreeOffsets.size()) - 1;
+        Core::GetThreadPool()->ParallelFor<Uint>(0, subtreeCount, [&](Uint subtree) {
+            for (Uint i = mSubtreeOffsets[subtree]; i < mSubtreeOffsets[subtree + 1]; i++)
+            {
+                const TransformNode& node = mTransformNodes[i];
+                TransformComponent& transform = transforms.get(node.Entity);
+                WorldTransformComponent& worldTransform = worldTransforms.get(node.Entity);
+
+                const bool parentUpdated = node.ParentIndex != -1 && mTransformUpdated[node.ParentIndex];
+                if (!parentUpdated && !worldTransform.IsOutdated(transform))
+                {
+                    mTransformUpdated[i] = false;
+                    continue;
+                }
+
+                worldTransform.Transform = transform.GetTransform();
+                if (node.ParentIndex != -1)
+                    worldTransform.Transform = worldTransforms.get(mTransformNodes[node.ParentIndex].Entity).Transform * worldTransform.Transform;
+
+                worldTransform.LocalPosition = transform.Position;
+                worldTransform.LocalRotation = transform.Rotation;
+                worldTransform.LocalScale = transform.Scale;
+                worldTransform.Dirty = false;
+                mTransformUpdated[i] = true;
+            }
+        });
+    }
+
     void Scene::ConvertToLocalSpace(Entity entity)
     {
         Entity parent = FindEntityByUUID(entity.GetParent());
@@ -254,6 +346,7 @@ namespace Surge
 
         // Set the Parent to be NULL, because, hey we just unparented the entity
         child.GetComponent<ParentChildComponent>().ParentID = 0;
+        mHierarchyDirty = true;
     }
 
     void Scene::ConvertToWorldSpace(Entity entity)
@@ -321,6 +414,18 @@ namespace Surge
         return result;
     }
 
+    void Scene::OnIDComponentConstruct(entt::registry& registry, entt::entity entity)
+    {
+        mEntityMap[registry.get<IDComponent>(entity).ID] = entity;
+    }
+
+    void Scene::OnIDComponentDestroy(entt::registry& registry, entt::entity entity)
+    {
+        auto it = mEntityMap.find(registry.get<IDComponent>(entity).ID);
+        if (it != mEntityMap.end() && it->second == entity)
+            mEntityMap.erase(it);
+    }
+
     void Scene::OnScriptComponentDestroy(entt::registry& registry, entt::entity entity)
     {
         if (mRuntime)
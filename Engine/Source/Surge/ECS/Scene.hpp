@@ -57,12 +57,36 @@ namespace Surge
         void ConvertToLocalSpace(Entity entity);
         void ConvertToWorldSpace(Entity entity);
         void OnScriptComponentDestroy(entt::registry& registry, entt::entity entity);
+        void OnIDComponentConstruct(entt::registry& registry, entt::entity entity);
+        void OnIDComponentDestroy(entt::registry& registry, entt::entity entity);
+        void OnHierarchyChanged(entt::registry& registry, entt::entity entity) { mHierarchyDirty = true; }
+
+        // Updates the WorldTransformComponent of every entity whose transform (or any of its ancestors' transform) changed
+        void UpdateWorldTransforms();
+        void RebuildTransformHierarchy();
 
     private:
+        struct TransformNode
+        {
+            entt::entity Entity;
+            int32_t ParentIndex; // Index into mTransformNodes, -1 for root entities
+        };
+
         Project* mParentProject;
         SceneMetadata mMetadata;
         entt::registry mRegistry;
         bool mRuntime;
+
+        // UUID -> entity lookup, kept in sync with the IDComponent storage through the registry signals.
+        // The ID of an entity must not change after its IDComponent was added
+        HashMap<UUID, entt::entity> mEntityMap;
+
+        // Flattened scene hierarchy, every root is followed by its whole subtree in depth first order (parents before children)
+        // Rebuilt only when the hierarchy changes
+        Vector<TransformNode> mTransformNodes;
+        Vector<Uint> mSubtreeOffsets; // Start of every root's subtree in mTransformNodes, plus one past the end
+        Vector<Byte> mTransformUpdated; // Per node, whether its world transform was recomputed this frame
+        bool mHierarchyDirty = true;
     };
 
     //
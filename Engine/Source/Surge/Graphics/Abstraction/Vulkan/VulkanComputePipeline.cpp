@@ -50,6 +50,20 @@ namespace Surge
         vkCmdDispatch(vulkanCmdBuffer, groupCountX, groupCountY, groupCountZ);
     }
 
+    void VulkanComputePipeline::InsertDispatchBarrier(const Ref<RenderCommandBuffer>& renderCmdBuffer)
+    {
+        VulkanRenderContext* renderContext = nullptr;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        Uint frameIndex = renderContext->GetFrameIndex();
+        VkCommandBuffer vulkanCmdBuffer = renderCmdBuffer.As<VulkanRenderCommandBuffer>()->GetVulkanCommandBuffer(frameIndex);
+
+        const VkPipelineStageFlags stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+        VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier(vulkanCmdBuffer, stages, stages, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+
     void VulkanComputePipeline::Reload()
     {
         Release();
@@ -71,9 +85,8 @@ namespace Surge
         // (TODO: switch to bindless)
         { // "Mess Scope" read the comments inside this scope for detail
 
-            // Create an empty layout
-            VkDescriptorSetLayoutCreateInfo layoutInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-            VK_CALL(vkCreateDescriptorSetLayout(logicalDevice, &layoutInfo, nullptr, &mEmptyLayout));
+            // Get the empty layout, it is shared by all the pipelines
+            mEmptyLayout = renderContext->GetDescriptorCache()->GetLayout({});
             // We have to do this because:
             // The descriptor set layouts for a pipeline layout always start from set 0, so if a
             // shader only uses set 5, then you must create a pipeline layout with *5 descriptor sets*
@@ -107,7 +120,10 @@ namespace Surge
         computePipelineCreateInfo.layout = mPipelineLayout;
         computePipelineCreateInfo.flags = 0;
         computePipelineCreateInfo.stage = shaderStage;
-        VK_CALL(vkCreateComputePipelines(logicalDevice, nullptr, 1, &computePipelineCreateInfo, nullptr, &mPipeline));
+        VulkanPipelineCache* pipelineCache = renderContext->GetPipelineCache();
+        Timer timer;
+        VK_CALL(vkCreateComputePipelines(logicalDevice, pipelineCache->GetVulkanPipelineCache(), 1, &computePipelineCreateInfo, nullptr, &mPipeline));
+        pipelineCache->RecordPipelineCreation(timer.ElapsedMillis());
         SET_VK_OBJECT_DEBUGNAME(mPipeline, VK_OBJECT_TYPE_PIPELINE, "Compute Pipeline");
     }
 
@@ -124,7 +140,6 @@ namespace Surge
         mPipelineLayout = VK_NULL_HANDLE;
         vkDestroyPipeline(logicalDevice, mPipeline, nullptr);
         mPipeline = VK_NULL_HANDLE;
-        vkDestroyDescriptorSetLayout(logicalDevice, mEmptyLayout, nullptr);
         mEmptyLayout = VK_NULL_HANDLE;
     }
 
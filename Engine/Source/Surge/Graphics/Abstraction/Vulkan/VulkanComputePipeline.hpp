@@ -15,6 +15,7 @@ namespace Surge
         virtual void Bind(const Ref<RenderCommandBuffer>& renderCmdBuffer) override;
         virtual void SetPushConstantData(const Ref<RenderCommandBuffer>& cmdBuffer, const String& bufferName, void* data) const override;
         virtual void Dispatch(const Ref<RenderCommandBuffer>& renderCmdBuffer, Uint groupCountX, Uint groupCountY, Uint groupCountZ) override;
+        virtual void InsertDispatchBarrier(const Ref<RenderCommandBuffer>& renderCmdBuffer) override;
         virtual const Ref<Shader>& GetShader() const override { return mShader; }
 
         VkPipelineLayout GetPipelineLayout() const { return mPipelineLayout; }
@@ -0,0 +1,83 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanDescriptorAllocator.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderContext.hpp"
+
+namespace Surge
+{
+    void VulkanDescriptorAllocator::Initialize(VkDevice device, const Vector<VkDescriptorPoolSize>& poolSizes, Uint maxSets, VkDescriptorPoolCreateFlags flags, const String& debugName)
+    {
+        mDevice = device;
+        mPoolSizes = poolSizes;
+        mMaxSets = maxSets;
+        mFlags = flags | VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        mDebugName = debugName;
+
+        mPools.push_back(CreatePool());
+        mCurrentPool = 0;
+    }
+
+    void VulkanDescriptorAllocator::Destroy()
+    {
+        for (VkDescriptorPool pool : mPools)
+            vkDestroyDescriptorPool(mDevice, pool, nullptr);
+        mPools.clear();
+    }
+
+    VkDescriptorSet VulkanDescriptorAllocator::Allocate(VkDescriptorSetLayout layout, VkDescriptorPool& outPool)
+    {
+        VkDescriptorSetAllocateInfo allocInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+        mFrameAllocations++;
+
+        // Starts with the pool of the last allocation, then tries the others since sets may have been freed from them
+        const Uint poolCount = static_cast<Uint>(mPools.size());
+        for (Uint i = 0; i < poolCount; i++)
+        {
+            const Uint poolIndex = (mCurrentPool + i) % poolCount;
+            allocInfo.descriptorPool = mPools[poolIndex];
+
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            const VkResult result = vkAllocateDescriptorSets(mDevice, &allocInfo, &descriptorSet);
+            if (result == VK_SUCCESS)
+            {
+                mCurrentPool = poolIndex;
+                outPool = mPools[poolIndex];
+                return descriptorSet;
+            }
+
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+                VK_CALL(result);
+        }
+
+        // All the pools are full
+        mCurrentPool = poolCount;
+        mPools.push_back(CreatePool());
+        allocInfo.descriptorPool = mPools[mCurrentPool];
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VK_CALL(vkAllocateDescriptorSets(mDevice, &allocInfo, &descriptorSet));
+        outPool = mPools[mCurrentPool];
+        return descriptorSet;
+    }
+
+    void VulkanDescriptorAllocator::Free(VkDescriptorSet descriptorSet, VkDescriptorPool pool)
+    {
+        VK_CALL(vkFreeDescriptorSets(mDevice, pool, 1, &descriptorSet));
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::CreatePool()
+    {
+        VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        poolInfo.flags = mFlags;
+        poolInfo.maxSets = mMaxSets;
+        poolInfo.poolSizeCount = static_cast<Uint>(mPoolSizes.size());
+        poolInfo.pPoolSizes = mPoolSizes.data();
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VK_CALL(vkCreateDescriptorPool(mDevice, &poolInfo, nullptr, &pool));
+        SET_VK_OBJECT_DEBUGNAME(pool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, mDebugName.c_str());
+        return pool;
+    }
+
+} // namespace Surge
@@ -0,0 +1,45 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Defines.hpp"
+#include "Surge/Core/String.hpp"
+#include <volk.h>
+
+namespace Surge
+{
+    // Allocates descriptor sets from a list of pools, a new pool is created when all of them are full so it never runs out.
+    // The pools are created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, freed sets are reused by the next allocations.
+    // Main thread only
+    class SURGE_API VulkanDescriptorAllocator
+    {
+    public:
+        VulkanDescriptorAllocator() = default;
+        ~VulkanDescriptorAllocator() = default;
+
+        // Every pool is created with 'poolSizes' and 'maxSets'
+        void Initialize(VkDevice device, const Vector<VkDescriptorPoolSize>& poolSizes, Uint maxSets, VkDescriptorPoolCreateFlags flags, const String& debugName);
+        void Destroy(); // Destroys the pools with all the sets in them
+
+        // The set must be freed to 'outPool'
+        VkDescriptorSet Allocate(VkDescriptorSetLayout layout, VkDescriptorPool& outPool);
+        void Free(VkDescriptorSet descriptorSet, VkDescriptorPool pool);
+
+        Uint GetPoolCount() const { return static_cast<Uint>(mPools.size()); }
+        Uint GetFrameAllocations() const { return mFrameAllocations; }
+        void ResetFrameStats() { mFrameAllocations = 0; }
+
+    private:
+        VkDescriptorPool CreatePool();
+
+    private:
+        VkDevice mDevice = VK_NULL_HANDLE;
+        Vector<VkDescriptorPoolSize> mPoolSizes;
+        Uint mMaxSets = 0;
+        VkDescriptorPoolCreateFlags mFlags = 0;
+        String mDebugName;
+
+        Vector<VkDescriptorPool> mPools;
+        Uint mCurrentPool = 0; // Pool of the last allocation, it is tried first
+        Uint mFrameAllocations = 0;
+    };
+
+} // namespace Surge
@@ -0,0 +1,212 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanDescriptorCache.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderContext.hpp"
+#include "Surge/Core/Hash.hpp"
+#include <algorithm>
+
+namespace Surge
+{
+    static_assert(DESCRIPTOR_CACHE_UNUSED_FRAMES > FRAMES_IN_FLIGHT, "A cached set could be freed while a frame in flight uses it!");
+
+    namespace
+    {
+        // The structs have padding, so they are hashed and compared member by member
+        uint64_t HashValue(uint64_t hash, uint64_t value)
+        {
+            return Hash::Combine(hash, Hash::GenerateFromBytes(&value, sizeof(value)));
+        }
+
+        template <typename T>
+        uint64_t HashHandle(uint64_t hash, T handle)
+        {
+            return HashValue(hash, reinterpret_cast<uint64_t>(handle));
+        }
+    } // namespace
+
+    bool VulkanDescriptorWrite::operator==(const VulkanDescriptorWrite& other) const
+    {
+        return Binding == other.Binding && Type == other.Type && ImageInfo.sampler == other.ImageInfo.sampler &&
+               ImageInfo.imageView == other.ImageInfo.imageView && ImageInfo.imageLayout == other.ImageInfo.imageLayout &&
+               BufferInfo.buffer == other.BufferInfo.buffer && BufferInfo.offset == other.BufferInfo.offset && BufferInfo.range == other.BufferInfo.range;
+    }
+
+    bool VulkanDescriptorCache::LayoutKey::operator==(const LayoutKey& other) const
+    {
+        if (Flags != other.Flags || Bindings.size() != other.Bindings.size() || BindingFlags != other.BindingFlags)
+            return false;
+
+        for (size_t i = 0; i < Bindings.size(); i++)
+        {
+            const VkDescriptorSetLayoutBinding& a = Bindings[i];
+            const VkDescriptorSetLayoutBinding& b = other.Bindings[i];
+            if (a.binding != b.binding || a.descriptorType != b.descriptorType || a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags)
+                return false;
+        }
+        return true;
+    }
+
+    bool VulkanDescriptorCache::SetKey::operator==(const SetKey& other) const
+    {
+        return Layout == other.Layout && Writes == other.Writes;
+    }
+
+    size_t VulkanDescriptorCache::KeyHasher::operator()(const LayoutKey& key) const
+    {
+        uint64_t hash = HashValue(0, key.Flags);
+        for (size_t i = 0; i < key.Bindings.size(); i++)
+        {
+            const VkDescriptorSetLayoutBinding& binding = key.Bindings[i];
+            hash = HashValue(hash, binding.binding);
+            hash = HashValue(hash, binding.descriptorType);
+            hash = HashValue(hash, binding.descriptorCount);
+            hash = HashValue(hash, binding.stageFlags);
+            hash = HashValue(hash, key.BindingFlags[i]);
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    size_t VulkanDescriptorCache::KeyHasher::operator()(const SetKey& key) const
+    {
+        uint64_t hash = HashHandle(0, key.Layout);
+        for (const VulkanDescriptorWrite& write : key.Writes)
+        {
+            hash = HashValue(hash, write.Binding);
+            hash = HashValue(hash, write.Type);
+            hash = HashHandle(hash, write.ImageInfo.sampler);
+            hash = HashHandle(hash, write.ImageInfo.imageView);
+            hash = HashValue(hash, write.ImageInfo.imageLayout);
+            hash = HashHandle(hash, write.BufferInfo.buffer);
+            hash = HashValue(hash, write.BufferInfo.offset);
+            hash = HashValue(hash, write.BufferInfo.range);
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    void VulkanDescriptorCache::Initialize(VkDevice device, VulkanDescriptorAllocator* allocator)
+    {
+        mDevice = device;
+        mAllocator = allocator;
+    }
+
+    void VulkanDescriptorCache::Destroy()
+    {
+        // The sets are destroyed with the pools of the allocator
+        mSets.clear();
+        std::scoped_lock<std::mutex> lock(mLayoutMutex);
+        for (auto& [key, layout] : mLayouts)
+            vkDestroyDescriptorSetLayout(mDevice, layout, nullptr);
+        mLayouts.clear();
+    }
+
+    VkDescriptorSetLayout VulkanDescriptorCache::GetLayout(const Vector<VkDescriptorSetLayoutBinding>& bindings, const Vector<VkDescriptorBindingFlags>& bindingFlags, VkDescriptorSetLayoutCreateFlags flags)
+    {
+        SG_ASSERT(bindingFlags.empty() || bindingFlags.size() == bindings.size(), "Every binding must have its flags!");
+
+        // The order of the bindings doesn't change the layout, they are sorted so that it doesn't change the key either
+        Vector<Uint> order(bindings.size());
+        for (Uint i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](Uint a, Uint b) { return bindings[a].binding < bindings[b].binding; });
+
+        LayoutKey key;
+        key.Flags = flags;
+        key.Bindings.reserve(bindings.size());
+        key.BindingFlags.reserve(bindings.size());
+        for (Uint i : order)
+        {
+            key.Bindings.push_back(bindings[i]);
+            key.BindingFlags.push_back(bindingFlags.empty() ? 0 : bindingFlags[i]);
+        }
+
+        // Held while creating the layout as well, so that two threads asking for the same bindings don't both create one
+        std::scoped_lock<std::mutex> lock(mLayoutMutex);
+        auto itr = mLayouts.find(key);
+        if (itr != mLayouts.end())
+            return itr->second;
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+        bindingFlagsInfo.bindingCount = static_cast<Uint>(key.BindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = key.BindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = flags;
+        layoutInfo.bindingCount = static_cast<Uint>(key.Bindings.size());
+        layoutInfo.pBindings = key.Bindings.data();
+
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        VK_CALL(vkCreateDescriptorSetLayout(mDevice, &layoutInfo, nullptr, &layout));
+        mLayouts[std::move(key)] = layout;
+        return layout;
+    }
+
+    VkDescriptorSet VulkanDescriptorCache::GetDescriptorSet(VkDescriptorSetLayout layout, const Vector<VulkanDescriptorWrite>& writes)
+    {
+        const uint64_t frameCount = Core::GetRenderContext()->GetFrameCount();
+        SetKey key = {layout, writes};
+        auto itr = mSets.find(key);
+        if (itr != mSets.end())
+        {
+            itr->second.LastUsedFrame = frameCount;
+            mFrameHits++;
+            return itr->second.Set;
+        }
+
+        CachedSet cachedSet;
+        cachedSet.Set = mAllocator->Allocate(layout, cachedSet.Pool);
+        cachedSet.LastUsedFrame = frameCount;
+        mFrameMisses++;
+
+        Vector<VkWriteDescriptorSet> writeDescriptorSets(writes.size());
+        for (size_t i = 0; i < writes.size(); i++)
+        {
+            VkWriteDescriptorSet& writeDescriptorSet = writeDescriptorSets[i];
+            writeDescriptorSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            writeDescriptorSet.dstSet = cachedSet.Set;
+            writeDescriptorSet.dstBinding = writes[i].Binding;
+            writeDescriptorSet.descriptorCount = 1;
+            writeDescriptorSet.descriptorType = writes[i].Type;
+            writeDescriptorSet.pImageInfo = &writes[i].ImageInfo;
+            writeDescriptorSet.pBufferInfo = &writes[i].BufferInfo;
+        }
+        vkUpdateDescriptorSets(mDevice, static_cast<Uint>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        renderContext->AddWrittenDescriptors(static_cast<Uint>(writes.size()));
+
+        mSets[std::move(key)] = cachedSet;
+        return cachedSet.Set;
+    }
+
+    void VulkanDescriptorCache::Update(uint64_t frameCount)
+    {
+        for (auto itr = mSets.begin(); itr != mSets.end();)
+        {
+            if (frameCount > itr->second.LastUsedFrame + DESCRIPTOR_CACHE_UNUSED_FRAMES)
+            {
+                mAllocator->Free(itr->second.Set, itr->second.Pool);
+                itr = mSets.erase(itr);
+            }
+            else
+                itr++;
+        }
+    }
+
+    void VulkanDescriptorCache::EvictImageView(VkImageView imageView)
+    {
+        for (auto itr = mSets.begin(); itr != mSets.end();)
+        {
+            const Vector<VulkanDescriptorWrite>& writes = itr->first.Writes;
+            const bool usesView = std::any_of(writes.begin(), writes.end(), [imageView](const VulkanDescriptorWrite& write) { return write.ImageInfo.imageView == imageView; });
+            if (usesView)
+            {
+                mAllocator->Free(itr->second.Set, itr->second.Pool);
+                itr = mSets.erase(itr);
+            }
+            else
+                itr++;
+        }
+    }
+
+} // namespace Surge
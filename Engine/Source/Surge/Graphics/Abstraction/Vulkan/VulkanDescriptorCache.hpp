@@ -0,0 +1,101 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanDescriptorAllocator.hpp"
+#include <mutex>
+#include <unordered_map>
+
+// Number of frames a cached descriptor set can go unused before it is freed, the frames in flight must be done with it by then
+#define DESCRIPTOR_CACHE_UNUSED_FRAMES 120
+
+namespace Surge
+{
+    // One descriptor of a cached set, only the info that matches 'Type' is used
+    struct VulkanDescriptorWrite
+    {
+        Uint Binding = 0;
+        VkDescriptorType Type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        VkDescriptorImageInfo ImageInfo = {};
+        VkDescriptorBufferInfo BufferInfo = {};
+
+        bool operator==(const VulkanDescriptorWrite& other) const;
+    };
+
+    // Deduplicates descriptor set layouts and descriptor sets. A layout is created once for every distinct set of bindings, and a set
+    // once for every distinct (layout, writes), so identical bindings return the set that was written for them the first time.
+    // The layouts live until Destroy, the sets until they are unused for DESCRIPTOR_CACHE_UNUSED_FRAMES or their image view is destroyed.
+    // GetLayout can be called from any thread (shaders and pipelines are created on the thread pool), everything else is main thread only
+    class SURGE_API VulkanDescriptorCache
+    {
+    public:
+        VulkanDescriptorCache() = default;
+        ~VulkanDescriptorCache() = default;
+
+        void Initialize(VkDevice device, VulkanDescriptorAllocator* allocator);
+        void Destroy();
+
+        // The returned layout is owned by the cache
+        VkDescriptorSetLayout GetLayout(const Vector<VkDescriptorSetLayoutBinding>& bindings, const Vector<VkDescriptorBindingFlags>& bindingFlags = {}, VkDescriptorSetLayoutCreateFlags flags = 0);
+
+        // The returned set is owned by the cache, it must not be updated. It stays valid until the end of the frame in flight
+        VkDescriptorSet GetDescriptorSet(VkDescriptorSetLayout layout, const Vector<VulkanDescriptorWrite>& writes);
+
+        // Frees the sets that weren't used for DESCRIPTOR_CACHE_UNUSED_FRAMES, called once per frame
+        void Update(uint64_t frameCount);
+
+        // Frees the sets that use 'imageView' right away, the caller must make sure the GPU is done with them
+        void EvictImageView(VkImageView imageView);
+
+        Uint GetSetCount() const { return static_cast<Uint>(mSets.size()); }
+        Uint GetLayoutCount() const
+        {
+            std::scoped_lock<std::mutex> lock(mLayoutMutex);
+            return static_cast<Uint>(mLayouts.size());
+        }
+        Uint GetFrameHits() const { return mFrameHits; }
+        Uint GetFrameMisses() const { return mFrameMisses; }
+        void ResetFrameStats() { mFrameHits = mFrameMisses = 0; }
+
+    private:
+        struct LayoutKey
+        {
+            VkDescriptorSetLayoutCreateFlags Flags;
+            Vector<VkDescriptorSetLayoutBinding> Bindings; // Sorted by binding
+            Vector<VkDescriptorBindingFlags> BindingFlags; // One for every binding
+
+            bool operator==(const LayoutKey& other) const;
+        };
+
+        struct SetKey
+        {
+            VkDescriptorSetLayout Layout;
+            Vector<VulkanDescriptorWrite> Writes;
+
+            bool operator==(const SetKey& other) const;
+        };
+
+        struct KeyHasher
+        {
+            size_t operator()(const LayoutKey& key) const;
+            size_t operator()(const SetKey& key) const;
+        };
+
+        struct CachedSet
+        {
+            VkDescriptorSet Set;
+            VkDescriptorPool Pool;
+            uint64_t LastUsedFrame;
+        };
+
+    private:
+        VkDevice mDevice = VK_NULL_HANDLE;
+        VulkanDescriptorAllocator* mAllocator = nullptr;
+
+        std::unordered_map<LayoutKey, VkDescriptorSetLayout, KeyHasher> mLayouts;
+        mutable std::mutex mLayoutMutex;
+        std::unordered_map<SetKey, CachedSet, KeyHasher> mSets;
+
+        Uint mFrameHits = 0;
+        Uint mFrameMisses = 0;
+    };
+
+} // namespace Surge
@@ -12,35 +12,51 @@
 
 namespace Surge
 {
+    namespace
+    {
+        uint64_t GetDescriptorKey(Uint binding, Uint arrayElement)
+        {
+            return (static_cast<uint64_t>(binding) << 32) | arrayElement;
+        }
+
+        bool operator==(const VkDescriptorBufferInfo& a, const VkDescriptorBufferInfo& b)
+        {
+            return a.buffer == b.buffer && a.offset == b.offset && a.range == b.range;
+        }
+
+        bool operator==(const VkDescriptorImageInfo& a, const VkDescriptorImageInfo& b)
+        {
+            return a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+        }
+    } // namespace
+
     VulkanDescriptorSet::VulkanDescriptorSet(const Ref<Shader>& shader, Uint setNumber, bool resetEveryFrame, int index)
         : mSetNumber(setNumber)
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
 
-        VkDescriptorSetAllocateInfo allocInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &shader.As<VulkanShader>()->GetDescriptorSetLayouts().at(setNumber);
-        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+        Ref<VulkanShader> vulkanShader = shader.As<VulkanShader>();
+        VkDescriptorSetLayout layout = vulkanShader->GetDescriptorSetLayouts().at(setNumber);
+        mBindless = vulkanShader->IsBindlessSet(setNumber);
+        VulkanDescriptorAllocator* allocator = mBindless ? renderContext->GetBindlessDescriptorAllocator() : renderContext->GetDescriptorAllocator();
 
         mDescriptorSets.resize(FRAMES_IN_FLIGHT);
+        mPools.resize(FRAMES_IN_FLIGHT);
+        mWrittenDescriptors.resize(FRAMES_IN_FLIGHT);
         for (int index = 0; index < FRAMES_IN_FLIGHT; index++)
-        {
-            allocInfo.descriptorPool = renderContext->GetNonResetableDescriptorPools()[index];
-            VK_CALL(vkAllocateDescriptorSets(device, &allocInfo, &mDescriptorSets[index]));
-        }
+            mDescriptorSets[index] = allocator->Allocate(layout, mPools[index]);
     }
 
     VulkanDescriptorSet::~VulkanDescriptorSet()
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+        VulkanDescriptorAllocator* allocator = mBindless ? renderContext->GetBindlessDescriptorAllocator() : renderContext->GetDescriptorAllocator();
 
         for (int index = 0; index < mDescriptorSets.size(); index++)
         {
-            VkDescriptorPool pool = renderContext->GetNonResetableDescriptorPools()[index];
-            vkFreeDescriptorSets(device, pool, 1, &mDescriptorSets[index]);
+            allocator->Free(mDescriptorSets[index], mPools[index]);
             mDescriptorSets[index] = VK_NULL_HANDLE;
         }
     }
@@ -70,42 +86,57 @@ namespace Surge
         VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
         Uint frameIndex = renderContext->GetFrameIndex();
 
-        // TODO: Check for previous resources
         if (!mPendingBuffers.empty() || !mPendingImages.empty() || !mPendingStorageBuffers.empty())
         {
+            HashMap<uint64_t, WrittenDescriptor>& writtenDescriptors = mWrittenDescriptors[frameIndex];
             Vector<VkWriteDescriptorSet> writeDescriptorSets;
-            for (auto& [binding, buffer] : mPendingBuffers)
-            {
+
+            // Skips the write if this frame's set already points at the same buffer range
+            auto writeBuffer = [&](Uint binding, VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo) {
+                VkDescriptorBufferInfo& written = writtenDescriptors[GetDescriptorKey(binding, 0)].BufferInfo;
+                if (written == bufferInfo)
+                    return;
+
+                written = bufferInfo;
                 VkWriteDescriptorSet writeDescriptorSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
                 writeDescriptorSet.dstBinding = binding;
-                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                writeDescriptorSet.pBufferInfo = &buffer.As<VulkanUniformBuffer>()->GetVulkanDescriptorBufferInfo();
+                writeDescriptorSet.descriptorType = type;
+                writeDescriptorSet.pBufferInfo = &bufferInfo;
                 writeDescriptorSet.descriptorCount = 1;
                 writeDescriptorSet.dstSet = mDescriptorSets[frameIndex];
                 writeDescriptorSets.push_back(writeDescriptorSet);
-            }
+            };
+
+            for (auto& [binding, buffer] : mPendingBuffers)
+                writeBuffer(binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, buffer.As<VulkanUniformBuffer>()->GetVulkanDescriptorBufferInfo());
             for (auto& [binding, buffer] : mPendingStorageBuffers)
+                writeBuffer(binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffer.As<VulkanStorageBuffer>()->GetVulkanDescriptorBufferInfo());
+
+            for (const PendingImage& pending : mPendingImages)
             {
-                VkWriteDescriptorSet writeDescriptorSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-                writeDescriptorSet.dstBinding = binding;
-                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                writeDescriptorSet.pBufferInfo = &buffer.As<VulkanStorageBuffer>()->GetVulkanDescriptorBufferInfo();
-                writeDescriptorSet.descriptorCount = 1;
-                writeDescriptorSet.dstSet = mDescriptorSets[frameIndex];
-                writeDescriptorSets.push_back(writeDescriptorSet);
-            }
-            for (auto& [binding, image] : mPendingImages)
-            {
+                const Ref<Image2D>& image = pending.Image;
+                const VkDescriptorImageInfo& imageInfo = image.As<VulkanImage2D>()->GetVulkanDescriptorImageInfo();
+                VkDescriptorImageInfo& written = writtenDescriptors[GetDescriptorKey(pending.Binding, pending.ArrayElement)].ImageInfo;
+                if (written == imageInfo)
+                    continue;
+
+                written = imageInfo;
                 const ImageSpecification& spec = image->GetSpecification();
                 VkWriteDescriptorSet writeDescriptorSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-                writeDescriptorSet.dstBinding = binding;
+                writeDescriptorSet.dstBinding = pending.Binding;
+                writeDescriptorSet.dstArrayElement = pending.ArrayElement;
                 writeDescriptorSet.descriptorType = spec.Usage == ImageUsage::Storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                writeDescriptorSet.pImageInfo = &image.As<VulkanImage2D>()->GetVulkanDescriptorImageInfo();
+                writeDescriptorSet.pImageInfo = &imageInfo;
                 writeDescriptorSet.descriptorCount = 1;
                 writeDescriptorSet.dstSet = mDescriptorSets[frameIndex];
                 writeDescriptorSets.push_back(writeDescriptorSet);
             }
-            vkUpdateDescriptorSets(device, static_cast<Uint>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+
+            if (!writeDescriptorSets.empty())
+            {
+                vkUpdateDescriptorSets(device, static_cast<Uint>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+                renderContext->AddWrittenDescriptors(static_cast<Uint>(writeDescriptorSets.size()));
+            }
 
             mPendingStorageBuffers.clear();
             mPendingBuffers.clear();
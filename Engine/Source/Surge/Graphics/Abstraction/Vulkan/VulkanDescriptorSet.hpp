@@ -17,17 +17,34 @@ namespace Surge
         virtual void UpdateForRendering() override;
         virtual void SetBuffer(const Ref<UniformBuffer>& dataBuffer, Uint binding) override { mPendingBuffers.push_back({binding, dataBuffer}); }
         virtual void SetBuffer(const Ref<StorageBuffer>& dataBuffer, Uint binding) override { mPendingStorageBuffers.push_back({binding, dataBuffer}); }
-        virtual void SetImage2D(const Ref<Image2D>& image, Uint binding) override { mPendingImages.push_back({binding, image}); }
+        virtual void SetImage2D(const Ref<Image2D>& image, Uint binding, Uint arrayElement = 0) override { mPendingImages.push_back({binding, arrayElement, image}); }
 
         Vector<VkDescriptorSet> GetVulkanDescriptorSets() { return mDescriptorSets; }
 
+        struct PendingImage
+        {
+            Uint Binding;
+            Uint ArrayElement;
+            Ref<Image2D> Image;
+        };
+
     private:
         Uint mSetNumber;
         Vector<VkDescriptorSet> mDescriptorSets;
+        Vector<VkDescriptorPool> mPools; // The pool of every set
+        bool mBindless = false;          // Allocated by VulkanRenderContext::GetBindlessDescriptorAllocator
 
         Vector<Pair<Uint, Ref<StorageBuffer>>> mPendingStorageBuffers;
         Vector<Pair<Uint, Ref<UniformBuffer>>> mPendingBuffers;
-        Vector<Pair<Uint, Ref<Image2D>>> mPendingImages;
+        Vector<PendingImage> mPendingImages;
+
+        // What every frame's set already holds, keyed by (binding, array element), so that rebinding the same resource writes nothing
+        struct WrittenDescriptor
+        {
+            VkDescriptorBufferInfo BufferInfo = {};
+            VkDescriptorImageInfo ImageInfo = {};
+        };
+        Vector<HashMap<uint64_t, WrittenDescriptor>> mWrittenDescriptors;
     };
 
 } // namespace Surge
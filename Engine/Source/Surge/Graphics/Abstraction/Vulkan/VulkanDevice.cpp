@@ -79,91 +79,6 @@ namespace Surge
         vkDestroyDevice(mLogicalDevice, nullptr);
     }
 
-    void VulkanDevice::InstantSubmit(VulkanQueueType type, std::function<void(VkCommandBuffer&)> function)
-    {
-        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-        VkCommandBufferAllocateInfo cmdBufAllocateInfo = {};
-        cmdBufAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-
-        switch (type)
-        {
-            case VulkanQueueType::Graphics: cmdBufAllocateInfo.commandPool = mGraphicsCommandPool; break;
-            case VulkanQueueType::Compute: cmdBufAllocateInfo.commandPool = mComputeCommandPool; break;
-            case VulkanQueueType::Transfer: cmdBufAllocateInfo.commandPool = mTransferCommandPool; break;
-        }
-
-        cmdBufAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        cmdBufAllocateInfo.commandBufferCount = 1;
-
-        VK_CALL(vkAllocateCommandBuffers(mLogicalDevice, &cmdBufAllocateInfo, &commandBuffer));
-
-        VkCommandBufferBeginInfo cmdBufferBeginInfo {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        VK_CALL(vkBeginCommandBuffer(commandBuffer, &cmdBufferBeginInfo));
-
-        function(commandBuffer); // Execute
-
-        const uint64_t fenceTimeout = 100000000000;
-
-        SG_ASSERT_NOMSG(commandBuffer != VK_NULL_HANDLE);
-        VK_CALL(vkEndCommandBuffer(commandBuffer));
-
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-
-        // Create fence to ensure that the command buffer has finished executing
-        VkFenceCreateInfo fenceCreateInfo = {};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = 0;
-        VkFence fence = VK_NULL_HANDLE;
-        VK_CALL(vkCreateFence(mLogicalDevice, &fenceCreateInfo, nullptr, &fence));
-
-        // Submit to the queue
-        switch (type)
-        {
-            case VulkanQueueType::Graphics:
-            {
-                VK_CALL(vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, fence));
-                break;
-            }
-            case VulkanQueueType::Compute:
-            {
-                VK_CALL(vkQueueSubmit(mComputeQueue, 1, &submitInfo, fence));
-                break;
-            }
-            case VulkanQueueType::Transfer:
-            {
-                VK_CALL(vkQueueSubmit(mTransferQueue, 1, &submitInfo, fence));
-                break;
-            }
-        }
-
-        // Wait for the fence to signal that command buffer has finished executing
-        VK_CALL(vkWaitForFences(mLogicalDevice, 1, &fence, VK_TRUE, fenceTimeout));
-
-        switch (type)
-        {
-            case VulkanQueueType::Graphics:
-            {
-                vkFreeCommandBuffers(mLogicalDevice, mGraphicsCommandPool, 1, &commandBuffer);
-                break;
-            }
-            case VulkanQueueType::Compute:
-            {
-                vkFreeCommandBuffers(mLogicalDevice, mComputeCommandPool, 1, &commandBuffer);
-                break;
-            }
-            case VulkanQueueType::Transfer:
-            {
-                vkFreeCommandBuffers(mLogicalDevice, mTransferCommandPool, 1, &commandBuffer);
-                break;
-            }
-        }
-
-        vkDestroyFence(mLogicalDevice, fence, nullptr);
-    }
-
     void VulkanDevice::QueryDeviceExtensions()
     {
         Uint extCount = 0;
@@ -215,6 +130,10 @@ namespace Surge
         requestedVulkan12Features.drawIndirectCount = VK_TRUE;
         requestedVulkan12Features.imagelessFramebuffer = VK_TRUE;
         requestedVulkan12Features.shaderInt8 = VK_TRUE;
+        requestedVulkan12Features.runtimeDescriptorArray = VK_TRUE; // Bindless textures of the MaterialTable
+        requestedVulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        requestedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        requestedVulkan12Features.timelineSemaphore = VK_TRUE; // VulkanUploadQueue
 
         VkPhysicalDeviceSynchronization2FeaturesKHR requestedSync2Features {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR};
         requestedSync2Features.synchronization2 = VK_TRUE;
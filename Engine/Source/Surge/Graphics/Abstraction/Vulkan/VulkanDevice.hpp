@@ -13,13 +13,6 @@ namespace Surge
         int32_t TransferQueue = -1;
     };
 
-    enum class SURGE_API VulkanQueueType
-    {
-        Graphics = 0,
-        Compute,
-        Transfer
-    };
-
     class SURGE_API VulkanDevice
     {
     public:
@@ -48,7 +41,6 @@ namespace Surge
             return properties;
         }
 
-        void InstantSubmit(VulkanQueueType type, std::function<void(VkCommandBuffer&)> function);
         bool IsExtensionSupported(const String& extensionName) { return mSupportedExtensions.find(extensionName) != mSupportedExtensions.end(); };
 
     private:
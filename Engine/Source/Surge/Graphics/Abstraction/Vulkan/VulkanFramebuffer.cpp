@@ -25,10 +25,40 @@ namespace Surge
         SG_ASSERT(width != 0 && height != 0, "Invalid size!");
         mSpecification.Width = width;
         mSpecification.Height = height;
-        Invalidate();
+
+        // The render pass doesn't depend on the size, the new attachments come with SetExternalAttachments
+        if (!mSpecification.ExternalAttachments)
+            Invalidate();
+    }
+
+    void VulkanFramebuffer::SetExternalAttachments(const Vector<Ref<Image2D>>& attachments)
+    {
+        SG_ASSERT(mSpecification.ExternalAttachments, "The framebuffer creates its own attachments!");
+        SG_ASSERT(attachments.size() == mSpecification.AttachmentSpecs.size(), "Wrong attachment count!");
+
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        if (mFramebuffer)
+        {
+            vkDestroyFramebuffer(renderContext->GetDevice()->GetLogicalDevice(), mFramebuffer, nullptr);
+            mFramebuffer = VK_NULL_HANDLE;
+        }
+
+        mColorAttachmentImages.clear();
+        mDepthAttachmentImage = nullptr;
+        for (const Ref<Image2D>& image : attachments)
+        {
+            SG_ASSERT(image->GetWidth() == mSpecification.Width && image->GetHeight() == mSpecification.Height, "Attachment size doesn't match the framebuffer!");
+            if (VulkanUtils::IsDepthFormat(image->GetSpecification().Format))
+                mDepthAttachmentImage = image;
+            else
+                mColorAttachmentImages.push_back(image);
+        }
+
+        CreateVulkanFramebuffer();
     }
 
-    void VulkanFramebuffer::BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer) const
+    void VulkanFramebuffer::BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer, bool secondaryContents) const
     {
         VulkanRenderContext* renderContext;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
@@ -65,8 +95,14 @@ namespace Surge
         renderPassBeginInfo.framebuffer = mFramebuffer;
         renderPassBeginInfo.clearValueCount = static_cast<Uint>(clearValues.size());
         renderPassBeginInfo.pClearValues = clearValues.data();
-        vkCmdBeginRenderPass(vulkanCmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        if (secondaryContents)
+        {
+            // The secondary command buffers set the viewport and scissor themselves, see VulkanRenderCommandBuffer::BeginRecording
+            vkCmdBeginRenderPass(vulkanCmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            return;
+        }
 
+        vkCmdBeginRenderPass(vulkanCmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
         vkCmdSetViewport(vulkanCmdBuffer, 0, 1, &viewport);
         vkCmdSetScissor(vulkanCmdBuffer, 0, 1, &scissor);
     }
@@ -92,20 +128,27 @@ namespace Surge
         VkAttachmentReference depthAttachmentReference;
 
         Uint attachmentIndex = 0;
+        const bool external = mSpecification.ExternalAttachments;
+        bool hasDepthAttachment = false;
         for (FramebufferAttachmentSpec& spec : mSpecification.AttachmentSpecs)
         {
-            ImageSpecification imageSpec;
-            imageSpec.Format = spec.Format;
-            imageSpec.Width = mSpecification.Width;
-            imageSpec.Height = mSpecification.Height;
-            imageSpec.Usage = ImageUsage::Attachment;
-            imageSpec.Mips = 1;
-            imageSpec.SamplerProps = spec.AttachmentSamplerProps;
-            Ref<Image2D> image = Image2D::Create(imageSpec);
+            Ref<Image2D> image;
+            if (!external)
+            {
+                ImageSpecification imageSpec;
+                imageSpec.Format = spec.Format;
+                imageSpec.Width = mSpecification.Width;
+                imageSpec.Height = mSpecification.Height;
+                imageSpec.Usage = ImageUsage::Attachment;
+                imageSpec.Mips = 1;
+                imageSpec.SamplerProps = spec.AttachmentSamplerProps;
+                image = Image2D::Create(imageSpec);
+            }
 
             if (VulkanUtils::IsDepthFormat(spec.Format))
             {
-                SG_ASSERT(!mDepthAttachmentImage, "Depth Attachment already exists!");
+                SG_ASSERT(!hasDepthAttachment, "Depth Attachment already exists!");
+                hasDepthAttachment = true;
                 mDepthAttachmentImage = image;
                 VkAttachmentDescription& depthAttachment = attachmentDescriptions.emplace_back();
                 depthAttachment = {};
@@ -115,14 +158,15 @@ namespace Surge
                 depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
                 depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
                 depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-                depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-                depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+                depthAttachment.initialLayout = external ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+                depthAttachment.finalLayout = external ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
                 depthAttachmentReference.attachment = attachmentIndex;
                 depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             }
             else
             {
-                mColorAttachmentImages.push_back(image);
+                if (!external)
+                    mColorAttachmentImages.push_back(image);
                 VkAttachmentDescription& colorAttachment = attachmentDescriptions.emplace_back();
                 colorAttachment = {};
                 colorAttachment.format = VulkanUtils::GetImageFormat(spec.Format);
@@ -131,8 +175,8 @@ namespace Surge
                 colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
                 colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;   // We don't care about stencil
                 colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // ^^
-                colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;         // We don't care what previous layout the image was in
-                colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                colorAttachment.initialLayout = external ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED; // We don't care what previous layout the image was in
+                colorAttachment.finalLayout = external ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
                 VkAttachmentReference colorAttachmentReference {};
                 colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -146,7 +190,7 @@ namespace Surge
         subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
         subpassDescription.colorAttachmentCount = static_cast<Uint>(colorAttachmentReferences.size());
         subpassDescription.pColorAttachments = colorAttachmentReferences.data();
-        if (mDepthAttachmentImage)
+        if (hasDepthAttachment)
             subpassDescription.pDepthStencilAttachment = &depthAttachmentReference;
 
         // Create the Framebuffer
@@ -160,6 +204,16 @@ namespace Surge
         VK_CALL(vkCreateRenderPass(logicalDevice, &renderPassInfo, nullptr, &mRenderPass));
         SET_VK_OBJECT_DEBUGNAME(mRenderPass, VK_OBJECT_TYPE_RENDER_PASS, "RenderPass");
 
+        if (!external)
+            CreateVulkanFramebuffer();
+    }
+
+    void VulkanFramebuffer::CreateVulkanFramebuffer()
+    {
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        VkDevice logicalDevice = renderContext->GetDevice()->GetLogicalDevice();
+
         Uint colorAttachmentImagesSize = static_cast<Uint>(mColorAttachmentImages.size());
         Vector<VkImageView> attachments(colorAttachmentImagesSize);
 
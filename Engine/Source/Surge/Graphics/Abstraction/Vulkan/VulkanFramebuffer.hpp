@@ -13,12 +13,13 @@ namespace Surge
 
         virtual void Resize(Uint width, Uint height) override;
 
-        virtual void BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer) const override;
+        virtual void BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer, bool secondaryContents = false) const override;
         virtual void EndRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer) const override;
 
         virtual const FramebufferSpecification& GetSpecification() const override { return mSpecification; }
         virtual const Ref<Image2D>& GetColorAttachment(Uint index) const override { return mColorAttachmentImages[index]; }
         virtual const Ref<Image2D>& GetDepthAttachment() const override { return mDepthAttachmentImage; }
+        virtual void SetExternalAttachments(const Vector<Ref<Image2D>>& attachments) override;
 
         // VulkanSpecific
         VkFramebuffer& GetVulkanFramebuffer() { return mFramebuffer; }
@@ -26,6 +27,7 @@ namespace Surge
 
     private:
         void Invalidate();
+        void CreateVulkanFramebuffer();
         void Clear();
 
     private:
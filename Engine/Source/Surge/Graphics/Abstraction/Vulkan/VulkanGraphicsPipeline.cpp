@@ -4,13 +4,15 @@
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanShader.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanUtils.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanFramebuffer.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanStorageBuffer.hpp"
 
 namespace Surge
 {
-    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const GraphicsPipelineSpecification& pipelineSpec)
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const GraphicsPipelineSpecification& pipelineSpec, bool deferCreation)
         : mSpecification(pipelineSpec)
     {
-        Reload();
+        if (!deferCreation)
+            Reload();
         mShaderReloadID = mSpecification.Shader->AddReloadCallback([&]() { this->Reload(); });
     }
 
@@ -29,8 +31,11 @@ namespace Surge
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         VkDevice logicalDevice = renderContext->GetDevice()->GetLogicalDevice();
 
+        // Raw pointers only, Reload() can run on a worker thread (PipelineLibrary) and Ref isn't thread safe
+        VulkanShader* vulkanShader = static_cast<VulkanShader*>(mSpecification.Shader.Raw());
+
         // Setting up all the shaders into a create info class SURGE_API
-        HashMap<ShaderType, VkShaderModule> shaderModules = mSpecification.Shader.As<VulkanShader>()->GetVulkanShaderModules();
+        const HashMap<ShaderType, VkShaderModule>& shaderModules = vulkanShader->GetVulkanShaderModules();
         Vector<VkPipelineShaderStageCreateInfo> shaderStages;
         for (const auto& shader : shaderModules)
         {
@@ -128,16 +133,14 @@ namespace Surge
         colorBlending.blendConstants[3] = 0.0f;
 
         // Setting up the pipeline layout
-        Ref<VulkanShader> vulkanShader = mSpecification.Shader.As<VulkanShader>();
         Vector<VkDescriptorSetLayout> descriptorSetLayouts(0);
         const Vector<VkPushConstantRange> pushConstants = VulkanUtils::GetPushConstantRangesVectorFromHashMap(vulkanShader->GetPushConstantRanges());
 
         // (TODO: switch to bindless)
         { // "Mess Scope" read the comments inside this scope for detail
 
-            // Create an empty layout
-            VkDescriptorSetLayoutCreateInfo layoutInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-            VK_CALL(vkCreateDescriptorSetLayout(logicalDevice, &layoutInfo, nullptr, &mEmptyLayout));
+            // Get the empty layout, it is shared by all the pipelines
+            mEmptyLayout = renderContext->GetDescriptorCache()->GetLayout({});
             // We have to do this because:
             // The descriptor set layouts for a pipeline layout always start from set 0, so if a
             // shader only uses set 5, then you must create a pipeline layout with *5 descriptor sets*
@@ -191,12 +194,15 @@ namespace Surge
         pipelineInfo.layout = mPipelineLayout;
 
         if (mSpecification.TargetFramebuffer)
-            pipelineInfo.renderPass = mSpecification.TargetFramebuffer.As<VulkanFramebuffer>()->GetVulkanRenderPass();
+            pipelineInfo.renderPass = static_cast<VulkanFramebuffer*>(mSpecification.TargetFramebuffer.Raw())->GetVulkanRenderPass();
         else
             pipelineInfo.renderPass = renderContext->GetSwapChain()->GetVulkanRenderPass();
 
         pipelineInfo.subpass = 0;
-        VK_CALL(vkCreateGraphicsPipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &mPipeline));
+        VulkanPipelineCache* pipelineCache = renderContext->GetPipelineCache();
+        Timer timer;
+        VK_CALL(vkCreateGraphicsPipelines(logicalDevice, pipelineCache->GetVulkanPipelineCache(), 1, &pipelineInfo, nullptr, &mPipeline));
+        pipelineCache->RecordPipelineCreation(timer.ElapsedMillis());
         SET_VK_OBJECT_DEBUGNAME(mPipeline, VK_OBJECT_TYPE_PIPELINE, "Graphics Pipeline");
     }
 
@@ -233,14 +239,27 @@ namespace Surge
         vkCmdPushConstants(vulkanCmdBuffer, mPipelineLayout, pushConstant.stageFlags, pushConstant.offset, pushConstant.size, data);
     }
 
-    void VulkanGraphicsPipeline::DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex) const
+    void VulkanGraphicsPipeline::DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex, Uint instanceCount, Uint firstInstance) const
+    {
+        VulkanRenderContext* renderContext = nullptr;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        Uint frameIndex = renderContext->GetFrameIndex();
+        VkCommandBuffer vulkanCmdBuffer = cmdBuffer.As<VulkanRenderCommandBuffer>()->GetVulkanCommandBuffer(frameIndex);
+
+        vkCmdDrawIndexed(vulkanCmdBuffer, indicesCount, instanceCount, baseIndex, baseVertex, firstInstance);
+    }
+
+    void VulkanGraphicsPipeline::DrawIndexedIndirectCount(const Ref<RenderCommandBuffer>& cmdBuffer, const Ref<StorageBuffer>& commands, Uint commandsOffset, const Ref<StorageBuffer>& count, Uint countOffset, Uint maxDrawCount) const
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         Uint frameIndex = renderContext->GetFrameIndex();
         VkCommandBuffer vulkanCmdBuffer = cmdBuffer.As<VulkanRenderCommandBuffer>()->GetVulkanCommandBuffer(frameIndex);
 
-        vkCmdDrawIndexed(vulkanCmdBuffer, indicesCount, 1, baseIndex, baseVertex, 0);
+        // CPUToGPU storage buffers have one region per frame in flight
+        const VkDescriptorBufferInfo& commandsRegion = commands.As<VulkanStorageBuffer>()->GetVulkanDescriptorBufferInfo();
+        const VkDescriptorBufferInfo& countRegion = count.As<VulkanStorageBuffer>()->GetVulkanDescriptorBufferInfo();
+        vkCmdDrawIndexedIndirectCount(vulkanCmdBuffer, commandsRegion.buffer, commandsRegion.offset + commandsOffset, countRegion.buffer, countRegion.offset + countOffset, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
     }
 
     void VulkanGraphicsPipeline::Clear()
@@ -256,7 +275,6 @@ namespace Surge
         mPipeline = VK_NULL_HANDLE;
         vkDestroyPipelineLayout(device, mPipelineLayout, nullptr);
         mPipelineLayout = VK_NULL_HANDLE;
-        vkDestroyDescriptorSetLayout(device, mEmptyLayout, nullptr);
         mEmptyLayout = VK_NULL_HANDLE;
     }
 
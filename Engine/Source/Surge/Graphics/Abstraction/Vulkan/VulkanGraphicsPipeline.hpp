@@ -9,13 +9,14 @@ namespace Surge
     class SURGE_API VulkanGraphicsPipeline : public GraphicsPipeline
     {
     public:
-        VulkanGraphicsPipeline(const GraphicsPipelineSpecification& pipelineSpec);
+        VulkanGraphicsPipeline(const GraphicsPipelineSpecification& pipelineSpec, bool deferCreation = false);
         virtual ~VulkanGraphicsPipeline();
 
         virtual void Reload() override;
         virtual void Bind(const Ref<RenderCommandBuffer>& cmdBuffer) const override;
         virtual void SetPushConstantData(const Ref<RenderCommandBuffer>& cmdBuffer, const String& bufferName, void* data) const override;
-        virtual void DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex) const override;
+        virtual void DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex, Uint instanceCount = 1, Uint firstInstance = 0) const override;
+        virtual void DrawIndexedIndirectCount(const Ref<RenderCommandBuffer>& cmdBuffer, const Ref<StorageBuffer>& commands, Uint commandsOffset, const Ref<StorageBuffer>& count, Uint countOffset, Uint maxDrawCount) const override;
 
         VkPipeline GetVulkanPipeline() const { return mPipeline; }
         VkPipelineLayout GetPipelineLayout() const { return mPipelineLayout; }
@@ -77,12 +77,14 @@ namespace Surge
         initInfo.MinImageCount = 2;
         initInfo.ImageCount = 3;
         initInfo.Allocator = VK_NULL_HANDLE;
-        initInfo.PipelineCache = VK_NULL_HANDLE;
+        initInfo.PipelineCache = renderContext->mPipelineCache.GetVulkanPipelineCache();
         initInfo.CheckVkResultFn = ImGuiCheckVkResult;
         ImGui_ImplVulkan_Init(&initInfo, renderContext->mSwapChain.GetVulkanRenderPass());
 
-        VkCommandBuffer cmd = nullptr;
-        vulkanDevice->InstantSubmit(VulkanQueueType::Graphics, [&](VkCommandBuffer& cmd) { ImGui_ImplVulkan_CreateFontsTexture(cmd); });
+        // The upload objects of the fonts are destroyed right after, so this waits for them
+        VulkanUploadQueue* uploadQueue = renderContext->GetUploadQueue();
+        uploadQueue->RecordGraphics([](VkCommandBuffer cmd) { ImGui_ImplVulkan_CreateFontsTexture(cmd); });
+        uploadQueue->WaitIdle();
 
         ImGui_ImplVulkan_DestroyFontUploadObjects();
         SetDarkThemeColors();
@@ -129,21 +131,15 @@ namespace Surge
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
 
-        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
-        VkDescriptorSetLayout descriptorSetLayout = ImGui_ImplVulkan_GetDescriptorSetLayout();
-
-        // Allocate the descriptor set (for the texture)
-        VkDescriptorSetAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &descriptorSetLayout;
-        allocInfo.descriptorPool = renderContext->GetDescriptorPools()[renderContext->GetFrameIndex()];
-        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
-        VK_CALL(vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet));
-
-        // Add the texture
+        // The editor asks for the same images every frame, they get the set that was written for them the first time
         Ref<VulkanImage2D> vulkanImage2d = image2d.As<VulkanImage2D>();
-        ImGui_ImplVulkan_AddTexture(vulkanImage2d->GetVulkanImageView(), vulkanImage2d->GetVulkanImageLayout(), vulkanImage2d->GetVulkanSampler(), descriptorSet);
-        return descriptorSet;
+        VulkanDescriptorWrite write;
+        write.Binding = 0;
+        write.Type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.ImageInfo.sampler = vulkanImage2d->GetVulkanSampler();
+        write.ImageInfo.imageView = vulkanImage2d->GetVulkanImageView();
+        write.ImageInfo.imageLayout = vulkanImage2d->GetVulkanImageLayout();
+        return renderContext->GetDescriptorCache()->GetDescriptorSet(ImGui_ImplVulkan_GetDescriptorSetLayout(), {write});
     }
 
     void VulkanImGuiContext::SetDarkThemeColors()
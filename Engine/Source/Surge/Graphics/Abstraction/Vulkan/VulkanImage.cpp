@@ -5,12 +5,94 @@
 
 namespace Surge
 {
+    VulkanImageMemory::VulkanImageMemory(const ImageMemoryRequirements& requirements)
+        : mRequirements(requirements)
+    {
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
+
+        VkMemoryRequirements memoryRequirements;
+        memoryRequirements.size = requirements.Size;
+        memoryRequirements.alignment = requirements.Alignment;
+        memoryRequirements.memoryTypeBits = requirements.MemoryTypeBits;
+        mAllocation = allocator->AllocateMemory(memoryRequirements, VMA_MEMORY_USAGE_GPU_ONLY);
+    }
+
+    VulkanImageMemory::~VulkanImageMemory()
+    {
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
+        allocator->Free(mAllocation);
+    }
+
     VulkanImage2D::VulkanImage2D(const ImageSpecification& specification)
         : mSpecification(specification)
     {
         Invalidate();
     }
 
+    VulkanImage2D::VulkanImage2D(const ImageSpecification& specification, const Ref<ImageMemory>& memory)
+        : mSpecification(specification), mSharedMemory(memory)
+    {
+        Invalidate();
+    }
+
+    ImageMemoryRequirements VulkanImage2D::GetMemoryRequirements(const ImageSpecification& specification)
+    {
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+
+        // The requirements only exist for an actual image, create one without memory just to ask
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(specification);
+        VkImage image;
+        VK_CALL(vkCreateImage(device, &imageInfo, nullptr, &image));
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device, image, &memoryRequirements);
+        vkDestroyImage(device, image, nullptr);
+
+        ImageMemoryRequirements result;
+        result.Size = memoryRequirements.size;
+        result.Alignment = memoryRequirements.alignment;
+        result.MemoryTypeBits = memoryRequirements.memoryTypeBits;
+        return result;
+    }
+
+    VkImageCreateInfo VulkanImage2D::GetImageCreateInfo(const ImageSpecification& specification)
+    {
+        VkImageCreateInfo imageInfo {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = specification.Width;
+        imageInfo.extent.height = specification.Height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = specification.Mips;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = VulkanUtils::GetImageFormat(specification.Format);
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VulkanUtils::GetImageUsageFlags(specification.Usage, specification.Format);
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return imageInfo;
+    }
+
+    void VulkanImage2D::DestroyImage()
+    {
+        VulkanRenderContext* renderContext;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        if (mSharedMemory)
+        {
+            vkDestroyImage(renderContext->GetDevice()->GetLogicalDevice(), mImage, nullptr);
+        }
+        else
+        {
+            VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
+            allocator->DestroyImage(mImage, mImageMemory);
+        }
+    }
+
     void VulkanImage2D::Release()
     {
         if (mImage == VK_NULL_HANDLE)
@@ -18,12 +100,13 @@ namespace Surge
 
         VulkanRenderContext* renderContext;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
         VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+        renderContext->GetUploadQueue()->Flush(); // The image may be used by the open batch of the upload queue
         vkDeviceWaitIdle(device);
+        renderContext->GetDescriptorCache()->EvictImageView(mImageView);
         vkDestroyImageView(device, mImageView, nullptr);
         vkDestroySampler(device, mImageSampler, nullptr);
-        allocator->DestroyImage(mImage, mImageMemory);
+        DestroyImage();
 
         mImage = VK_NULL_HANDLE;
         mImageView = VK_NULL_HANDLE;
@@ -37,27 +120,18 @@ namespace Surge
         VulkanDevice* device = renderContext->GetDevice();
         VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
 
-        VkFormat textureFormat = VulkanUtils::GetImageFormat(mSpecification.Format);
-        VkImageUsageFlags usageFlags = VulkanUtils::GetImageUsageFlags(mSpecification.Usage, mSpecification.Format);
-
         VkImageAspectFlags aspectMask = VulkanUtils::IsDepthFormat(mSpecification.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
         if (mSpecification.Format == ImageFormat::Depth24Stencil8)
             aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
 
-        VkImageCreateInfo imageInfo {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-        imageInfo.imageType = VK_IMAGE_TYPE_2D;
-        imageInfo.extent.width = mSpecification.Width;
-        imageInfo.extent.height = mSpecification.Height;
-        imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = mSpecification.Mips;
-        imageInfo.arrayLayers = 1;
-        imageInfo.format = textureFormat;
-        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = usageFlags;
-        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        mImageMemory = allocator->AllocateImage(imageInfo, VMA_MEMORY_USAGE_GPU_ONLY, mImage, nullptr);
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(mSpecification);
+        if (mSharedMemory)
+        {
+            VK_CALL(vkCreateImage(device->GetLogicalDevice(), &imageInfo, nullptr, &mImage));
+            allocator->BindImageMemory(mSharedMemory.As<VulkanImageMemory>()->GetVulkanAllocation(), mImage);
+        }
+        else
+            mImageMemory = allocator->AllocateImage(imageInfo, VMA_MEMORY_USAGE_GPU_ONLY, mImage, nullptr);
         SET_VK_OBJECT_DEBUGNAME(mImage, VK_OBJECT_TYPE_IMAGE, "Image");
 
         // Create the image view
@@ -96,7 +170,7 @@ namespace Surge
         // Transition image to VK_IMAGE_LAYOUT_GENERAL layout, if it is Storage
         if (mSpecification.Usage == ImageUsage::Storage)
         {
-            device->InstantSubmit(VulkanQueueType::Graphics, [&](VkCommandBuffer& cmd) {
+            renderContext->GetUploadQueue()->RecordGraphics([&](VkCommandBuffer cmd) {
                 VkImageSubresourceRange subresourceRange {};
                 subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
                 subresourceRange.baseMipLevel = 0;
@@ -128,8 +202,8 @@ namespace Surge
     {
         VulkanRenderContext* renderContext;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
         VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+        renderContext->GetUploadQueue()->Flush();
         vkDeviceWaitIdle(device);
 
         if (mImageSampler)
@@ -139,12 +213,13 @@ namespace Surge
         }
         if (mImageView)
         {
+            renderContext->GetDescriptorCache()->EvictImageView(mImageView);
             vkDestroyImageView(device, mImageView, nullptr);
             mImageView = VK_NULL_HANDLE;
         }
         if (mImage)
         {
-            allocator->DestroyImage(mImage, mImageMemory);
+            DestroyImage();
             mImage = VK_NULL_HANDLE;
         }
     }
@@ -6,10 +6,27 @@
 
 namespace Surge
 {
+    class SURGE_API VulkanImageMemory : public ImageMemory
+    {
+    public:
+        VulkanImageMemory(const ImageMemoryRequirements& requirements);
+        virtual ~VulkanImageMemory();
+
+        virtual uint64_t GetSize() const override { return mRequirements.Size; }
+
+        // Vulkan Specific
+        VmaAllocation GetVulkanAllocation() const { return mAllocation; }
+
+    private:
+        ImageMemoryRequirements mRequirements;
+        VmaAllocation mAllocation = VK_NULL_HANDLE;
+    };
+
     class SURGE_API VulkanImage2D : public Image2D
     {
     public:
         VulkanImage2D(const ImageSpecification& specification);
+        VulkanImage2D(const ImageSpecification& specification, const Ref<ImageMemory>& memory);
         virtual ~VulkanImage2D();
 
         virtual Uint GetWidth() const override { return mSpecification.Width; }
@@ -25,9 +42,13 @@ namespace Surge
         VkImageLayout GetVulkanImageLayout() { return mDescriptorInfo.imageLayout; }
         const VkDescriptorImageInfo& GetVulkanDescriptorImageInfo() const { return mDescriptorInfo; }
 
+        static ImageMemoryRequirements GetMemoryRequirements(const ImageSpecification& specification);
+
     private:
         void Invalidate();
         void UpdateDescriptor();
+        void DestroyImage();
+        static VkImageCreateInfo GetImageCreateInfo(const ImageSpecification& specification);
 
     private:
         ImageSpecification mSpecification;
@@ -35,7 +56,8 @@ namespace Surge
         VkImage mImage = VK_NULL_HANDLE;
         VkImageView mImageView = VK_NULL_HANDLE;
         VkSampler mImageSampler = VK_NULL_HANDLE;
-        VmaAllocation mImageMemory;
+        VmaAllocation mImageMemory = VK_NULL_HANDLE;
+        Ref<ImageMemory> mSharedMemory; // If set, the image lives in this memory and mImageMemory is unused
 
         VkDescriptorImageInfo mDescriptorInfo;
         friend class SURGE_API VulkanTexture2D;
@@ -14,6 +14,8 @@ namespace Surge
 
         VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
 
+        // The copy may still be in the open batch of the upload queue
+        renderContext->GetUploadQueue()->Flush();
         vkDeviceWaitIdle(renderContext->GetDevice()->GetLogicalDevice());
         allocator->DestroyBuffer(mVulkanBuffer, mAllocation);
     }
@@ -32,19 +34,6 @@ namespace Surge
         SURGE_GET_VULKAN_CONTEXT(renderContext);
 
         VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
-        VulkanDevice* vulkanDevice = renderContext->GetDevice();
-
-        VkBufferCreateInfo bufferCreateInfo {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-        bufferCreateInfo.size = mSize;
-        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        VkBuffer stagingBuffer = VK_NULL_HANDLE;
-        VmaAllocation stagingBufferAllocation = allocator->AllocateBuffer(bufferCreateInfo, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, nullptr);
-
-        // Copy data to staging buffer
-        void* destData = allocator->MapMemory(stagingBufferAllocation);
-        memcpy(destData, data, mSize);
-        allocator->UnmapMemory(stagingBufferAllocation);
 
         VkBufferCreateInfo indexBufferCreateInfo = {};
         indexBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -53,13 +42,7 @@ namespace Surge
         indexBufferCreateInfo.flags = VK_SHARING_MODE_EXCLUSIVE;
         mAllocation = allocator->AllocateBuffer(indexBufferCreateInfo, VMA_MEMORY_USAGE_GPU_ONLY, mVulkanBuffer, nullptr);
 
-        vulkanDevice->InstantSubmit(VulkanQueueType::Transfer, [&](VkCommandBuffer& cmd) {
-            VkBufferCopy copyRegion = {};
-            copyRegion.size = mSize;
-            vkCmdCopyBuffer(cmd, stagingBuffer, mVulkanBuffer, 1, &copyRegion);
-        });
-
-        allocator->DestroyBuffer(stagingBuffer, stagingBufferAllocation);
+        renderContext->GetUploadQueue()->UploadBuffer(mVulkanBuffer, data, mSize);
         SET_VK_OBJECT_DEBUGNAME(mVulkanBuffer, VK_OBJECT_TYPE_BUFFER, "Index Buffer");
     }
 } // namespace Surge
\ No newline at end of file
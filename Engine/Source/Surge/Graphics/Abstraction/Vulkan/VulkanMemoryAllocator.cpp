@@ -57,6 +57,24 @@ namespace Surge
         vmaDestroyImage(mAllocator, image, allocation);
     }
 
+    VmaAllocation VulkanMemoryAllocator::AllocateMemory(const VkMemoryRequirements& requirements, VmaMemoryUsage usage)
+    {
+        VmaAllocationCreateInfo allocCreateInfo = {};
+        allocCreateInfo.usage = usage;
+
+        VmaAllocation allocation;
+        VK_CALL(vmaAllocateMemory(mAllocator, &requirements, &allocCreateInfo, &allocation, nullptr));
+
+        return allocation;
+    }
+
+    void VulkanMemoryAllocator::BindImageMemory(VmaAllocation allocation, VkImage image)
+    {
+        SG_ASSERT_NOMSG(image);
+        SG_ASSERT_NOMSG(allocation);
+        VK_CALL(vmaBindImageMemory(mAllocator, allocation, image));
+    }
+
     void VulkanMemoryAllocator::Free(VmaAllocation allocation) { vmaFreeMemory(mAllocator, allocation); }
 
     void* VulkanMemoryAllocator::MapMemory(VmaAllocation allocation)
@@ -48,6 +48,10 @@ namespace Surge
         VmaAllocation AllocateImage(VkImageCreateInfo imageCreateInfo, VmaMemoryUsage usage, VkImage& outImage, VmaAllocationInfo* allocationInfo);
         void DestroyImage(VkImage image, VmaAllocation allocation);
 
+        // Raw memory, for resources that share an allocation
+        VmaAllocation AllocateMemory(const VkMemoryRequirements& requirements, VmaMemoryUsage usage);
+        void BindImageMemory(VmaAllocation allocation, VkImage image);
+
         void Free(VmaAllocation allocation);
 
         void* MapMemory(VmaAllocation allocation);
@@ -0,0 +1,146 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanPipelineCache.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderContext.hpp"
+#include "Surge/Core/Hash.hpp"
+#include "Surge/Utility/Filesystem.hpp"
+#include <filesystem>
+
+// "SGPC", little endian
+#define PIPELINE_CACHE_MAGIC 0x43504753
+
+// Must be bumped whenever the layout of CacheFileHeader changes
+#define PIPELINE_CACHE_VERSION 1
+
+namespace Surge
+{
+    namespace
+    {
+        // File layout: [CacheFileHeader][data returned by vkGetPipelineCacheData]
+        // The driver validates its own data too, but it doesn't have to reject the data of an older driver version
+        struct CacheFileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t VendorID;
+            uint32_t DeviceID;
+            uint32_t DriverVersion;
+            uint8_t PipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t DataSize;
+            uint64_t DataHash;
+        };
+
+        CacheFileHeader GetExpectedHeader(const VkPhysicalDeviceProperties& properties)
+        {
+            CacheFileHeader header = {};
+            header.Magic = PIPELINE_CACHE_MAGIC;
+            header.Version = PIPELINE_CACHE_VERSION;
+            header.VendorID = properties.vendorID;
+            header.DeviceID = properties.deviceID;
+            header.DriverVersion = properties.driverVersion;
+            std::memcpy(header.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+            return header;
+        }
+
+        bool IsSameDevice(const CacheFileHeader& a, const CacheFileHeader& b)
+        {
+            return a.Magic == b.Magic && a.Version == b.Version && a.VendorID == b.VendorID && a.DeviceID == b.DeviceID &&
+                   a.DriverVersion == b.DriverVersion && std::memcmp(a.PipelineCacheUUID, b.PipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+    } // namespace
+
+    void VulkanPipelineCache::Initialize(VulkanDevice& device)
+    {
+        SURGE_PROFILE_FUNC("VulkanPipelineCache::Initialize()");
+        const CacheFileHeader expected = GetExpectedHeader(device.GetPhysicalDeviceProperties());
+
+        // Keeps the file mapped until the VkPipelineCache is created, the driver copies the data
+        Scope<Filesystem::MappedFile> file;
+        VkPipelineCacheCreateInfo createInfo {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+        if (Filesystem::Exists(PIPELINE_CACHE_PATH))
+        {
+            file = CreateScope<Filesystem::MappedFile>(PIPELINE_CACHE_PATH);
+            CacheFileHeader header = {};
+            if (file->IsValid() && file->GetSize() >= sizeof(CacheFileHeader))
+                std::memcpy(&header, file->GetData(), sizeof(CacheFileHeader));
+
+            const Byte* data = file->IsValid() ? file->GetData() + sizeof(CacheFileHeader) : nullptr;
+            const bool valid = IsSameDevice(header, expected) && header.DataSize <= file->GetSize() - sizeof(CacheFileHeader) &&
+                               Hash::GenerateFromBytes(data, static_cast<size_t>(header.DataSize)) == header.DataHash;
+            if (valid)
+            {
+                createInfo.initialDataSize = static_cast<size_t>(header.DataSize);
+                createInfo.pInitialData = data;
+            }
+            else
+                Log<Severity::Warn>("Pipeline cache({0}) was written by another device/driver or is corrupted, starting with an empty one", PIPELINE_CACHE_PATH);
+        }
+
+        VK_CALL(vkCreatePipelineCache(device.GetLogicalDevice(), &createInfo, nullptr, &mPipelineCache));
+        SET_VK_OBJECT_DEBUGNAME(mPipelineCache, VK_OBJECT_TYPE_PIPELINE_CACHE, "Pipeline Cache");
+        mStats.InitialCacheSize = createInfo.initialDataSize;
+    }
+
+    void VulkanPipelineCache::Destroy(VulkanDevice& device)
+    {
+        if (!mPipelineCache)
+            return;
+
+        Save(device);
+        vkDestroyPipelineCache(device.GetLogicalDevice(), mPipelineCache, nullptr);
+        mPipelineCache = VK_NULL_HANDLE;
+    }
+
+    void VulkanPipelineCache::RecordPipelineCreation(float milliseconds)
+    {
+        std::scoped_lock lock(mStatsMutex);
+        mStats.PipelineCount++;
+        mStats.TotalCreationTime += milliseconds;
+        mStats.LastCreationTime = milliseconds;
+        mStats.MaxCreationTime = std::max(mStats.MaxCreationTime, milliseconds);
+    }
+
+    PipelineStats VulkanPipelineCache::GetStats() const
+    {
+        std::scoped_lock lock(mStatsMutex);
+        return mStats;
+    }
+
+    void VulkanPipelineCache::Save(VulkanDevice& device)
+    {
+        SURGE_PROFILE_FUNC("VulkanPipelineCache::Save()");
+        VkDevice logicalDevice = device.GetLogicalDevice();
+
+        size_t dataSize = 0;
+        VK_CALL(vkGetPipelineCacheData(logicalDevice, mPipelineCache, &dataSize, nullptr));
+        if (dataSize == 0)
+            return;
+
+        Vector<Byte> data(sizeof(CacheFileHeader) + dataSize);
+        VK_CALL(vkGetPipelineCacheData(logicalDevice, mPipelineCache, &dataSize, data.data() + sizeof(CacheFileHeader)));
+
+        CacheFileHeader header = GetExpectedHeader(device.GetPhysicalDeviceProperties());
+        header.DataSize = dataSize;
+        header.DataHash = Hash::GenerateFromBytes(data.data() + sizeof(CacheFileHeader), dataSize);
+        std::memcpy(data.data(), &header, sizeof(CacheFileHeader));
+
+        // Written under a temporary name and renamed, so a crash halfway through never leaves a broken cache behind
+        const String tempPath = fmt::format("{0}.tmp", PIPELINE_CACHE_PATH);
+        FILE* f = nullptr;
+        fopen_s(&f, tempPath.c_str(), "wb");
+        if (!f)
+        {
+            Log<Severity::Error>("Cannot open path({0}) for writing the pipeline cache!", tempPath);
+            return;
+        }
+        fwrite(data.data(), sizeof(Byte), sizeof(CacheFileHeader) + dataSize, f);
+        fclose(f);
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, PIPELINE_CACHE_PATH, error);
+        if (error)
+        {
+            Log<Severity::Error>("Cannot write the pipeline cache({0})! {1}", PIPELINE_CACHE_PATH, error.message());
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+} // namespace Surge
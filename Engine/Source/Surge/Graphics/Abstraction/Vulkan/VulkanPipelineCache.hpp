@@ -0,0 +1,40 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/RenderContext.hpp"
+#include <mutex>
+#include <volk.h>
+
+#define PIPELINE_CACHE_PATH "Engine/Assets/Temp/PipelineCache.bin"
+
+namespace Surge
+{
+    class SURGE_API VulkanDevice;
+
+    // Device wide VkPipelineCache, every graphics and compute pipeline is created through it.
+    // It is loaded from PIPELINE_CACHE_PATH on startup and written back on shutdown, the file is only used if it was
+    // written by the same GPU (vendor, device and pipeline cache UUID) with the same driver version
+    class SURGE_API VulkanPipelineCache
+    {
+    public:
+        VulkanPipelineCache() = default;
+        ~VulkanPipelineCache() = default;
+
+        void Initialize(VulkanDevice& device);
+        void Destroy(VulkanDevice& device); // Saves the cache to disk before destroying it
+
+        VkPipelineCache GetVulkanPipelineCache() const { return mPipelineCache; }
+
+        // Called by the pipelines after the driver created one, 'milliseconds' is how long it took
+        void RecordPipelineCreation(float milliseconds);
+        PipelineStats GetStats() const;
+
+    private:
+        void Save(VulkanDevice& device);
+
+    private:
+        VkPipelineCache mPipelineCache = VK_NULL_HANDLE;
+
+        mutable std::mutex mStatsMutex;
+        PipelineStats mStats;
+    };
+} // namespace Surge
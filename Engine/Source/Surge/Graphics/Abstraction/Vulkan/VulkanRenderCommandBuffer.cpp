@@ -2,14 +2,46 @@
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderCommandBuffer.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDevice.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDiagnostics.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanFramebuffer.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanImage.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanStorageBuffer.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanUtils.hpp"
+#include "Surge/Graphics/Interface/ResourceBarrier.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanSwapChain.hpp"
 
 namespace Surge
 {
-    VulkanRenderCommandBuffer::VulkanRenderCommandBuffer(bool createFromSwapchain, Uint size)
-        : mCreatedFromSwapchain(createFromSwapchain)
+    struct VulkanResourceState
+    {
+        VkPipelineStageFlags Stage;
+        VkAccessFlags Access;
+        VkImageLayout Layout;
+    };
+
+    static VulkanResourceState GetVulkanResourceState(ResourceState state, bool depthImage)
+    {
+        const VkImageLayout readLayout = depthImage ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        switch (state)
+        {
+            case ResourceState::Undefined: return {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED};
+            case ResourceState::ColorAttachment:
+                return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+            case ResourceState::DepthAttachment:
+                return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+            case ResourceState::FragmentShaderRead: return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, readLayout};
+            case ResourceState::ComputeShaderRead: return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, readLayout};
+            case ResourceState::ComputeShaderWrite: return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+        }
+        SG_ASSERT_INTERNAL("Invalid ResourceState!");
+        return {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED};
+    }
+
+    VulkanRenderCommandBuffer::VulkanRenderCommandBuffer(bool createFromSwapchain, Uint size, bool secondary)
+        : mCreatedFromSwapchain(createFromSwapchain), mSecondary(secondary)
     {
         SCOPED_TIMER("RenderCommandBuffer Creation");
+        SG_ASSERT(!(createFromSwapchain && secondary), "The swapchain command buffers are primary command buffers!");
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         VulkanDevice* vulkanDevice = renderContext->GetDevice();
@@ -26,7 +58,7 @@ namespace Surge
             // Command Buffers
             VkCommandBufferAllocateInfo commandBufferAllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
             commandBufferAllocateInfo.commandPool = mCommandPool;
-            commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            commandBufferAllocateInfo.level = mSecondary ? VK_COMMAND_BUFFER_LEVEL_SECONDARY : VK_COMMAND_BUFFER_LEVEL_PRIMARY;
             Uint finalSize = size;
             if (finalSize == 0)
             {
@@ -39,6 +71,10 @@ namespace Surge
 
             VK_CALL(vkAllocateCommandBuffers(logicalDevice, &commandBufferAllocateInfo, mCommandBuffers.data()));
 
+            // Secondary command buffers are executed by a primary one, which owns the fences
+            if (mSecondary)
+                return;
+
             // Sync Objects
             VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
             fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
@@ -75,6 +111,7 @@ namespace Surge
 
     void VulkanRenderCommandBuffer::BeginRecording()
     {
+        SG_ASSERT(!mSecondary, "Secondary command buffers must be recorded inside of a render pass!");
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         VkDevice logicalDevice = renderContext->GetDevice()->GetLogicalDevice();
@@ -91,6 +128,43 @@ namespace Surge
         vkBeginCommandBuffer(commandBuffer, &cmdBufInfo);
     }
 
+    void VulkanRenderCommandBuffer::BeginRecording(const Ref<Framebuffer>& framebuffer)
+    {
+        SG_ASSERT(mSecondary, "Only secondary command buffers can continue a render pass!");
+        VulkanRenderContext* renderContext = nullptr;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        Uint frameIndex = renderContext->GetFrameIndex();
+        Ref<VulkanFramebuffer> vulkanFramebuffer = framebuffer.As<VulkanFramebuffer>();
+
+        VkCommandBufferInheritanceInfo inheritanceInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+        inheritanceInfo.renderPass = vulkanFramebuffer->GetVulkanRenderPass();
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = vulkanFramebuffer->GetVulkanFramebuffer();
+
+        // The pool is created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, beginning resets the command buffer of this frame
+        VkCommandBufferBeginInfo cmdBufInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        cmdBufInfo.pInheritanceInfo = &inheritanceInfo;
+
+        VkCommandBuffer commandBuffer = mCommandBuffers[frameIndex];
+        VK_CALL(vkBeginCommandBuffer(commandBuffer, &cmdBufInfo));
+
+        // Dynamic state is not inherited from the primary command buffer
+        const FramebufferSpecification& spec = framebuffer->GetSpecification();
+        VkViewport viewport = {};
+        viewport.width = float(spec.Width);
+        viewport.height = float(spec.Height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor = {};
+        scissor.extent = {spec.Width, spec.Height};
+        scissor.offset = {0, 0};
+
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    }
+
     void VulkanRenderCommandBuffer::EndRecording()
     {
         VulkanRenderContext* renderContext = nullptr;
@@ -101,6 +175,7 @@ namespace Surge
 
     void VulkanRenderCommandBuffer::Submit()
     {
+        SG_ASSERT(!mSecondary, "Secondary command buffers can't be submitted, execute them from a primary one!");
         if (mCreatedFromSwapchain)
             return;
 
@@ -109,11 +184,114 @@ namespace Surge
         VulkanDevice* vulkanDevice = renderContext->GetDevice();
         Uint frameIndex = renderContext->GetFrameIndex();
 
+        // The uploads of the frame are submitted first, the commands wait for them
+        VulkanUploadQueue* uploadQueue = renderContext->GetUploadQueue();
+        uploadQueue->Flush();
+        VkSemaphore uploadSemaphore = uploadQueue->GetSemaphore();
+        const uint64_t uploadValue = uploadQueue->GetSubmittedValue();
+        const VkPipelineStageFlags uploadWaitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &uploadValue;
+
         VkSubmitInfo submitInfo {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &uploadSemaphore;
+        submitInfo.pWaitDstStageMask = &uploadWaitStage;
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &mCommandBuffers[frameIndex];
 
         VK_CALL(vkQueueSubmit(vulkanDevice->GetGraphicsQueue(), 1, &submitInfo, mWaitFences[frameIndex]));
     }
 
+    void VulkanRenderCommandBuffer::Execute(const Ref<RenderCommandBuffer>* secondaryBuffers, Uint count)
+    {
+        SG_ASSERT(!mSecondary, "Secondary command buffers can't execute other command buffers!");
+        if (!count)
+            return;
+
+        VulkanRenderContext* renderContext = nullptr;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        Uint frameIndex = renderContext->GetFrameIndex();
+
+        Vector<VkCommandBuffer> commandBuffers(count);
+        for (Uint i = 0; i < count; i++)
+        {
+            SG_ASSERT(secondaryBuffers[i]->IsSecondary(), "Only secondary command buffers can be executed!");
+            commandBuffers[i] = secondaryBuffers[i].As<VulkanRenderCommandBuffer>()->GetVulkanCommandBuffer(frameIndex);
+        }
+
+        vkCmdExecuteCommands(mCommandBuffers[frameIndex], count, commandBuffers.data());
+    }
+
+    void VulkanRenderCommandBuffer::InsertBarriers(const ResourceBarriers& barriers)
+    {
+        if (barriers.Empty())
+            return;
+
+        VulkanRenderContext* renderContext = nullptr;
+        SURGE_GET_VULKAN_CONTEXT(renderContext);
+        Uint frameIndex = renderContext->GetFrameIndex();
+
+        VkPipelineStageFlags srcStageMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+
+        Vector<VkImageMemoryBarrier> imageBarriers;
+        imageBarriers.reserve(barriers.Images.size());
+        for (const ImageBarrier& barrier : barriers.Images)
+        {
+            Ref<VulkanImage2D> image = barrier.Image.As<VulkanImage2D>();
+            const ImageSpecification& spec = image->GetSpecification();
+            const bool depthImage = VulkanUtils::IsDepthFormat(spec.Format);
+            const VulkanResourceState before = GetVulkanResourceState(barrier.Before, depthImage);
+            const VulkanResourceState after = GetVulkanResourceState(barrier.After, depthImage);
+
+            VkImageMemoryBarrier& imageBarrier = imageBarriers.emplace_back();
+            imageBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            imageBarrier.srcAccessMask = before.Access;
+            imageBarrier.dstAccessMask = after.Access;
+            imageBarrier.oldLayout = barrier.Discard ? VK_IMAGE_LAYOUT_UNDEFINED : before.Layout;
+            imageBarrier.newLayout = after.Layout;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.image = image->GetVulkanImage();
+            imageBarrier.subresourceRange.aspectMask = depthImage ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+            if (spec.Format == ImageFormat::Depth24Stencil8)
+                imageBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+            imageBarrier.subresourceRange.levelCount = spec.Mips;
+            imageBarrier.subresourceRange.layerCount = 1;
+
+            srcStageMask |= before.Stage;
+            dstStageMask |= after.Stage;
+        }
+
+        Vector<VkBufferMemoryBarrier> bufferBarriers;
+        bufferBarriers.reserve(barriers.Buffers.size());
+        for (const BufferBarrier& barrier : barriers.Buffers)
+        {
+            const VkDescriptorBufferInfo& bufferInfo = barrier.Buffer.As<VulkanStorageBuffer>()->GetVulkanDescriptorBufferInfo();
+            const VulkanResourceState before = GetVulkanResourceState(barrier.Before, false);
+            const VulkanResourceState after = GetVulkanResourceState(barrier.After, false);
+
+            VkBufferMemoryBarrier& bufferBarrier = bufferBarriers.emplace_back();
+            bufferBarrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            bufferBarrier.srcAccessMask = before.Access;
+            bufferBarrier.dstAccessMask = after.Access;
+            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            bufferBarrier.buffer = bufferInfo.buffer;
+            bufferBarrier.offset = bufferInfo.offset;
+            bufferBarrier.size = bufferInfo.range;
+
+            srcStageMask |= before.Stage;
+            dstStageMask |= after.Stage;
+        }
+
+        vkCmdPipelineBarrier(mCommandBuffers[frameIndex], srcStageMask, dstStageMask, 0, 0, nullptr,
+                             static_cast<Uint>(bufferBarriers.size()), bufferBarriers.data(),
+                             static_cast<Uint>(imageBarriers.size()), imageBarriers.data());
+    }
+
 } // namespace Surge
@@ -10,18 +10,23 @@ namespace Surge
     class SURGE_API VulkanRenderCommandBuffer : public RenderCommandBuffer
     {
     public:
-        VulkanRenderCommandBuffer(bool createFromSwapchain, Uint size = 0);
+        VulkanRenderCommandBuffer(bool createFromSwapchain, Uint size = 0, bool secondary = false);
         virtual ~VulkanRenderCommandBuffer() override;
 
         virtual void BeginRecording() override;
+        virtual void BeginRecording(const Ref<Framebuffer>& framebuffer) override;
         virtual void EndRecording() override;
         virtual void Submit() override;
+        virtual void Execute(const Ref<RenderCommandBuffer>* secondaryBuffers, Uint count) override;
+        virtual bool IsSecondary() const override { return mSecondary; }
+        virtual void InsertBarriers(const ResourceBarriers& barriers) override;
 
         VkCommandPool GetVulkanCommandPool() const { return mCommandPool; }
         VkCommandBuffer GetVulkanCommandBuffer(Uint index) const { return mCommandBuffers[index]; }
 
     private:
         bool mCreatedFromSwapchain;
+        bool mSecondary;
         VkCommandPool mCommandPool {};
         Vector<VkCommandBuffer> mCommandBuffers {};
 
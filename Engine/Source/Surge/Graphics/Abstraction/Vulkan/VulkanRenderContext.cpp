@@ -1,6 +1,7 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderContext.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDiagnostics.hpp"
+#include "Surge/Graphics/Shader/ReflectionData.hpp"
 
 // clang-format off
 #define FORCE_VALIDATION 0    
@@ -51,11 +52,13 @@ namespace Surge
         mDevice.Initialize(mVulkanInstance);
         mSwapChain.Initialize(window);
         mMemoryAllocator.Initialize(mVulkanInstance, mDevice);
+        mPipelineCache.Initialize(mDevice);
+        mUploadQueue.Initialize(mDevice, mMemoryAllocator);
 
         if (mImGuiEnabled)
             mImGuiContext.Initialize(this);
 
-        CreateDescriptorPools();
+        CreateDescriptorAllocators();
 
         // Fill In GPUInfo
         mGPUInfo.Name = mDevice.GetProperties().vk10Properties.properties.deviceName;
@@ -67,11 +70,24 @@ namespace Surge
         SURGE_PROFILE_FUNC("VulkanRenderContext::BeginFrame()");
 
         mSwapChain.BeginFrame();
+        mUploadQueue.BeginFrame();
         if (mImGuiEnabled)
             mImGuiContext.BeginFrame();
 
-        // Reset the descriptor pool
-        VK_CALL(vkResetDescriptorPool(mDevice.GetLogicalDevice(), mDescriptorPools[mSwapChain.GetCurrentFrameIndex()], 0));
+        // The stats of the frame that ended, the counters start over for this one
+        mDescriptorStats.AllocatedSets = mDescriptorAllocator.GetFrameAllocations() + mBindlessDescriptorAllocator.GetFrameAllocations();
+        mDescriptorStats.CacheHits = mDescriptorCache.GetFrameHits();
+        mDescriptorStats.CacheMisses = mDescriptorCache.GetFrameMisses();
+        mDescriptorStats.WrittenDescriptors = mWrittenDescriptors;
+        mDescriptorStats.CachedSets = mDescriptorCache.GetSetCount();
+        mDescriptorStats.CachedLayouts = mDescriptorCache.GetLayoutCount();
+        mDescriptorStats.PoolCount = mDescriptorAllocator.GetPoolCount() + mBindlessDescriptorAllocator.GetPoolCount();
+        mDescriptorAllocator.ResetFrameStats();
+        mBindlessDescriptorAllocator.ResetFrameStats();
+        mDescriptorCache.ResetFrameStats();
+        mWrittenDescriptors = 0;
+
+        mDescriptorCache.Update(GetFrameCount());
     }
 
     void VulkanRenderContext::EndFrame()
@@ -91,12 +107,12 @@ namespace Surge
         if (mImGuiEnabled)
             mImGuiContext.Destroy();
 
-        // Destroy the descriptor pools
-        for (VkDescriptorPool& pool : mDescriptorPools)
-            vkDestroyDescriptorPool(device, pool, nullptr);
-        for (VkDescriptorPool& pool : mNonResetableDescriptorPools)
-            vkDestroyDescriptorPool(device, pool, nullptr);
+        mDescriptorCache.Destroy();
+        mDescriptorAllocator.Destroy();
+        mBindlessDescriptorAllocator.Destroy();
 
+        mPipelineCache.Destroy(mDevice);
+        mUploadQueue.Destroy();
         mMemoryAllocator.Destroy();
         mSwapChain.Destroy();
         ENABLE_IF_VK_VALIDATION(mVulkanDiagnostics.EndDiagnostics(mVulkanInstance));
@@ -143,40 +159,31 @@ namespace Surge
         return instanceLayers;
     }
 
-    void VulkanRenderContext::CreateDescriptorPools()
+    void VulkanRenderContext::CreateDescriptorAllocators()
     {
-        VkDescriptorPoolSize poolSizes[] =
-            {{VK_DESCRIPTOR_TYPE_SAMPLER, 10000},
-             {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 10000},
-             {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 10000},
-             {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 10000},
-             {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 10000},
-             {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 10000},
-             {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 10000},
-             {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 10000},
-             {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 10000},
-             {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 10000},
-             {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 10000}};
-
-        VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-        poolInfo.maxSets = 100 * (sizeof(poolSizes) / sizeof(VkDescriptorPoolSize));
-        poolInfo.poolSizeCount = (Uint)(sizeof(poolSizes) / sizeof(VkDescriptorPoolSize));
-        poolInfo.pPoolSizes = poolSizes;
-
-        mDescriptorPools.resize(FRAMES_IN_FLIGHT);
-        for (auto& descriptorPool : mDescriptorPools)
-        {
-            VK_CALL(vkCreateDescriptorPool(mDevice.GetLogicalDevice(), &poolInfo, nullptr, &descriptorPool));
-            SET_VK_OBJECT_DEBUGNAME(descriptorPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, "DescriptorPool");
-        }
-
-        mNonResetableDescriptorPools.resize(FRAMES_IN_FLIGHT);
-        for (auto& descriptorPool : mNonResetableDescriptorPools)
-        {
-            VK_CALL(vkCreateDescriptorPool(mDevice.GetLogicalDevice(), &poolInfo, nullptr, &descriptorPool));
-            SET_VK_OBJECT_DEBUGNAME(descriptorPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, "NonResetable DescriptorPool");
-        }
+        // Sized for the sets of a few dozen shaders, the allocator adds a pool when one is full
+        const Vector<VkDescriptorPoolSize> poolSizes =
+            {{VK_DESCRIPTOR_TYPE_SAMPLER, 256},
+             {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
+             {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 256},
+             {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 256},
+             {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 64},
+             {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 64},
+             {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 512},
+             {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 512},
+             {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 128},
+             {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 128},
+             {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 64}};
+        mDescriptorAllocator.Initialize(mDevice.GetLogicalDevice(), poolSizes, 1024, 0, "DescriptorPool");
+
+        // Sets with runtime arrays are few (one per frame in flight for the MaterialTable), but every one of them holds a whole array
+        const Vector<VkDescriptorPoolSize> bindlessPoolSizes =
+            {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, RUNTIME_DESCRIPTOR_ARRAY_SIZE * FRAMES_IN_FLIGHT * 2},
+             {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16 * FRAMES_IN_FLIGHT},
+             {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 * FRAMES_IN_FLIGHT}};
+        mBindlessDescriptorAllocator.Initialize(mDevice.GetLogicalDevice(), bindlessPoolSizes, 2 * FRAMES_IN_FLIGHT, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT, "Bindless DescriptorPool");
+
+        mDescriptorCache.Initialize(mDevice.GetLogicalDevice(), &mDescriptorAllocator);
     }
 
 } // namespace Surge
@@ -1,10 +1,13 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanDescriptorCache.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDevice.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDiagnostics.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanImGuiContext.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanMemoryAllocator.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanPipelineCache.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanSwapChain.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanUploadQueue.hpp"
 #include "Surge/Graphics/RenderContext.hpp"
 #include <volk.h>
 
@@ -23,16 +26,24 @@ namespace Surge
         virtual void RenderImGui() override;
 
         Uint GetFrameIndex() const override { return mSwapChain.GetCurrentFrameIndex(); }
+        virtual uint64_t GetFrameCount() const override { return mSwapChain.GetFrameCount(); }
         virtual GPUMemoryStats GetMemoryStatus() const override { return mMemoryAllocator.GetStats(); };
         virtual GPUInfo GetGPUInfo() const override { return mGPUInfo; }
+        virtual PipelineStats GetPipelineStats() const override { return mPipelineCache.GetStats(); }
+        virtual DescriptorStats GetDescriptorStats() const override { return mDescriptorStats; }
+        virtual UploadStats GetUploadStats() const override { return mUploadQueue.GetStats(); }
 
         VkInstance GetInstance() const { return mVulkanInstance; }
         VulkanDevice* GetDevice() { return &mDevice; }
         VulkanSwapChain* GetSwapChain() { return &mSwapChain; }
         VulkanMemoryAllocator* GetMemoryAllocator() { return &mMemoryAllocator; }
+        VulkanPipelineCache* GetPipelineCache() { return &mPipelineCache; }
+        VulkanUploadQueue* GetUploadQueue() { return &mUploadQueue; }
 
-        const Vector<VkDescriptorPool>& GetDescriptorPools() const { return mDescriptorPools; }
-        const Vector<VkDescriptorPool>& GetNonResetableDescriptorPools() const { return mNonResetableDescriptorPools; }
+        VulkanDescriptorAllocator* GetDescriptorAllocator() { return &mDescriptorAllocator; }
+        VulkanDescriptorAllocator* GetBindlessDescriptorAllocator() { return &mBindlessDescriptorAllocator; } // For the sets of VulkanShader::IsBindlessSet
+        VulkanDescriptorCache* GetDescriptorCache() { return &mDescriptorCache; }
+        void AddWrittenDescriptors(Uint count) { mWrittenDescriptors += count; } // Counted in the DescriptorStats of the frame
 
         virtual void* GetImGuiTextureID(const Ref<Image2D>& image) const;
         virtual void* GetImGuiContext() { return mImGuiContext.GetContext(); }
@@ -40,7 +51,7 @@ namespace Surge
     private:
         Vector<const char*> GetRequiredInstanceExtensions();
         Vector<const char*> GetRequiredInstanceLayers();
-        void CreateDescriptorPools();
+        void CreateDescriptorAllocators();
 
     private:
         VkInstance mVulkanInstance = VK_NULL_HANDLE;
@@ -48,12 +59,17 @@ namespace Surge
         VulkanDevice mDevice {};
         VulkanSwapChain mSwapChain {};
         VulkanMemoryAllocator mMemoryAllocator {};
+        VulkanPipelineCache mPipelineCache {};
+        VulkanUploadQueue mUploadQueue;
         VulkanImGuiContext mImGuiContext;
         bool mImGuiEnabled;
 
-        // Descriptor Pools
-        Vector<VkDescriptorPool> mDescriptorPools;
-        Vector<VkDescriptorPool> mNonResetableDescriptorPools;
+        // Descriptors
+        VulkanDescriptorAllocator mDescriptorAllocator;
+        VulkanDescriptorAllocator mBindlessDescriptorAllocator;
+        VulkanDescriptorCache mDescriptorCache;
+        DescriptorStats mDescriptorStats; // Of the last frame
+        Uint mWrittenDescriptors = 0;
 
         GPUInfo mGPUInfo;
         friend class SURGE_API VulkanImGuiContext;
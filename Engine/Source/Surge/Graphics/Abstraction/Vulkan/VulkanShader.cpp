@@ -3,6 +3,7 @@
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDevice.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanDiagnostics.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanUtils.hpp"
+#include "Surge/Core/Hash.hpp"
 #include "Surge/Utility/Filesystem.hpp"
 #include <shaderc/shaderc.hpp>
 #include <filesystem>
@@ -15,6 +16,35 @@
 
 namespace Surge
 {
+    namespace
+    {
+        shaderc::CompileOptions GetCompileOptions()
+        {
+            shaderc::CompileOptions options;
+            options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+
+            // NOTE(Rid - AC3R) If we enable optimization, it removes the name :kekCry:
+            // options.SetOptimizationLevel(shaderc_optimization_level_performance);
+            return options;
+        }
+
+        // Everything besides the source that changes the SPIR-V, must be kept in sync with GetCompileOptions()
+        uint64_t GetCompileOptionsHash()
+        {
+            Uint spirvVersion = 0, spirvRevision = 0;
+            shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+
+            const uint64_t values[] = {
+                static_cast<uint64_t>(shaderc_target_env_vulkan),
+                static_cast<uint64_t>(shaderc_env_version_vulkan_1_2),
+                static_cast<uint64_t>(shaderc_optimization_level_zero),
+                static_cast<uint64_t>(spirvVersion),
+                static_cast<uint64_t>(spirvRevision),
+            };
+            return Hash::GenerateFromBytes(values, sizeof(values));
+        }
+    } // namespace
+
     VulkanShader::VulkanShader(const Path& path)
         : mPath(path), mCreatedDescriptorSetLayouts(false)
     {
@@ -26,25 +56,17 @@ namespace Surge
         SG_ASSERT(mCallbacks.empty(), "Callbacks must be empty! Did you forgot to call 'RemoveReloadCallback(id);' somewhere?");
         Clear();
 
-        // DescriptorSetLayouts doesn't get recreated when the shader is reloaded, thus it is outside the Clear() function
-        VulkanRenderContext* renderContext;
-        SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
-        for (auto& descriptorSetLayout : mDescriptorSetLayouts)
-        {
-            if (descriptorSetLayout.second)
-                vkDestroyDescriptorSetLayout(device, descriptorSetLayout.second, nullptr);
-        }
+        // The DescriptorSetLayouts are owned by the VulkanDescriptorCache, other shaders may use them too
         mDescriptorSetLayouts.clear();
         mPushConstants.clear();
     }
 
-    void VulkanShader::Load(const HashMap<ShaderType, bool>& compileStages)
+    void VulkanShader::Load(const HashMap<ShaderType, bool>& compileStages, bool parallel)
     {
         SCOPED_TIMER("Shader({0}) Compilation", Filesystem::GetNameWithExtension(mPath));
         Clear();
         ParseShader();
-        Compile(compileStages);
+        Compile(compileStages, parallel);
 
         // We want to make sure that the DescriptorSetLayouts doesn't get recreated when the shader is reloaded
         if (!mCreatedDescriptorSetLayouts)
@@ -79,23 +101,26 @@ namespace Surge
         SG_ASSERT_INTERNAL("Invalid UUID!");
     }
 
-    void VulkanShader::Compile(const HashMap<ShaderType, bool>& compileStages)
+    void VulkanShader::Compile(const HashMap<ShaderType, bool>& compileStages, bool parallel)
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
 
-        shaderc::Compiler compiler;
-        shaderc::CompileOptions options;
-        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
-        bool saveHash = false;
-
-        // NOTE(Rid - AC3R) If we enable optimization, it removes the name :kekCry:
-        // options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
+        Vector<ShaderType> stages;
+        stages.reserve(mShaderSources.size());
         for (auto&& [stage, source] : mShaderSources)
-        {
-            SPIRVHandle spirvHandle;
+            stages.push_back(stage);
+
+        // Every stage is compiled (or loaded from the cache) and turned into a VkShaderModule on its own worker,
+        // so the shader takes as long as its slowest stage instead of the sum of all of them.
+        // A grain size covering every stage makes a single chunk, which the ParallelFor runs on the calling thread
+        Vector<VkShaderModule> shaderModules(stages.size(), VK_NULL_HANDLE);
+        mShaderSPIRVs.resize(stages.size());
+        const size_t grainSize = parallel ? 0 : stages.size();
+        Core::GetThreadPool()->ParallelFor<size_t>(0, stages.size(), [&](size_t i) {
+            const ShaderType stage = stages[i];
+            SPIRVHandle& spirvHandle = mShaderSPIRVs[i];
             spirvHandle.Type = stage;
             bool compile = true; // Default is "true", shader should be compiled if not specified in compileStages
 
@@ -105,14 +130,18 @@ namespace Surge
             {
                 auto itr = compileStages.find(stage);
                 if (itr != compileStages.end())
-                    compile = compileStages.at(stage);
+                    compile = itr->second;
             }
 
             // Load or create the SPIRV
             if (compile)
             {
+                // A Compiler per stage, creating one is nothing compared to a compilation and they don't have to be shared between threads
+                shaderc::Compiler compiler;
+                const shaderc::CompileOptions options = GetCompileOptions();
+
                 // Compile, not present in cache
-                shaderc::CompilationResult result = compiler.CompileGlslToSpv(source, VulkanUtils::ShadercShaderKindFromSurgeShaderType(stage), mPath, options);
+                shaderc::CompilationResult result = compiler.CompileGlslToSpv(mShaderSources.at(stage), VulkanUtils::ShadercShaderKindFromSurgeShaderType(stage), mPath, options);
                 if (result.GetCompilationStatus() != shaderc_compilation_status_success)
                 {
                     Log<Severity::Error>("{0} Shader compilation failure!", VulkanUtils::ShaderTypeToString(stage));
@@ -135,10 +164,13 @@ namespace Surge
             VkShaderModuleCreateInfo createInfo {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
             createInfo.codeSize = spirvHandle.SPIRV.size() * sizeof(Uint);
             createInfo.pCode = spirvHandle.SPIRV.data();
-            VK_CALL(vkCreateShaderModule(device, &createInfo, nullptr, &mVkShaderModules[stage]));
-            SET_VK_OBJECT_DEBUGNAME(mVkShaderModules.at(stage), VK_OBJECT_TYPE_SHADER_MODULE, "Vulkan Shader");
-            mShaderSPIRVs.push_back(spirvHandle);
-        }
+            VK_CALL(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModules[i]));
+            SET_VK_OBJECT_DEBUGNAME(shaderModules[i], VK_OBJECT_TYPE_SHADER_MODULE, "Vulkan Shader");
+        }, grainSize);
+
+        for (size_t i = 0; i < stages.size(); i++)
+            mVkShaderModules[stages[i]] = shaderModules[i];
+
         if (mShaderSources.empty())
         {
             for (auto& dir : std::filesystem::directory_iterator(SHADER_CACHE_PATH))
@@ -199,14 +231,15 @@ namespace Surge
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
+        VulkanDescriptorCache* descriptorCache = renderContext->GetDescriptorCache();
 
-        // Iterate through all the sets and creating the layouts
+        // Iterate through all the sets and creating the layouts, shaders with the same bindings in a set share its layout
         const Vector<Uint>& descriptorSetCount = mReflectionData.GetDescriptorSets();
 
         for (const Uint& descriptorSet : descriptorSetCount)
         {
             Vector<VkDescriptorSetLayoutBinding> layoutBindings;
+            Vector<VkDescriptorBindingFlags> bindingFlags;
             for (const ShaderBuffer& buffer : mReflectionData.GetBuffers())
             {
                 if (buffer.Set != descriptorSet)
@@ -214,9 +247,10 @@ namespace Surge
 
                 VkDescriptorSetLayoutBinding& layoutBinding = layoutBindings.emplace_back();
                 layoutBinding.binding = buffer.Binding;
-                layoutBinding.descriptorCount = 1; // TODO: Need to add arrays
+                layoutBinding.descriptorCount = 1;
                 layoutBinding.descriptorType = VulkanUtils::ShaderBufferTypeToVulkan(buffer.ShaderUsage);
                 layoutBinding.stageFlags = VulkanUtils::GetShaderStagesFlagsFromShaderTypes(buffer.ShaderStages) | VK_SHADER_STAGE_ALL;
+                bindingFlags.push_back(0);
             }
 
             for (const ShaderResource& texture : mReflectionData.GetResources())
@@ -226,17 +260,22 @@ namespace Surge
 
                 VkDescriptorSetLayoutBinding& LayoutBinding = layoutBindings.emplace_back();
                 LayoutBinding.binding = texture.Binding;
-                LayoutBinding.descriptorCount = 1; // TODO: Need to add arrays
+                LayoutBinding.descriptorCount = texture.Count;
                 LayoutBinding.descriptorType = VulkanUtils::ShaderImageUsageToVulkan(texture.ShaderUsage);
                 LayoutBinding.stageFlags = VulkanUtils::GetShaderStagesFlagsFromShaderTypes(texture.ShaderStages) | VK_SHADER_STAGE_ALL;
-            }
+                bindingFlags.push_back(0);
 
-            VkDescriptorSetLayoutCreateInfo layoutInfo {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-            layoutInfo.flags = 0;
-            layoutInfo.bindingCount = static_cast<Uint>(layoutBindings.size());
-            layoutInfo.pBindings = layoutBindings.data();
+                // Runtime arrays are bindless, only the descriptors that are used need to be valid and they can be written while the set is in use
+                if (texture.Count == 0)
+                {
+                    LayoutBinding.descriptorCount = RUNTIME_DESCRIPTOR_ARRAY_SIZE;
+                    bindingFlags.back() = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+                    mBindlessDescriptorSets.insert(descriptorSet);
+                }
+            }
 
-            VK_CALL(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &mDescriptorSetLayouts[descriptorSet]));
+            const VkDescriptorSetLayoutCreateFlags flags = IsBindlessSet(descriptorSet) ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0;
+            mDescriptorSetLayouts[descriptorSet] = descriptorCache->GetLayout(layoutBindings, bindingFlags, flags);
         }
         mCreatedDescriptorSetLayouts = true;
     }
@@ -254,6 +293,7 @@ namespace Surge
 
     void VulkanShader::ParseShader()
     {
+        static const uint64_t compileOptionsHash = GetCompileOptionsHash();
         String source = Filesystem::ReadFile<String>(mPath);
 
         const char* typeToken = "[SurgeShader:";
@@ -270,7 +310,10 @@ namespace Surge
             SG_ASSERT((int)shaderType, "Invalid shader type!");
             pos = source.find(typeToken, nextLinePos);
             mShaderSources[shaderType] = (pos == std::string::npos) ? source.substr(nextLinePos) : source.substr(nextLinePos, pos - nextLinePos);
-            mHashCodes[shaderType] = Hash().Generate<String>(mShaderSources.at(shaderType));
+
+            // The shader cache key, the SPIR-V only changes if the source or the way it is compiled changes
+            const String& stageSource = mShaderSources.at(shaderType);
+            mHashCodes[shaderType] = static_cast<HashCode>(Hash::Combine(Hash::GenerateFromBytes(stageSource.data(), stageSource.size()), compileOptionsHash));
             mTypesBit |= shaderType;
         }
     }
@@ -3,6 +3,7 @@
 #include "Surge/Graphics/Shader/Shader.hpp"
 #include "Surge/Graphics/Shader/ShaderReflector.hpp"
 #include <volk.h>
+#include <set>
 
 namespace Surge
 {
@@ -12,7 +13,7 @@ namespace Surge
         VulkanShader(const Path& path);
         virtual ~VulkanShader() override;
 
-        virtual void Load(const HashMap<ShaderType, bool>& compileStages = {}) override;
+        virtual void Load(const HashMap<ShaderType, bool>& compileStages = {}, bool parallel = true) override;
         virtual void Reload() override;
         virtual UUID AddReloadCallback(const std::function<void()> callback) override;
         virtual void RemoveReloadCallback(const UUID& id);
@@ -29,8 +30,11 @@ namespace Surge
         const std::map<Uint, VkDescriptorSetLayout>& GetDescriptorSetLayouts() const { return mDescriptorSetLayouts; }
         const HashMap<String, VkPushConstantRange>& GetPushConstantRanges() const { return mPushConstants; }
 
+        // The set has a runtime array, its descriptor sets must come from VulkanRenderContext::GetBindlessDescriptorAllocator
+        bool IsBindlessSet(Uint set) const { return mBindlessDescriptorSets.find(set) != mBindlessDescriptorSets.end(); }
+
         void ParseShader();
-        void Compile(const HashMap<ShaderType, bool>& compileStages);
+        void Compile(const HashMap<ShaderType, bool>& compileStages, bool parallel);
         void Clear();
         void CreateVulkanDescriptorSetLayouts();
         void CreateVulkanPushConstantRanges();
@@ -44,6 +48,7 @@ namespace Surge
 
         HashMap<ShaderType, VkShaderModule> mVkShaderModules;
         std::map<Uint, VkDescriptorSetLayout> mDescriptorSetLayouts;
+        std::set<Uint> mBindlessDescriptorSets;
 
         HashMap<String, VkPushConstantRange> mPushConstants;
         ShaderType mTypesBit;
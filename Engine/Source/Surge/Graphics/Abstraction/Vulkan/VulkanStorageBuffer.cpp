@@ -4,8 +4,8 @@
 
 namespace Surge
 {
-    VulkanStorageBuffer::VulkanStorageBuffer(Uint size, GPUMemoryUsage memoryUsage)
-        : mSize(size), mMemoryUsage(memoryUsage)
+    VulkanStorageBuffer::VulkanStorageBuffer(Uint size, GPUMemoryUsage memoryUsage, bool indirectArguments)
+        : mSize(size), mMemoryUsage(memoryUsage), mIndirectArguments(indirectArguments)
     {
         Invalidate();
     }
@@ -17,24 +17,27 @@ namespace Surge
 
     void VulkanStorageBuffer::SetData(const Buffer& data, Uint offset) const
     {
-        VulkanRenderContext* renderContext;
-        SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = renderContext->GetMemoryAllocator();
-
-        void* mappedData = allocator->MapMemory(mAllocation);
-        memcpy(mappedData, (const Byte*)data.Data + offset, mSize);
-        allocator->UnmapMemory(mAllocation);
+        SetData(data.Data, offset);
     }
 
     void VulkanStorageBuffer::SetData(const void* data, Uint offset) const
     {
-        VulkanRenderContext* renderContext;
-        SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = renderContext->GetMemoryAllocator();
+        SG_ASSERT(mMappedData, "Cannot write to a StorageBuffer that isn't visible to the CPU!");
+        const VkDescriptorBufferInfo& region = GetVulkanDescriptorBufferInfo();
+        memcpy(mMappedData + region.offset, (const Byte*)data + offset, mSize);
+    }
+
+    void VulkanStorageBuffer::SetDataRange(const void* data, Uint size, Uint bufferOffset) const
+    {
+        SG_ASSERT(mMappedData, "Cannot write to a StorageBuffer that isn't visible to the CPU!");
+        SG_ASSERT(bufferOffset + size <= mSize, "Write is out of the bounds of the StorageBuffer!");
+        const VkDescriptorBufferInfo& region = GetVulkanDescriptorBufferInfo();
+        memcpy(mMappedData + region.offset + bufferOffset, data, size);
+    }
 
-        void* mappedData = allocator->MapMemory(mAllocation);
-        memcpy(mappedData, (const Byte*)data + offset, mSize);
-        allocator->UnmapMemory(mAllocation);
+    const VkDescriptorBufferInfo& VulkanStorageBuffer::GetVulkanDescriptorBufferInfo() const
+    {
+        return IsPerFrame() ? mDescriptorInfos[Core::GetRenderContext()->GetFrameIndex()] : mDescriptorInfos[0];
     }
 
     void VulkanStorageBuffer::Resize(Uint newSize)
@@ -49,22 +52,32 @@ namespace Surge
         VulkanRenderContext* renderContext;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
 
-        VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-        allocInfo.pNext = nullptr;
-        allocInfo.allocationSize = 0;
-        allocInfo.memoryTypeIndex = 0;
+        const VkDeviceSize alignment = renderContext->GetDevice()->GetProperties().vk10Properties.properties.limits.minStorageBufferOffsetAlignment;
+        const VkDeviceSize alignedSize = (mSize + alignment - 1) & ~(alignment - 1);
+        const Uint regionCount = IsPerFrame() ? FRAMES_IN_FLIGHT : 1;
 
         VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
         bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-        bufferInfo.size = mSize;
+        if (mIndirectArguments)
+            bufferInfo.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        bufferInfo.size = alignedSize * regionCount;
 
-        mAllocation = renderContext->GetMemoryAllocator()->AllocateBuffer(bufferInfo, SurgeMemoryUsageToVmaMemoryUsage(mMemoryUsage), mVulkanBuffer, nullptr);
+        // GPU only memory can't be mapped
+        VmaAllocationInfo allocationInfo = {};
+        const bool hostVisible = mMemoryUsage != GPUMemoryUsage::GPUOnly && mMemoryUsage != GPUMemoryUsage::GPULazilyAllocated;
+        VulkanMemoryAllocator* allocator = renderContext->GetMemoryAllocator();
+        mAllocation = allocator->AllocateBuffer(bufferInfo, SurgeMemoryUsageToVmaMemoryUsage(mMemoryUsage), mVulkanBuffer, hostVisible ? &allocationInfo : nullptr);
+        mMappedData = static_cast<Byte*>(allocationInfo.pMappedData);
         SET_VK_OBJECT_DEBUGNAME(mVulkanBuffer, VK_OBJECT_TYPE_BUFFER, "Storage Buffer");
 
-        // Update Descriptor info
-        mDescriptorInfo.buffer = mVulkanBuffer;
-        mDescriptorInfo.range = mSize;
-        mDescriptorInfo.offset = 0;
+        // Update Descriptor infos
+        mDescriptorInfos.resize(regionCount);
+        for (Uint i = 0; i < regionCount; i++)
+        {
+            mDescriptorInfos[i].buffer = mVulkanBuffer;
+            mDescriptorInfos[i].range = mSize;
+            mDescriptorInfos[i].offset = alignedSize * i;
+        }
     }
 
     void VulkanStorageBuffer::Release()
@@ -79,6 +92,7 @@ namespace Surge
 
         mVulkanBuffer = VK_NULL_HANDLE;
         mAllocation = VK_NULL_HANDLE;
+        mMappedData = nullptr;
     }
 
 } // namespace Surge
@@ -6,30 +6,38 @@
 
 namespace Surge
 {
+    // Host visible storage buffers stay mapped for their whole lifetime.
+    // GPUMemoryUsage::CPUToGPU buffers are written by the CPU every frame, they get one region per frame in flight (see VulkanUniformBuffer),
+    // every other usage keeps a single region
     class SURGE_API VulkanStorageBuffer : public StorageBuffer
     {
     public:
-        VulkanStorageBuffer(Uint size, GPUMemoryUsage memoryUsage);
+        VulkanStorageBuffer(Uint size, GPUMemoryUsage memoryUsage, bool indirectArguments = false);
         virtual ~VulkanStorageBuffer() override;
 
         virtual void SetData(const void* data, Uint offset = 0) const override;
         virtual void SetData(const Buffer& data, Uint offset = 0) const override;
+        virtual void SetDataRange(const void* data, Uint size, Uint bufferOffset = 0) const override;
         virtual Uint GetSize() const override { return mSize; }
         virtual void Resize(Uint newSize) override;
 
         const VkBuffer& GetVulkanBuffer() const { return mVulkanBuffer; }
-        const VkDescriptorBufferInfo& GetVulkanDescriptorBufferInfo() const { return mDescriptorInfo; }
+        const VkDescriptorBufferInfo& GetVulkanDescriptorBufferInfo() const;
 
     private:
         void Invalidate();
         void Release();
 
+        bool IsPerFrame() const { return mMemoryUsage == GPUMemoryUsage::CPUToGPU; }
+
     private:
         Uint mSize;
         GPUMemoryUsage mMemoryUsage;
+        bool mIndirectArguments;
         VkBuffer mVulkanBuffer = VK_NULL_HANDLE;
         VmaAllocation mAllocation = VK_NULL_HANDLE;
-        VkDescriptorBufferInfo mDescriptorInfo {};
+        Byte* mMappedData = nullptr; // nullptr if the memory isn't host visible
+        Vector<VkDescriptorBufferInfo> mDescriptorInfos; // One per region
     };
 
 } // namespace Surge
\ No newline at end of file
@@ -326,11 +326,22 @@ namespace Surge
         SURGE_GET_VULKAN_CONTEXT(renderContext);
         VulkanDevice* device = renderContext->GetDevice();
 
-        VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        // Waits for the uploads too, the value given for the binary semaphore is ignored
+        VulkanUploadQueue* uploadQueue = renderContext->GetUploadQueue();
+        uploadQueue->Flush();
+        const VkSemaphore waitSemaphores[] = {mImageAvailable, uploadQueue->GetSemaphore()};
+        const uint64_t waitValues[] = {0, uploadQueue->GetSubmittedValue()};
+        const VkPipelineStageFlags waitStageMasks[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.waitSemaphoreValueCount = 2;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+
         VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-        submitInfo.pWaitDstStageMask = &waitStageMask;
-        submitInfo.pWaitSemaphores = &mImageAvailable;
-        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.pWaitDstStageMask = waitStageMasks;
+        submitInfo.pWaitSemaphores = waitSemaphores;
+        submitInfo.waitSemaphoreCount = 2;
         submitInfo.pSignalSemaphores = &mRenderAvailable;
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pCommandBuffers = &mCommandBuffers[mCurrentFrameIndex];
@@ -349,6 +360,7 @@ namespace Surge
         VK_CHECK_WITHOUT_OUT_OF_DATE(vkQueuePresentKHR(mPresentQueue, &presentInfo));
 
         mCurrentFrameIndex = (mCurrentFrameIndex + 1) % FRAMES_IN_FLIGHT;
+        mFrameCount++;
     }
 
     void VulkanSwapChain::EndFrame()
@@ -34,6 +34,7 @@ namespace Surge
         Vector<VkCommandBuffer> GetVulkanCommandBuffers() const { return mCommandBuffers; }
         Uint GetCurrentFrameIndex() const { return mCurrentFrameIndex; }
         Uint GetCurrentImageIndex() const { return mCurrentImageIndex; }
+        uint64_t GetFrameCount() const { return mFrameCount; }
 
     private:
         void Present();
@@ -54,6 +55,7 @@ namespace Surge
         Uint mImageCount;
         Uint mCurrentImageIndex = 0;
         Uint mCurrentFrameIndex = 0;
+        uint64_t mFrameCount = 0; // Frames presented since startup, never wraps around unlike mCurrentFrameIndex
 
         // Framebuffers + Renderpasses
         VkRenderPass mRenderPass;
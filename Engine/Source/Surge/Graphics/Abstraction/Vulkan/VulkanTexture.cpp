@@ -1,41 +1,25 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanTexture.hpp"
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanImage.hpp"
-#include <stb_image.h>
 
 namespace Surge
 {
-    VulkanTexture2D::VulkanTexture2D(const String& filepath, TextureSpecification specification) : mFilePath(filepath), mSpecification(specification)
+    VulkanTexture2D::VulkanTexture2D(const String& filepath, TextureSpecification specification)
+        : VulkanTexture2D(TextureData(filepath), specification)
     {
-        // Loading the texture
-        int width, height, channels;
-        ImageFormat imageFormat;
-        bool defaultFormat = false;
-        if (specification.Format == ImageFormat::None)
-            defaultFormat = true;
-        else
-        {
-            imageFormat = specification.Format;
-            defaultFormat = false;
-        }
-
-        if (stbi_is_hdr(filepath.c_str()))
-        {
-            mPixelData = (void*)stbi_loadf(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-            if (defaultFormat)
-                imageFormat = ImageFormat::RGBA32F;
-        }
-        else
-        {
-            mPixelData = (void*)stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-            if (defaultFormat)
-                imageFormat = ImageFormat::RGBA8;
-        }
-        SG_ASSERT(mPixelData, "Failed to load image!");
-        mWidth = width;
-        mHeight = height;
-        mPixelDataSize = VulkanUtils::GetMemorySize(imageFormat, width, height);
-        Uint mipChainLevels = CalculateMipChainLevels(width, height);
+        mFilePath = filepath;
+    }
+
+    VulkanTexture2D::VulkanTexture2D(const TextureData& data, TextureSpecification specification) : mSpecification(specification)
+    {
+        SG_ASSERT(data.IsValid(), "Failed to load image!");
+        const ImageFormat imageFormat = specification.Format == ImageFormat::None ? data.GetFormat() : specification.Format;
+
+        mPixelData = data.GetPixels();
+        mWidth = data.GetWidth();
+        mHeight = data.GetHeight();
+        mPixelDataSize = VulkanUtils::GetMemorySize(imageFormat, mWidth, mHeight);
+        Uint mipChainLevels = CalculateMipChainLevels(mWidth, mHeight);
 
         // Creating the image
         ImageSpecification imageSpec {};
@@ -49,7 +33,7 @@ namespace Surge
         mSpecification.Format = imageFormat;
 
         Invalidate();
-        stbi_image_free(mPixelData);
+        mPixelData = nullptr; // Owned by 'data'
     }
 
     VulkanTexture2D::VulkanTexture2D(ImageFormat format, Uint width, Uint height, void* data, TextureSpecification specification)
@@ -83,64 +67,24 @@ namespace Surge
     {
         mImage->Release();
         VulkanRenderContext* renderContext = static_cast<VulkanRenderContext*>(Core::GetRenderContext());
-        VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
-        VulkanDevice* device = renderContext->GetDevice();
+        VulkanUploadQueue* uploadQueue = renderContext->GetUploadQueue();
 
         ImageSpecification& imageSpec = mImage->GetSpecification();
         imageSpec.Format = mSpecification.Format;
         Ref<VulkanImage2D> image = mImage.As<VulkanImage2D>();
         image->Invalidate(); // ReCreate the image
 
-        VkDeviceSize size = mPixelDataSize;
+        VkImageSubresourceRange subresourceRange {};
+        subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        subresourceRange.baseMipLevel = 0;
+        subresourceRange.levelCount = imageSpec.Mips;
+        subresourceRange.layerCount = 1;
 
-        // Create staging buffer
-        VkBufferCreateInfo bufferCreateInfo {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-        bufferCreateInfo.size = size;
-        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        VkBuffer stagingBuffer;
-        VmaAllocation stagingBufferAllocation = allocator->AllocateBuffer(bufferCreateInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, stagingBuffer, nullptr);
-
-        // Copy data to staging buffer
-        void* destData = allocator->MapMemory(stagingBufferAllocation);
+        // Copies the pixels on the transfer queue, the image is left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
         SG_ASSERT(mPixelData, "Invalid pixel data!");
-        memcpy(destData, mPixelData, mPixelDataSize);
-        allocator->UnmapMemory(stagingBufferAllocation);
-
-        device->InstantSubmit(VulkanQueueType::Graphics, [&](VkCommandBuffer& cmd) {
-            VkImageSubresourceRange subresourceRange {};
-            subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            subresourceRange.baseMipLevel = 0;
-            subresourceRange.levelCount = imageSpec.Mips;
-            subresourceRange.layerCount = 1;
-
-            // Transition the texture image layout to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-            // VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-            VkImageMemoryBarrier imageMemoryBarrier {};
-            imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.image = image->GetVulkanImage();
-            imageMemoryBarrier.subresourceRange = subresourceRange;
-            imageMemoryBarrier.srcAccessMask = 0;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-            VkBufferImageCopy bufferCopyRegion = {};
-            bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            bufferCopyRegion.imageSubresource.mipLevel = 0;
-            bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-            bufferCopyRegion.imageSubresource.layerCount = 1;
-            bufferCopyRegion.imageExtent.width = mWidth;
-            bufferCopyRegion.imageExtent.height = mHeight;
-            bufferCopyRegion.imageExtent.depth = 1;
-            bufferCopyRegion.bufferOffset = 0;
-
-            // Copy data from staging buffer, the image is in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-            vkCmdCopyBufferToImage(cmd, stagingBuffer, image->GetVulkanImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferCopyRegion);
+        uploadQueue->UploadImage(image->GetVulkanImage(), mPixelData, mPixelDataSize, mWidth, mHeight, subresourceRange);
 
+        uploadQueue->RecordGraphics([&](VkCommandBuffer cmd) {
             if (!mSpecification.UseMips)
             {
                 // VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
@@ -156,7 +100,6 @@ namespace Surge
                                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, subresourceRange);
             }
         });
-        allocator->DestroyBuffer(stagingBuffer, stagingBufferAllocation);
 
         if (mSpecification.UseMips)
             GenerateMips();
@@ -166,13 +109,12 @@ namespace Surge
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanDevice* device = renderContext->GetDevice();
-        VkDevice logicalDevice = device->GetLogicalDevice();
 
         Ref<VulkanImage2D> image = mImage.As<VulkanImage2D>();
         ImageSpecification& imageSpec = mImage->GetSpecification();
 
-        device->InstantSubmit(VulkanQueueType::Graphics, [&](VkCommandBuffer& cmd) {
+        // Blits need the graphics queue, they run after the copy of the batch
+        renderContext->GetUploadQueue()->RecordGraphics([&](VkCommandBuffer cmd) {
             VkImage& vulkanImage = image->GetVulkanImage();
             VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
             barrier.image = vulkanImage;
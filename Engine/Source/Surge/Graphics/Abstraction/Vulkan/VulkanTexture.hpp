@@ -8,6 +8,7 @@ namespace Surge
     {
     public:
         VulkanTexture2D(const String& filepath, TextureSpecification specification = {});
+        VulkanTexture2D(const TextureData& data, TextureSpecification specification = {});
         VulkanTexture2D(ImageFormat format, Uint width, Uint height, void* data = nullptr, TextureSpecification specification = {});
 
         virtual ~VulkanTexture2D() override;
@@ -17,24 +17,19 @@ namespace Surge
 
     void VulkanUniformBuffer::SetData(const Buffer& data, Uint offset) const
     {
-        VulkanRenderContext* renderContext;
-        SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = renderContext->GetMemoryAllocator();
-
-        void* mappedData = allocator->MapMemory(mAllocation);
-        memcpy(mappedData, (const Byte*)data.Data + offset, mSize);
-        allocator->UnmapMemory(mAllocation);
+        SetData(data.Data, offset);
     }
 
     void VulkanUniformBuffer::SetData(const void* data, Uint offset) const
     {
-        VulkanRenderContext* renderContext;
-        SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanMemoryAllocator* allocator = renderContext->GetMemoryAllocator();
+        // The buffer stays mapped for its whole lifetime, no need to map/unmap here
+        const Uint frameIndex = Core::GetRenderContext()->GetFrameIndex();
+        memcpy(mMappedData + mDescriptorInfos[frameIndex].offset, (const Byte*)data + offset, mSize);
+    }
 
-        void* mappedData = allocator->MapMemory(mAllocation);
-        memcpy(mappedData, (const Byte*)data + offset, mSize);
-        allocator->UnmapMemory(mAllocation);
+    const VkDescriptorBufferInfo& VulkanUniformBuffer::GetVulkanDescriptorBufferInfo() const
+    {
+        return mDescriptorInfos[Core::GetRenderContext()->GetFrameIndex()];
     }
 
     void VulkanUniformBuffer::Invalidate()
@@ -43,24 +38,28 @@ namespace Surge
         VulkanRenderContext* renderContext;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
 
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.pNext = nullptr;
-        allocInfo.allocationSize = 0;
-        allocInfo.memoryTypeIndex = 0;
+        // Every region has to start at a valid offset for the descriptors
+        const VkDeviceSize alignment = renderContext->GetDevice()->GetProperties().vk10Properties.properties.limits.minUniformBufferOffsetAlignment;
+        mAlignedSize = static_cast<Uint>((mSize + alignment - 1) & ~(alignment - 1));
 
         VkBufferCreateInfo bufferInfo = {};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        bufferInfo.size = mSize;
+        bufferInfo.size = static_cast<VkDeviceSize>(mAlignedSize) * FRAMES_IN_FLIGHT;
 
-        mAllocation = renderContext->GetMemoryAllocator()->AllocateBuffer(bufferInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, mVulkanBuffer, nullptr);
+        VmaAllocationInfo allocationInfo = {};
+        mAllocation = renderContext->GetMemoryAllocator()->AllocateBuffer(bufferInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, mVulkanBuffer, &allocationInfo);
+        mMappedData = static_cast<Byte*>(allocationInfo.pMappedData);
         SET_VK_OBJECT_DEBUGNAME(mVulkanBuffer, VK_OBJECT_TYPE_BUFFER, "Uniform Buffer");
 
-        // Update Descriptor info
-        mDescriptorInfo.buffer = mVulkanBuffer;
-        mDescriptorInfo.range = mSize;
-        mDescriptorInfo.offset = 0;
+        // Update Descriptor infos
+        mDescriptorInfos.resize(FRAMES_IN_FLIGHT);
+        for (Uint i = 0; i < FRAMES_IN_FLIGHT; i++)
+        {
+            mDescriptorInfos[i].buffer = mVulkanBuffer;
+            mDescriptorInfos[i].range = mSize;
+            mDescriptorInfos[i].offset = static_cast<VkDeviceSize>(mAlignedSize) * i;
+        }
     }
 
     void VulkanUniformBuffer::Release()
@@ -75,5 +74,6 @@ namespace Surge
 
         mVulkanBuffer = VK_NULL_HANDLE;
         mAllocation = VK_NULL_HANDLE;
+        mMappedData = nullptr;
     }
-} // namespace Surge
\ No newline at end of file
+} // namespace Surge
@@ -7,6 +7,9 @@
 
 namespace Surge
 {
+    // One persistently mapped VkBuffer split in FRAMES_IN_FLIGHT regions, SetData writes to the region of the current frame
+    // so the CPU never overwrites data that a frame in flight is still reading.
+    // Since every region holds its own copy, SetData needs to be called on every frame the buffer is used
     class SURGE_API VulkanUniformBuffer : public UniformBuffer
     {
     public:
@@ -18,7 +21,10 @@ namespace Surge
         virtual Uint GetSize() const override { return mSize; }
 
         const VkBuffer& GetVulkanBuffer() const { return mVulkanBuffer; }
-        const VkDescriptorBufferInfo& GetVulkanDescriptorBufferInfo() const { return mDescriptorInfo; }
+
+        // Points to the region of the current frame
+        const VkDescriptorBufferInfo& GetVulkanDescriptorBufferInfo() const;
+        const VkDescriptorBufferInfo& GetVulkanDescriptorBufferInfo(Uint frameIndex) const { return mDescriptorInfos[frameIndex]; }
 
     private:
         void Invalidate();
@@ -26,9 +32,11 @@ namespace Surge
 
     private:
         Uint mSize;
+        Uint mAlignedSize = 0; // mSize rounded up to minUniformBufferOffsetAlignment, size of one region
 
         VkBuffer mVulkanBuffer = VK_NULL_HANDLE;
         VmaAllocation mAllocation = VK_NULL_HANDLE;
-        VkDescriptorBufferInfo mDescriptorInfo {};
+        Byte* mMappedData = nullptr;
+        Vector<VkDescriptorBufferInfo> mDescriptorInfos; // One per frame in flight
     };
-} // namespace Surge
\ No newline at end of file
+} // namespace Surge
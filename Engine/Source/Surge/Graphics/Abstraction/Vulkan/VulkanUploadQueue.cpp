@@ -0,0 +1,374 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanUploadQueue.hpp"
+#include "Surge/Graphics/Abstraction/Vulkan/VulkanRenderContext.hpp"
+#include <cstring>
+
+namespace Surge
+{
+    namespace
+    {
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        VkSemaphore CreateTimelineSemaphore(VkDevice device)
+        {
+            VkSemaphoreTypeCreateInfo typeInfo {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+            typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            typeInfo.initialValue = 0;
+
+            VkSemaphoreCreateInfo createInfo {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+            createInfo.pNext = &typeInfo;
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            VK_CALL(vkCreateSemaphore(device, &createInfo, nullptr, &semaphore));
+            return semaphore;
+        }
+    } // namespace
+
+    void VulkanUploadQueue::Initialize(VulkanDevice& device, VulkanMemoryAllocator& allocator)
+    {
+        mDevice = device.GetLogicalDevice();
+        mAllocator = &allocator;
+        mTransferQueue = device.GetTransferQueue();
+        mGraphicsQueue = device.GetGraphicsQueue();
+        mTransferFamily = device.GetQueueFamilyIndices().TransferQueue;
+        mGraphicsFamily = device.GetQueueFamilyIndices().GraphicsQueue;
+
+        VkCommandPoolCreateInfo cmdPoolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        cmdPoolInfo.queueFamilyIndex = mTransferFamily;
+        VK_CALL(vkCreateCommandPool(mDevice, &cmdPoolInfo, nullptr, &mTransferCommandPool));
+        cmdPoolInfo.queueFamilyIndex = mGraphicsFamily;
+        VK_CALL(vkCreateCommandPool(mDevice, &cmdPoolInfo, nullptr, &mGraphicsCommandPool));
+
+        mTransferSemaphore = CreateTimelineSemaphore(mDevice);
+        mGraphicsSemaphore = CreateTimelineSemaphore(mDevice);
+
+        // Mapped for the lifetime of the queue
+        VkBufferCreateInfo bufferCreateInfo {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bufferCreateInfo.size = UPLOAD_STAGING_RING_SIZE;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        mStagingBuffer.Allocation = mAllocator->AllocateBuffer(bufferCreateInfo, VMA_MEMORY_USAGE_CPU_ONLY, mStagingBuffer.Buffer, nullptr);
+        mStagingData = static_cast<Byte*>(mAllocator->MapMemory(mStagingBuffer.Allocation));
+
+        const VkDeviceSize copyAlignment = device.GetPhysicalDeviceProperties().limits.optimalBufferCopyOffsetAlignment;
+        mStagingAlignment = copyAlignment > mStagingAlignment ? copyAlignment : mStagingAlignment;
+        mStats.StagingSize = UPLOAD_STAGING_RING_SIZE;
+    }
+
+    void VulkanUploadQueue::Destroy()
+    {
+        WaitIdle();
+
+        for (Batch& batch : mFreeBatches)
+        {
+            for (StagingBuffer& staging : batch.DedicatedStaging)
+            {
+                mAllocator->UnmapMemory(staging.Allocation);
+                mAllocator->DestroyBuffer(staging.Buffer, staging.Allocation);
+            }
+        }
+        mFreeBatches.clear();
+
+        // Frees the command buffers too
+        vkDestroyCommandPool(mDevice, mTransferCommandPool, nullptr);
+        vkDestroyCommandPool(mDevice, mGraphicsCommandPool, nullptr);
+        vkDestroySemaphore(mDevice, mTransferSemaphore, nullptr);
+        vkDestroySemaphore(mDevice, mGraphicsSemaphore, nullptr);
+
+        mAllocator->UnmapMemory(mStagingBuffer.Allocation);
+        mAllocator->DestroyBuffer(mStagingBuffer.Buffer, mStagingBuffer.Allocation);
+        mStagingData = nullptr;
+    }
+
+    void VulkanUploadQueue::UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize offset)
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        void* stagingData = nullptr;
+        const VkDeviceSize stagingOffset = AllocateStaging(size, stagingBuffer, stagingData);
+        std::memcpy(stagingData, data, size);
+
+        Batch& batch = GetOpenBatch();
+        VkBufferCopy copyRegion = {};
+        copyRegion.srcOffset = stagingOffset;
+        copyRegion.dstOffset = offset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(batch.TransferCmd, stagingBuffer, buffer, 1, &copyRegion);
+
+        // Released by the transfer queue family and acquired by the graphics one, the semaphores order the two
+        if (mTransferFamily != mGraphicsFamily)
+        {
+            VkBufferMemoryBarrier barrier {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            barrier.srcQueueFamilyIndex = mTransferFamily;
+            barrier.dstQueueFamilyIndex = mGraphicsFamily;
+            barrier.buffer = buffer;
+            barrier.offset = offset;
+            barrier.size = size;
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            vkCmdPipelineBarrier(batch.TransferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            vkCmdPipelineBarrier(batch.GraphicsCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+
+        mFrameStats.UploadCount++;
+        mFrameStats.UploadedBytes += size;
+    }
+
+    void VulkanUploadQueue::UploadImage(VkImage image, const void* data, VkDeviceSize size, Uint width, Uint height, const VkImageSubresourceRange& range)
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        void* stagingData = nullptr;
+        const VkDeviceSize stagingOffset = AllocateStaging(size, stagingBuffer, stagingData);
+        std::memcpy(stagingData, data, size);
+
+        Batch& batch = GetOpenBatch();
+        VkImageMemoryBarrier barrier {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = range;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        vkCmdPipelineBarrier(batch.TransferCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy copyRegion = {};
+        copyRegion.bufferOffset = stagingOffset;
+        copyRegion.imageSubresource.aspectMask = range.aspectMask;
+        copyRegion.imageSubresource.mipLevel = range.baseMipLevel;
+        copyRegion.imageSubresource.baseArrayLayer = range.baseArrayLayer;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent = {width, height, 1};
+        vkCmdCopyBufferToImage(batch.TransferCmd, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+        // The layout stays the same, the graphics queue transitions it after the acquire
+        if (mTransferFamily != mGraphicsFamily)
+        {
+            barrier.srcQueueFamilyIndex = mTransferFamily;
+            barrier.dstQueueFamilyIndex = mGraphicsFamily;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            vkCmdPipelineBarrier(batch.TransferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(batch.GraphicsCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+
+        mFrameStats.UploadCount++;
+        mFrameStats.UploadedBytes += size;
+    }
+
+    void VulkanUploadQueue::RecordGraphics(const std::function<void(VkCommandBuffer)>& function)
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        function(GetOpenBatch().GraphicsCmd);
+    }
+
+    void VulkanUploadQueue::Flush()
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        if (mBatchOpen)
+            SubmitBatch();
+        RetireBatches();
+    }
+
+    void VulkanUploadQueue::WaitIdle()
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        if (mBatchOpen)
+            SubmitBatch();
+        WaitForValue(mSubmittedValue);
+        RetireBatches();
+    }
+
+    void VulkanUploadQueue::BeginFrame()
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        RetireBatches();
+
+        mStats.UploadCount = mFrameStats.UploadCount;
+        mStats.UploadedBytes = mFrameStats.UploadedBytes;
+        mStats.SubmittedBatches = mFrameStats.SubmittedBatches;
+        mFrameStats = {};
+    }
+
+    UploadStats VulkanUploadQueue::GetStats() const
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        UploadStats stats = mStats;
+        stats.PendingBatches = static_cast<Uint>(mPendingBatches.size());
+        stats.StagingUsage = mStagingHead - mStagingTail;
+        return stats;
+    }
+
+    VulkanUploadQueue::Batch& VulkanUploadQueue::GetOpenBatch()
+    {
+        if (mBatchOpen)
+            return mOpenBatch;
+
+        if (!mFreeBatches.empty())
+        {
+            mOpenBatch = std::move(mFreeBatches.back());
+            mFreeBatches.pop_back();
+        }
+        else
+        {
+            mOpenBatch = {};
+            VkCommandBufferAllocateInfo allocInfo {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            allocInfo.commandPool = mTransferCommandPool;
+            VK_CALL(vkAllocateCommandBuffers(mDevice, &allocInfo, &mOpenBatch.TransferCmd));
+            allocInfo.commandPool = mGraphicsCommandPool;
+            VK_CALL(vkAllocateCommandBuffers(mDevice, &allocInfo, &mOpenBatch.GraphicsCmd));
+        }
+
+        VkCommandBufferBeginInfo beginInfo {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        VK_CALL(vkBeginCommandBuffer(mOpenBatch.TransferCmd, &beginInfo));
+        VK_CALL(vkBeginCommandBuffer(mOpenBatch.GraphicsCmd, &beginInfo));
+        mBatchOpen = true;
+        return mOpenBatch;
+    }
+
+    void VulkanUploadQueue::SubmitBatch()
+    {
+        SURGE_PROFILE_FUNC("VulkanUploadQueue::SubmitBatch");
+        Batch& batch = mOpenBatch;
+        VK_CALL(vkEndCommandBuffer(batch.TransferCmd));
+        VK_CALL(vkEndCommandBuffer(batch.GraphicsCmd));
+        batch.Value = mSubmittedValue + 1;
+        batch.StagingEnd = mStagingHead;
+
+        // Transfer queue: the copies
+        VkTimelineSemaphoreSubmitInfo transferTimelineInfo {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        transferTimelineInfo.signalSemaphoreValueCount = 1;
+        transferTimelineInfo.pSignalSemaphoreValues = &batch.Value;
+
+        VkSubmitInfo transferSubmit {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        transferSubmit.pNext = &transferTimelineInfo;
+        transferSubmit.commandBufferCount = 1;
+        transferSubmit.pCommandBuffers = &batch.TransferCmd;
+        transferSubmit.signalSemaphoreCount = 1;
+        transferSubmit.pSignalSemaphores = &mTransferSemaphore;
+        VK_CALL(vkQueueSubmit(mTransferQueue, 1, &transferSubmit, VK_NULL_HANDLE));
+
+        // Graphics queue: the acquires and the work recorded with RecordGraphics, once the copies are done
+        VkTimelineSemaphoreSubmitInfo graphicsTimelineInfo {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        graphicsTimelineInfo.waitSemaphoreValueCount = 1;
+        graphicsTimelineInfo.pWaitSemaphoreValues = &batch.Value;
+        graphicsTimelineInfo.signalSemaphoreValueCount = 1;
+        graphicsTimelineInfo.pSignalSemaphoreValues = &batch.Value;
+
+        const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkSubmitInfo graphicsSubmit {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        graphicsSubmit.pNext = &graphicsTimelineInfo;
+        graphicsSubmit.waitSemaphoreCount = 1;
+        graphicsSubmit.pWaitSemaphores = &mTransferSemaphore;
+        graphicsSubmit.pWaitDstStageMask = &waitStage;
+        graphicsSubmit.commandBufferCount = 1;
+        graphicsSubmit.pCommandBuffers = &batch.GraphicsCmd;
+        graphicsSubmit.signalSemaphoreCount = 1;
+        graphicsSubmit.pSignalSemaphores = &mGraphicsSemaphore;
+        VK_CALL(vkQueueSubmit(mGraphicsQueue, 1, &graphicsSubmit, VK_NULL_HANDLE));
+
+        mSubmittedValue = batch.Value;
+        mPendingBatches.push_back(std::move(batch));
+        mBatchOpen = false;
+        mFrameStats.SubmittedBatches++;
+    }
+
+    void VulkanUploadQueue::RetireBatches()
+    {
+        if (mPendingBatches.empty())
+            return;
+
+        uint64_t completedValue = 0;
+        VK_CALL(vkGetSemaphoreCounterValue(mDevice, mGraphicsSemaphore, &completedValue));
+        while (!mPendingBatches.empty() && mPendingBatches.front().Value <= completedValue)
+        {
+            Batch& batch = mPendingBatches.front();
+            if (batch.UsesStaging)
+                mStagingTail = batch.StagingEnd;
+            for (StagingBuffer& staging : batch.DedicatedStaging)
+            {
+                mAllocator->UnmapMemory(staging.Allocation);
+                mAllocator->DestroyBuffer(staging.Buffer, staging.Allocation);
+            }
+            batch.DedicatedStaging.clear();
+            batch.UsesStaging = false;
+
+            mFreeBatches.push_back(std::move(batch));
+            mPendingBatches.pop_front();
+        }
+    }
+
+    void VulkanUploadQueue::WaitForValue(uint64_t value)
+    {
+        SURGE_PROFILE_FUNC("VulkanUploadQueue::WaitForValue");
+        VkSemaphoreWaitInfo waitInfo {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &mGraphicsSemaphore;
+        waitInfo.pValues = &value;
+        VK_CALL(vkWaitSemaphores(mDevice, &waitInfo, UINT64_MAX));
+    }
+
+    VkDeviceSize VulkanUploadQueue::AllocateStaging(VkDeviceSize size, VkBuffer& outBuffer, void*& outData)
+    {
+        if (size > UPLOAD_STAGING_RING_SIZE)
+        {
+            StagingBuffer staging;
+            VkBufferCreateInfo bufferCreateInfo {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+            bufferCreateInfo.size = size;
+            bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            staging.Allocation = mAllocator->AllocateBuffer(bufferCreateInfo, VMA_MEMORY_USAGE_CPU_ONLY, staging.Buffer, nullptr);
+
+            // Kept mapped until the batch is done, it is unmapped right before being destroyed
+            outBuffer = staging.Buffer;
+            outData = mAllocator->MapMemory(staging.Allocation);
+            GetOpenBatch().DedicatedStaging.push_back(staging);
+            return 0;
+        }
+
+        // An allocation doesn't wrap around the end of the ring, it starts over at the beginning
+        uint64_t offset = AlignUp(mStagingHead, mStagingAlignment);
+        if (offset % UPLOAD_STAGING_RING_SIZE + size > UPLOAD_STAGING_RING_SIZE)
+            offset = AlignUp(offset, UPLOAD_STAGING_RING_SIZE);
+
+        // The ring is full, waits for the oldest batches. The open batch is submitted first if it is using the ring
+        while (offset + size > mStagingTail + UPLOAD_STAGING_RING_SIZE)
+        {
+            if (mBatchOpen && mOpenBatch.UsesStaging)
+                SubmitBatch();
+
+            if (mPendingBatches.empty())
+            {
+                mStagingTail = offset; // Nothing reads the ring
+                break;
+            }
+
+            WaitForValue(mPendingBatches.front().Value);
+            RetireBatches();
+        }
+
+        mStagingHead = offset + size;
+        GetOpenBatch().UsesStaging = true;
+        outBuffer = mStagingBuffer.Buffer;
+        outData = mStagingData + offset % UPLOAD_STAGING_RING_SIZE;
+        return offset % UPLOAD_STAGING_RING_SIZE;
+    }
+
+} // namespace Surge
@@ -0,0 +1,112 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/RenderContext.hpp"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+// Size of the persistently mapped staging buffer, bigger uploads get a staging buffer of their own
+#define UPLOAD_STAGING_RING_SIZE (64 * 1024 * 1024)
+
+namespace Surge
+{
+    class SURGE_API VulkanDevice;
+    class SURGE_API VulkanMemoryAllocator;
+
+    // Uploads the data of new resources without waiting for the GPU. The data is copied into a staging ring right away and the copies are
+    // batched into one command buffer for the transfer queue, which is submitted by Flush before the graphics queue needs them.
+    // Every batch has a command buffer for the graphics queue too, which takes the ownership of the resources from the transfer queue
+    // family and runs the work that needs the graphics queue (mip generation, layout transitions).
+    // A batch signals a timeline semaphore on both queues, every graphics submit must wait for GetSubmittedValue() of GetSemaphore()
+    class SURGE_API VulkanUploadQueue
+    {
+    public:
+        VulkanUploadQueue() = default;
+        ~VulkanUploadQueue() = default;
+
+        void Initialize(VulkanDevice& device, VulkanMemoryAllocator& allocator);
+        void Destroy();
+
+        // Copies 'data' into 'buffer' at 'offset', the buffer must have VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+        // Meant for the resources that are created with their data, the transfer queue doesn't take the ownership back from the graphics queue
+        void UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        // Copies 'data' into the first mip of 'image', whose previous content is discarded. The image is left in
+        // VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, RecordGraphics must transition it to the layout it is used in
+        void UploadImage(VkImage image, const void* data, VkDeviceSize size, Uint width, Uint height, const VkImageSubresourceRange& range);
+
+        // 'function' records into the graphics command buffer of the batch, which runs after the copies of the batch
+        void RecordGraphics(const std::function<void(VkCommandBuffer)>& function);
+
+        // Submits the batch to the GPU, called before the graphics submits of the frame
+        void Flush();
+        void WaitIdle(); // Flushes and blocks until the GPU is done with every batch
+
+        VkSemaphore GetSemaphore() const { return mGraphicsSemaphore; }
+        uint64_t GetSubmittedValue() const { return mSubmittedValue; }
+
+        // Recycles the batches that are done and starts the stats of a new frame
+        void BeginFrame();
+        UploadStats GetStats() const;
+
+    private:
+        struct StagingBuffer
+        {
+            VkBuffer Buffer;
+            VmaAllocation Allocation;
+        };
+
+        struct Batch
+        {
+            VkCommandBuffer TransferCmd = VK_NULL_HANDLE;
+            VkCommandBuffer GraphicsCmd = VK_NULL_HANDLE;
+            uint64_t Value = 0;      // Signaled by the batch on both timeline semaphores
+            uint64_t StagingEnd = 0; // mStagingHead when the batch was submitted
+            bool UsesStaging = false;
+            Vector<StagingBuffer> DedicatedStaging; // For the uploads that don't fit in the ring
+        };
+
+    private:
+        Batch& GetOpenBatch(); // Begins a batch if there is none
+        void SubmitBatch();
+        void RetireBatches(); // Recycles the batches that are done on the GPU
+        void WaitForValue(uint64_t value);
+
+        // Returns the buffer and the offset in it to copy 'size' bytes from, 'outData' is where the bytes go
+        VkDeviceSize AllocateStaging(VkDeviceSize size, VkBuffer& outBuffer, void*& outData);
+
+    private:
+        VkDevice mDevice = VK_NULL_HANDLE;
+        VulkanMemoryAllocator* mAllocator = nullptr;
+        VkQueue mTransferQueue = VK_NULL_HANDLE;
+        VkQueue mGraphicsQueue = VK_NULL_HANDLE;
+        Uint mTransferFamily = 0;
+        Uint mGraphicsFamily = 0;
+        VkCommandPool mTransferCommandPool = VK_NULL_HANDLE;
+        VkCommandPool mGraphicsCommandPool = VK_NULL_HANDLE;
+
+        // Timeline semaphores, the graphics one is signaled once the transfer one is
+        VkSemaphore mTransferSemaphore = VK_NULL_HANDLE;
+        VkSemaphore mGraphicsSemaphore = VK_NULL_HANDLE;
+        uint64_t mSubmittedValue = 0;
+
+        // Staging ring, the offsets only grow and are wrapped with UPLOAD_STAGING_RING_SIZE
+        StagingBuffer mStagingBuffer = {};
+        Byte* mStagingData = nullptr;
+        VkDeviceSize mStagingAlignment = 16;
+        uint64_t mStagingHead = 0; // Where the next allocation goes
+        uint64_t mStagingTail = 0; // Start of the oldest allocation that may still be read by the GPU
+
+        Batch mOpenBatch;
+        bool mBatchOpen = false;
+        std::deque<Batch> mPendingBatches;
+        Vector<Batch> mFreeBatches; // Their command buffers are reused
+
+        mutable std::mutex mMutex;
+        UploadStats mFrameStats; // Counted this frame
+        UploadStats mStats;      // Of the last frame
+    };
+
+} // namespace Surge
@@ -18,6 +18,8 @@ namespace Surge
         VkDevice device = renderContext->GetDevice()->GetLogicalDevice();
         VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
 
+        // The copy may still be in the open batch of the upload queue
+        renderContext->GetUploadQueue()->Flush();
         vkDeviceWaitIdle(device);
         allocator->DestroyBuffer(mVulkanBuffer, mAllocation);
     }
@@ -35,21 +37,8 @@ namespace Surge
     {
         VulkanRenderContext* renderContext = nullptr;
         SURGE_GET_VULKAN_CONTEXT(renderContext);
-        VulkanDevice* device = renderContext->GetDevice();
         VulkanMemoryAllocator* allocator = static_cast<VulkanMemoryAllocator*>(renderContext->GetMemoryAllocator());
 
-        VkBufferCreateInfo bufferCreateInfo {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-        bufferCreateInfo.size = mSize;
-        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        VkBuffer stagingBuffer = VK_NULL_HANDLE;
-        VmaAllocation stagingBufferAllocation = allocator->AllocateBuffer(bufferCreateInfo, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, nullptr);
-
-        // Copy data to staging buffer
-        void* destData = allocator->MapMemory(stagingBufferAllocation);
-        memcpy(destData, data, mSize);
-        allocator->UnmapMemory(stagingBufferAllocation);
-
         VkBufferCreateInfo vertexBufferCreateInfo = {};
         vertexBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         vertexBufferCreateInfo.size = mSize;
@@ -57,13 +46,7 @@ namespace Surge
         vertexBufferCreateInfo.flags = VK_SHARING_MODE_EXCLUSIVE;
         mAllocation = allocator->AllocateBuffer(vertexBufferCreateInfo, VMA_MEMORY_USAGE_GPU_ONLY, mVulkanBuffer, nullptr);
 
-        device->InstantSubmit(VulkanQueueType::Transfer, [&](VkCommandBuffer& cmd) {
-            VkBufferCopy copyRegion = {};
-            copyRegion.size = mSize;
-            vkCmdCopyBuffer(cmd, stagingBuffer, mVulkanBuffer, 1, &copyRegion);
-        });
-
-        allocator->DestroyBuffer(stagingBuffer, stagingBufferAllocation);
+        renderContext->GetUploadQueue()->UploadBuffer(mVulkanBuffer, data, mSize);
         SET_VK_OBJECT_DEBUGNAME(mVulkanBuffer, VK_OBJECT_TYPE_BUFFER, "Vertex Buffer");
     }
 } // namespace Surge
\ No newline at end of file
@@ -13,6 +13,10 @@ namespace Surge
         virtual void Bind(const Ref<RenderCommandBuffer>& renderCmdBuffer) = 0;
         virtual void SetPushConstantData(const Ref<RenderCommandBuffer>& cmdBuffer, const String& bufferName, void* data) const = 0;
         virtual void Dispatch(const Ref<RenderCommandBuffer>& renderCmdBuffer, Uint groupCountX, Uint groupCountY, Uint groupCountZ) = 0;
+
+        // Makes the buffer writes of the previous dispatches visible to the following dispatches, indirect draws and vertex shaders.
+        // Also keeps the following dispatches from overwriting buffers that earlier draws are still reading
+        virtual void InsertDispatchBarrier(const Ref<RenderCommandBuffer>& renderCmdBuffer) = 0;
         virtual const Ref<Shader>& GetShader() const = 0;
 
         static Ref<ComputePipeline> Create(Ref<Shader>& computeShader);
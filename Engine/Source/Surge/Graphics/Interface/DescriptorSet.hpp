@@ -19,7 +19,7 @@ namespace Surge
         virtual void UpdateForRendering() = 0;
         virtual void SetBuffer(const Ref<UniformBuffer>& dataBuffer, Uint binding) = 0;
         virtual void SetBuffer(const Ref<StorageBuffer>& dataBuffer, Uint binding) = 0;
-        virtual void SetImage2D(const Ref<Image2D>& image, Uint binding) = 0;
+        virtual void SetImage2D(const Ref<Image2D>& image, Uint binding, Uint arrayElement = 0) = 0;
 
         static Ref<DescriptorSet> Create(const Ref<Shader>& shader, Uint setNumber, bool resetEveryFrame, int index = -1);
     };
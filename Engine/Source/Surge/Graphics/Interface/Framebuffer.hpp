@@ -19,6 +19,10 @@ namespace Surge
         Vector<FramebufferAttachmentSpec> AttachmentSpecs;
         glm::vec4 ClearColor = {0.1f, 0.1f, 0.1f, 1.0f};
         bool NoResize = false;
+
+        // The attachment images are given by SetExternalAttachments (see RenderGraph) instead of being created by the framebuffer.
+        // The attachments must be in the attachment state when the render pass begins, they are left in it when it ends
+        bool ExternalAttachments = false;
     };
 
     class SURGE_API Framebuffer : public RefCounted
@@ -28,13 +32,17 @@ namespace Surge
 
         virtual void Resize(Uint width, Uint height) = 0;
 
-        virtual void BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer) const = 0;
+        // If 'secondaryContents' is true the render pass can only execute secondary command buffers, see RenderCommandBuffer::Execute
+        virtual void BeginRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer, bool secondaryContents = false) const = 0;
         virtual void EndRenderPass(const Ref<RenderCommandBuffer>& cmdBuffer) const = 0;
 
         virtual const FramebufferSpecification& GetSpecification() const = 0;
         virtual const Ref<Image2D>& GetColorAttachment(Uint index) const = 0;
         virtual const Ref<Image2D>& GetDepthAttachment() const = 0;
 
+        // Only for framebuffers with ExternalAttachments, 'attachments' are the color attachments in order, then the depth attachment
+        virtual void SetExternalAttachments(const Vector<Ref<Image2D>>& attachments) = 0;
+
         static Ref<Framebuffer> Create(const FramebufferSpecification& spec);
     };
 } // namespace Surge
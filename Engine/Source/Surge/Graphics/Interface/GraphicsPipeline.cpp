@@ -4,9 +4,9 @@
 
 namespace Surge
 {
-    Ref<GraphicsPipeline> GraphicsPipeline::Create(const GraphicsPipelineSpecification& pipelineSpec)
+    Ref<GraphicsPipeline> GraphicsPipeline::Create(const GraphicsPipelineSpecification& pipelineSpec, bool deferCreation)
     {
-        return Ref<VulkanGraphicsPipeline>::Create(pipelineSpec);
+        return Ref<VulkanGraphicsPipeline>::Create(pipelineSpec, deferCreation);
     }
 
 } // namespace Surge
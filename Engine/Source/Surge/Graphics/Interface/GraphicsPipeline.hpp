@@ -7,6 +7,8 @@
 
 namespace Surge
 {
+    class StorageBuffer;
+
     enum class SURGE_API PrimitiveTopology
     {
         None = 0,
@@ -69,8 +71,14 @@ namespace Surge
         virtual const GraphicsPipelineSpecification& GetSpecification() const = 0;
         virtual void Bind(const Ref<RenderCommandBuffer>& cmdBuffer) const = 0;
         virtual void SetPushConstantData(const Ref<RenderCommandBuffer>& cmdBuffer, const String& bufferName, void* data) const = 0;
-        virtual void DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex) const = 0;
+        // gl_InstanceIndex starts at 'firstInstance'
+        virtual void DrawIndexed(const Ref<RenderCommandBuffer>& cmdBuffer, Uint indicesCount, Uint baseIndex, Uint baseVertex, Uint instanceCount = 1, Uint firstInstance = 0) const = 0;
+
+        // Draws the VkDrawIndexedIndirectCommand(s) at 'commandsOffset' (in bytes), the number of draws is read from the Uint at 'countOffset' and is
+        // clamped to 'maxDrawCount'. Both buffers must be created with 'indirectArguments'; the offsets are relative to the region of the current frame
+        virtual void DrawIndexedIndirectCount(const Ref<RenderCommandBuffer>& cmdBuffer, const Ref<StorageBuffer>& commands, Uint commandsOffset, const Ref<StorageBuffer>& count, Uint countOffset, Uint maxDrawCount) const = 0;
 
-        static Ref<GraphicsPipeline> Create(const GraphicsPipelineSpecification& pipelineSpec);
+        // If 'deferCreation' is true, the API objects are only created by Reload(), which can be called from any thread. Used by the PipelineLibrary
+        static Ref<GraphicsPipeline> Create(const GraphicsPipelineSpecification& pipelineSpec, bool deferCreation = false);
     };
 } // namespace Surge
\ No newline at end of file
@@ -8,4 +8,19 @@ namespace Surge
         return Ref<VulkanImage2D>::Create(specification);
     }
 
+    Ref<Image2D> Image2D::Create(const ImageSpecification& specification, const Ref<ImageMemory>& memory)
+    {
+        return Ref<VulkanImage2D>::Create(specification, memory);
+    }
+
+    ImageMemoryRequirements Image2D::GetMemoryRequirements(const ImageSpecification& specification)
+    {
+        return VulkanImage2D::GetMemoryRequirements(specification);
+    }
+
+    Ref<ImageMemory> ImageMemory::Create(const ImageMemoryRequirements& requirements)
+    {
+        return Ref<VulkanImageMemory>::Create(requirements);
+    }
+
 } // namespace Surge
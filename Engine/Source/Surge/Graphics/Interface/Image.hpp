@@ -72,6 +72,24 @@ namespace Surge
         Uint Mips = 1;
     };
 
+    struct ImageMemoryRequirements
+    {
+        uint64_t Size = 0;
+        uint64_t Alignment = 0;
+        Uint MemoryTypeBits = 0; // Memory types the image can live in, images can only share memory if they have one in common
+    };
+
+    // Device memory that several images can be placed in, as long as they are never in use at the same time (see RenderGraph)
+    class SURGE_API ImageMemory : public RefCounted
+    {
+    public:
+        virtual ~ImageMemory() = default;
+
+        virtual uint64_t GetSize() const = 0;
+
+        static Ref<ImageMemory> Create(const ImageMemoryRequirements& requirements);
+    };
+
     class SURGE_API Image : public RefCounted
     {
     public:
@@ -88,5 +106,10 @@ namespace Surge
     {
     public:
         static Ref<Image2D> Create(const ImageSpecification& specification);
+
+        // The image is placed at the start of 'memory' instead of getting memory of its own,
+        // 'memory' must satisfy GetMemoryRequirements(specification)
+        static Ref<Image2D> Create(const ImageSpecification& specification, const Ref<ImageMemory>& memory);
+        static ImageMemoryRequirements GetMemoryRequirements(const ImageSpecification& specification);
     };
 } // namespace Surge
@@ -8,4 +8,9 @@ namespace Surge
     {
         return Ref<VulkanRenderCommandBuffer>::Create(createFromSwapchain, size);
     }
+
+    Ref<RenderCommandBuffer> RenderCommandBuffer::CreateSecondary()
+    {
+        return Ref<VulkanRenderCommandBuffer>::Create(false, 0, true);
+    }
 } // namespace Surge
@@ -4,15 +4,33 @@
 
 namespace Surge
 {
+    class Framebuffer;
+    struct ResourceBarriers;
     class SURGE_API RenderCommandBuffer : public RefCounted
     {
     public:
         virtual ~RenderCommandBuffer() = default;
 
         virtual void BeginRecording() = 0;
+
+        // Secondary command buffers only, the recorded commands continue the render pass of 'framebuffer'
+        virtual void BeginRecording(const Ref<Framebuffer>& framebuffer) = 0;
         virtual void EndRecording() = 0;
         virtual void Submit() = 0;
 
+        // Primary command buffers only, executes secondary command buffers that have been recorded this frame.
+        // Must be called inside of a render pass begun with secondary contents
+        virtual void Execute(const Ref<RenderCommandBuffer>* secondaryBuffers, Uint count) = 0;
+
+        virtual bool IsSecondary() const = 0;
+
+        // Makes the resources of 'barriers' go from their Before to their After state, must be called outside of a render pass
+        virtual void InsertBarriers(const ResourceBarriers& barriers) = 0;
+
         static Ref<RenderCommandBuffer> Create(bool createFromSwapchain, Uint size = 0);
+
+        // A command buffer per frame in flight, allocated from a command pool of its own so that it can be recorded on any thread.
+        // Never submitted on its own, see Execute
+        static Ref<RenderCommandBuffer> CreateSecondary();
     };
 } // namespace Surge
@@ -0,0 +1,49 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Interface/Image.hpp"
+#include "Surge/Graphics/Interface/StorageBuffer.hpp"
+
+namespace Surge
+{
+    // How a resource is used by the GPU, every state maps to a pipeline stage, an access and (for images) a layout
+    enum class SURGE_API ResourceState
+    {
+        Undefined = 0,
+        ColorAttachment,
+        DepthAttachment,
+        FragmentShaderRead,
+        ComputeShaderRead,
+        ComputeShaderWrite
+    };
+
+    FORCEINLINE bool IsWriteState(ResourceState state)
+    {
+        return state == ResourceState::ColorAttachment || state == ResourceState::DepthAttachment || state == ResourceState::ComputeShaderWrite;
+    }
+
+    struct ImageBarrier
+    {
+        Ref<Image2D> Image;
+        ResourceState Before;
+        ResourceState After;
+        bool Discard = false; // The contents of the image don't matter, its layout is transitioned from undefined
+    };
+
+    struct BufferBarrier
+    {
+        Ref<StorageBuffer> Buffer;
+        ResourceState Before;
+        ResourceState After;
+    };
+
+    // Recorded as a single pipeline barrier, see RenderCommandBuffer::InsertBarriers
+    struct ResourceBarriers
+    {
+        Vector<ImageBarrier> Images;
+        Vector<BufferBarrier> Buffers;
+
+        bool Empty() const { return Images.empty() && Buffers.empty(); }
+        Uint GetCount() const { return static_cast<Uint>(Images.size() + Buffers.size()); }
+    };
+
+} // namespace Surge
@@ -4,9 +4,9 @@
 
 namespace Surge
 {
-    Ref<StorageBuffer> StorageBuffer::Create(Uint size, GPUMemoryUsage memoryUsage)
+    Ref<StorageBuffer> StorageBuffer::Create(Uint size, GPUMemoryUsage memoryUsage, bool indirectArguments)
     {
-        return Ref<VulkanStorageBuffer>::Create(size, memoryUsage);
+        return Ref<VulkanStorageBuffer>::Create(size, memoryUsage, indirectArguments);
     }
 
 } // namespace Surge
@@ -13,10 +13,12 @@ namespace Surge
 
         virtual void SetData(const void* data, Uint offset = 0) const = 0;
         virtual void SetData(const Buffer& data, Uint offset = 0) const = 0;
+        virtual void SetDataRange(const void* data, Uint size, Uint bufferOffset = 0) const = 0; // Only writes 'size' bytes at 'bufferOffset'
         virtual Uint GetSize() const = 0;
         virtual void Resize(Uint newSize) = 0;
 
-        static Ref<StorageBuffer> Create(Uint size, GPUMemoryUsage memoryUsage);
+        // 'indirectArguments' allows the buffer to be the source of indirect draw commands and counts (see GraphicsPipeline::DrawIndexedIndirectCount)
+        static Ref<StorageBuffer> Create(Uint size, GPUMemoryUsage memoryUsage, bool indirectArguments = false);
     };
 
 } // namespace Surge
@@ -1,13 +1,70 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/Abstraction/Vulkan/VulkanTexture.hpp"
+#include <stb_image.h>
 
 namespace Surge
 {
+    TextureData::TextureData(const Path& filepath)
+    {
+        int width, height, channels;
+        if (stbi_is_hdr(filepath))
+        {
+            mPixels = (void*)stbi_loadf(filepath, &width, &height, &channels, STBI_rgb_alpha);
+            mFormat = ImageFormat::RGBA32F;
+        }
+        else
+        {
+            mPixels = (void*)stbi_load(filepath, &width, &height, &channels, STBI_rgb_alpha);
+            mFormat = ImageFormat::RGBA8;
+        }
+
+        if (!mPixels)
+        {
+            Log<Severity::Error>("Failed to decode image: {0} ({1})", filepath, stbi_failure_reason());
+            return;
+        }
+        mWidth = width;
+        mHeight = height;
+    }
+
+    TextureData::TextureData(TextureData&& other) noexcept
+        : mPixels(other.mPixels), mWidth(other.mWidth), mHeight(other.mHeight), mFormat(other.mFormat)
+    {
+        other.mPixels = nullptr;
+    }
+
+    TextureData& TextureData::operator=(TextureData&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (mPixels)
+                stbi_image_free(mPixels);
+
+            mPixels = other.mPixels;
+            mWidth = other.mWidth;
+            mHeight = other.mHeight;
+            mFormat = other.mFormat;
+            other.mPixels = nullptr;
+        }
+        return *this;
+    }
+
+    TextureData::~TextureData()
+    {
+        if (mPixels)
+            stbi_image_free(mPixels);
+    }
+
     Ref<Texture2D> Texture2D::Create(const String& filepath, TextureSpecification specification)
     {
         return Ref<VulkanTexture2D>::Create(filepath, specification);
     }
 
+    Ref<Texture2D> Texture2D::Create(const TextureData& data, TextureSpecification specification)
+    {
+        return Ref<VulkanTexture2D>::Create(data, specification);
+    }
+
     Ref<Texture2D> Texture2D::Create(ImageFormat format, Uint width, Uint height, void* data, TextureSpecification specification)
     {
         return Ref<VulkanTexture2D>::Create(format, width, height, data, specification);
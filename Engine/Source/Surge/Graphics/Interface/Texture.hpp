@@ -14,6 +14,31 @@ namespace Surge
         bool UseMips = false;
     };
 
+    // Pixels of an image file, decoded on the CPU. Decoding doesn't touch the GPU, so it can be done on any thread
+    // HDR files are decoded as RGBA32F, everything else as RGBA8
+    class SURGE_API TextureData
+    {
+    public:
+        TextureData() = default;
+        TextureData(const Path& filepath);
+        TextureData(TextureData&& other) noexcept;
+        TextureData& operator=(TextureData&& other) noexcept;
+        ~TextureData();
+        SURGE_DISABLE_COPY(TextureData);
+
+        bool IsValid() const { return mPixels != nullptr; }
+        void* GetPixels() const { return mPixels; }
+        Uint GetWidth() const { return mWidth; }
+        Uint GetHeight() const { return mHeight; }
+        ImageFormat GetFormat() const { return mFormat; }
+
+    private:
+        void* mPixels = nullptr;
+        Uint mWidth = 0;
+        Uint mHeight = 0;
+        ImageFormat mFormat = ImageFormat::None;
+    };
+
     class SURGE_API Texture : public RefCounted
     {
     public:
@@ -32,6 +57,7 @@ namespace Surge
     public:
         virtual const Ref<Image2D> GetImage2D() const = 0;
         static Ref<Texture2D> Create(const String& filepath, TextureSpecification specification = {});
+        static Ref<Texture2D> Create(const TextureData& data, TextureSpecification specification = {});
         static Ref<Texture2D> Create(ImageFormat format, Uint width, Uint height, void* data = nullptr, TextureSpecification specification = {});
     };
 
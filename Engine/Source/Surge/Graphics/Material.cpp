@@ -1,15 +1,104 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/Material.hpp"
-#include "Surge/Graphics/Abstraction/Vulkan/VulkanMaterial.hpp"
 #include "Renderer/Renderer.hpp"
 
 namespace Surge
 {
     Ref<Texture2D> Material::mDummyTexture = nullptr;
 
+    static bool IsTextureMember(const ShaderBufferMember& member)
+    {
+        const String suffix = "Map";
+        return member.DataType == ShaderDataType::UInt && member.Name.size() > suffix.size() &&
+               member.Name.compare(member.Name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    Material::Material(const Ref<Shader>& shader, const String& materialName)
+    {
+        mName = materialName;
+        mShader = shader;
+
+        // The layout of the material is read once, the MaterialTable can't change the size of its materials
+        mShaderReloadID = mShader->AddReloadCallback([&]() { MarkDirty(); });
+
+        const ShaderBuffer& materials = mShader->GetReflectionData().GetBuffer("Materials");
+        mShaderBuffer.BufferName = "Material";
+        mShaderBuffer.Size = materials.ElementSize;
+        mShaderBuffer.Members = materials.ElementMembers;
+        mBufferMemory.Allocate(mShaderBuffer.Size);
+        mBufferMemory.ZeroInitialize();
+
+        MaterialTable& materialTable = Core::GetRenderer()->GetData()->MaterialTable;
+        SG_ASSERT(mShaderBuffer.Size == materialTable.GetMaterialSize(), "The material doesn't match the layout of the MaterialTable!");
+        mIndex = materialTable.AddMaterial();
+
+        const Ref<Texture2D>& whiteTexture = Core::GetRenderer()->GetData()->WhiteTexture;
+        for (const ShaderBufferMember& member : mShaderBuffer.Members)
+        {
+            if (!IsTextureMember(member))
+                continue;
+
+            TextureMember& texture = mTextures.emplace_back();
+            texture.Name = member.Name.substr(member.Name.find('.') + 1);
+            texture.MemoryOffset = member.MemoryOffset;
+            texture.Texture = whiteTexture;
+            mBufferMemory.Read<Uint>(texture.MemoryOffset) = materialTable.AddTexture(whiteTexture);
+        }
+        MarkDirty();
+    }
+
+    Material::~Material()
+    {
+        MaterialTable& materialTable = Core::GetRenderer()->GetData()->MaterialTable;
+        for (TextureMember& texture : mTextures)
+            materialTable.RemoveTexture(texture.Texture);
+        materialTable.RemoveMaterial(mIndex);
+
+        mShader->RemoveReloadCallback(mShaderReloadID);
+        mBufferMemory.Release();
+    }
+
     Ref<Material> Material::Create(const String& shaderName, const String& materialName)
     {
-        return Ref<VulkanMaterial>::Create(Core::GetRenderer()->GetShader(shaderName), materialName);
+        return Ref<Material>::Create(Core::GetRenderer()->GetShader(shaderName), materialName);
+    }
+
+    Ref<Material> Material::Clone() const
+    {
+        Ref<Material> clone = Ref<Material>::Create(mShader, mName);
+        clone->mBufferMemory.Write(mBufferMemory.Data, mBufferMemory.Size);
+
+        // SetTexture rewrites the copied slots, moving the references of the clone from the white texture to the textures of this material
+        for (const TextureMember& texture : mTextures)
+            clone->SetTexture(texture.Name, texture.Texture);
+        clone->MarkDirty();
+        return clone;
+    }
+
+    void Material::UpdateForRendering()
+    {
+        if (mCopiedVersion == mVersion)
+            return;
+
+        Core::GetRenderer()->GetData()->MaterialTable.SetMaterialData(mIndex, mBufferMemory);
+        mCopiedVersion = mVersion;
+    }
+
+    void Material::SetTexture(const String& name, const Ref<Texture2D>& texture)
+    {
+        for (TextureMember& member : mTextures)
+        {
+            if (member.Name == name)
+            {
+                // Added first, so a texture that is set again keeps its slot
+                MaterialTable& materialTable = Core::GetRenderer()->GetData()->MaterialTable;
+                mBufferMemory.Read<Uint>(member.MemoryOffset) = materialTable.AddTexture(texture);
+                materialTable.RemoveTexture(member.Texture);
+                member.Texture = texture;
+                MarkDirty();
+                break;
+            }
+        }
     }
 
     void Material::RemoveTexture(const String& name)
@@ -18,4 +107,4 @@ namespace Surge
         this->Set<Ref<Texture2D>>(name, whiteTex);
     }
 
-} // namespace Surge
\ No newline at end of file
+} // namespace Surge
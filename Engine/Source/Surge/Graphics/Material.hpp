@@ -4,38 +4,27 @@
 #include "Surge/Core/String.hpp"
 #include "Surge/Graphics/Shader/Shader.hpp"
 #include "Surge/Graphics/Shader/ReflectionData.hpp"
-#include "Surge/Graphics/Interface/UniformBuffer.hpp"
 #include "Surge/Graphics/Interface/Texture.hpp"
-#include "Surge/Graphics/Interface/RenderCommandBuffer.hpp"
-#include "Surge/Graphics/Interface/GraphicsPipeline.hpp"
 
 namespace Surge
 {
+    // One element of the 'Materials' buffer of the shader, stored in the MaterialTable of the renderer. The uints of the
+    // material whose names end with "Map" are its textures, they hold the slot of the texture in the MaterialTable
     class SURGE_API Material : public RefCounted
     {
     public:
-        Material() = default;
-        virtual ~Material() = default;
+        Material(const Ref<Shader>& shader, const String& materialName);
+        ~Material();
 
-        virtual void UpdateForRendering() = 0;
-        virtual void Bind(const Ref<RenderCommandBuffer>& cmdBuffer, const Ref<GraphicsPipeline>& gfxPipeline) const = 0;
-        virtual void Load() = 0;
-        virtual void Release() = 0;
+        // Copies the material into the MaterialTable if it changed since the last copy, the MaterialTable uploads it
+        void UpdateForRendering();
 
         template <typename T>
         FORCEINLINE void Set(const String& name, const T& data)
         {
             if constexpr (std::is_same_v<T, Ref<Texture2D>>)
             {
-                for (auto& [binding, res] : mShaderResources)
-                {
-                    if (res.Name == name)
-                    {
-                        mTextures[res.Binding] = data;
-                        mUpdatePendingTextures.push_back({res.Binding, mTextures.at(res.Binding).Raw()});
-                        break;
-                    }
-                }
+                SetTexture(name, data);
             }
             else
             {
@@ -43,20 +32,22 @@ namespace Surge
                 SG_ASSERT_NOMSG(member);
                 SG_ASSERT(sizeof(data) == member->Size, "The size of the shader member and the size of the input data doesn't match!");
                 mBufferMemory.Write((Byte*)&data, sizeof(data), member->MemoryOffset);
+                MarkDirty();
             }
         }
 
+        // Writing through the reference returned by Get doesn't change the version, MarkDirty must be called afterwards.
+        // Textures can only be changed with Set
+
         template <typename T>
         constexpr FORCEINLINE auto& Get(const String& name)
         {
             if constexpr (std::is_same_v<T, Ref<Texture2D>>)
             {
-                for (auto& [binding, res] : mShaderResources)
+                for (TextureMember& texture : mTextures)
                 {
-                    if (res.Name == name)
-                    {
-                        return mTextures[res.Binding];
-                    }
+                    if (texture.Name == name)
+                        return texture.Texture;
                 }
                 return mDummyTexture;
             }
@@ -70,27 +61,43 @@ namespace Surge
 
         void RemoveTexture(const String& name);
 
+        // Every change to the material makes a new version, which is copied once into the MaterialTable
+        FORCEINLINE void MarkDirty() { mVersion++; }
+        FORCEINLINE Uint GetVersion() const { return mVersion; }
+
+        // Index of the material in the MaterialTable, pushed as 'MaterialIndex' with the draws that use it
+        Uint GetIndex() const { return mIndex; }
+
         const String& GetName() const { return mName; }
         const ShaderBuffer& GetShaderBuffer() const { return mShaderBuffer; }
+
+        // New material in the MaterialTable with the same values and textures
+        Ref<Material> Clone() const;
         static Ref<Material> Create(const String& shaderName, const String& materialName);
         static Ref<Texture2D> mDummyTexture;
 
-    protected:
+    private:
+        void SetTexture(const String& name, const Ref<Texture2D>& texture);
+
+    private:
+        struct TextureMember
+        {
+            String Name; // Without the "Material." prefix, like "AlbedoMap"
+            Uint MemoryOffset;
+            Ref<Texture2D> Texture;
+        };
+
         Ref<Shader> mShader;
         String mName;
+        Uint mIndex;
 
-        // Buffer
+        // Buffer, laid out like one element of the 'Materials' buffer
         Buffer mBufferMemory;
         ShaderBuffer mShaderBuffer;
-        Ref<UniformBuffer> mUniformBuffer;
-
-        // Textures
-        //   Binding - Res
-        HashMap<Uint, ShaderResource> mShaderResources;
-        HashMap<Uint, Ref<Texture2D>> mTextures;
-
-        Vector<Pair<Uint, Texture2D*>> mUpdatePendingTextures;
+        Vector<TextureMember> mTextures;
 
+        Uint mVersion = 0;
+        Uint mCopiedVersion = 0; // Version in the MaterialTable
         UUID mShaderReloadID;
     };
 
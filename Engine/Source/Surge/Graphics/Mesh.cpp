@@ -1,10 +1,16 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Mesh.hpp"
 #include "Surge/Utility/Filesystem.hpp"
+#include "Surge/Core/Hash.hpp"
+#include "Surge/Asset/AssetManager.hpp"
+#include "Surge/Graphics/MeshCache.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+// Vertices/Faces processed per job while extracting mesh data
+#define MESH_IMPORT_GRAIN_SIZE 4096
+
 namespace Surge
 {
     static glm::mat4 AssimpMat4ToGlmMat4(const aiMatrix4x4& matrix)
@@ -32,56 +38,102 @@ namespace Surge
     static const Uint sMeshImportFlags = aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_GenUVCoords | aiProcess_OptimizeMeshes | aiProcess_ValidateDataStructure |
                                          aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace;
     template <aiTextureType texType>
-    static void LoadTexture(const Path& meshPath, aiMaterial* aiMat, Ref<Material>& material, const String& texName)
+    static void LoadTexture(const Path& meshPath, aiMaterial* aiMat, MeshMaterialDescription& material, const String& texName)
     {
         aiString aiTexPath;
         if (aiMat->GetTexture(texType, 0, &aiTexPath) == aiReturn_SUCCESS)
         {
-            Path texturePath = Filesystem::GetParentPath(meshPath) / String(aiTexPath.data);
-            Log<Severity::Trace>("{0} path: {1}", texName, texturePath);
+            Log<Severity::Trace>("{0} path: {1}", texName, Filesystem::GetParentPath(meshPath) / String(aiTexPath.data));
 
-            TextureSpecification spec;
-            spec.UseMips = true;
-            Ref<Texture2D> texture = Texture2D::Create(texturePath, spec);
-            material->Set<Ref<Texture2D>>(texName, texture);
+            // Decoded later in Mesh::DecodeTextures, cooked meshes only have the paths as well
+            MeshMaterialDescription::TextureMap& textureMap = material.TextureMaps.emplace_back();
+            textureMap.Name = texName;
+            textureMap.FilePath = aiTexPath.data;
         }
         if constexpr (texType == aiTextureType_DIFFUSE)
-            material->Set("Material.Albedo", glm::vec3(1.0f));
+            material.Albedo = glm::vec3(1.0f);
         else if constexpr (texType == aiTextureType_SHININESS)
-            material->Set("Material.Roughness", 1.0f);
+            material.Roughness = 1.0f;
         else if constexpr (texType == aiTextureType_SPECULAR)
-            material->Set("Material.Metalness", 1.0f);
+            material.Metalness = 1.0f;
+    }
+
+    static uint64_t HashSourceFile(const Path& path)
+    {
+        Filesystem::MappedFile file(path);
+        if (!file.IsValid())
+            return 0;
+
+        return Hash::GenerateFromBytes(file.GetData(), static_cast<size_t>(file.GetSize()));
     }
 
-    static void SetValues(aiMaterial* aiMaterial, Ref<Material>& material)
+    static void SetValues(aiMaterial* aiMaterial, MeshMaterialDescription& material)
     {
         //Color
         glm::vec3 albedoColor = {1.0f, 1.0f, 1.0f};
         aiColor3D aiColor;
         if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor) == AI_SUCCESS)
             albedoColor = {aiColor.r, aiColor.g, aiColor.b};
-        material->Set("Material.Albedo", albedoColor);
+        material.Albedo = albedoColor;
 
         //Roughness
         float shininess;
         if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) != aiReturn_SUCCESS)
             shininess = 50.0f;
         float roughness = 1.0f - glm::sqrt(shininess / 100.0f);
-        material->Set<float>("Material.Roughness", roughness);
+        material.Roughness = roughness;
 
         //Metalness
         float metalness = 0.0f;
         aiMaterial->Get(AI_MATKEY_REFLECTIVITY, metalness);
-        material->Set<float>("Material.Metalness", metalness);
+        material.Metalness = metalness;
     }
 
-    Mesh::Mesh(const Path& filepath) : mPath(filepath)
+    Mesh::Mesh(const Path& filepath, bool deferLoading) : mPath(filepath)
     {
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(filepath, sMeshImportFlags);
+        if (deferLoading)
+            return;
+
+        Import();
+        if (GetState() == MeshState::Imported)
+            Upload();
+    }
+
+    void Mesh::Import(uint64_t sourceHash)
+    {
+        SURGE_PROFILE_FUNC("Mesh::Import");
+        mSourceHash = sourceHash ? sourceHash : HashSourceFile(mPath);
+
+        // Assimp only runs if there is no up to date cooked mesh
+        const uint64_t cacheKey = MeshCache::GenerateKey(mSourceHash, sMeshImportFlags);
+        if (!cacheKey || !MeshCache::Load(*this, cacheKey))
+        {
+            mVertices.clear();
+            mIndices.clear();
+            mSubmeshes.clear();
+            mMaterialDescriptions.clear();
+            if (!ImportSource())
+            {
+                Log<Severity::Error>("Failed to load mesh file: {0}", mPath);
+                mState.store(MeshState::Failed, std::memory_order_release);
+                return;
+            }
+
+            if (cacheKey)
+                MeshCache::Store(*this, cacheKey);
+        }
+
+        DecodeTextures();
+        mState.store(MeshState::Imported, std::memory_order_release);
+    }
 
+    bool Mesh::ImportSource()
+    {
+        SURGE_PROFILE_FUNC("Mesh::ImportSource");
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(mPath.Str(), sMeshImportFlags);
         if (!scene || !scene->HasMeshes())
-            Log<Severity::Error>("Failed to load mesh file: {0}", filepath);
+            return false;
 
         Uint vertexCount = 0;
         Uint indexCount = 0;
@@ -102,75 +154,130 @@ namespace Surge
             submesh.MeshName = mesh->mName.C_Str();
             vertexCount += submesh.VertexCount;
             indexCount += submesh.IndexCount;
-
-            GetVertexData(mesh, submesh.BoundingBox);
-            GetIndexData(mesh);
         }
 
+        // Every submesh writes to its own range of the vertex/index arrays, so all of them can be extracted in parallel
+        mVertices.resize(vertexCount);
+        mIndices.resize(indexCount / 3);
+        ThreadPool* threadPool = Core::GetThreadPool();
+        threadPool->ParallelFor<Uint>(0, scene->mNumMeshes, [&](Uint m) {
+            aiMesh* mesh = scene->mMeshes[m];
+            Submesh& submesh = mSubmeshes[m];
+            GetVertexData(mesh, submesh.BaseVertex, submesh.BoundingBox);
+            GetIndexData(mesh, submesh.BaseIndex / 3);
+        });
+
         TraverseNodes(scene->mRootNode);
 
         if (scene->HasMaterials())
         {
-            mMaterials.resize(scene->mNumMaterials);
+            mMaterialDescriptions.resize(scene->mNumMaterials);
             for (Uint i = 0; i < scene->mNumMaterials; i++)
             {
                 aiMaterial* assimpMaterial = scene->mMaterials[i];
-                const String& materialName = assimpMaterial->GetName().C_Str();
-
-                Ref<Material> material = Material::Create("PBR", materialName.empty() ? "NoName" : materialName);
-                mMaterials[i] = material;
+                MeshMaterialDescription& material = mMaterialDescriptions[i];
+                material.Name = assimpMaterial->GetName().C_Str();
 
                 SetValues(assimpMaterial, material);
-                LoadTexture<aiTextureType_DIFFUSE>(mPath, assimpMaterial, mMaterials[i], "AlbedoMap");
-                LoadTexture<aiTextureType_HEIGHT>(mPath, assimpMaterial, mMaterials[i], "NormalMap");
-                LoadTexture<aiTextureType_SHININESS>(mPath, assimpMaterial, mMaterials[i], "RoughnessMap");
-                LoadTexture<aiTextureType_SPECULAR>(mPath, assimpMaterial, mMaterials[i], "MetalnessMap");
+                LoadTexture<aiTextureType_DIFFUSE>(mPath, assimpMaterial, material, "AlbedoMap");
+                LoadTexture<aiTextureType_HEIGHT>(mPath, assimpMaterial, material, "NormalMap");
+                LoadTexture<aiTextureType_SHININESS>(mPath, assimpMaterial, material, "RoughnessMap");
+                LoadTexture<aiTextureType_SPECULAR>(mPath, assimpMaterial, material, "MetalnessMap");
             }
         }
 
-        mVertexBuffer = VertexBuffer::Create(mVertices.data(), static_cast<Uint>(mVertices.size()) * sizeof(Vertex));
-        mIndexBuffer = IndexBuffer::Create(mIndices.data(), static_cast<Uint>(mIndices.size() * sizeof(Index)));
+        return true;
     }
 
-    void Mesh::GetVertexData(const aiMesh* mesh, AABB& outAABB)
+    void Mesh::DecodeTextures()
     {
-        outAABB.Reset();
-        for (size_t i = 0; i < mesh->mNumVertices; i++)
+        // Texture decoding dominates the import of cooked meshes, every material decodes its textures on its own
+        Core::GetThreadPool()->ParallelFor<size_t>(0, mMaterialDescriptions.size(), [this](size_t i) {
+            for (MeshMaterialDescription::TextureMap& textureMap : mMaterialDescriptions[i].TextureMaps)
+                textureMap.Data = TextureData(GetTexturePath(textureMap));
+        });
+    }
+
+    Path Mesh::GetTexturePath(const MeshMaterialDescription::TextureMap& textureMap) const
+    {
+        return Filesystem::GetParentPath(mPath) / textureMap.FilePath;
+    }
+
+    void Mesh::Upload()
+    {
+        SURGE_PROFILE_FUNC("Mesh::Upload");
+        SG_ASSERT(GetState() == MeshState::Imported, "Mesh must be imported before it is uploaded!");
+
+        AssetManager* assetManager = Core::GetAssetManager();
+        mMaterials.resize(mMaterialDescriptions.size());
+        for (size_t i = 0; i < mMaterialDescriptions.size(); i++)
         {
-            Vertex vertex;
-            vertex.Position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
-            vertex.Normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
-
-            outAABB.Min.x = glm::min(vertex.Position.x, outAABB.Min.x);
-            outAABB.Min.y = glm::min(vertex.Position.y, outAABB.Min.y);
-            outAABB.Min.z = glm::min(vertex.Position.z, outAABB.Min.z);
-            outAABB.Max.x = glm::max(vertex.Position.x, outAABB.Max.x);
-            outAABB.Max.y = glm::max(vertex.Position.y, outAABB.Max.y);
-            outAABB.Max.z = glm::max(vertex.Position.z, outAABB.Max.z);
-
-            if (mesh->HasTangentsAndBitangents())
+            MeshMaterialDescription& description = mMaterialDescriptions[i];
+            Ref<Material> material = Material::Create("PBR", description.Name.empty() ? "NoName" : description.Name);
+            mMaterials[i] = material;
+
+            material->Set("Material.Albedo", description.Albedo);
+            material->Set<float>("Material.Roughness", description.Roughness);
+            material->Set<float>("Material.Metalness", description.Metalness);
+
+            TextureSpecification spec;
+            spec.UseMips = true;
+            for (MeshMaterialDescription::TextureMap& textureMap : description.TextureMaps)
             {
-                vertex.Tangent = {mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
-                vertex.Bitangent = {mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
+                if (!textureMap.Data.IsValid())
+                    continue;
+
+                Ref<Texture2D> texture = assetManager->LoadTexture(GetTexturePath(textureMap), textureMap.Data, spec);
+                material->Set<Ref<Texture2D>>(textureMap.Name, texture);
             }
+        }
+        mMaterialDescriptions.clear();
+        mMaterialDescriptions.shrink_to_fit();
 
-            if (mesh->HasTextureCoords(0))
-                vertex.TexCoord = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
-            else
-                vertex.TexCoord = {0.0f, 0.0f};
+        mVertexBuffer = VertexBuffer::Create(mVertices.data(), static_cast<Uint>(mVertices.size()) * sizeof(Vertex));
+        mIndexBuffer = IndexBuffer::Create(mIndices.data(), static_cast<Uint>(mIndices.size() * sizeof(Index)));
+        mState.store(MeshState::Ready, std::memory_order_release);
+    }
 
-            mVertices.push_back(vertex);
-        }
+    void Mesh::GetVertexData(const aiMesh* mesh, Uint baseVertex, AABB& outAABB)
+    {
+        AABB emptyAABB;
+        emptyAABB.Reset();
+
+        const bool hasTangents = mesh->HasTangentsAndBitangents();
+        const bool hasTexCoords = mesh->HasTextureCoords(0);
+        outAABB = Core::GetThreadPool()->ParallelReduce<Uint>(
+            0, mesh->mNumVertices, emptyAABB,
+            [&](Uint i) {
+                Vertex& vertex = mVertices[baseVertex + i];
+                vertex.Position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+                vertex.Normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+
+                if (hasTangents)
+                {
+                    vertex.Tangent = {mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
+                    vertex.Bitangent = {mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
+                }
+
+                if (hasTexCoords)
+                    vertex.TexCoord = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
+                else
+                    vertex.TexCoord = {0.0f, 0.0f};
+
+                return AABB(vertex.Position, vertex.Position);
+            },
+            [](const AABB& a, const AABB& b) { return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max)); },
+            MESH_IMPORT_GRAIN_SIZE);
     }
 
-    void Mesh::GetIndexData(const aiMesh* mesh)
+    void Mesh::GetIndexData(const aiMesh* mesh, Uint baseIndex)
     {
-        for (size_t i = 0; i < mesh->mNumFaces; i++)
-        {
-            SG_ASSERT(mesh->mFaces[i].mNumIndices == 3, "Mesh Must have 3 indices!");
-            Index index = {mesh->mFaces[i].mIndices[0], mesh->mFaces[i].mIndices[1], mesh->mFaces[i].mIndices[2]};
-            mIndices.push_back(index);
-        }
+        Core::GetThreadPool()->ParallelFor<Uint>(
+            0, mesh->mNumFaces, [&](Uint i) {
+                SG_ASSERT(mesh->mFaces[i].mNumIndices == 3, "Mesh Must have 3 indices!");
+                mIndices[baseIndex + i] = {mesh->mFaces[i].mIndices[0], mesh->mFaces[i].mIndices[1], mesh->mFaces[i].mIndices[2]};
+            },
+            MESH_IMPORT_GRAIN_SIZE);
     }
 
     void Mesh::TraverseNodes(aiNode* node, const glm::mat4& parentTransform, Uint level)
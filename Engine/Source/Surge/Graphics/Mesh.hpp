@@ -6,6 +6,7 @@
 #include "Surge/Graphics/Interface/VertexBuffer.hpp"
 #include "Surge/Graphics/Material.hpp"
 #include <glm/glm.hpp>
+#include <atomic>
 
 struct aiMesh;
 struct aiNode;
@@ -41,10 +42,42 @@ namespace Surge
         Uint V1, V2, V3;
     };
 
+    // Everything needed to create a Material of a Mesh, gathered while importing since Materials can only be created on the main thread
+    struct MeshMaterialDescription
+    {
+        struct TextureMap
+        {
+            String Name;
+            String FilePath; // Relative to the mesh file, as written in the source file
+            TextureData Data;
+        };
+
+        String Name;
+        glm::vec3 Albedo = {1.0f, 1.0f, 1.0f};
+        float Roughness = 1.0f;
+        float Metalness = 0.0f;
+        Vector<TextureMap> TextureMaps;
+    };
+
+    enum class MeshState
+    {
+        Loading, // Being imported on a worker thread
+        Imported, // Imported, waiting for the GPU upload on the main thread
+        Ready,
+        Failed
+    };
+
     class SURGE_API Mesh : public RefCounted
     {
     public:
-        Mesh(const Path& filepath);
+        // Imports and uploads the Mesh right away. If 'deferLoading' is true the Mesh is created empty, in the Loading state,
+        // and it is up to the AssetManager to import and upload it (see AssetManager::LoadMeshAsync)
+        Mesh(const Path& filepath, bool deferLoading = false);
+
+        FORCEINLINE MeshState GetState() const { return mState.load(std::memory_order_acquire); }
+
+        // Buffers, submeshes and materials must not be accessed before the Mesh is ready
+        FORCEINLINE bool IsReady() const { return GetState() == MeshState::Ready; }
 
         // Returns the path from which the Mesh was loaded
         FORCEINLINE const Path& GetPath() const { return mPath; }
@@ -60,13 +93,31 @@ namespace Surge
 
         FORCEINLINE Vector<Ref<Material>>& GetMaterials() { return mMaterials; }
 
+        // CPU side copies of the data in the vertex/index buffers
+        FORCEINLINE const Vector<Vertex>& GetVertices() const { return mVertices; }
+        FORCEINLINE const Vector<Index>& GetIndices() const { return mIndices; }
+
     private:
-        void GetVertexData(const aiMesh* mesh, AABB& outAABB);
-        void GetIndexData(const aiMesh* mesh);
+        // CPU side of the loading, reads the cooked mesh from the MeshCache (or the source file with Assimp if there is none)
+        // and decodes the textures. 'sourceHash' is the hash of the contents of the source file, it is computed here if 0.
+        // Safe to call from a worker thread
+        void Import(uint64_t sourceHash = 0);
+        bool ImportSource();
+        void DecodeTextures();
+        Path GetTexturePath(const MeshMaterialDescription::TextureMap& textureMap) const;
+
+        // Creates the GPU buffers, Materials and Textures. Main thread only
+        void Upload();
+
+        void GetVertexData(const aiMesh* mesh, Uint baseVertex, AABB& outAABB);
+        void GetIndexData(const aiMesh* mesh, Uint baseIndex);
         void TraverseNodes(aiNode* node, const glm::mat4& parentTransform = glm::mat4(1.0f), Uint level = 0);
 
     private:
         Path mPath;
+        std::atomic<MeshState> mState = MeshState::Loading;
+        uint64_t mSourceHash = 0; // Hash of the contents of the source file, set by Import(). 0 if it cannot be read
+        Vector<MeshMaterialDescription> mMaterialDescriptions; // Only alive between Import() and Upload()
         Vector<Submesh> mSubmeshes;
 
         Ref<VertexBuffer> mVertexBuffer;
@@ -75,6 +126,9 @@ namespace Surge
 
         Vector<Vertex> mVertices;
         Vector<Index> mIndices;
+
+        friend class AssetManager;
+        friend class MeshCache;
     };
 
 } // namespace Surge
\ No newline at end of file
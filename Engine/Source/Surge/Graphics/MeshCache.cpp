@@ -0,0 +1,329 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/MeshCache.hpp"
+#include "Surge/Core/Hash.hpp"
+#include "Surge/Utility/Filesystem.hpp"
+#include <filesystem>
+
+// "SGMC", little endian
+#define MESH_CACHE_MAGIC 0x434D4753
+
+// Must be bumped whenever the file layout, any record or the Vertex/Index structs change
+#define MESH_CACHE_VERSION 1
+
+// Every section starts at a multiple of this, so that records can be used in place from the mapped file
+#define MESH_CACHE_ALIGNMENT 16
+
+#define MESH_CACHE_EXTENSION ".smesh"
+
+namespace Surge
+{
+    namespace
+    {
+        // File layout:
+        // [FileHeader][vertices][indices][submeshes][materials][texture maps][blob]
+        // All offsets are from the start of the file, strings live in the blob and are referenced with a BlobRef
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t Key;
+            uint32_t VertexCount;
+            uint32_t IndexCount; // Number of Index records (triangles)
+            uint32_t SubmeshCount;
+            uint32_t MaterialCount;
+            uint32_t TextureMapCount;
+            uint32_t Reserved;
+            uint64_t VertexOffset;
+            uint64_t IndexOffset;
+            uint64_t SubmeshOffset;
+            uint64_t MaterialOffset;
+            uint64_t TextureMapOffset;
+            uint64_t BlobOffset;
+            uint64_t BlobSize;
+        };
+
+        struct BlobRef
+        {
+            uint32_t Offset;
+            uint32_t Size; // In bytes
+        };
+
+        struct SubmeshRecord
+        {
+            Uint BaseVertex;
+            Uint BaseIndex;
+            Uint MaterialIndex;
+            Uint IndexCount;
+            Uint VertexCount;
+            glm::vec3 BoundsMin;
+            glm::vec3 BoundsMax;
+            glm::mat4 Transform;
+            glm::mat4 LocalTransform;
+            BlobRef NodeName;
+            BlobRef MeshName;
+        };
+
+        struct MaterialRecord
+        {
+            BlobRef Name;
+            glm::vec3 Albedo;
+            float Roughness;
+            float Metalness;
+            uint32_t FirstTextureMap;
+            uint32_t TextureMapCount;
+        };
+
+        struct TextureMapRecord
+        {
+            BlobRef Name;
+            BlobRef FilePath;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Vertex>);
+        static_assert(std::is_trivially_copyable_v<Index>);
+
+        uint64_t AlignUp(uint64_t value)
+        {
+            return (value + MESH_CACHE_ALIGNMENT - 1) & ~static_cast<uint64_t>(MESH_CACHE_ALIGNMENT - 1);
+        }
+
+        BlobRef WriteToBlob(Vector<Byte>& blob, const String& string)
+        {
+            BlobRef ref = {static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(string.size())};
+            blob.insert(blob.end(), string.begin(), string.end());
+            return ref;
+        }
+
+        // Bounds checked access to the mapped file
+        class MeshFileView
+        {
+        public:
+            MeshFileView(const Byte* data, uint64_t size)
+                : mData(data), mSize(size) {}
+
+            template <typename T>
+            const T* Get(uint64_t offset, uint64_t count) const
+            {
+                if (offset % alignof(T) != 0 || offset > mSize || count > (mSize - offset) / sizeof(T))
+                    return nullptr;
+                return reinterpret_cast<const T*>(mData + offset);
+            }
+
+        private:
+            const Byte* mData;
+            uint64_t mSize;
+        };
+    } // namespace
+
+    uint64_t MeshCache::GenerateKey(uint64_t sourceHash, Uint importFlags)
+    {
+        if (!sourceHash)
+            return 0;
+
+        uint64_t key = Hash::Combine(sourceHash, importFlags);
+        key = Hash::Combine(key, MESH_CACHE_VERSION);
+        return key;
+    }
+
+    bool MeshCache::Load(Mesh& mesh, uint64_t key)
+    {
+        SURGE_PROFILE_FUNC("MeshCache::Load");
+        const String cachePath = GetCachePath(mesh.mPath);
+        if (!Filesystem::Exists(cachePath))
+            return false;
+
+        if (ReadCookedMesh(mesh, key, cachePath))
+            return true;
+
+        // The entry is outdated or corrupted, it would never be loaded again, so it is removed right away (Store
+        // overwrites it anyway if the import succeeds)
+        std::error_code error;
+        std::filesystem::remove(cachePath, error);
+        return false;
+    }
+
+    bool MeshCache::ReadCookedMesh(Mesh& mesh, uint64_t key, const String& cachePath)
+    {
+        Filesystem::MappedFile file(cachePath);
+        if (!file.IsValid())
+            return false;
+
+        MeshFileView view(file.GetData(), file.GetSize());
+        const FileHeader* header = view.Get<FileHeader>(0, 1);
+        if (!header || header->Magic != MESH_CACHE_MAGIC || header->Version != MESH_CACHE_VERSION || header->Key != key)
+            return false;
+
+        const Vertex* vertices = view.Get<Vertex>(header->VertexOffset, header->VertexCount);
+        const Index* indices = view.Get<Index>(header->IndexOffset, header->IndexCount);
+        const SubmeshRecord* submeshes = view.Get<SubmeshRecord>(header->SubmeshOffset, header->SubmeshCount);
+        const MaterialRecord* materials = view.Get<MaterialRecord>(header->MaterialOffset, header->MaterialCount);
+        const TextureMapRecord* textureMaps = view.Get<TextureMapRecord>(header->TextureMapOffset, header->TextureMapCount);
+        const char* blob = view.Get<char>(header->BlobOffset, header->BlobSize);
+        if (!vertices || !indices || !submeshes || !materials || !textureMaps || !blob)
+        {
+            Log<Severity::Warn>("Cooked mesh '{0}' is corrupted, reimporting {1}", cachePath, mesh.mPath);
+            return false;
+        }
+
+        auto isValid = [header](const BlobRef& ref) { return static_cast<uint64_t>(ref.Offset) + ref.Size <= header->BlobSize; };
+        auto getString = [blob](const BlobRef& ref) { return String(blob + ref.Offset, ref.Size); };
+
+        mesh.mVertices.assign(vertices, vertices + header->VertexCount);
+        mesh.mIndices.assign(indices, indices + header->IndexCount);
+
+        mesh.mSubmeshes.resize(header->SubmeshCount);
+        for (uint32_t i = 0; i < header->SubmeshCount; i++)
+        {
+            const SubmeshRecord& record = submeshes[i];
+            const bool inRange = static_cast<uint64_t>(record.BaseVertex) + record.VertexCount <= header->VertexCount &&
+                                 static_cast<uint64_t>(record.BaseIndex) + record.IndexCount <= static_cast<uint64_t>(header->IndexCount) * 3 &&
+                                 record.MaterialIndex < std::max<uint32_t>(header->MaterialCount, 1);
+            if (!inRange || !isValid(record.NodeName) || !isValid(record.MeshName))
+                return false;
+
+            Submesh& submesh = mesh.mSubmeshes[i];
+            submesh.BaseVertex = record.BaseVertex;
+            submesh.BaseIndex = record.BaseIndex;
+            submesh.MaterialIndex = record.MaterialIndex;
+            submesh.IndexCount = record.IndexCount;
+            submesh.VertexCount = record.VertexCount;
+            submesh.BoundingBox = AABB(record.BoundsMin, record.BoundsMax);
+            submesh.Transform = record.Transform;
+            submesh.LocalTransform = record.LocalTransform;
+            submesh.NodeName = getString(record.NodeName);
+            submesh.MeshName = getString(record.MeshName);
+        }
+
+        mesh.mMaterialDescriptions.resize(header->MaterialCount);
+        for (uint32_t i = 0; i < header->MaterialCount; i++)
+        {
+            const MaterialRecord& record = materials[i];
+            if (!isValid(record.Name) || static_cast<uint64_t>(record.FirstTextureMap) + record.TextureMapCount > header->TextureMapCount)
+                return false;
+
+            MeshMaterialDescription& material = mesh.mMaterialDescriptions[i];
+            material.Name = getString(record.Name);
+            material.Albedo = record.Albedo;
+            material.Roughness = record.Roughness;
+            material.Metalness = record.Metalness;
+            material.TextureMaps.resize(record.TextureMapCount);
+            for (uint32_t t = 0; t < record.TextureMapCount; t++)
+            {
+                const TextureMapRecord& textureMap = textureMaps[record.FirstTextureMap + t];
+                if (!isValid(textureMap.Name) || !isValid(textureMap.FilePath))
+                    return false;
+
+                material.TextureMaps[t].Name = getString(textureMap.Name);
+                material.TextureMaps[t].FilePath = getString(textureMap.FilePath);
+            }
+        }
+
+        return true;
+    }
+
+    void MeshCache::Store(const Mesh& mesh, uint64_t key)
+    {
+        SURGE_PROFILE_FUNC("MeshCache::Store");
+        Vector<SubmeshRecord> submeshes;
+        Vector<MaterialRecord> materials;
+        Vector<TextureMapRecord> textureMaps;
+        Vector<Byte> blob;
+
+        submeshes.reserve(mesh.mSubmeshes.size());
+        for (const Submesh& submesh : mesh.mSubmeshes)
+        {
+            SubmeshRecord& record = submeshes.emplace_back();
+            record.BaseVertex = submesh.BaseVertex;
+            record.BaseIndex = submesh.BaseIndex;
+            record.MaterialIndex = submesh.MaterialIndex;
+            record.IndexCount = submesh.IndexCount;
+            record.VertexCount = submesh.VertexCount;
+            record.BoundsMin = submesh.BoundingBox.Min;
+            record.BoundsMax = submesh.BoundingBox.Max;
+            record.Transform = submesh.Transform;
+            record.LocalTransform = submesh.LocalTransform;
+            record.NodeName = WriteToBlob(blob, submesh.NodeName);
+            record.MeshName = WriteToBlob(blob, submesh.MeshName);
+        }
+
+        materials.reserve(mesh.mMaterialDescriptions.size());
+        for (const MeshMaterialDescription& material : mesh.mMaterialDescriptions)
+        {
+            MaterialRecord& record = materials.emplace_back();
+            record.Name = WriteToBlob(blob, material.Name);
+            record.Albedo = material.Albedo;
+            record.Roughness = material.Roughness;
+            record.Metalness = material.Metalness;
+            record.FirstTextureMap = static_cast<uint32_t>(textureMaps.size());
+            record.TextureMapCount = static_cast<uint32_t>(material.TextureMaps.size());
+            for (const MeshMaterialDescription::TextureMap& textureMap : material.TextureMaps)
+                textureMaps.push_back({WriteToBlob(blob, textureMap.Name), WriteToBlob(blob, textureMap.FilePath)});
+        }
+
+        FileHeader header = {};
+        header.Magic = MESH_CACHE_MAGIC;
+        header.Version = MESH_CACHE_VERSION;
+        header.Key = key;
+        header.VertexCount = static_cast<uint32_t>(mesh.mVertices.size());
+        header.IndexCount = static_cast<uint32_t>(mesh.mIndices.size());
+        header.SubmeshCount = static_cast<uint32_t>(submeshes.size());
+        header.MaterialCount = static_cast<uint32_t>(materials.size());
+        header.TextureMapCount = static_cast<uint32_t>(textureMaps.size());
+
+        Vector<Byte> data(sizeof(FileHeader), 0);
+        auto appendSection = [&data](const void* source, uint64_t size) -> uint64_t {
+            const uint64_t offset = AlignUp(data.size());
+            data.resize(offset + size);
+            if (size)
+                std::memcpy(data.data() + offset, source, size);
+            return offset;
+        };
+        header.VertexOffset = appendSection(mesh.mVertices.data(), mesh.mVertices.size() * sizeof(Vertex));
+        header.IndexOffset = appendSection(mesh.mIndices.data(), mesh.mIndices.size() * sizeof(Index));
+        header.SubmeshOffset = appendSection(submeshes.data(), submeshes.size() * sizeof(SubmeshRecord));
+        header.MaterialOffset = appendSection(materials.data(), materials.size() * sizeof(MaterialRecord));
+        header.TextureMapOffset = appendSection(textureMaps.data(), textureMaps.size() * sizeof(TextureMapRecord));
+        header.BlobOffset = appendSection(blob.data(), blob.size());
+        header.BlobSize = blob.size();
+        std::memcpy(data.data(), &header, sizeof(FileHeader));
+
+        std::error_code error;
+        std::filesystem::create_directories(MESH_CACHE_PATH, error);
+
+        // Written under a temporary name first, another thread might be loading the same cooked mesh
+        const String cachePath = GetCachePath(mesh.mPath);
+        const String tempPath = fmt::format("{0}.{1}.tmp", cachePath, std::hash<std::thread::id>()(std::this_thread::get_id()));
+        FILE* f;
+        errno_t e = fopen_s(&f, tempPath.c_str(), "wb");
+        if (!f)
+        {
+            Log<Severity::Error>("Cannot open path({0}) for writing the cooked mesh!", tempPath);
+            return;
+        }
+        fwrite(data.data(), sizeof(Byte), data.size(), f);
+        fclose(f);
+
+        std::filesystem::rename(tempPath, cachePath, error);
+        if (error)
+            std::filesystem::remove(tempPath, error);
+        else
+            Log<Severity::Debug>("Cached Mesh at: {0}", cachePath);
+    }
+
+    void MeshCache::Remove(const Path& sourcePath)
+    {
+        std::error_code error;
+        std::filesystem::remove(GetCachePath(sourcePath), error);
+    }
+
+    String MeshCache::GetCachePath(const Path& sourcePath)
+    {
+        // One entry per source file, named after its path so that files with the same name in different folders don't clash.
+        // The key in the header tells if the entry is up to date, and a newer cook replaces the old one instead of piling up
+        const String& path = sourcePath.Str();
+        const uint64_t pathHash = Hash::GenerateFromBytes(path.data(), path.size());
+        return fmt::format("{0}/{1}.{2:016x}{3}", MESH_CACHE_PATH, Filesystem::GetNameWithExtension(sourcePath), pathHash, MESH_CACHE_EXTENSION);
+    }
+
+} // namespace Surge
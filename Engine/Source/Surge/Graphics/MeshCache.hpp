@@ -0,0 +1,34 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Mesh.hpp"
+
+#define MESH_CACHE_PATH "Engine/Assets/Temp/MeshCache"
+
+namespace Surge
+{
+    // Cooked meshes, works like the SPIR-V cache of the ShaderSet.
+    // Everything Assimp produces for a mesh file (vertices, indices, submeshes and material bindings) is dumped to a binary
+    // file in MESH_CACHE_PATH, one per source file, stamped with a key made from the contents of the source file and the import
+    // flags. Loading a cooked mesh is a single memory mapping and a few copies, Assimp only runs when the source file or the
+    // flags change, and the new cook overwrites the outdated one
+    class SURGE_API MeshCache
+    {
+    public:
+        // 'sourceHash' is the hash of the contents of the source file. Returns 0 if it is 0 (the source file cannot be read),
+        // which means the mesh shouldn't be cached
+        static uint64_t GenerateKey(uint64_t sourceHash, Uint importFlags);
+
+        // Fills the vertices, indices, submeshes and material descriptions of 'mesh'. Returns false if there
+        // is no cooked mesh for 'key' or if it is outdated/corrupted, in which case the stale entry is deleted
+        static bool Load(Mesh& mesh, uint64_t key);
+        static void Store(const Mesh& mesh, uint64_t key);
+
+        // Deletes the cooked mesh of 'sourcePath', if there is one
+        static void Remove(const Path& sourcePath);
+
+    private:
+        static bool ReadCookedMesh(Mesh& mesh, uint64_t key, const String& cachePath);
+        static String GetCachePath(const Path& sourcePath);
+    };
+
+} // namespace Surge
@@ -0,0 +1,113 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/PipelineLibrary.hpp"
+#include "Surge/Core/Core.hpp"
+#include "Surge/Core/Hash.hpp"
+
+namespace Surge
+{
+    Ref<GraphicsPipeline> PipelineLibrary::GetGraphicsPipeline(const GraphicsPipelineSpecification& spec)
+    {
+        SURGE_PROFILE_FUNC("PipelineLibrary::GetGraphicsPipeline");
+        auto itr = mGraphicsPipelines.find(spec);
+        if (itr == mGraphicsPipelines.end())
+        {
+            Entry& entry = mGraphicsPipelines[spec];
+            entry.Pipeline = GraphicsPipeline::Create(spec);
+            return entry.Pipeline;
+        }
+
+        Entry& entry = itr->second;
+        if (entry.Pending)
+        {
+            Core::GetThreadPool()->Wait(entry.CreationJob);
+            entry.Pending = false;
+        }
+        return entry.Pipeline;
+    }
+
+    void PipelineLibrary::PrecompileGraphicsPipeline(const GraphicsPipelineSpecification& spec)
+    {
+        auto [itr, inserted] = mGraphicsPipelines.try_emplace(spec);
+        if (!inserted)
+            return;
+
+        // The Ref is created here, the job only gets the raw pointer. Ref isn't thread safe
+        Entry& entry = itr->second;
+        entry.Pipeline = GraphicsPipeline::Create(spec, true);
+        GraphicsPipeline* pipeline = entry.Pipeline.Raw();
+        entry.CreationJob = Core::GetThreadPool()->Run([pipeline]() { pipeline->Reload(); });
+        entry.Pending = true;
+    }
+
+    void PipelineLibrary::ReleaseUnused()
+    {
+        for (auto itr = mGraphicsPipelines.begin(); itr != mGraphicsPipelines.end();)
+        {
+            if (!itr->second.Pending && itr->second.Pipeline->GetRefCount() == 1)
+                itr = mGraphicsPipelines.erase(itr);
+            else
+                ++itr;
+        }
+    }
+
+    void PipelineLibrary::Clear()
+    {
+        ThreadPool* threadPool = Core::GetThreadPool();
+        for (auto& [key, entry] : mGraphicsPipelines)
+        {
+            if (entry.Pending)
+                threadPool->Wait(entry.CreationJob);
+        }
+        mGraphicsPipelines.clear();
+    }
+
+    uint64_t PipelineLibrary::HashSpecification(const GraphicsPipelineSpecification& spec)
+    {
+        uint32_t lineWidth; // Set when the pipeline is bound, so it must be part of the key
+        std::memcpy(&lineWidth, &spec.LineWidth, sizeof(uint32_t));
+
+        Vector<uint64_t> values = {
+            reinterpret_cast<uint64_t>(spec.Shader.Raw()),
+            static_cast<uint64_t>(spec.Topology),
+            static_cast<uint64_t>(spec.PolygonMode),
+            static_cast<uint64_t>(spec.CullingMode),
+            static_cast<uint64_t>(spec.DepthCompOperation),
+            static_cast<uint64_t>(spec.UseDepth),
+            static_cast<uint64_t>(spec.UseStencil),
+            static_cast<uint64_t>(lineWidth),
+        };
+
+        // Render pass compatibility, no framebuffer means the swapchain
+        if (spec.TargetFramebuffer)
+        {
+            for (const FramebufferAttachmentSpec& attachment : spec.TargetFramebuffer->GetSpecification().AttachmentSpecs)
+                values.push_back(static_cast<uint64_t>(attachment.Format) + 1);
+        }
+        return Hash::GenerateFromBytes(values.data(), values.size() * sizeof(uint64_t));
+    }
+
+    bool PipelineLibrary::IsCompatible(const GraphicsPipelineSpecification& a, const GraphicsPipelineSpecification& b)
+    {
+        // LineWidth is compared bitwise, like it is hashed
+        if (a.Shader.Raw() != b.Shader.Raw() || a.Topology != b.Topology || a.PolygonMode != b.PolygonMode || a.CullingMode != b.CullingMode ||
+            a.DepthCompOperation != b.DepthCompOperation || a.UseDepth != b.UseDepth || a.UseStencil != b.UseStencil ||
+            std::memcmp(&a.LineWidth, &b.LineWidth, sizeof(float)) != 0)
+            return false;
+
+        if (!a.TargetFramebuffer || !b.TargetFramebuffer)
+            return !a.TargetFramebuffer && !b.TargetFramebuffer;
+
+        const Vector<FramebufferAttachmentSpec>& attachmentsA = a.TargetFramebuffer->GetSpecification().AttachmentSpecs;
+        const Vector<FramebufferAttachmentSpec>& attachmentsB = b.TargetFramebuffer->GetSpecification().AttachmentSpecs;
+        if (attachmentsA.size() != attachmentsB.size())
+            return false;
+
+        for (size_t i = 0; i < attachmentsA.size(); i++)
+        {
+            if (attachmentsA[i].Format != attachmentsB[i].Format)
+                return false;
+        }
+        return true;
+    }
+
+} // namespace Surge
@@ -0,0 +1,57 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Thread/Job.hpp"
+#include "Surge/Graphics/Interface/GraphicsPipeline.hpp"
+#include <unordered_map>
+
+namespace Surge
+{
+    // Shared GraphicsPipeline(s), looked up by their GraphicsPipelineSpecification.
+    // Two specifications that only differ in their TargetFramebuffer get the same pipeline as long as the framebuffers
+    // are render pass compatible (same attachment formats), the DebugName is ignored. Main thread only
+    class SURGE_API PipelineLibrary
+    {
+    public:
+        PipelineLibrary() = default;
+        ~PipelineLibrary() { Clear(); }
+        SURGE_DISABLE_COPY_AND_MOVE(PipelineLibrary);
+
+        // Returns the pipeline right away if it exists, otherwise creates it. Waits for it if it is being created asynchronously
+        Ref<GraphicsPipeline> GetGraphicsPipeline(const GraphicsPipelineSpecification& spec);
+
+        // Starts creating the pipeline on the worker threads, so that a later GetGraphicsPipeline() doesn't have to wait (as long)
+        void PrecompileGraphicsPipeline(const GraphicsPipelineSpecification& spec);
+
+        // Destroys the pipelines that aren't used outside of the library. A pipeline keeps its shader and TargetFramebuffer alive
+        void ReleaseUnused();
+        void Clear();
+
+        static uint64_t HashSpecification(const GraphicsPipelineSpecification& spec);
+
+        // True if both specifications can use the same pipeline, everything HashSpecification() looks at is the same
+        static bool IsCompatible(const GraphicsPipelineSpecification& a, const GraphicsPipelineSpecification& b);
+
+    private:
+        struct Entry
+        {
+            Ref<GraphicsPipeline> Pipeline; // Keeps the pipeline alive while the creation job uses it
+            JobHandle CreationJob;
+            bool Pending = false;
+        };
+
+        struct SpecHasher
+        {
+            size_t operator()(const GraphicsPipelineSpecification& spec) const { return static_cast<size_t>(HashSpecification(spec)); }
+        };
+
+        struct SpecEqual
+        {
+            bool operator()(const GraphicsPipelineSpecification& a, const GraphicsPipelineSpecification& b) const { return IsCompatible(a, b); }
+        };
+
+    private:
+        // Keyed by the whole specification, two specifications with the same hash don't share a pipeline unless they are compatible
+        std::unordered_map<GraphicsPipelineSpecification, Entry, SpecHasher, SpecEqual> mGraphicsPipelines;
+    };
+
+} // namespace Surge
@@ -21,6 +21,36 @@ namespace Surge
         uint64_t Free = 0;
     };
 
+    struct PipelineStats
+    {
+        Uint PipelineCount = 0;         // Pipelines created since startup
+        float TotalCreationTime = 0.0f; // In ms, time spent in the driver creating all of them
+        float LastCreationTime = 0.0f;  // In ms
+        float MaxCreationTime = 0.0f;   // In ms
+        uint64_t InitialCacheSize = 0;  // Size of the pipeline cache loaded from disk in bytes, 0 on a cold start
+    };
+
+    struct DescriptorStats
+    {
+        Uint AllocatedSets = 0;      // Last frame
+        Uint CacheHits = 0;          // Last frame, sets of the descriptor cache that were reused
+        Uint CacheMisses = 0;        // Last frame, sets of the descriptor cache that were allocated and written
+        Uint WrittenDescriptors = 0; // Last frame
+        Uint CachedSets = 0;
+        Uint CachedLayouts = 0;
+        Uint PoolCount = 0; // Descriptor pools created by the allocators
+    };
+
+    struct UploadStats
+    {
+        Uint UploadCount = 0;       // Last frame, buffers and images
+        uint64_t UploadedBytes = 0; // Last frame
+        Uint SubmittedBatches = 0;  // Last frame
+        Uint PendingBatches = 0;    // Submitted, but not done on the GPU yet
+        uint64_t StagingUsage = 0;  // Bytes of the staging ring that are not free yet
+        uint64_t StagingSize = 0;
+    };
+
     enum class SURGE_API GPUMemoryUsage
     {
         Unknown = 0,
@@ -48,7 +78,8 @@ namespace Surge
         virtual void EndFrame() = 0;
 
         virtual void OnResize() = 0;
-        virtual Uint GetFrameIndex() const = 0;
+        virtual Uint GetFrameIndex() const = 0;  // Index of the frame in flight, [0, FRAMES_IN_FLIGHT)
+        virtual uint64_t GetFrameCount() const = 0; // Number of frames presented since startup
 
         // Maybe move ImGui stuff somwhere else?
         virtual void RenderImGui() = 0;
@@ -56,6 +87,9 @@ namespace Surge
         virtual void* GetImGuiContext() = 0;
         virtual GPUMemoryStats GetMemoryStatus() const = 0;
         virtual GPUInfo GetGPUInfo() const = 0;
+        virtual PipelineStats GetPipelineStats() const = 0;
+        virtual DescriptorStats GetDescriptorStats() const = 0;
+        virtual UploadStats GetUploadStats() const = 0;
     };
 
 } // namespace Surge
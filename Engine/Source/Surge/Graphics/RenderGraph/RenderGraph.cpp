@@ -0,0 +1,402 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/RenderGraph/RenderGraph.hpp"
+#include "Surge/Core/Profiler.hpp"
+#include <algorithm>
+
+namespace Surge
+{
+    RenderGraphResource RenderGraphBuilder::CreateImage(const String& name, const RenderGraphImageDesc& desc)
+    {
+        const RenderGraphResource index = mGraph->GetOrAddResource(name);
+        RenderGraph::Resource& resource = mGraph->mResources[index];
+        SG_ASSERT(resource.Type == RenderGraph::ResourceType::None, "RenderGraph resource '{0}' is declared twice!", name);
+        SG_ASSERT(desc.Width && desc.Height, "RenderGraph image '{0}' has an invalid size!", name);
+        resource.Type = RenderGraph::ResourceType::Image;
+        resource.ImageDesc = desc;
+        return index;
+    }
+
+    RenderGraphResource RenderGraphBuilder::ImportBuffer(const String& name, const Ref<StorageBuffer>& buffer)
+    {
+        const RenderGraphResource index = mGraph->GetOrAddResource(name);
+        RenderGraph::Resource& resource = mGraph->mResources[index];
+        SG_ASSERT(resource.Type == RenderGraph::ResourceType::None, "RenderGraph resource '{0}' is declared twice!", name);
+        resource.Type = RenderGraph::ResourceType::Buffer;
+        resource.Buffer = buffer;
+        return index;
+    }
+
+    RenderGraphResource RenderGraphBuilder::Read(const String& name, ResourceState state)
+    {
+        SG_ASSERT(!IsWriteState(state), "'{0}' is read in a write state!", name);
+        return AddAccess(mGraph->GetOrAddResource(name), state);
+    }
+
+    RenderGraphResource RenderGraphBuilder::Write(const String& name, ResourceState state)
+    {
+        SG_ASSERT(IsWriteState(state), "'{0}' is written in a read state!", name);
+        return AddAccess(mGraph->GetOrAddResource(name), state);
+    }
+
+    void RenderGraphBuilder::AddRenderTarget(const Ref<Framebuffer>& framebuffer, const Vector<RenderGraphResource>& colors, RenderGraphResource depth)
+    {
+        SG_ASSERT(framebuffer->GetSpecification().ExternalAttachments, "RenderGraph render targets must be created with ExternalAttachments!");
+        mGraph->mPasses[mPass].Targets.push_back({framebuffer, colors, depth});
+
+        for (RenderGraphResource color : colors)
+            AddAccess(color, ResourceState::ColorAttachment);
+        if (depth != INVALID_RENDER_GRAPH_RESOURCE)
+            AddAccess(depth, ResourceState::DepthAttachment);
+    }
+
+    void RenderGraphBuilder::MarkOutput(RenderGraphResource resource, ResourceState finalState)
+    {
+        RenderGraph::Resource& output = mGraph->mResources[resource];
+        output.Output = true;
+        output.FinalState = finalState;
+    }
+
+    void RenderGraphBuilder::MarkPersistent(RenderGraphResource resource)
+    {
+        RenderGraph::Resource& persistent = mGraph->mResources[resource];
+        SG_ASSERT(persistent.Type == RenderGraph::ResourceType::Image, "Only images can be persistent, '{0}' is not an image!", persistent.Name);
+        persistent.Persistent = true;
+    }
+
+    RenderGraphResource RenderGraphBuilder::AddAccess(RenderGraphResource resource, ResourceState state)
+    {
+        RenderGraph::Pass& pass = mGraph->mPasses[mPass];
+        RenderGraph::Resource& usedResource = mGraph->mResources[resource];
+        for (const RenderGraph::ResourceAccess& access : pass.Accesses)
+            SG_ASSERT(access.Resource != resource, "'{0}' is used more than once by the same pass!", usedResource.Name);
+
+        if (IsWriteState(state))
+        {
+            SG_ASSERT(usedResource.Writer == INVALID_RENDER_GRAPH_RESOURCE, "'{0}' is written by more than one pass!", usedResource.Name);
+            usedResource.Writer = mPass;
+        }
+
+        pass.Accesses.push_back({resource, state});
+        return resource;
+    }
+
+    void RenderGraph::Reset()
+    {
+        mPasses.clear();
+        mResources.clear();
+        mResourceIndices.clear();
+        mExecutionOrder.clear();
+        mMemoryBlocks.clear();
+        mFinalBarriers = {};
+        mStats = {};
+        mExecuted = false;
+    }
+
+    RenderGraphBuilder RenderGraph::AddPass(RenderProcedure* procedure)
+    {
+        Pass& pass = mPasses.emplace_back();
+        pass.Procedure = procedure;
+        return RenderGraphBuilder(this, static_cast<Uint>(mPasses.size() - 1));
+    }
+
+    const Ref<Image2D>& RenderGraph::GetImage(RenderGraphResource resource) const
+    {
+        const Resource& image = mResources[resource];
+        SG_ASSERT(image.Type == ResourceType::Image, "'{0}' is not an image!", image.Name);
+        return image.Image;
+    }
+
+    RenderGraphResource RenderGraph::GetOrAddResource(const String& name)
+    {
+        auto itr = mResourceIndices.find(name);
+        if (itr != mResourceIndices.end())
+            return itr->second;
+
+        const RenderGraphResource index = static_cast<RenderGraphResource>(mResources.size());
+        mResources.emplace_back().Name = name;
+        mResourceIndices[name] = index;
+        return index;
+    }
+
+    void RenderGraph::Compile()
+    {
+        SURGE_PROFILE_FUNC("RenderGraph::Compile");
+        for (const Resource& resource : mResources)
+        {
+            SG_ASSERT(resource.Type != ResourceType::None, "RenderGraph resource '{0}' is used, but no pass declares it!", resource.Name);
+            SG_ASSERT(resource.Type != ResourceType::Image || resource.Writer != INVALID_RENDER_GRAPH_RESOURCE, "RenderGraph image '{0}' is never written!", resource.Name);
+        }
+
+        SortPasses();
+        CullPasses();
+
+        // Lifetimes, outputs and persistent images are used before and after the graph so they are alive for the whole frame
+        const Uint executedPassCount = static_cast<Uint>(mExecutionOrder.size());
+        for (Uint position = 0; position < executedPassCount; position++)
+        {
+            for (const ResourceAccess& access : mPasses[mExecutionOrder[position]].Accesses)
+            {
+                Resource& resource = mResources[access.Resource];
+                resource.FirstUse = std::min(resource.FirstUse, position);
+                resource.LastUse = std::max(resource.LastUse, position);
+            }
+        }
+        for (Resource& resource : mResources)
+        {
+            if ((resource.Output || resource.Persistent) && resource.FirstUse != INVALID_RENDER_GRAPH_RESOURCE)
+            {
+                resource.FirstUse = 0;
+                resource.LastUse = executedPassCount;
+            }
+        }
+
+        AllocateImages();
+
+        for (Uint passIndex : mExecutionOrder)
+        {
+            for (const RenderTarget& target : mPasses[passIndex].Targets)
+            {
+                Vector<Ref<Image2D>> attachments;
+                for (RenderGraphResource color : target.Colors)
+                    attachments.push_back(GetImage(color));
+                if (target.Depth != INVALID_RENDER_GRAPH_RESOURCE)
+                    attachments.push_back(GetImage(target.Depth));
+                target.Framebuffer->SetExternalAttachments(attachments);
+            }
+        }
+
+        BuildBarriers();
+        mExecuted = false;
+
+        mStats.PassCount = static_cast<Uint>(mPasses.size());
+        mStats.CulledPassCount = mStats.PassCount - executedPassCount;
+        mStats.BarrierCount = mFinalBarriers.GetCount();
+        for (Uint passIndex : mExecutionOrder)
+            mStats.BarrierCount += mPasses[passIndex].Barriers.GetCount();
+    }
+
+    void RenderGraph::SortPasses()
+    {
+        // Kahn's algorithm, always picking the first pass that is ready so that independent passes keep the order they were added in
+        const Uint passCount = static_cast<Uint>(mPasses.size());
+        Vector<Uint> dependencyCounts(passCount, 0);
+        Vector<Vector<Uint>> dependents(passCount);
+        for (Uint i = 0; i < passCount; i++)
+        {
+            for (const ResourceAccess& access : mPasses[i].Accesses)
+            {
+                const Uint writer = mResources[access.Resource].Writer;
+                if (IsWriteState(access.State) || writer == INVALID_RENDER_GRAPH_RESOURCE)
+                    continue;
+
+                dependents[writer].push_back(i);
+                dependencyCounts[i]++;
+            }
+        }
+
+        mExecutionOrder.clear();
+        Vector<bool> scheduled(passCount, false);
+        for (Uint n = 0; n < passCount; n++)
+        {
+            Uint next = INVALID_RENDER_GRAPH_RESOURCE;
+            for (Uint i = 0; i < passCount; i++)
+            {
+                if (!scheduled[i] && dependencyCounts[i] == 0)
+                {
+                    next = i;
+                    break;
+                }
+            }
+            SG_ASSERT(next != INVALID_RENDER_GRAPH_RESOURCE, "The RenderGraph has a dependency cycle!");
+
+            scheduled[next] = true;
+            mExecutionOrder.push_back(next);
+            for (Uint dependent : dependents[next])
+                dependencyCounts[dependent]--;
+        }
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        // Writing an output or an imported resource is a side effect, such passes always run, and so do the passes they read from.
+        // The writers come before their readers in the execution order, one walk from the back reaches all of them
+        for (Pass& pass : mPasses)
+        {
+            pass.Culled = true;
+            for (const ResourceAccess& access : pass.Accesses)
+            {
+                const Resource& resource = mResources[access.Resource];
+                if (IsWriteState(access.State) && (resource.Output || resource.Type == ResourceType::Buffer))
+                    pass.Culled = false;
+            }
+        }
+
+        for (auto itr = mExecutionOrder.rbegin(); itr != mExecutionOrder.rend(); itr++)
+        {
+            const Pass& pass = mPasses[*itr];
+            if (pass.Culled)
+                continue;
+
+            for (const ResourceAccess& access : pass.Accesses)
+            {
+                const Uint writer = mResources[access.Resource].Writer;
+                if (!IsWriteState(access.State) && writer != INVALID_RENDER_GRAPH_RESOURCE)
+                    mPasses[writer].Culled = false;
+            }
+        }
+
+        mExecutionOrder.erase(std::remove_if(mExecutionOrder.begin(), mExecutionOrder.end(), [this](Uint pass) { return mPasses[pass].Culled; }), mExecutionOrder.end());
+    }
+
+    void RenderGraph::AllocateImages()
+    {
+        Vector<RenderGraphResource> images;
+        Vector<ImageSpecification> specs(mResources.size());
+        Vector<ImageMemoryRequirements> requirements(mResources.size());
+        for (RenderGraphResource i = 0; i < mResources.size(); i++)
+        {
+            const Resource& resource = mResources[i];
+            if (!IsLiveImage(resource))
+                continue;
+
+            ImageSpecification& spec = specs[i];
+            spec.Format = resource.ImageDesc.Format;
+            spec.Width = resource.ImageDesc.Width;
+            spec.Height = resource.ImageDesc.Height;
+            spec.SamplerProps = resource.ImageDesc.SamplerProps;
+            spec.Mips = 1;
+            spec.Usage = ImageUsage::Attachment;
+            for (Uint passIndex : mExecutionOrder)
+            {
+                for (const ResourceAccess& access : mPasses[passIndex].Accesses)
+                {
+                    if (access.Resource == i && access.State == ResourceState::ComputeShaderWrite)
+                        spec.Usage = ImageUsage::Storage;
+                }
+            }
+
+            requirements[i] = Image2D::GetMemoryRequirements(spec);
+            images.push_back(i);
+        }
+
+        // Biggest images first, so the smaller ones fill the blocks made for them.
+        // An image goes to the first block it fits in whose images are never in use at the same time as it
+        std::stable_sort(images.begin(), images.end(), [&requirements](RenderGraphResource a, RenderGraphResource b) { return requirements[a].Size > requirements[b].Size; });
+        for (RenderGraphResource i : images)
+        {
+            Resource& resource = mResources[i];
+            const ImageMemoryRequirements& imageRequirements = requirements[i];
+            mStats.TransientMemory += imageRequirements.Size;
+
+            Uint blockIndex = INVALID_RENDER_GRAPH_RESOURCE;
+            for (Uint j = 0; j < mMemoryBlocks.size() && blockIndex == INVALID_RENDER_GRAPH_RESOURCE; j++)
+            {
+                const MemoryBlock& block = mMemoryBlocks[j];
+                if (!(block.Requirements.MemoryTypeBits & imageRequirements.MemoryTypeBits) || imageRequirements.Size > block.Requirements.Size ||
+                    imageRequirements.Alignment > block.Requirements.Alignment)
+                    continue;
+
+                bool overlaps = false;
+                for (RenderGraphResource other : block.Resources)
+                    overlaps |= resource.FirstUse <= mResources[other].LastUse && mResources[other].FirstUse <= resource.LastUse;
+
+                if (!overlaps)
+                    blockIndex = j;
+            }
+
+            if (blockIndex == INVALID_RENDER_GRAPH_RESOURCE)
+            {
+                blockIndex = static_cast<Uint>(mMemoryBlocks.size());
+                mMemoryBlocks.emplace_back().Requirements = imageRequirements;
+            }
+
+            MemoryBlock& block = mMemoryBlocks[blockIndex];
+            block.Requirements.MemoryTypeBits &= imageRequirements.MemoryTypeBits;
+            block.Resources.push_back(i);
+            resource.MemoryBlock = blockIndex;
+        }
+
+        for (MemoryBlock& block : mMemoryBlocks)
+        {
+            block.Memory = ImageMemory::Create(block.Requirements);
+            for (RenderGraphResource i : block.Resources)
+                mResources[i].Image = Image2D::Create(specs[i], block.Memory);
+
+            mStats.AllocatedMemory += block.Requirements.Size;
+        }
+
+        mStats.TransientImageCount = static_cast<Uint>(images.size());
+        mStats.MemoryBlockCount = static_cast<Uint>(mMemoryBlocks.size());
+    }
+
+    void RenderGraph::BuildBarriers()
+    {
+        // The barriers follow the state of every slot, a slot is the memory block of the images or a buffer.
+        // An image takes over the state its memory was left in by the previous image of the block, its contents are discarded
+        const Uint blockCount = static_cast<Uint>(mMemoryBlocks.size());
+        auto getSlot = [this, blockCount](RenderGraphResource index) {
+            const Resource& resource = mResources[index];
+            return resource.Type == ResourceType::Image ? resource.MemoryBlock : blockCount + index;
+        };
+
+        // A frame starts with the states the previous one ended with
+        Vector<ResourceState> slotStates(blockCount + mResources.size(), ResourceState::Undefined);
+        for (Uint passIndex : mExecutionOrder)
+        {
+            for (const ResourceAccess& access : mPasses[passIndex].Accesses)
+                slotStates[getSlot(access.Resource)] = access.State;
+        }
+        for (RenderGraphResource i = 0; i < mResources.size(); i++)
+        {
+            if (mResources[i].Output && mResources[i].FirstUse != INVALID_RENDER_GRAPH_RESOURCE)
+                slotStates[getSlot(i)] = mResources[i].FinalState;
+        }
+
+        Vector<bool> used(mResources.size(), false);
+        for (Uint passIndex : mExecutionOrder)
+        {
+            Pass& pass = mPasses[passIndex];
+            pass.Barriers = {};
+            pass.InitialBarriers = {};
+            for (const ResourceAccess& access : pass.Accesses)
+            {
+                const Resource& resource = mResources[access.Resource];
+                ResourceState& state = slotStates[getSlot(access.Resource)];
+
+                // Reads in the same state don't depend on each other, everything else does
+                const bool firstUse = !used[access.Resource];
+                const bool dependent = state != access.State || IsWriteState(access.State);
+                const bool discard = firstUse && IsWriteState(access.State) && !resource.Persistent;
+                const bool initialDiscard = firstUse && (IsWriteState(access.State) || resource.Persistent);
+                if (dependent || discard)
+                    AddBarrier(pass.Barriers, resource, state, access.State, discard);
+                if (dependent || initialDiscard)
+                    AddBarrier(pass.InitialBarriers, resource, state, access.State, initialDiscard);
+
+                state = access.State;
+                used[access.Resource] = true;
+            }
+        }
+
+        mFinalBarriers = {};
+        for (RenderGraphResource i = 0; i < mResources.size(); i++)
+        {
+            const Resource& resource = mResources[i];
+            if (!resource.Output || resource.FirstUse == INVALID_RENDER_GRAPH_RESOURCE)
+                continue;
+
+            const ResourceState state = slotStates[getSlot(i)];
+            if (state != resource.FinalState)
+                AddBarrier(mFinalBarriers, resource, state, resource.FinalState, false);
+        }
+    }
+
+    void RenderGraph::AddBarrier(ResourceBarriers& barriers, const Resource& resource, ResourceState before, ResourceState after, bool discard)
+    {
+        if (resource.Type == ResourceType::Image)
+            barriers.Images.push_back({resource.Image, before, after, discard});
+        else
+            barriers.Buffers.push_back({resource.Buffer, before, after});
+    }
+
+} // namespace Surge
@@ -0,0 +1,179 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Interface/Framebuffer.hpp"
+#include "Surge/Graphics/Interface/ResourceBarrier.hpp"
+#include "Surge/Core/String.hpp"
+
+#define INVALID_RENDER_GRAPH_RESOURCE UINT32_MAX
+
+namespace Surge
+{
+    class RenderProcedure;
+    class RenderGraph;
+    using RenderGraphResource = Uint; // Index of a resource in the RenderGraph, valid as soon as its name is first used
+
+    // An image that is created by the RenderGraph, its memory is shared with the images that are never in use at the same time
+    struct RenderGraphImageDesc
+    {
+        ImageFormat Format = ImageFormat::RGBA8;
+        Uint Width = 0;
+        Uint Height = 0;
+        SamplerProperties SamplerProps = {};
+    };
+
+    // Given to RenderProcedure::Setup, declares the resources the pass uses. Resources are referred to by name, a pass can use
+    // a resource that is declared by a pass set up after it. Every resource is written by one pass at most, and a pass uses a resource once
+    class SURGE_API RenderGraphBuilder
+    {
+    public:
+        RenderGraphResource CreateImage(const String& name, const RenderGraphImageDesc& desc);
+        RenderGraphResource ImportBuffer(const String& name, const Ref<StorageBuffer>& buffer);
+
+        RenderGraphResource Read(const String& name, ResourceState state);
+        RenderGraphResource Write(const String& name, ResourceState state);
+
+        // The pass renders to 'framebuffer' (created with ExternalAttachments), which gets the images of 'colors' and 'depth' as attachments.
+        // The pass writes them as attachments, 'depth' can be INVALID_RENDER_GRAPH_RESOURCE. A pass can have several render targets
+        void AddRenderTarget(const Ref<Framebuffer>& framebuffer, const Vector<RenderGraphResource>& colors, RenderGraphResource depth);
+
+        // The resource is used after the graph, it is left in 'finalState' and its memory is never shared
+        void MarkOutput(RenderGraphResource resource, ResourceState finalState);
+
+        // The contents of the image are kept from one frame to the next, so the pass that writes it can skip rendering to it.
+        // Its memory is never shared and it is only discarded the first time the graph runs
+        void MarkPersistent(RenderGraphResource resource);
+
+    private:
+        RenderGraphBuilder(RenderGraph* graph, Uint pass) : mGraph(graph), mPass(pass) {}
+        RenderGraphResource AddAccess(RenderGraphResource resource, ResourceState state);
+
+    private:
+        RenderGraph* mGraph;
+        Uint mPass;
+        friend class RenderGraph;
+    };
+
+    struct RenderGraphStats
+    {
+        Uint PassCount = 0;
+        Uint CulledPassCount = 0;
+        Uint BarrierCount = 0; // Per frame
+        Uint TransientImageCount = 0;
+        Uint MemoryBlockCount = 0;
+        uint64_t TransientMemory = 0; // What the transient images would take without aliasing
+        uint64_t AllocatedMemory = 0;
+    };
+
+    // Every RenderProcedure is a pass of the graph. Compile derives from the declared reads and writes:
+    // - The execution order, the passes are sorted by their dependencies (keeping the order they were added in when possible)
+    // - Which passes run, a pass is culled if nothing it writes ends up in an output or an imported resource
+    // - Where the images live, images whose lifetimes don't overlap are placed in the same memory
+    // - The barriers recorded before every pass, and at the end of the graph for the outputs
+    // The barriers assume that every frame runs the same passes, the state a resource is left in by a frame is the state the next one starts with
+    class SURGE_API RenderGraph
+    {
+    public:
+        RenderGraph() = default;
+        ~RenderGraph() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(RenderGraph);
+
+        // Removes all the passes and resources, the images stay alive as long as their framebuffers use them
+        void Reset();
+
+        RenderGraphBuilder AddPass(RenderProcedure* procedure);
+        void Compile();
+
+        // The passes to run, in order. Culled passes aren't part of it
+        const Vector<Uint>& GetExecutionOrder() const { return mExecutionOrder; }
+        RenderProcedure* GetPassProcedure(Uint pass) const { return mPasses[pass].Procedure; }
+        const ResourceBarriers& GetPassBarriers(Uint pass) const { return mExecuted ? mPasses[pass].Barriers : mPasses[pass].InitialBarriers; }
+        const ResourceBarriers& GetFinalBarriers() const { return mFinalBarriers; }
+
+        // Called once the barriers of a frame are recorded, the first frame after Compile uses the InitialBarriers of the passes
+        FORCEINLINE void SetExecuted() { mExecuted = true; }
+
+        const Ref<Image2D>& GetImage(RenderGraphResource resource) const;
+        const RenderGraphStats& GetStats() const { return mStats; }
+
+    private:
+        enum class ResourceType
+        {
+            None = 0, // Used by name, but not declared yet
+            Image,
+            Buffer
+        };
+
+        struct Resource
+        {
+            String Name;
+            ResourceType Type = ResourceType::None;
+            RenderGraphImageDesc ImageDesc;
+            Ref<Image2D> Image;
+            Ref<StorageBuffer> Buffer;
+
+            Uint Writer = INVALID_RENDER_GRAPH_RESOURCE; // Pass that writes the resource
+            bool Output = false;
+            bool Persistent = false;
+            ResourceState FinalState = ResourceState::Undefined;
+
+            // Positions in the execution order
+            Uint FirstUse = INVALID_RENDER_GRAPH_RESOURCE;
+            Uint LastUse = 0;
+            Uint MemoryBlock = INVALID_RENDER_GRAPH_RESOURCE; // Images only
+        };
+
+        struct ResourceAccess
+        {
+            RenderGraphResource Resource;
+            ResourceState State;
+        };
+
+        struct RenderTarget
+        {
+            Ref<Surge::Framebuffer> Framebuffer;
+            Vector<RenderGraphResource> Colors;
+            RenderGraphResource Depth;
+        };
+
+        struct Pass
+        {
+            RenderProcedure* Procedure;
+            Vector<ResourceAccess> Accesses;
+            Vector<RenderTarget> Targets;
+
+            bool Culled = false;
+            ResourceBarriers Barriers;
+            ResourceBarriers InitialBarriers; // Also discards the persistent images, they have no contents yet
+        };
+
+        struct MemoryBlock
+        {
+            ImageMemoryRequirements Requirements;
+            Vector<RenderGraphResource> Resources;
+            Ref<ImageMemory> Memory;
+        };
+
+    private:
+        RenderGraphResource GetOrAddResource(const String& name);
+        void SortPasses();
+        void CullPasses();
+        void AllocateImages();
+        void BuildBarriers();
+        static void AddBarrier(ResourceBarriers& barriers, const Resource& resource, ResourceState before, ResourceState after, bool discard);
+        bool IsLiveImage(const Resource& resource) const { return resource.Type == ResourceType::Image && resource.FirstUse != INVALID_RENDER_GRAPH_RESOURCE; }
+
+    private:
+        Vector<Pass> mPasses;
+        Vector<Resource> mResources;
+        HashMap<String, RenderGraphResource> mResourceIndices;
+
+        Vector<Uint> mExecutionOrder;
+        Vector<MemoryBlock> mMemoryBlocks;
+        ResourceBarriers mFinalBarriers;
+        RenderGraphStats mStats;
+        bool mExecuted = false;
+
+        friend class RenderGraphBuilder;
+    };
+
+} // namespace Surge
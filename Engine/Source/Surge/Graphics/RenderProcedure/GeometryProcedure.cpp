@@ -14,6 +14,7 @@ namespace Surge
         spec.AttachmentSpecs = {{{ImageFormat::RGBA16F, {}}, {ImageFormat::Depth32, {}}}};
         spec.Width = 1280;
         spec.Height = 720;
+        spec.ExternalAttachments = true;
         mProcData.OutputFrambuffer = Framebuffer::Create(spec);
 
         Ref<Shader> mainPBRShader = mRendererData->ShaderSet.GetShader("PBR");
@@ -26,53 +27,114 @@ namespace Surge
         pipelineSpec.DebugName = "MeshPipeline";
         pipelineSpec.LineWidth = 1.0f;
         pipelineSpec.TargetFramebuffer = mProcData.OutputFrambuffer;
-        mProcData.GeometryPipeline = GraphicsPipeline::Create(pipelineSpec);
+        mPipelineSpec = pipelineSpec;
+        mRendererData->PipelineLibrary.PrecompileGraphicsPipeline(mPipelineSpec);
+    }
+
+    const Ref<GraphicsPipeline>& GeometryProcedure::GetPipeline()
+    {
+        // Compiled on the worker threads since Init, this only waits if it isn't done by the first frame
+        if (!mProcData.GeometryPipeline)
+            mProcData.GeometryPipeline = mRendererData->PipelineLibrary.GetGraphicsPipeline(mPipelineSpec);
+        return mProcData.GeometryPipeline;
+    }
+
+    void GeometryProcedure::Setup(RenderGraphBuilder& builder)
+    {
+        const ShadowMapProcedure* shadowProc = Core::GetRenderer()->GetRenderProcManager()->GetProcedure<ShadowMapProcedure>();
+        for (Uint i = 0; i < CascadeCountToUInt(shadowProc->GetCascadeCount()); i++)
+            builder.Read(ShadowMapProcedure::GetCascadeImageName(i), ResourceState::FragmentShaderRead);
+        builder.Read("LightCulling.LightList", ResourceState::FragmentShaderRead);
+
+        const FramebufferSpecification& spec = mProcData.OutputFrambuffer->GetSpecification();
+        RenderGraphImageDesc colorDesc;
+        colorDesc.Format = ImageFormat::RGBA16F;
+        colorDesc.Width = spec.Width;
+        colorDesc.Height = spec.Height;
+        colorDesc.SamplerProps = spec.AttachmentSpecs[0].AttachmentSamplerProps;
+        RenderGraphImageDesc depthDesc = colorDesc;
+        depthDesc.Format = ImageFormat::Depth32;
+        depthDesc.SamplerProps = spec.AttachmentSpecs[1].AttachmentSamplerProps;
+
+        const RenderGraphResource color = builder.CreateImage("Geometry.Color", colorDesc);
+        const RenderGraphResource depth = builder.CreateImage("Geometry.Depth", depthDesc);
+        builder.AddRenderTarget(mProcData.OutputFrambuffer, {color}, depth);
+
+        // Sampled by the editor viewport (see Renderer::GetFinalPassFramebuffer)
+        builder.MarkOutput(color, ResourceState::FragmentShaderRead);
     }
 
     void GeometryProcedure::Update()
     {
         SURGE_PROFILE_FUNC("GeometryProcedure::Update");
+        GetPipeline();
 
-        LightCullingProcedure::InternalData* lightCullingProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<LightCullingProcedure>();
         ShadowMapProcedure::InternalData* shadowProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<ShadowMapProcedure>();
-        mProcData.GeometryPipeline->Bind(mRendererData->RenderCmdBuffer);
-
         shadowProcData->ShadowDesciptorSet->SetBuffer(shadowProcData->ShadowUniformBuffer, 0);
         shadowProcData->ShadowDesciptorSet->UpdateForRendering();
-        shadowProcData->ShadowDesciptorSet->Bind(mRendererData->RenderCmdBuffer, mProcData.GeometryPipeline);
-        mRendererData->DescriptorSet0->Bind(mRendererData->RenderCmdBuffer, mProcData.GeometryPipeline);
 
-        mProcData.OutputFrambuffer->BeginRenderPass(mRendererData->RenderCmdBuffer);
-        for (const DrawCommand& object : mRendererData->DrawList)
+        // The MaterialTable can't change while the pass is being recorded on the job system. Batches are sorted by material,
+        // so every material is updated once per frame. Only the ones that changed copy anything
+        const Material* updatedMaterial = nullptr;
+        for (const DrawBatch& batch : mRendererData->DrawBatches)
         {
-            const Ref<Mesh>& mesh = object.MeshComp->Mesh;
-
-            mesh->GetVertexBuffer()->Bind(mRendererData->RenderCmdBuffer);
-            mesh->GetIndexBuffer()->Bind(mRendererData->RenderCmdBuffer);
-
-            Vector<Ref<Material>>& materials = object.MeshComp->Mesh->GetMaterials();
-
-            for (auto& mat : materials)
-                mat->UpdateForRendering();
-
-            const Submesh* submeshes = mesh->GetSubmeshes().data();
-            for (Uint i = 0; i < mesh->GetSubmeshes().size(); i++)
+            if (batch.Material != updatedMaterial)
             {
-                const Submesh& submesh = submeshes[i];
-                glm::mat4 meshData[2] = {object.Transform * submesh.Transform, mRendererData->ViewProjection};
-                materials[submesh.MaterialIndex]->Bind(mRendererData->RenderCmdBuffer, mProcData.GeometryPipeline);
-
-                mProcData.GeometryPipeline->SetPushConstantData(mRendererData->RenderCmdBuffer, "uMesh", meshData);
-                mProcData.GeometryPipeline->DrawIndexed(mRendererData->RenderCmdBuffer, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex);
+                batch.Material->UpdateForRendering();
+                updatedMaterial = batch.Material;
             }
         }
-        mProcData.OutputFrambuffer->EndRenderPass(mRendererData->RenderCmdBuffer);
+        mRendererData->MaterialTable.Update();
+
+        // Reuses the camera view culled for the PreDepthProcedure
+        const bool gpuDriven = mRendererData->GPUDrivenRendering;
+        const Uint itemCount = gpuDriven ? mRendererData->GPUScene.GetRunCount() : static_cast<Uint>(mRendererData->CPUCuller.GetVisibleBatches(GPU_SCENE_CAMERA_VIEW).size());
+        mRendererData->CommandRecorder.RecordRenderPass(mProcData.OutputFrambuffer, itemCount, MIN_BATCHES_PER_RECORDING_JOB, [this, shadowProcData, gpuDriven](const Ref<RenderCommandBuffer>& cmd, Uint begin, Uint end) {
+            const Ref<GraphicsPipeline>& pipeline = mProcData.GeometryPipeline;
+            pipeline->Bind(cmd);
+            shadowProcData->ShadowDesciptorSet->Bind(cmd, pipeline);
+            mRendererData->DescriptorSet0->Bind(cmd, pipeline);
+            mRendererData->MaterialTable.Bind(cmd, pipeline);
+
+            // Pushed again with the index of every material the draws switch to
+            MaterialPushConstants constants = {mRendererData->ViewProjection, 0};
+            if (gpuDriven)
+            {
+                mRendererData->GPUScene.Draw(cmd, GPU_SCENE_CAMERA_VIEW, pipeline, &constants, begin, end);
+                return;
+            }
+
+            const Vector<DrawBatch>& batches = mRendererData->CPUCuller.GetVisibleBatches(GPU_SCENE_CAMERA_VIEW);
+            const Mesh* boundMesh = nullptr;
+            const Material* boundMaterial = nullptr;
+            for (Uint i = begin; i < end; i++)
+            {
+                const DrawBatch& batch = batches[i];
+                if (batch.Mesh != boundMesh)
+                {
+                    batch.Mesh->GetVertexBuffer()->Bind(cmd);
+                    batch.Mesh->GetIndexBuffer()->Bind(cmd);
+                    boundMesh = batch.Mesh;
+                }
+
+                if (batch.Material != boundMaterial)
+                {
+                    constants.MaterialIndex = batch.Material->GetIndex();
+                    pipeline->SetPushConstantData(cmd, "uMesh", &constants);
+                    boundMaterial = batch.Material;
+                }
+
+                const Submesh& submesh = batch.Mesh->GetSubmeshes()[batch.SubmeshIndex];
+                pipeline->DrawIndexed(cmd, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex, batch.InstanceCount, batch.FirstInstance);
+            }
+        });
     }
 
     void GeometryProcedure::Shutdown()
     {
         mProcData.OutputFrambuffer.Reset();
         mProcData.GeometryPipeline.Reset();
+        mPipelineSpec = {};
     }
 
     void GeometryProcedure::Resize(Uint newWidth, Uint newHeight)
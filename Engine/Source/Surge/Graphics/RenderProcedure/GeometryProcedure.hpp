@@ -16,6 +16,10 @@ namespace Surge
         virtual void Update() override;
         virtual void Shutdown() override;
         virtual void Resize(Uint newWidth, Uint newHeight) override;
+        virtual void Setup(RenderGraphBuilder& builder) override;
+
+        // Precompiled by Init, waits for it the first time if it isn't created yet
+        const Ref<GraphicsPipeline>& GetPipeline();
 
     public:
         struct InternalData
@@ -29,6 +33,7 @@ namespace Surge
 
     private:
         InternalData mProcData;
+        GraphicsPipelineSpecification mPipelineSpec;
         RendererData* mRendererData;
 
         SURGE_REFLECTION_ENABLE;
@@ -1,6 +1,5 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/RenderProcedure/LightCullingProcedure.hpp"
-#include "PreDepthProcedure.hpp"
 #include "GeometryProcedure.hpp"
 
 namespace Surge
@@ -14,9 +13,19 @@ namespace Surge
         mProcData.LightListStorageBuffer = StorageBuffer::Create(1, GPUMemoryUsage::GPUToCPU); // Size of `1`, resized later. GPU will write to this buffer
     }
 
+    void LightCullingProcedure::Setup(RenderGraphBuilder& builder)
+    {
+        mPreDepthImage = builder.Read("PreDepth.Depth", ResourceState::ComputeShaderRead);
+        builder.ImportBuffer("LightCulling.LightList", mProcData.LightListStorageBuffer);
+        builder.Write("LightCulling.LightList", ResourceState::ComputeShaderWrite);
+    }
+
     void LightCullingProcedure::Update()
     {
-        const Ref<Image2D>& preDepthImage = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<PreDepthProcedure>()->OutputFrambuffer->GetDepthAttachment();
+        // The dispatch must come after the PreDepthProcedure and the barriers, which may still be waiting in the CommandRecorder
+        mRendererData->CommandRecorder.Flush();
+
+        const Ref<Image2D>& preDepthImage = Core::GetRenderer()->GetRenderProcManager()->GetRenderGraph().GetImage(mPreDepthImage);
         Ref<RenderCommandBuffer>& cmd = mRendererData->RenderCmdBuffer;
         mProcData.LightCullingPipeline->Bind(cmd);
 
@@ -3,6 +3,7 @@
 #include "Surge/Graphics/RenderProcedure/RenderProcedure.hpp"
 #include "Surge/Graphics/Interface/ComputePipeline.hpp"
 #include "Surge/Graphics/Interface/StorageBuffer.hpp"
+#include "Surge/Graphics/RenderGraph/RenderGraph.hpp"
 
 namespace Surge
 {
@@ -16,6 +17,7 @@ namespace Surge
         virtual void Update() override;
         virtual void Shutdown() override;
         virtual void Resize(Uint newWidth, Uint newHeight) override;
+        virtual void Setup(RenderGraphBuilder& builder) override;
 
     public:
         struct InternalData
@@ -34,6 +36,7 @@ namespace Surge
         RendererData* mRendererData;
         glm::ivec2 mScreenSize;
         glm::ivec3 mLightCullingWorkGroups;
+        RenderGraphResource mPreDepthImage;
 
         SURGE_REFLECTION_ENABLE;
     };
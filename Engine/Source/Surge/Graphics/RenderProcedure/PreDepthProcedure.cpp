@@ -11,6 +11,7 @@ namespace Surge
         spec.AttachmentSpecs = {{ImageFormat::Depth32, {}}};
         spec.Width = 1280;
         spec.Height = 720;
+        spec.ExternalAttachments = true;
         mProcData.OutputFrambuffer = Framebuffer::Create(spec);
 
         Ref<Shader> preDepthShader = mRendererData->ShaderSet.GetShader("PreDepth");
@@ -23,39 +24,72 @@ namespace Surge
         pipelineSpec.DebugName = "DepthPrepass";
         pipelineSpec.LineWidth = 1.0f;
         pipelineSpec.TargetFramebuffer = mProcData.OutputFrambuffer;
-        mProcData.PreDepthPipeline = GraphicsPipeline::Create(pipelineSpec);
+        mPipelineSpec = pipelineSpec;
+        mRendererData->PipelineLibrary.PrecompileGraphicsPipeline(mPipelineSpec);
+        mProcData.InstanceDescriptorSet = DescriptorSet::Create(preDepthShader, 0, false);
+    }
+
+    void PreDepthProcedure::Setup(RenderGraphBuilder& builder)
+    {
+        const FramebufferSpecification& spec = mProcData.OutputFrambuffer->GetSpecification();
+        RenderGraphImageDesc depthDesc;
+        depthDesc.Format = ImageFormat::Depth32;
+        depthDesc.Width = spec.Width;
+        depthDesc.Height = spec.Height;
+        depthDesc.SamplerProps = spec.AttachmentSpecs[0].AttachmentSamplerProps;
+        const RenderGraphResource depth = builder.CreateImage("PreDepth.Depth", depthDesc);
+        builder.AddRenderTarget(mProcData.OutputFrambuffer, {}, depth);
     }
 
     void PreDepthProcedure::Update()
     {
         SURGE_PROFILE_FUNC("PreDepthProcedure::Update");
 
-        mProcData.OutputFrambuffer->BeginRenderPass(mRendererData->RenderCmdBuffer);
+        // Compiled on the worker threads since Init, this only waits if it isn't done by the first frame
+        if (!mProcData.PreDepthPipeline)
+            mProcData.PreDepthPipeline = mRendererData->PipelineLibrary.GetGraphicsPipeline(mPipelineSpec);
 
-        mProcData.PreDepthPipeline->Bind(mRendererData->RenderCmdBuffer);
-        for (const DrawCommand& drawCmd : mRendererData->DrawList)
-        {
-            const Ref<Mesh>& mesh = drawCmd.MeshComp->Mesh;
+        mProcData.InstanceDescriptorSet->SetBuffer(mRendererData->GetDrawInstanceBuffer(), INSTANCE_BUFFER_BINDING);
+        mProcData.InstanceDescriptorSet->UpdateForRendering();
 
-            mesh->GetVertexBuffer()->Bind(mRendererData->RenderCmdBuffer);
-            mesh->GetIndexBuffer()->Bind(mRendererData->RenderCmdBuffer);
+        const bool gpuDriven = mRendererData->GPUDrivenRendering;
+        const Uint itemCount = gpuDriven ? mRendererData->GPUScene.GetRunCount() : static_cast<Uint>(mRendererData->CPUCuller.GetVisibleBatches(GPU_SCENE_CAMERA_VIEW).size());
+        mRendererData->CommandRecorder.RecordRenderPass(mProcData.OutputFrambuffer, itemCount, MIN_BATCHES_PER_RECORDING_JOB, [this, gpuDriven](const Ref<RenderCommandBuffer>& cmd, Uint begin, Uint end) {
+            const Ref<GraphicsPipeline>& pipeline = mProcData.PreDepthPipeline;
+            pipeline->Bind(cmd);
+            mProcData.InstanceDescriptorSet->Bind(cmd, pipeline);
+            pipeline->SetPushConstantData(cmd, "uMesh", &mRendererData->ViewProjection);
 
-            const Vector<Submesh>& submeshes = mesh->GetSubmeshes();
-            for (const Submesh& submesh : submeshes)
+            if (gpuDriven)
             {
-                glm::mat4 meshData[2] = {drawCmd.Transform * submesh.Transform, mRendererData->ViewProjection};
-                mProcData.PreDepthPipeline->SetPushConstantData(mRendererData->RenderCmdBuffer, "uMesh", meshData);
-                mProcData.PreDepthPipeline->DrawIndexed(mRendererData->RenderCmdBuffer, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex);
+                mRendererData->GPUScene.Draw(cmd, GPU_SCENE_CAMERA_VIEW, pipeline, nullptr, begin, end);
+                return;
             }
-        }
 
-        mProcData.OutputFrambuffer->EndRenderPass(mRendererData->RenderCmdBuffer);
+            const Vector<DrawBatch>& batches = mRendererData->CPUCuller.GetVisibleBatches(GPU_SCENE_CAMERA_VIEW);
+            const Mesh* boundMesh = nullptr;
+            for (Uint i = begin; i < end; i++)
+            {
+                const DrawBatch& batch = batches[i];
+                if (batch.Mesh != boundMesh)
+                {
+                    batch.Mesh->GetVertexBuffer()->Bind(cmd);
+                    batch.Mesh->GetIndexBuffer()->Bind(cmd);
+                    boundMesh = batch.Mesh;
+                }
+
+                const Submesh& submesh = batch.Mesh->GetSubmeshes()[batch.SubmeshIndex];
+                pipeline->DrawIndexed(cmd, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex, batch.InstanceCount, batch.FirstInstance);
+            }
+        });
     }
 
     void PreDepthProcedure::Shutdown()
     {
         mProcData.OutputFrambuffer.Reset();
         mProcData.PreDepthPipeline.Reset();
+        mPipelineSpec = {};
+        mProcData.InstanceDescriptorSet.Reset();
     }
 
     void PreDepthProcedure::Resize(Uint newWidth, Uint newHeight)
@@ -14,12 +14,14 @@ namespace Surge
         virtual void Update() override;
         virtual void Shutdown() override;
         virtual void Resize(Uint newWidth, Uint newHeight) override;
+        virtual void Setup(RenderGraphBuilder& builder) override;
 
     public:
         struct InternalData
         {
             Ref<GraphicsPipeline> PreDepthPipeline;
             Ref<Framebuffer> OutputFrambuffer;
+            Ref<DescriptorSet> InstanceDescriptorSet;
         };
 
     protected:
@@ -27,6 +29,7 @@ namespace Surge
 
     private:
         InternalData mProcData;
+        GraphicsPipelineSpecification mPipelineSpec; // The pipeline is precompiled by Init and fetched by the first Update
         RendererData* mRendererData;
 
         SURGE_REFLECTION_ENABLE;
@@ -5,6 +5,7 @@
 namespace Surge
 {
     struct RendererData;
+    class RenderGraphBuilder;
     class SURGE_API RenderProcedure
     {
     public:
@@ -16,6 +17,9 @@ namespace Surge
         virtual void Shutdown() = 0;
         virtual void Resize(Uint newWidth, Uint newHeight) = 0;
 
+        // Declares the resources the procedure uses to the RenderGraph, called every time the graph is rebuilt (see RenderProcedureManager)
+        virtual void Setup(RenderGraphBuilder& builder) = 0;
+
     protected:
         virtual void* GetInternalDataBlock() = 0;
 
@@ -1,5 +1,6 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/RenderProcedure/RenderProcedureManager.hpp"
+#include "Surge/Graphics/Renderer/Renderer.hpp"
 
 namespace Surge
 {
@@ -8,14 +9,40 @@ namespace Surge
         SURGE_PROFILE_FUNC("RenderProcedureManager::UpdateAll");
         SG_ASSERT(!mProcOrder.empty(), "Empty ProcOrder! Have you forgot to call Sort()?");
 
-        for (const SurgeReflect::ClassHash& hash : mProcOrder)
+        if (mRenderGraphDirty)
+            BuildRenderGraph();
+
+        // The barriers go between the render passes that are still being recorded, see ParallelCommandRecorder
+        ParallelCommandRecorder& recorder = mRendererData->CommandRecorder;
+        for (Uint pass : mRenderGraph.GetExecutionOrder())
         {
-            auto& [isActive, procedure] = mProcedures.at(hash);
+            recorder.InsertBarriers(mRenderGraph.GetPassBarriers(pass));
+
+            auto& [isActive, procedure] = mProcedures.at(mProcOrder[pass]);
             if (!isActive)
                 continue;
 
             procedure->Update();
         }
+        recorder.InsertBarriers(mRenderGraph.GetFinalBarriers());
+        mRenderGraph.SetExecuted();
+    }
+
+    void RenderProcedureManager::BuildRenderGraph()
+    {
+        SURGE_PROFILE_FUNC("RenderProcedureManager::BuildRenderGraph");
+        SG_ASSERT(!mProcOrder.empty(), "Empty ProcOrder! Have you forgot to call Sort()?");
+
+        mRenderGraph.Reset();
+        for (const SurgeReflect::ClassHash& hash : mProcOrder)
+        {
+            auto& [isActive, procedure] = mProcedures.at(hash);
+            RenderGraphBuilder builder = mRenderGraph.AddPass(procedure);
+            procedure->Setup(builder);
+        }
+
+        mRenderGraph.Compile();
+        mRenderGraphDirty = false;
     }
 
 } // namespace Surge
@@ -1,6 +1,7 @@
 ﻿// Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
 #include "Surge/Graphics/RenderProcedure/RenderProcedure.hpp"
+#include "Surge/Graphics/RenderGraph/RenderGraph.hpp"
 #include "Surge/Core/Profiler.hpp"
 #include "SurgeReflect/SurgeReflect.hpp"
 #include "Surge/Core/Core.hpp"
@@ -51,8 +52,17 @@ namespace Surge
             return nullptr;
         }
 
+        // Runs the procedures in the order of the RenderGraph, with the barriers it derived before each of them.
+        // An inactive procedure isn't updated, but its barriers are still recorded so the resources go through the states the others expect
         void UpdateAll();
 
+        // Rebuilds the RenderGraph from the Setup of every procedure, which recreates the images of the graph
+        void BuildRenderGraph();
+
+        // The RenderGraph is rebuilt at the next UpdateAll, until then the procedures keep using the current images
+        FORCEINLINE void InvalidateRenderGraph() { mRenderGraphDirty = true; }
+        const RenderGraph& GetRenderGraph() const { return mRenderGraph; }
+
         template <typename T>
         FORCEINLINE typename T::InternalData* GetRenderProcData()
         {
@@ -75,6 +85,7 @@ namespace Surge
 
                 proc->Shutdown();
                 proc->Init(mRendererData);
+                BuildRenderGraph();
             });
         }
 
@@ -85,6 +96,7 @@ namespace Surge
                 auto& [isActive, procedure] = mProcedures.at(hash);
                 procedure->Resize(newWidth, newHeight);
             }
+            InvalidateRenderGraph();
         }
 
         template <typename T>
@@ -105,6 +117,7 @@ namespace Surge
 
         FORCEINLINE void Shutdown()
         {
+            mRenderGraph.Reset();
             for (const SurgeReflect::ClassHash& hash : mProcOrder)
             {
                 auto& [isActive, procedure] = mProcedures.at(hash);
@@ -130,6 +143,9 @@ namespace Surge
         RendererData* mRendererData;
         Vector<SurgeReflect::ClassHash> mProcOrder;
         HashMap<SurgeReflect::ClassHash, Pair<bool, RenderProcedure*>> mProcedures; // mapped as-> classHash - {isActive, proc}
+
+        RenderGraph mRenderGraph; // The passes are the procedures, in the order of mProcOrder
+        bool mRenderGraphDirty = true;
     };
 
 } // namespace Surge
@@ -1,6 +1,6 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/RenderProcedure/ShadowMapProcedure.hpp"
-#include "Surge/ECS/Scene.hpp"
+#include "SurgeMath/Frustum.hpp"
 #include "GeometryProcedure.hpp"
 #define NUM_FRUSTUM_CORNERS 8
 
@@ -39,6 +39,7 @@ namespace Surge
         spec.AttachmentSpecs = {{ImageFormat::Depth32, {}}};
         spec.Width = mShadowMapResolution;
         spec.Height = mShadowMapResolution;
+        spec.ExternalAttachments = true;
         for (Uint i = 0; i < totalCascades; i++)
             mProcData.ShadowMapFramebuffers[i] = Framebuffer::Create(spec);
 
@@ -51,59 +52,115 @@ namespace Surge
         pipelineSpec.UseStencil = false;
         pipelineSpec.DebugName = "ShadowMapPipeline";
         pipelineSpec.LineWidth = 1.0f;
-        for (Uint i = 0; i < totalCascades; i++)
-        {
-            pipelineSpec.TargetFramebuffer = mProcData.ShadowMapFramebuffers[i];
-            mProcData.ShadowMapPipelines[i] = GraphicsPipeline::Create(pipelineSpec);
-        }
+        pipelineSpec.TargetFramebuffer = mProcData.ShadowMapFramebuffers[0];
+        mPipelineSpec = pipelineSpec;
+        mRendererData->PipelineLibrary.PrecompileGraphicsPipeline(mPipelineSpec);
 
         mProcData.ShadowDesciptorSet = DescriptorSet::Create(mainPBRshader, 3, false);
         mProcData.ShadowUniformBuffer = UniformBuffer::Create(sizeof(ShadowParams));
+        mProcData.InstanceDescriptorSet = DescriptorSet::Create(shadowMapShader, 0, false);
+    }
+
+    void ShadowMapProcedure::Setup(RenderGraphBuilder& builder)
+    {
+        // The graph creates new images for the cascades, nothing is rendered into them yet
+        mCascadeCaches = {};
+        mNextStaleCascade = 1;
+
+        for (Uint i = 0; i < CascadeCountToUInt(mTotalCascades); i++)
+        {
+            const FramebufferSpecification& spec = mProcData.ShadowMapFramebuffers[i]->GetSpecification();
+            RenderGraphImageDesc cascadeDesc;
+            cascadeDesc.Format = ImageFormat::Depth32;
+            cascadeDesc.Width = spec.Width;
+            cascadeDesc.Height = spec.Height;
+            cascadeDesc.SamplerProps = spec.AttachmentSpecs[0].AttachmentSamplerProps;
+            const RenderGraphResource cascade = builder.CreateImage(GetCascadeImageName(i), cascadeDesc);
+            builder.AddRenderTarget(mProcData.ShadowMapFramebuffers[i], {}, cascade);
+            builder.MarkPersistent(cascade); // Cached from one frame to the next, see SelectCascadesToRender
+        }
     }
 
     void ShadowMapProcedure::Update()
     {
         SURGE_PROFILE_FUNC("ShadowMapProcedure::Update");
 
-        glm::vec3 direction;
-        if (mRendererData->SceneContext)
+        // Compiled on the worker threads since Init, this only waits if it isn't done by the first frame
+        if (!mProcData.ShadowMapPipeline)
+            mProcData.ShadowMapPipeline = mRendererData->PipelineLibrary.GetGraphicsPipeline(mPipelineSpec);
+
+        // The direction is submitted along with the rest of the light, see Renderer::SubmitDirectionalLight
+        CalculateCascades(mRendererData->ProjectionMatrix, mRendererData->ViewMatrix, mRendererData->DirLight.Direction);
+
+        const Uint cascadeCount = CascadeCountToUInt(mTotalCascades);
+        const bool gpuDriven = mRendererData->GPUDrivenRendering;
+        if (!gpuDriven)
         {
-            auto view = mRendererData->SceneContext->GetRegistry().view<TransformComponent, DirectionalLightComponent>();
-            for (const entt::entity& entity : view)
-            {
-                auto [transform, light] = view.get<TransformComponent, DirectionalLightComponent>(entity);
-                direction = transform.GetTransform()[2];
-                break;
-            }
+            for (Uint j = 0; j < cascadeCount; j++)
+                mRendererData->CPUCuller.Cull(GPU_SCENE_CAMERA_VIEW + 1 + j, mCascadeViewProjections[j]);
         }
 
-        CalculateCascades(mRendererData->ViewProjection, glm::normalize(direction));
-
-        // Loop over all the shadow maps and bind and render the whole scene to each of them
-        for (Uint j = 0; j < CascadeCountToUInt(mTotalCascades); j++)
+        InvalidateChangedCascades();
+        SelectCascadesToRender();
+        for (Uint j = 0; j < cascadeCount; j++)
         {
-            const Ref<Framebuffer>& shadowMapBuffer = mProcData.ShadowMapFramebuffers[j];
-            const Ref<GraphicsPipeline>& shadowPipeline = mProcData.ShadowMapPipelines[j];
+            if (!mRenderCascades[j])
+                continue;
 
-            shadowMapBuffer->BeginRenderPass(mRendererData->RenderCmdBuffer);
-            shadowPipeline->Bind(mRendererData->RenderCmdBuffer);
+            mProcData.LightViewProjections[j] = mCascadeViewProjections[j];
+            mCascadeCaches[j].CastersChanged = false;
+            mCascadeCaches[j].Valid = true;
+        }
 
-            for (const DrawCommand& drawCmd : mRendererData->DrawList)
+        if (gpuDriven && mProcData.RenderedCascadeCount)
+        {
+            // The culling is recorded straight into the primary command buffer, after the passes that are still being recorded
+            mRendererData->CommandRecorder.Flush();
+            for (Uint j = 0; j < cascadeCount; j++)
             {
-                const Ref<Mesh>& mesh = drawCmd.MeshComp->Mesh;
+                if (mRenderCascades[j])
+                    mRendererData->GPUScene.Cull(GPU_SCENE_CAMERA_VIEW + 1 + j, mProcData.LightViewProjections[j]);
+            }
+        }
 
-                mesh->GetVertexBuffer()->Bind(mRendererData->RenderCmdBuffer);
-                mesh->GetIndexBuffer()->Bind(mRendererData->RenderCmdBuffer);
+        // Every cascade is a render pass of its own, they are all recorded in parallel
+        mProcData.InstanceDescriptorSet->SetBuffer(mRendererData->GetDrawInstanceBuffer(), INSTANCE_BUFFER_BINDING);
+        mProcData.InstanceDescriptorSet->UpdateForRendering();
+        for (Uint j = 0; j < cascadeCount; j++)
+        {
+            if (!mRenderCascades[j])
+                continue;
+
+            const Uint view = GPU_SCENE_CAMERA_VIEW + 1 + j;
+            const Uint itemCount = gpuDriven ? mRendererData->GPUScene.GetRunCount() : static_cast<Uint>(mRendererData->CPUCuller.GetVisibleBatches(view).size());
+            mRendererData->CommandRecorder.RecordRenderPass(mProcData.ShadowMapFramebuffers[j], itemCount, MIN_BATCHES_PER_RECORDING_JOB, [this, gpuDriven, view, j](const Ref<RenderCommandBuffer>& cmd, Uint begin, Uint end) {
+                const Ref<GraphicsPipeline>& shadowPipeline = mProcData.ShadowMapPipeline;
+                shadowPipeline->Bind(cmd);
+                mProcData.InstanceDescriptorSet->Bind(cmd, shadowPipeline);
+                shadowPipeline->SetPushConstantData(cmd, "uMesh", &mProcData.LightViewProjections[j]);
+
+                if (gpuDriven)
+                {
+                    mRendererData->GPUScene.Draw(cmd, view, shadowPipeline, nullptr, begin, end);
+                    return;
+                }
 
-                const Vector<Submesh>& submeshes = mesh->GetSubmeshes();
-                for (const Submesh& submesh : submeshes)
+                const Vector<DrawBatch>& batches = mRendererData->CPUCuller.GetVisibleBatches(view);
+                const Mesh* boundMesh = nullptr;
+                for (Uint i = begin; i < end; i++)
                 {
-                    glm::mat4 meshData[2] = {drawCmd.Transform * submesh.Transform, mProcData.LightViewProjections[j]};
-                    shadowPipeline->SetPushConstantData(mRendererData->RenderCmdBuffer, "uMesh", meshData);
-                    shadowPipeline->DrawIndexed(mRendererData->RenderCmdBuffer, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex);
+                    const DrawBatch& batch = batches[i];
+                    if (batch.Mesh != boundMesh)
+                    {
+                        batch.Mesh->GetVertexBuffer()->Bind(cmd);
+                        batch.Mesh->GetIndexBuffer()->Bind(cmd);
+                        boundMesh = batch.Mesh;
+                    }
+
+                    const Submesh& submesh = batch.Mesh->GetSubmeshes()[batch.SubmeshIndex];
+                    shadowPipeline->DrawIndexed(cmd, submesh.IndexCount, submesh.BaseIndex, submesh.BaseVertex, batch.InstanceCount, batch.FirstInstance);
                 }
-            }
-            shadowMapBuffer->EndRenderPass(mRendererData->RenderCmdBuffer);
+            });
         }
 
         UpdateShadowMapDescriptorSet();
@@ -111,14 +168,17 @@ namespace Surge
 
     void ShadowMapProcedure::Shutdown()
     {
-        for (Uint i = 0; i < mProcData.ShadowMapFramebuffers.size(); i++)
-            mProcData.ShadowMapPipelines[i].Reset();
+        // The pipeline holds on to the first cascade framebuffer, don't keep it alive when the cascades are recreated
+        mProcData.ShadowMapPipeline.Reset();
+        mPipelineSpec = {};
+        mRendererData->PipelineLibrary.ReleaseUnused();
 
         for (Uint i = 0; i < mProcData.ShadowMapFramebuffers.size(); i++)
             mProcData.ShadowMapFramebuffers[i].Reset();
 
         mProcData.ShadowUniformBuffer.Reset();
         mProcData.ShadowDesciptorSet.Reset();
+        mProcData.InstanceDescriptorSet.Reset();
     }
 
     void ShadowMapProcedure::SetCascadeCount(CascadeCount count)
@@ -127,12 +187,79 @@ namespace Surge
         Surge::Core::AddFrameEndCallback([&]() {
             Shutdown();
             Init(mRendererData);
+            Core::GetRenderer()->GetRenderProcManager()->BuildRenderGraph();
         });
     }
 
-    void ShadowMapProcedure::CalculateCascades(const glm::mat4& viewProjection, const glm::vec3& normalizedDirection)
+    void ShadowMapProcedure::SetShadowMapsResolution(Uint newSize)
+    {
+        mShadowMapResolution = newSize;
+        for (Uint i = 0; i < CascadeCountToUInt(mTotalCascades); i++)
+            mProcData.ShadowMapFramebuffers[i]->Resize(mShadowMapResolution, mShadowMapResolution);
+
+        // The cascade images are recreated by the RenderGraph
+        Core::GetRenderer()->GetRenderProcManager()->InvalidateRenderGraph();
+    }
+
+    void ShadowMapProcedure::InvalidateChangedCascades()
+    {
+        // Uses what BuildDrawBatches found out while writing the instance transforms, nothing is hashed or compared here
+        const Uint cascadeCount = CascadeCountToUInt(mTotalCascades);
+        if (mRendererData->InstancesRebatched)
+        {
+            for (Uint j = 0; j < cascadeCount; j++)
+                mCascadeCaches[j].CastersChanged = true;
+            return;
+        }
+
+        const AABB& bounds = mRendererData->ChangedInstanceBounds;
+        if (bounds.Min.x > bounds.Max.x)
+            return; // Nothing moved
+
+        // Tested against the matrix the cascade was rendered with as well, it is still the one in use until the cascade is updated
+        const glm::vec3 center = (bounds.Min + bounds.Max) * 0.5f;
+        const glm::vec3 extents = (bounds.Max - bounds.Min) * 0.5f;
+        for (Uint j = 0; j < cascadeCount; j++)
+        {
+            if (Frustum(mCascadeViewProjections[j]).IsBoxVisible(center, extents) || Frustum(mProcData.LightViewProjections[j]).IsBoxVisible(center, extents))
+                mCascadeCaches[j].CastersChanged = true;
+        }
+    }
+
+    void ShadowMapProcedure::SelectCascadesToRender()
     {
-        glm::mat4 inverseViewProjection = glm::inverse(viewProjection);
+        // A cascade is stale once its light matrix or the casters inside of it change. The first cascade is right in front of the camera,
+        // it is updated as soon as it is stale. The others cover a lot more ground, lagging a few frames behind there doesn't show,
+        // so only one of them is updated per frame
+        const Uint cascadeCount = CascadeCountToUInt(mTotalCascades);
+        std::array<bool, MAX_CASCADE_COUNT> stale = {};
+        for (Uint j = 0; j < cascadeCount; j++)
+        {
+            const CascadeCache& cache = mCascadeCaches[j];
+            stale[j] = mProcData.LightViewProjections[j] != mCascadeViewProjections[j] || cache.CastersChanged;
+            mRenderCascades[j] = !mProcData.CascadeCaching || !cache.Valid || (j == 0 && stale[j]);
+        }
+
+        for (Uint i = 0; i < cascadeCount - 1; i++)
+        {
+            const Uint j = 1 + (mNextStaleCascade - 1 + i) % (cascadeCount - 1);
+            if (stale[j] && !mRenderCascades[j])
+            {
+                mRenderCascades[j] = true;
+                mNextStaleCascade = j % (cascadeCount - 1) + 1;
+                break;
+            }
+        }
+
+        mProcData.RenderedCascadeCount = 0;
+        for (Uint j = 0; j < cascadeCount; j++)
+            mProcData.RenderedCascadeCount += mRenderCascades[j];
+    }
+
+    void ShadowMapProcedure::CalculateCascades(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& normalizedDirection)
+    {
+        const glm::mat4 inverseProjection = glm::inverse(projection);
+        const glm::mat4 inverseView = glm::inverse(view);
 
         // TODO: Automate this
         const float nearClip = 0.1f;
@@ -153,6 +280,10 @@ namespace Surge
             mCascadeSplits[i] = (d - nearClip) / clipRange;
         }
 
+        // The light only rotates the world, every cascade is placed in light space on its own (see below)
+        const glm::vec3 lightDir = -normalizedDirection;
+        const glm::mat4 lightViewMatrix = glm::lookAt(glm::vec3(0.0f), lightDir, glm::vec3(0.0f, 0.0f, 1.0f));
+
         float lastSplitDist = 0.0f;
         // Calculate Orthographic Projection matrix for each cascade
         for (Uint cascade = 0; cascade < CascadeCountToUInt(mTotalCascades); cascade++)
@@ -173,10 +304,11 @@ namespace Surge
                     {-1.0f, -1.0f, 1.0f, 1.0f},
                 };
 
-            // Project frustum corners into world space from clip space
+            // Project frustum corners into view space from clip space. The slice is fitted in view space, so its bounding sphere
+            // only depends on the projection: it keeps the same radius however the camera moves or turns
             for (glm::vec4& frustumCorner : frustumCorners)
             {
-                glm::vec4 invCorner = inverseViewProjection * frustumCorner;
+                glm::vec4 invCorner = inverseProjection * frustumCorner;
                 frustumCorner = invCorner / invCorner.w;
             }
 
@@ -193,7 +325,7 @@ namespace Surge
                 frustumCenter += glm::vec3(frustumCorner);
             frustumCenter /= NUM_FRUSTUM_CORNERS;
 
-            // Get the minimum and maximum extents
+            // Radius of the bounding sphere
             float radius = 0.0f;
             for (glm::vec4& frustumCorner : frustumCorners)
             {
@@ -201,32 +333,22 @@ namespace Surge
                 radius = glm::max(radius, distance);
             }
             radius = std::ceil(radius * 16.0f) / 16.0f;
-            glm::vec3 maxExtents = glm::vec3(radius);
-            glm::vec3 minExtents = -maxExtents;
-
-            // Calculate the view and projection matrix
-            glm::vec3 lightDir = -normalizedDirection;
-            glm::mat4 lightViewMatrix = glm::lookAt(frustumCenter - lightDir * -minExtents.z, frustumCenter, glm::vec3(0.0f, 0.0f, 1.0f));
-            glm::mat4 lightProjectionMatrix = glm::ortho(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, -15.0f, maxExtents.z - minExtents.z + 15.0f);
-
-            // Offset to texel space to avoid shimmering ->(https://stackoverflow.com/q/33499053/14349078)
-            glm::mat4 shadowMatrix = lightProjectionMatrix * lightViewMatrix;
-            glm::vec4 shadowOrigin = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-            shadowOrigin = shadowMatrix * shadowOrigin;
-            float storedW = shadowOrigin.w;
-            shadowOrigin = shadowOrigin * static_cast<float>(mShadowMapResolution) / 2.0f;
-            glm::vec4 roundedOrigin = glm::round(shadowOrigin);
-            glm::vec4 roundOffset = roundedOrigin - shadowOrigin;
-            roundOffset = roundOffset * 2.0f / static_cast<float>(mShadowMapResolution);
-            roundOffset.z = 0.0f;
-            roundOffset.w = 0.0f;
-            glm::mat4 shadowProj = lightProjectionMatrix;
-            shadowProj[3] += roundOffset;
-            lightProjectionMatrix = shadowProj;
+
+            // Snap the center of the sphere to whole shadow map texels in light space, so that the matrix of the cascade only changes
+            // when the camera moves by a texel: no shimmering on the edges of the shadows, and the cached cascades stay valid
+            // while the camera moves inside of a texel (see SelectCascadesToRender)
+            const float texelSize = 2.0f * radius / static_cast<float>(mShadowMapResolution);
+            glm::vec3 lightSpaceCenter = lightViewMatrix * inverseView * glm::vec4(frustumCenter, 1.0f);
+            lightSpaceCenter = glm::floor(lightSpaceCenter / texelSize) * texelSize;
+
+            // The light looks down -Z. 15 units of extra depth on both sides, for the casters right outside of the sphere
+            const float centerDepth = -lightSpaceCenter.z;
+            const glm::mat4 lightProjectionMatrix = glm::ortho(lightSpaceCenter.x - radius, lightSpaceCenter.x + radius, lightSpaceCenter.y - radius, lightSpaceCenter.y + radius,
+                                                               centerDepth - radius - 15.0f, centerDepth + radius + 15.0f);
 
             // Store SplitDistance and ViewProjection-Matrix
             mProcData.CascadeSplitDepths[cascade] = (nearClip + splitDist * clipRange) * 1.0f;
-            mProcData.LightViewProjections[cascade] = lightProjectionMatrix * lightViewMatrix;
+            mCascadeViewProjections[cascade] = lightProjectionMatrix * lightViewMatrix;
 
             lastSplitDist = mCascadeSplits[cascade];
         }
@@ -36,6 +36,7 @@ namespace Surge
         virtual void Update() override;
         virtual void Shutdown() override;
         virtual void Resize(Uint newWidth, Uint newHeight) override {}
+        virtual void Setup(RenderGraphBuilder& builder) override;
 
         // ShadowProc functions
         const CascadeCount& GetCascadeCount() const { return mTotalCascades; };
@@ -45,46 +46,60 @@ namespace Surge
         FORCEINLINE void SetShadowQuality(ShadowQuality quality) { mProcData.ShadowQuality = quality; }
 
         FORCEINLINE const Uint& GetShadowMapsResolution() const { return mShadowMapResolution; }
-        FORCEINLINE void SetShadowMapsResolution(Uint newSize)
-        {
-            mShadowMapResolution = newSize;
-            for (Ref<Framebuffer>& framebuffer : mProcData.ShadowMapFramebuffers)
-            {
-                framebuffer->Resize(mShadowMapResolution, mShadowMapResolution);
-            }
-        }
+        void SetShadowMapsResolution(Uint newSize);
+
+        // Name of the RenderGraph image of a cascade
+        static String GetCascadeImageName(Uint cascade) { return "ShadowMap.Cascade" + std::to_string(cascade); }
 
     public:
         struct InternalData
         {
-            std::array<Ref<GraphicsPipeline>, MAX_CASCADE_COUNT> ShadowMapPipelines;
+            Ref<GraphicsPipeline> ShadowMapPipeline; // Shared by all the cascades, their framebuffers are render pass compatible
             std::array<Ref<Framebuffer>, MAX_CASCADE_COUNT> ShadowMapFramebuffers;
             std::array<glm::mat4, MAX_CASCADE_COUNT> LightViewProjections = {};
             std::array<float, MAX_CASCADE_COUNT> CascadeSplitDepths = {};
 
             float CascadeSplitLambda = 0.91f;
             bool VisualizeCascades = false;
+            bool CascadeCaching = true; // If false, every cascade is rendered every frame
+            Uint RenderedCascadeCount = 0; // Last frame
             Surge::ShadowQuality ShadowQuality = ShadowQuality::Ultra;
 
             Ref<UniformBuffer> ShadowUniformBuffer;
             Ref<DescriptorSet> ShadowDesciptorSet;
+            Ref<DescriptorSet> InstanceDescriptorSet; // Set 0 of the ShadowMap shader
         };
 
     protected:
         virtual void* GetInternalDataBlock() override { return &mProcData; }
 
     private:
-        void CalculateCascades(const glm::mat4& viewProjection, const glm::vec3& normalizedDirection);
+        void CalculateCascades(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& normalizedDirection);
         void UpdateShadowMapDescriptorSet();
+        void InvalidateChangedCascades();
+        void SelectCascadesToRender();
 
     private:
+        // What a cascade was last rendered with, its light matrix is in InternalData::LightViewProjections
+        struct CascadeCache
+        {
+            bool CastersChanged = false; // An instance inside of the cascade moved, or instances were added/removed, since it was rendered
+            bool Valid = false;          // False until the cascade is rendered into its current image
+        };
+
         InternalData mProcData;
+        GraphicsPipelineSpecification mPipelineSpec; // The pipeline is precompiled by Init and fetched by the first Update
         RendererData* mRendererData;
 
         CascadeCount mTotalCascades;
         Uint mShadowMapResolution;
         std::array<float, MAX_CASCADE_COUNT> mCascadeSplits = {};
 
+        std::array<glm::mat4, MAX_CASCADE_COUNT> mCascadeViewProjections = {}; // Of the current camera, the cascades are rendered with them once they are updated
+        std::array<CascadeCache, MAX_CASCADE_COUNT> mCascadeCaches = {};
+        std::array<bool, MAX_CASCADE_COUNT> mRenderCascades = {};
+        Uint mNextStaleCascade = 1; // The stale cascades past the first are updated one per frame, in turns
+
         SURGE_REFLECTION_ENABLE;
     };
 
@@ -0,0 +1,265 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Renderer/CPUCuller.hpp"
+#include "Surge/Graphics/Renderer/Renderer.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <immintrin.h>
+#include <random>
+
+// Number of transforms the culled instance buffer starts with, it grows by doubling
+#define INITIAL_CULLED_CAPACITY 1024
+
+namespace Surge
+{
+    void CullingBoxes::Resize(Uint count)
+    {
+        // The padding boxes are never reported as visible, CullBoxes stops at Count
+        const Uint paddedCount = (count + CULLING_SIMD_WIDTH - 1) / CULLING_SIMD_WIDTH * CULLING_SIMD_WIDTH;
+        Count = count;
+        for (Vector<float>* component : {&CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ})
+            component->resize(paddedCount, 0.0f);
+    }
+
+    void CullingBoxes::Set(Uint index, const AABB& localBox, const glm::mat4& transform)
+    {
+        // The extents are rotated into a new axis aligned box
+        const glm::vec3 center = transform * glm::vec4((localBox.Min + localBox.Max) * 0.5f, 1.0f);
+        const glm::vec3 localExtents = (localBox.Max - localBox.Min) * 0.5f;
+        const glm::vec3 extents = glm::abs(glm::vec3(transform[0])) * localExtents.x + glm::abs(glm::vec3(transform[1])) * localExtents.y + glm::abs(glm::vec3(transform[2])) * localExtents.z;
+
+        CenterX[index] = center.x;
+        CenterY[index] = center.y;
+        CenterZ[index] = center.z;
+        ExtentX[index] = extents.x;
+        ExtentY[index] = extents.y;
+        ExtentZ[index] = extents.z;
+    }
+
+    // A box is visible if, for every plane, dot(normal, center) + w + dot(abs(normal), extents) >= 0
+    Uint CullBoxes(const CullingBoxes& boxes, const Frustum& frustum, Uint* outVisible)
+    {
+        Uint visibleCount = 0;
+        const Uint paddedCount = static_cast<Uint>(boxes.CenterX.size());
+
+#if defined(__AVX__)
+        __m256 planes[6][7]; // nx, ny, nz, w, |nx|, |ny|, |nz| of every plane, in all the lanes
+        for (Uint p = 0; p < 6; p++)
+        {
+            const glm::vec4& plane = frustum.Planes[p];
+            planes[p][0] = _mm256_set1_ps(plane.x);
+            planes[p][1] = _mm256_set1_ps(plane.y);
+            planes[p][2] = _mm256_set1_ps(plane.z);
+            planes[p][3] = _mm256_set1_ps(plane.w);
+            planes[p][4] = _mm256_set1_ps(glm::abs(plane.x));
+            planes[p][5] = _mm256_set1_ps(glm::abs(plane.y));
+            planes[p][6] = _mm256_set1_ps(glm::abs(plane.z));
+        }
+
+        const __m256 zero = _mm256_setzero_ps();
+        for (Uint i = 0; i < paddedCount; i += 8)
+        {
+            const __m256 cx = _mm256_loadu_ps(&boxes.CenterX[i]);
+            const __m256 cy = _mm256_loadu_ps(&boxes.CenterY[i]);
+            const __m256 cz = _mm256_loadu_ps(&boxes.CenterZ[i]);
+            const __m256 ex = _mm256_loadu_ps(&boxes.ExtentX[i]);
+            const __m256 ey = _mm256_loadu_ps(&boxes.ExtentY[i]);
+            const __m256 ez = _mm256_loadu_ps(&boxes.ExtentZ[i]);
+
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (Uint p = 0; p < 6; p++)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes[p][0], cx), planes[p][3]);
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][1], cy));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][2], cz));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][4], ex));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][5], ey));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][6], ez));
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+            }
+
+            const int mask = _mm256_movemask_ps(visible);
+            for (Uint lane = 0; lane < 8; lane++)
+            {
+                if ((mask & (1 << lane)) && i + lane < boxes.Count)
+                    outVisible[visibleCount++] = i + lane;
+            }
+        }
+#else
+        __m128 planes[6][7]; // nx, ny, nz, w, |nx|, |ny|, |nz| of every plane, in all the lanes
+        for (Uint p = 0; p < 6; p++)
+        {
+            const glm::vec4& plane = frustum.Planes[p];
+            planes[p][0] = _mm_set1_ps(plane.x);
+            planes[p][1] = _mm_set1_ps(plane.y);
+            planes[p][2] = _mm_set1_ps(plane.z);
+            planes[p][3] = _mm_set1_ps(plane.w);
+            planes[p][4] = _mm_set1_ps(glm::abs(plane.x));
+            planes[p][5] = _mm_set1_ps(glm::abs(plane.y));
+            planes[p][6] = _mm_set1_ps(glm::abs(plane.z));
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        for (Uint i = 0; i < paddedCount; i += 4)
+        {
+            const __m128 cx = _mm_loadu_ps(&boxes.CenterX[i]);
+            const __m128 cy = _mm_loadu_ps(&boxes.CenterY[i]);
+            const __m128 cz = _mm_loadu_ps(&boxes.CenterZ[i]);
+            const __m128 ex = _mm_loadu_ps(&boxes.ExtentX[i]);
+            const __m128 ey = _mm_loadu_ps(&boxes.ExtentY[i]);
+            const __m128 ez = _mm_loadu_ps(&boxes.ExtentZ[i]);
+
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (Uint p = 0; p < 6; p++)
+            {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(planes[p][0], cx), planes[p][3]);
+                distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][1], cy));
+                distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][2], cz));
+                distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][4], ex));
+                distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][5], ey));
+                distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][6], ez));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, zero));
+            }
+
+            const int mask = _mm_movemask_ps(visible);
+            for (Uint lane = 0; lane < 4; lane++)
+            {
+                if ((mask & (1 << lane)) && i + lane < boxes.Count)
+                    outVisible[visibleCount++] = i + lane;
+            }
+        }
+#endif
+        return visibleCount;
+    }
+
+    void CPUCuller::Initialize(RendererData* rendererData)
+    {
+        mRendererData = rendererData;
+        mCulledTransforms.resize(INITIAL_CULLED_CAPACITY);
+        mCulledInstanceBuffer = StorageBuffer::Create(INITIAL_CULLED_CAPACITY * sizeof(glm::mat4), GPUMemoryUsage::CPUToGPU);
+    }
+
+    void CPUCuller::Shutdown()
+    {
+        mCulledInstanceBuffer.Reset();
+        for (Vector<DrawBatch>& batches : mVisibleBatches)
+            batches.clear();
+    }
+
+    void CPUCuller::Update()
+    {
+        SURGE_PROFILE_FUNC("CPUCuller::Update");
+        const Vector<DrawBatch>& drawBatches = mRendererData->DrawBatches;
+        const Vector<glm::mat4>& transforms = mRendererData->InstanceTransforms;
+        const Uint instanceCount = drawBatches.empty() ? 0 : drawBatches.back().FirstInstance + drawBatches.back().InstanceCount;
+
+        mBoxes.Resize(instanceCount);
+        mInstanceBatches.resize(instanceCount);
+        mVisibleInstances.resize(instanceCount);
+        for (Uint i = 0; i < drawBatches.size(); i++)
+        {
+            const DrawBatch& batch = drawBatches[i];
+            for (Uint j = 0; j < batch.InstanceCount; j++)
+                mInstanceBatches[batch.FirstInstance + j] = i;
+        }
+
+        Core::GetThreadPool()->ParallelFor<Uint>(0, instanceCount, [&](Uint i) {
+            const DrawBatch& batch = drawBatches[mInstanceBatches[i]];
+            mBoxes.Set(i, batch.Mesh->GetSubmeshes()[batch.SubmeshIndex].BoundingBox, transforms[i]);
+        });
+
+        // Every view can see every instance, make sure the buffer never has to grow while the frame is being recorded
+        const size_t requiredCapacity = static_cast<size_t>(instanceCount) * GPU_SCENE_VIEW_COUNT;
+        if (requiredCapacity > mCulledTransforms.size())
+        {
+            size_t newCapacity = mCulledTransforms.size();
+            while (newCapacity < requiredCapacity)
+                newCapacity *= 2;
+
+            mCulledTransforms.resize(newCapacity);
+            mCulledInstanceBuffer->Resize(static_cast<Uint>(newCapacity * sizeof(glm::mat4)));
+        }
+
+        mCulledCount = 0;
+        for (Uint view = 0; view < GPU_SCENE_VIEW_COUNT; view++)
+        {
+            mVisibleBatches[view].clear();
+            mVisibleInstanceCounts[view] = 0;
+        }
+    }
+
+    void CPUCuller::Cull(Uint view, const glm::mat4& viewProjection)
+    {
+        SURGE_PROFILE_FUNC("CPUCuller::Cull");
+        SG_ASSERT(view < GPU_SCENE_VIEW_COUNT, "Invalid culling view!");
+        const Vector<DrawBatch>& drawBatches = mRendererData->DrawBatches;
+        const Vector<glm::mat4>& transforms = mRendererData->InstanceTransforms;
+
+        const Uint visibleCount = CullBoxes(mBoxes, Frustum(viewProjection), mVisibleInstances.data());
+        Vector<DrawBatch>& visibleBatches = mVisibleBatches[view];
+        visibleBatches.clear();
+
+        // The visible instances are in ascending order, so the instances of a batch are still next to each other
+        Uint lastBatch = ~0u;
+        for (Uint i = 0; i < visibleCount; i++)
+        {
+            const Uint instance = mVisibleInstances[i];
+            const Uint batchIndex = mInstanceBatches[instance];
+            const Uint culledIndex = mCulledCount + i;
+            mCulledTransforms[culledIndex] = transforms[instance];
+
+            if (batchIndex == lastBatch)
+            {
+                visibleBatches.back().InstanceCount++;
+                continue;
+            }
+
+            DrawBatch batch = drawBatches[batchIndex];
+            batch.FirstInstance = culledIndex;
+            batch.InstanceCount = 1;
+            visibleBatches.push_back(batch);
+            lastBatch = batchIndex;
+        }
+
+        mVisibleInstanceCounts[view] = visibleCount;
+        mCulledCount += visibleCount;
+    }
+
+    void CPUCuller::Upload()
+    {
+        if (mCulledCount)
+            mCulledInstanceBuffer->SetDataRange(mCulledTransforms.data(), static_cast<Uint>(mCulledCount * sizeof(glm::mat4)));
+    }
+
+    float CPUCuller::RunBenchmark(Uint boxCount, Uint iterations)
+    {
+        SURGE_PROFILE_FUNC("CPUCuller::RunBenchmark");
+
+        // Unit cubes scattered around a camera at the origin, roughly a third of them ends up inside of the frustum
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+        const AABB unitBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+
+        CullingBoxes boxes;
+        boxes.Resize(boxCount);
+        for (Uint i = 0; i < boxCount; i++)
+        {
+            const glm::mat4 transform = glm::translate(glm::mat4(1.0f), {position(generator), position(generator), position(generator)}) * glm::scale(glm::mat4(1.0f), glm::vec3(scale(generator)));
+            boxes.Set(i, unitBox, transform);
+        }
+
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const Frustum frustum(projection * view);
+
+        Vector<Uint> visible(boxCount);
+        Uint visibleCount = 0;
+        Timer timer;
+        for (Uint i = 0; i < iterations; i++)
+            visibleCount += CullBoxes(boxes, frustum, visible.data());
+        const float elapsed = timer.ElapsedMillis();
+
+        Log<Severity::Info>("Culled {0} boxes {1} times in {2} ms, {3} visible per iteration", boxCount, iterations, elapsed, iterations ? visibleCount / iterations : 0);
+        return elapsed > 0.0f ? (static_cast<float>(boxCount) * iterations) / elapsed : 0.0f;
+    }
+
+} // namespace Surge
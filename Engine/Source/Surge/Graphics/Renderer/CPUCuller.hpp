@@ -0,0 +1,73 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Interface/StorageBuffer.hpp"
+#include "Surge/Graphics/Renderer/GPUScene.hpp"
+#include "SurgeMath/Frustum.hpp"
+
+#define CULLING_SIMD_WIDTH 8 // The boxes are padded to a multiple of this, enough for both the SSE and the AVX path
+
+namespace Surge
+{
+    struct RendererData;
+    struct DrawBatch;
+
+    // World space AABBs in SoA layout, so that CullBoxes can test 4 (SSE) or 8 (AVX) of them at once
+    struct CullingBoxes
+    {
+        void Resize(Uint count);
+        void Set(Uint index, const AABB& localBox, const glm::mat4& transform);
+
+        Uint Count = 0;
+        Vector<float> CenterX, CenterY, CenterZ;
+        Vector<float> ExtentX, ExtentY, ExtentZ;
+    };
+
+    // Writes the indices of the boxes that intersect the frustum to 'outVisible', in ascending order, and returns how many there are.
+    // 'outVisible' must have room for boxes.Count indices
+    SURGE_API Uint CullBoxes(const CullingBoxes& boxes, const Frustum& frustum, Uint* outVisible);
+
+    // Frustum culling of RendererData::DrawBatches on the CPU, used when GPU driven rendering is off.
+    // Every view (see GPUScene) gets its own DrawBatches with only the visible instances, their transforms are
+    // packed one view after the other in the culled instance buffer. Main thread only
+    class SURGE_API CPUCuller
+    {
+    public:
+        CPUCuller() = default;
+        ~CPUCuller() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(CPUCuller);
+
+        void Initialize(RendererData* rendererData);
+        void Shutdown();
+
+        // Transforms the submesh AABBs of this frame's DrawBatches to world space, called by the Renderer once they are built
+        void Update();
+
+        // Builds the visible DrawBatches of 'view', culled against the frustum of 'viewProjection'. Every view must be culled once per frame at most
+        void Cull(Uint view, const glm::mat4& viewProjection);
+
+        // Copies the transforms of the culled instances to the GPU, after all the views are culled and before the frame is submitted
+        void Upload();
+
+        const Vector<DrawBatch>& GetVisibleBatches(Uint view) const { return mVisibleBatches[view]; }
+        Uint GetVisibleInstanceCount(Uint view) const { return mVisibleInstanceCounts[view]; }
+        Uint GetInstanceCount() const { return mBoxes.Count; }
+        const Ref<StorageBuffer>& GetCulledInstanceBuffer() const { return mCulledInstanceBuffer; }
+
+        // Culls 'boxCount' random boxes against a camera frustum 'iterations' times, returns the throughput in boxes per millisecond
+        static float RunBenchmark(Uint boxCount, Uint iterations);
+
+    private:
+        RendererData* mRendererData = nullptr;
+        CullingBoxes mBoxes;
+        Vector<Uint> mInstanceBatches; // Index of the DrawBatch of every instance
+        Vector<Uint> mVisibleInstances; // Scratch space for CullBoxes
+
+        Vector<DrawBatch> mVisibleBatches[GPU_SCENE_VIEW_COUNT];
+        Uint mVisibleInstanceCounts[GPU_SCENE_VIEW_COUNT] = {};
+
+        Vector<glm::mat4> mCulledTransforms; // Always as big as the culled instance buffer
+        Ref<StorageBuffer> mCulledInstanceBuffer;
+        Uint mCulledCount = 0; // Transforms written this frame, by all the views
+    };
+
+} // namespace Surge
@@ -0,0 +1,215 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Renderer/GPUScene.hpp"
+#include "Surge/Graphics/Renderer/Renderer.hpp"
+#include "Surge/Graphics/RenderProcedure/ShadowMapProcedure.hpp"
+#include "SurgeMath/Frustum.hpp"
+#include <cstring>
+
+// Must match IndirectCulling.glsl
+#define CULLING_WORKGROUP_SIZE 64
+#define CULL_INSTANCES 0
+#define WRITE_COMMANDS 1
+
+// Number of batches and instances the buffers start with, they grow by doubling
+#define INITIAL_BATCH_CAPACITY 256
+#define INITIAL_INSTANCE_CAPACITY 1024
+
+namespace Surge
+{
+    static_assert(GPU_SCENE_VIEW_COUNT == MAX_CASCADE_COUNT + 1, "The GPUScene needs a view for the camera and every shadow cascade!");
+
+    // Same layout as VkDrawIndexedIndirectCommand
+    struct DrawIndexedIndirectCommand
+    {
+        Uint IndexCount;
+        Uint InstanceCount;
+        Uint FirstIndex;
+        int VertexOffset;
+        Uint FirstInstance;
+    };
+
+    struct CullPushConstants // 'uCullData' in IndirectCulling.glsl
+    {
+        glm::vec4 FrustumPlanes[6];
+        Uint Mode;
+        Uint View;
+        Uint InstanceCount;
+        Uint BatchCount;
+        Uint RunCount;
+        Uint RunCountersOffset;
+    };
+
+    static Uint GrowCapacity(Uint capacity, Uint required)
+    {
+        while (capacity < required)
+            capacity *= 2;
+        return capacity;
+    }
+
+    void GPUScene::Initialize(RendererData* rendererData)
+    {
+        mRendererData = rendererData;
+
+        Ref<Shader>& cullingShader = mRendererData->ShaderSet.GetShader("IndirectCulling");
+        mCullingPipeline = ComputePipeline::Create(cullingShader);
+        mCullingDescriptorSet = DescriptorSet::Create(cullingShader, 0, false);
+
+        mBatches.resize(INITIAL_BATCH_CAPACITY);
+        mInstanceBatches.resize(INITIAL_INSTANCE_CAPACITY);
+        mZeroCounters.resize(GPU_SCENE_VIEW_COUNT * INITIAL_BATCH_CAPACITY * 2); // Runs never outnumber batches
+        mBatchBuffer = StorageBuffer::Create(INITIAL_BATCH_CAPACITY * sizeof(GPUBatch), GPUMemoryUsage::CPUToGPU);
+        mInstanceBatchBuffer = StorageBuffer::Create(INITIAL_INSTANCE_CAPACITY * sizeof(Uint), GPUMemoryUsage::CPUToGPU);
+        mCounterBuffer = StorageBuffer::Create(static_cast<Uint>(mZeroCounters.size() * sizeof(Uint)), GPUMemoryUsage::CPUToGPU, true);
+        mCommandBuffer = StorageBuffer::Create(GPU_SCENE_VIEW_COUNT * INITIAL_BATCH_CAPACITY * sizeof(DrawIndexedIndirectCommand), GPUMemoryUsage::GPUOnly, true);
+        mCulledInstanceBuffer = StorageBuffer::Create(GPU_SCENE_VIEW_COUNT * INITIAL_INSTANCE_CAPACITY * sizeof(glm::mat4), GPUMemoryUsage::GPUOnly);
+    }
+
+    void GPUScene::Shutdown()
+    {
+        mCullingPipeline.Reset();
+        mCullingDescriptorSet.Reset();
+        mBatchBuffer.Reset();
+        mInstanceBatchBuffer.Reset();
+        mCounterBuffer.Reset();
+        mCommandBuffer.Reset();
+        mCulledInstanceBuffer.Reset();
+        mRuns.clear();
+    }
+
+    void GPUScene::Reserve(Uint batchCount, Uint instanceCount)
+    {
+        const Uint batchCapacity = static_cast<Uint>(mBatches.size());
+        if (batchCount > batchCapacity)
+        {
+            const Uint newCapacity = GrowCapacity(batchCapacity, batchCount);
+            mBatches.resize(newCapacity);
+            mZeroCounters.resize(GPU_SCENE_VIEW_COUNT * newCapacity * 2);
+            mBatchBuffer->Resize(newCapacity * sizeof(GPUBatch));
+            mCounterBuffer->Resize(static_cast<Uint>(mZeroCounters.size() * sizeof(Uint)));
+            mCommandBuffer->Resize(GPU_SCENE_VIEW_COUNT * newCapacity * sizeof(DrawIndexedIndirectCommand));
+        }
+
+        const Uint instanceCapacity = static_cast<Uint>(mInstanceBatches.size());
+        if (instanceCount > instanceCapacity)
+        {
+            const Uint newCapacity = GrowCapacity(instanceCapacity, instanceCount);
+            mInstanceBatches.resize(newCapacity);
+            mInstanceBatchBuffer->Resize(newCapacity * sizeof(Uint));
+            mCulledInstanceBuffer->Resize(GPU_SCENE_VIEW_COUNT * newCapacity * sizeof(glm::mat4));
+        }
+    }
+
+    void GPUScene::Update()
+    {
+        SURGE_PROFILE_FUNC("GPUScene::Update");
+        static_assert(sizeof(GPUBatch) == 48, "GPUBatch must match the std430 layout of IndirectCulling.glsl!");
+        const Vector<DrawBatch>& drawBatches = mRendererData->DrawBatches;
+        mBatchCount = static_cast<Uint>(drawBatches.size());
+        mInstanceCount = drawBatches.empty() ? 0 : drawBatches.back().FirstInstance + drawBatches.back().InstanceCount;
+        mRuns.clear();
+        if (!mBatchCount)
+            return;
+
+        Reserve(mBatchCount, mInstanceCount);
+        for (Uint i = 0; i < mBatchCount; i++)
+        {
+            const DrawBatch& batch = drawBatches[i];
+            if (mRuns.empty() || mRuns.back().Mesh != batch.Mesh || mRuns.back().Material != batch.Material)
+                mRuns.push_back({batch.Mesh, batch.Material, i, 0});
+            DrawRun& run = mRuns.back();
+            run.BatchCount++;
+
+            const Submesh& submesh = batch.Mesh->GetSubmeshes()[batch.SubmeshIndex];
+            GPUBatch& gpuBatch = mBatches[i];
+            gpuBatch.BoundsMin = submesh.BoundingBox.Min;
+            gpuBatch.IndexCount = submesh.IndexCount;
+            gpuBatch.BoundsMax = submesh.BoundingBox.Max;
+            gpuBatch.FirstIndex = submesh.BaseIndex;
+            gpuBatch.VertexOffset = static_cast<int>(submesh.BaseVertex);
+            gpuBatch.FirstInstance = batch.FirstInstance;
+            gpuBatch.RunIndex = static_cast<Uint>(mRuns.size() - 1);
+            gpuBatch.FirstCommand = run.FirstBatch;
+
+            for (Uint j = 0; j < batch.InstanceCount; j++)
+                mInstanceBatches[batch.FirstInstance + j] = i;
+        }
+
+        mBatchBuffer->SetData(mBatches.data());
+        mInstanceBatchBuffer->SetData(mInstanceBatches.data());
+        mCounterBuffer->SetData(mZeroCounters.data());
+
+        mCullingDescriptorSet->SetBuffer(mRendererData->InstanceBuffer, 0);
+        mCullingDescriptorSet->SetBuffer(mInstanceBatchBuffer, 1);
+        mCullingDescriptorSet->SetBuffer(mBatchBuffer, 2);
+        mCullingDescriptorSet->SetBuffer(mCounterBuffer, 3);
+        mCullingDescriptorSet->SetBuffer(mCommandBuffer, 4);
+        mCullingDescriptorSet->SetBuffer(mCulledInstanceBuffer, 5);
+        mCullingDescriptorSet->UpdateForRendering();
+    }
+
+    void GPUScene::Cull(Uint view, const glm::mat4& viewProjection)
+    {
+        SURGE_PROFILE_FUNC("GPUScene::Cull");
+        SG_ASSERT(view < GPU_SCENE_VIEW_COUNT, "Invalid GPUScene view!");
+        if (!mBatchCount)
+            return;
+
+        const Ref<RenderCommandBuffer>& cmd = mRendererData->RenderCmdBuffer;
+        const Frustum frustum(viewProjection);
+        CullPushConstants constants;
+        std::memcpy(constants.FrustumPlanes, frustum.Planes, sizeof(frustum.Planes));
+        constants.View = view;
+        constants.InstanceCount = mInstanceCount;
+        constants.BatchCount = mBatchCount;
+        constants.RunCount = static_cast<Uint>(mRuns.size());
+        constants.RunCountersOffset = GPU_SCENE_VIEW_COUNT * mBatchCount;
+
+        mCullingPipeline->Bind(cmd);
+        mCullingDescriptorSet->Bind(cmd, mCullingPipeline);
+
+        // The culled instances and commands are shared by all the frames in flight, wait for the draws that are still reading them
+        mCullingPipeline->InsertDispatchBarrier(cmd);
+
+        constants.Mode = CULL_INSTANCES;
+        mCullingPipeline->SetPushConstantData(cmd, "uCullData", &constants);
+        mCullingPipeline->Dispatch(cmd, (mInstanceCount + CULLING_WORKGROUP_SIZE - 1) / CULLING_WORKGROUP_SIZE, 1, 1);
+        mCullingPipeline->InsertDispatchBarrier(cmd);
+
+        constants.Mode = WRITE_COMMANDS;
+        mCullingPipeline->SetPushConstantData(cmd, "uCullData", &constants);
+        mCullingPipeline->Dispatch(cmd, (mBatchCount + CULLING_WORKGROUP_SIZE - 1) / CULLING_WORKGROUP_SIZE, 1, 1);
+        mCullingPipeline->InsertDispatchBarrier(cmd);
+    }
+
+    void GPUScene::Draw(const Ref<RenderCommandBuffer>& cmd, Uint view, const Ref<GraphicsPipeline>& pipeline, MaterialPushConstants* materialConstants, Uint firstRun, Uint lastRun) const
+    {
+        SURGE_PROFILE_FUNC("GPUScene::Draw");
+        const Uint firstCommand = view * mBatchCount;
+        const Uint firstRunCounter = GPU_SCENE_VIEW_COUNT * mBatchCount + view * static_cast<Uint>(mRuns.size());
+
+        const Mesh* boundMesh = nullptr;
+        const Material* boundMaterial = nullptr;
+        for (Uint i = firstRun; i < lastRun; i++)
+        {
+            const DrawRun& run = mRuns[i];
+            if (run.Mesh != boundMesh)
+            {
+                run.Mesh->GetVertexBuffer()->Bind(cmd);
+                run.Mesh->GetIndexBuffer()->Bind(cmd);
+                boundMesh = run.Mesh;
+            }
+
+            if (materialConstants && run.Material != boundMaterial)
+            {
+                materialConstants->MaterialIndex = run.Material->GetIndex();
+                pipeline->SetPushConstantData(cmd, "uMesh", materialConstants);
+                boundMaterial = run.Material;
+            }
+
+            const Uint commandsOffset = (firstCommand + run.FirstBatch) * sizeof(DrawIndexedIndirectCommand);
+            const Uint countOffset = (firstRunCounter + i) * sizeof(Uint);
+            pipeline->DrawIndexedIndirectCount(cmd, mCommandBuffer, commandsOffset, mCounterBuffer, countOffset, run.BatchCount);
+        }
+    }
+
+} // namespace Surge
@@ -0,0 +1,97 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Graphics/Interface/ComputePipeline.hpp"
+#include "Surge/Graphics/Interface/DescriptorSet.hpp"
+#include "Surge/Graphics/Interface/GraphicsPipeline.hpp"
+#include "Surge/Graphics/Interface/StorageBuffer.hpp"
+#include <glm/glm.hpp>
+
+#define GPU_SCENE_CAMERA_VIEW 0 // Views 1 to MAX_CASCADE_COUNT are the shadow cascades
+#define GPU_SCENE_VIEW_COUNT 5  // The camera and MAX_CASCADE_COUNT shadow cascades
+
+namespace Surge
+{
+    struct RendererData;
+    struct MaterialPushConstants;
+    class Mesh;
+    class Material;
+
+    // GPU driven drawing of RendererData::DrawBatches. The batches and their submesh AABBs are uploaded once per frame, then for every view
+    // a compute pass (IndirectCulling.glsl) frustum culls the instances and writes the indirect draw commands, which are drawn with one
+    // vkCmdDrawIndexedIndirectCount per run of batches that share a mesh and a material. Main thread only
+    class SURGE_API GPUScene
+    {
+    public:
+        GPUScene() = default;
+        ~GPUScene() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(GPUScene);
+
+        void Initialize(RendererData* rendererData);
+        void Shutdown();
+
+        // Uploads the DrawBatches of this frame, called by the Renderer once they are built
+        void Update();
+
+        // Records the culling of 'view' against the frustum of 'viewProjection'. Must be recorded outside of a render pass,
+        // before the view is drawn
+        void Cull(Uint view, const glm::mat4& viewProjection);
+
+        // Records the indirect draws of the runs [firstRun, lastRun) of 'view' into 'cmd'. The pipeline, its descriptor sets and push
+        // constants must already be bound. If 'materialConstants' isn't null, they are pushed with the MaterialIndex of every run.
+        // Thread safe, as long as the materials are already updated for rendering
+        void Draw(const Ref<RenderCommandBuffer>& cmd, Uint view, const Ref<GraphicsPipeline>& pipeline, MaterialPushConstants* materialConstants, Uint firstRun, Uint lastRun) const;
+
+        // Number of runs of batches that share a mesh and a material, one indirect draw is recorded per run and view
+        Uint GetRunCount() const { return static_cast<Uint>(mRuns.size()); }
+
+        // Transforms of the visible instances of every view, the mesh passes read it in place of RendererData::InstanceBuffer
+        const Ref<StorageBuffer>& GetCulledInstanceBuffer() const { return mCulledInstanceBuffer; }
+
+    private:
+        void Reserve(Uint batchCount, Uint instanceCount);
+
+    private:
+        // Mirrors 'Batch' in IndirectCulling.glsl
+        struct GPUBatch
+        {
+            glm::vec3 BoundsMin;
+            Uint IndexCount;
+            glm::vec3 BoundsMax;
+            Uint FirstIndex;
+
+            int VertexOffset;
+            Uint FirstInstance;
+            Uint RunIndex;
+            Uint FirstCommand;
+        };
+
+        // Consecutive batches that can be drawn without rebinding anything
+        struct DrawRun
+        {
+            Surge::Mesh* Mesh;
+            Surge::Material* Material;
+            Uint FirstBatch;
+            Uint BatchCount;
+        };
+
+        RendererData* mRendererData = nullptr;
+        Ref<ComputePipeline> mCullingPipeline;
+        Ref<DescriptorSet> mCullingDescriptorSet;
+
+        Ref<StorageBuffer> mBatchBuffer;          // GPUBatch per batch
+        Ref<StorageBuffer> mInstanceBatchBuffer;  // Index of the batch of every instance
+        Ref<StorageBuffer> mCounterBuffer;        // Visible instances per batch and commands per run, of every view
+        Ref<StorageBuffer> mCommandBuffer;        // Indirect commands of every view, written by the GPU
+        Ref<StorageBuffer> mCulledInstanceBuffer; // Visible instance transforms of every view, written by the GPU
+
+        // CPU side of the buffers, always as big as them since StorageBuffer::SetData copies the whole buffer
+        Vector<GPUBatch> mBatches;
+        Vector<Uint> mInstanceBatches;
+        Vector<Uint> mZeroCounters;
+        Vector<DrawRun> mRuns;
+
+        Uint mBatchCount = 0;
+        Uint mInstanceCount = 0;
+    };
+
+} // namespace Surge
@@ -0,0 +1,159 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Renderer/MaterialTable.hpp"
+#include "Surge/Graphics/Renderer/Renderer.hpp"
+#include <cstring>
+
+// Number of materials the buffer starts with, it grows by doubling
+#define INITIAL_MATERIAL_CAPACITY 256
+
+namespace Surge
+{
+    void MaterialTable::Initialize(RendererData* rendererData)
+    {
+        mRendererData = rendererData;
+
+        // Every material shader must lay its materials out like the PBR one
+        Ref<Shader>& shader = mRendererData->ShaderSet.GetShader("PBR");
+        mMaterialSize = shader->GetReflectionData().GetBuffer("Materials").ElementSize;
+        SG_ASSERT(mMaterialSize, "'Materials' must end with a runtime array of the materials!");
+
+        mDescriptorSet = DescriptorSet::Create(shader, MATERIAL_TABLE_SET, false);
+        mMaterialData.resize(INITIAL_MATERIAL_CAPACITY * mMaterialSize);
+        mMaterialBuffer = StorageBuffer::Create(static_cast<Uint>(mMaterialData.size()), GPUMemoryUsage::CPUToGPU);
+        mUploadedVersions.assign(FRAMES_IN_FLIGHT, mVersion);
+        mPendingTextureSlots.resize(FRAMES_IN_FLIGHT);
+    }
+
+    void MaterialTable::Shutdown()
+    {
+        mDescriptorSet.Reset();
+        mMaterialBuffer.Reset();
+        mTextures.clear();
+        mTextureSlots.clear();
+        mFreeTextureSlots.clear();
+        mRetiredTextureSlots.clear();
+        mPendingTextureSlots.clear();
+    }
+
+    Uint MaterialTable::AddMaterial()
+    {
+        if (!mFreeMaterials.empty())
+        {
+            const Uint index = mFreeMaterials.back();
+            mFreeMaterials.pop_back();
+            return index;
+        }
+
+        const Uint index = mMaterialCount++;
+        const Uint requiredSize = mMaterialCount * mMaterialSize;
+        if (requiredSize > mMaterialData.size())
+        {
+            // The new buffer has nothing in it, every frame in flight uploads all the materials again
+            mMaterialData.resize(mMaterialData.size() * 2);
+            mMaterialBuffer->Resize(static_cast<Uint>(mMaterialData.size()));
+            mUploadedVersions.assign(FRAMES_IN_FLIGHT, mVersion - 1);
+        }
+        return index;
+    }
+
+    void MaterialTable::RemoveMaterial(Uint index)
+    {
+        // The frames in flight have their own copy of the materials, so the index can be reused right away
+        mFreeMaterials.push_back(index);
+    }
+
+    void MaterialTable::SetMaterialData(Uint index, const Buffer& data)
+    {
+        SG_ASSERT(index < mMaterialCount && data.Size == mMaterialSize, "Invalid material!");
+        std::memcpy(mMaterialData.data() + index * mMaterialSize, data.Data, mMaterialSize);
+        mVersion++;
+    }
+
+    Uint MaterialTable::AddTexture(const Ref<Texture2D>& texture)
+    {
+        auto itr = mTextureSlots.find(texture.Raw());
+        if (itr != mTextureSlots.end())
+        {
+            itr->second.RefCount++;
+            return itr->second.Slot;
+        }
+
+        // Slots retired FRAMES_IN_FLIGHT frames ago are no longer sampled by any frame
+        const uint64_t frameCount = Core::GetRenderContext()->GetFrameCount();
+        for (size_t i = 0; i < mRetiredTextureSlots.size();)
+        {
+            if (frameCount >= mRetiredTextureSlots[i].Frame + FRAMES_IN_FLIGHT)
+            {
+                mTextures[mRetiredTextureSlots[i].Slot].Reset();
+                mFreeTextureSlots.push_back(mRetiredTextureSlots[i].Slot);
+                mRetiredTextureSlots[i] = mRetiredTextureSlots.back();
+                mRetiredTextureSlots.pop_back();
+            }
+            else
+                i++;
+        }
+
+        Uint slot;
+        if (!mFreeTextureSlots.empty())
+        {
+            slot = mFreeTextureSlots.back();
+            mFreeTextureSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<Uint>(mTextures.size());
+            SG_ASSERT(slot < RUNTIME_DESCRIPTOR_ARRAY_SIZE, "The MaterialTable is out of texture slots!");
+            mTextures.emplace_back();
+        }
+
+        mTextures[slot] = texture;
+        mTextureSlots[texture.Raw()] = {slot, 1};
+        for (Vector<Uint>& pendingSlots : mPendingTextureSlots)
+            pendingSlots.push_back(slot);
+        return slot;
+    }
+
+    void MaterialTable::RemoveTexture(const Ref<Texture2D>& texture)
+    {
+        auto itr = mTextureSlots.find(texture.Raw());
+        SG_ASSERT(itr != mTextureSlots.end(), "The texture isn't in the MaterialTable!");
+        if (--itr->second.RefCount)
+            return;
+
+        // The texture is kept alive until its slot is reused, a frame in flight may still sample it
+        mRetiredTextureSlots.push_back({itr->second.Slot, Core::GetRenderContext()->GetFrameCount()});
+        mTextureSlots.erase(itr);
+    }
+
+    void MaterialTable::Update()
+    {
+        SURGE_PROFILE_FUNC("MaterialTable::Update");
+        const Uint frameIndex = Core::GetRenderContext()->GetFrameIndex();
+        mStats.MaterialCount = mMaterialCount - static_cast<Uint>(mFreeMaterials.size());
+        mStats.TextureCount = static_cast<Uint>(mTextureSlots.size());
+        mStats.UploadedBytes = 0;
+
+        if (mUploadedVersions[frameIndex] != mVersion)
+        {
+            mStats.UploadedBytes = mMaterialCount * mMaterialSize;
+            mMaterialBuffer->SetDataRange(mMaterialData.data(), mStats.UploadedBytes);
+            mUploadedVersions[frameIndex] = mVersion;
+        }
+
+        // A retired slot keeps its texture until it is reused, so every pending slot has one
+        Vector<Uint>& pendingSlots = mPendingTextureSlots[frameIndex];
+        for (Uint slot : pendingSlots)
+            mDescriptorSet->SetImage2D(mTextures[slot]->GetImage2D(), MATERIAL_TEXTURES_BINDING, slot);
+        mStats.WrittenTextures = static_cast<Uint>(pendingSlots.size());
+        pendingSlots.clear();
+
+        mDescriptorSet->SetBuffer(mMaterialBuffer, MATERIAL_BUFFER_BINDING);
+        mDescriptorSet->UpdateForRendering();
+    }
+
+    void MaterialTable::Bind(const Ref<RenderCommandBuffer>& cmd, const Ref<GraphicsPipeline>& pipeline) const
+    {
+        mDescriptorSet->Bind(cmd, pipeline);
+    }
+
+} // namespace Surge
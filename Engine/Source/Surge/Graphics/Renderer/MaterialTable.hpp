@@ -0,0 +1,99 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Buffer.hpp"
+#include "Surge/Graphics/Interface/DescriptorSet.hpp"
+#include "Surge/Graphics/Interface/GraphicsPipeline.hpp"
+#include "Surge/Graphics/Interface/StorageBuffer.hpp"
+#include "Surge/Graphics/Interface/Texture.hpp"
+#include <glm/glm.hpp>
+
+// Set of the MaterialTable in the shaders that shade with it (PBR.glsl)
+#define MATERIAL_TABLE_SET 1
+#define MATERIAL_BUFFER_BINDING 0
+#define MATERIAL_TEXTURES_BINDING 1
+
+namespace Surge
+{
+    struct RendererData;
+
+    // 'uMesh' in PBR.glsl, MaterialIndex selects the material of the draw in the MaterialTable
+    struct MaterialPushConstants
+    {
+        glm::mat4 ViewProjection;
+        Uint MaterialIndex;
+    };
+
+    struct MaterialTableStats
+    {
+        Uint MaterialCount = 0;
+        Uint TextureCount = 0;
+        Uint UploadedBytes = 0;   // This frame
+        Uint WrittenTextures = 0; // This frame
+    };
+
+    // Every Material of the renderer lives in one storage buffer, and every texture they use in one bindless array of descriptors.
+    // Both are in one descriptor set (MATERIAL_TABLE_SET) that is bound once per pass, a draw only pushes the index of its material.
+    // The materials store the slots of their textures in the array, a texture used by several materials has one slot. Main thread only
+    class SURGE_API MaterialTable
+    {
+    public:
+        MaterialTable() = default;
+        ~MaterialTable() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(MaterialTable);
+
+        void Initialize(RendererData* rendererData);
+        void Shutdown();
+
+        // Index of a new material in the buffer, its data is given with SetMaterialData
+        Uint AddMaterial();
+        void RemoveMaterial(Uint index);
+        void SetMaterialData(Uint index, const Buffer& data);
+        Uint GetMaterialSize() const { return mMaterialSize; }
+
+        // Slot of 'texture' in the texture array, every AddTexture must be matched by a RemoveTexture
+        Uint AddTexture(const Ref<Texture2D>& texture);
+        void RemoveTexture(const Ref<Texture2D>& texture);
+
+        // Uploads the materials and writes the new textures into the copy of the current frame, before the passes are recorded
+        void Update();
+        void Bind(const Ref<RenderCommandBuffer>& cmd, const Ref<GraphicsPipeline>& pipeline) const;
+
+        const MaterialTableStats& GetStats() const { return mStats; }
+
+    private:
+        struct TextureSlot
+        {
+            Uint Slot;
+            Uint RefCount;
+        };
+
+        struct RetiredSlot
+        {
+            Uint Slot;
+            uint64_t Frame; // RenderContext::GetFrameCount() when the slot was last used
+        };
+
+    private:
+        RendererData* mRendererData = nullptr;
+        Ref<DescriptorSet> mDescriptorSet;
+        Ref<StorageBuffer> mMaterialBuffer;
+
+        // Materials, the CPU side is always as big as the buffer since StorageBuffer::SetData copies the whole buffer
+        Vector<Byte> mMaterialData;
+        Vector<Uint> mFreeMaterials;
+        Uint mMaterialSize = 0;
+        Uint mMaterialCount = 0; // Including the free ones
+        Uint mVersion = 0;
+        Vector<Uint> mUploadedVersions; // Version of the materials in the copy of every frame in flight
+
+        // Textures, a slot is reused once the frames in flight that could still sample the old texture are done
+        Vector<Ref<Texture2D>> mTextures;
+        HashMap<const Texture2D*, TextureSlot> mTextureSlots;
+        Vector<Uint> mFreeTextureSlots;
+        Vector<RetiredSlot> mRetiredTextureSlots;
+        Vector<Vector<Uint>> mPendingTextureSlots; // Slots to write into the copy of every frame in flight
+
+        MaterialTableStats mStats;
+    };
+
+} // namespace Surge
@@ -0,0 +1,121 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Graphics/Renderer/ParallelCommandRecorder.hpp"
+#include "Surge/Graphics/Renderer/Renderer.hpp"
+#include "Surge/Core/Thread/ThreadPool.hpp"
+
+namespace Surge
+{
+    void ParallelCommandRecorder::Initialize(RendererData* rendererData)
+    {
+        mRendererData = rendererData;
+    }
+
+    void ParallelCommandRecorder::Shutdown()
+    {
+        ThreadPool* threadPool = Core::GetThreadPool();
+        for (const JobHandle& job : mJobs)
+            threadPool->Wait(job);
+
+        mJobs.clear();
+        mPendingPasses.clear();
+        mSecondaryBuffers.clear();
+        mUsedBuffers = 0;
+    }
+
+    void ParallelCommandRecorder::RecordRenderPass(const Ref<Framebuffer>& framebuffer, Uint itemCount, Uint minChunkSize, RenderPassRecordFn record)
+    {
+        SURGE_PROFILE_FUNC("ParallelCommandRecorder::RecordRenderPass");
+        const Ref<RenderCommandBuffer>& primaryBuffer = mRendererData->RenderCmdBuffer;
+        if (!mRendererData->ParallelRecording)
+        {
+            Flush();
+            framebuffer->BeginRenderPass(primaryBuffer);
+            record(primaryBuffer, 0, itemCount);
+            framebuffer->EndRenderPass(primaryBuffer);
+            return;
+        }
+
+        // One chunk per thread (the main thread helps while flushing), unless that makes the chunks too small to be worth a job
+        ThreadPool* threadPool = Core::GetThreadPool();
+        const Uint maxChunkCount = threadPool->GetThreadCount() + 1;
+        const Uint chunkSize = std::max({minChunkSize, (itemCount + maxChunkCount - 1) / maxChunkCount, 1u});
+        const Uint chunkCount = (itemCount + chunkSize - 1) / chunkSize;
+
+        while (mSecondaryBuffers.size() < mUsedBuffers + chunkCount)
+            mSecondaryBuffers.push_back(RenderCommandBuffer::CreateSecondary());
+
+        PendingPass& pass = mPendingPasses.emplace_back();
+        pass.Target = framebuffer;
+        pass.Record = std::move(record);
+        pass.ItemCount = itemCount;
+        pass.ChunkSize = chunkSize;
+        pass.FirstBuffer = mUsedBuffers;
+        pass.BufferCount = chunkCount;
+        pass.Barriers = nullptr;
+        mUsedBuffers += chunkCount;
+
+        for (Uint i = 0; i < chunkCount; i++)
+        {
+            // The job holds its own reference, mSecondaryBuffers may grow while it is running
+            mJobs.push_back(threadPool->Run([pass = &pass, cmd = mSecondaryBuffers[pass.FirstBuffer + i], chunk = i]() mutable {
+                SURGE_PROFILE_FUNC("ParallelCommandRecorder::RecordChunk");
+                const Uint begin = chunk * pass->ChunkSize;
+                const Uint end = std::min(begin + pass->ChunkSize, pass->ItemCount);
+
+                cmd->BeginRecording(pass->Target);
+                pass->Record(cmd, begin, end);
+                cmd->EndRecording();
+            }));
+        }
+    }
+
+    void ParallelCommandRecorder::InsertBarriers(const ResourceBarriers& barriers)
+    {
+        if (barriers.Empty())
+            return;
+
+        if (mPendingPasses.empty())
+        {
+            mRendererData->RenderCmdBuffer->InsertBarriers(barriers);
+            return;
+        }
+
+        PendingPass& pass = mPendingPasses.emplace_back();
+        pass.Barriers = &barriers;
+    }
+
+    void ParallelCommandRecorder::Flush()
+    {
+        if (mPendingPasses.empty())
+            return;
+
+        SURGE_PROFILE_FUNC("ParallelCommandRecorder::Flush");
+        ThreadPool* threadPool = Core::GetThreadPool();
+        for (const JobHandle& job : mJobs)
+            threadPool->Wait(job);
+
+        const Ref<RenderCommandBuffer>& primaryBuffer = mRendererData->RenderCmdBuffer;
+        for (const PendingPass& pass : mPendingPasses)
+        {
+            if (pass.Barriers)
+            {
+                primaryBuffer->InsertBarriers(*pass.Barriers);
+                continue;
+            }
+
+            pass.Target->BeginRenderPass(primaryBuffer, true);
+            primaryBuffer->Execute(mSecondaryBuffers.data() + pass.FirstBuffer, pass.BufferCount);
+            pass.Target->EndRenderPass(primaryBuffer);
+        }
+
+        mJobs.clear();
+        mPendingPasses.clear();
+    }
+
+    void ParallelCommandRecorder::EndFrame()
+    {
+        Flush();
+        mUsedBuffers = 0;
+    }
+
+} // namespace Surge
@@ -0,0 +1,71 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Thread/Job.hpp"
+#include "Surge/Graphics/Interface/Framebuffer.hpp"
+#include "Surge/Graphics/Interface/RenderCommandBuffer.hpp"
+#include "Surge/Graphics/Interface/ResourceBarrier.hpp"
+#include <functional>
+
+#define MIN_BATCHES_PER_RECORDING_JOB 64 // Smallest chunk of DrawBatches (or GPUScene runs) the mesh procedures hand to a recording job
+
+namespace Surge
+{
+    struct RendererData;
+
+    // Records the draws of a render pass into the command buffer 'cmd', for the items [begin, end) of the pass
+    using RenderPassRecordFn = std::function<void(const Ref<RenderCommandBuffer>& cmd, Uint begin, Uint end)>;
+
+    // Records the render passes of the mesh procedures on the job system.
+    // Every pass is split into chunks of items (batches, runs...), every chunk is recorded by a job into a secondary command buffer.
+    // The passes are written to RendererData::RenderCmdBuffer by Flush, in the order they were added, so passes added one after
+    // the other are recorded in parallel. Anything recorded straight into RendererData::RenderCmdBuffer must come after a Flush.
+    // Every secondary command buffer has its own command pool and is recorded by one job at a time, so no pool is ever used by two
+    // threads at once. Main thread only
+    class SURGE_API ParallelCommandRecorder
+    {
+    public:
+        ParallelCommandRecorder() = default;
+        ~ParallelCommandRecorder() = default;
+        SURGE_DISABLE_COPY_AND_MOVE(ParallelCommandRecorder);
+
+        void Initialize(RendererData* rendererData);
+        void Shutdown();
+
+        // Schedules the recording of a render pass on 'framebuffer' that draws 'itemCount' items, in chunks of at least 'minChunkSize' items.
+        // 'record' runs on the job system and may be called concurrently for different chunks, everything it reads must stay alive and
+        // unchanged until the next Flush. If parallel recording is off, the pass is recorded right away into the primary command buffer
+        void RecordRenderPass(const Ref<Framebuffer>& framebuffer, Uint itemCount, Uint minChunkSize, RenderPassRecordFn record);
+
+        // Records 'barriers' in the primary command buffer after the passes scheduled so far, 'barriers' must stay alive until the next Flush
+        void InsertBarriers(const ResourceBarriers& barriers);
+
+        // Waits for the scheduled passes and executes them in the primary command buffer
+        void Flush();
+
+        // Flushes and recycles the secondary command buffers, called by the Renderer before the primary command buffer is submitted.
+        // A secondary command buffer is recorded once per frame at most, recording it again would invalidate the primary one
+        void EndFrame();
+
+        Uint GetSecondaryBufferCount() const { return static_cast<Uint>(mSecondaryBuffers.size()); }
+
+    private:
+        struct PendingPass
+        {
+            Ref<Framebuffer> Target;
+            RenderPassRecordFn Record;
+            Uint ItemCount;
+            Uint ChunkSize;
+            Uint FirstBuffer; // Index of the first secondary command buffer of the pass in mSecondaryBuffers
+            Uint BufferCount;
+            const ResourceBarriers* Barriers; // If set, the entry is a barrier between two passes instead of a pass
+        };
+
+        RendererData* mRendererData = nullptr;
+        Deque<PendingPass> mPendingPasses; // Deque, so that the jobs can hold on to their pass while more are added
+        Vector<JobHandle> mJobs;
+
+        Vector<Ref<RenderCommandBuffer>> mSecondaryBuffers; // Grows on demand, reused every frame
+        Uint mUsedBuffers = 0;
+    };
+
+} // namespace Surge
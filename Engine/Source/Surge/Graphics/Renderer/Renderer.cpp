@@ -7,9 +7,28 @@
 #include "Surge/Graphics/RenderProcedure/GeometryProcedure.hpp"
 #include "Surge/Graphics/RenderProcedure/LightCullingProcedure.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+
+#define PLACEHOLDER_MESH_PATH "Engine/Assets/Mesh/Cube.fbx"
+
+// Number of instance transforms the InstanceBuffer starts with, it grows by doubling
+#define INITIAL_INSTANCE_CAPACITY 1024
 
 namespace Surge
 {
+    namespace
+    {
+        // Grows 'bounds' by 'localBox' transformed to world space
+        void ExpandBounds(AABB& bounds, const AABB& localBox, const glm::mat4& transform)
+        {
+            const glm::vec3 center = transform * glm::vec4((localBox.Min + localBox.Max) * 0.5f, 1.0f);
+            const glm::vec3 localExtents = (localBox.Max - localBox.Min) * 0.5f;
+            const glm::vec3 extents = glm::abs(glm::vec3(transform[0])) * localExtents.x + glm::abs(glm::vec3(transform[1])) * localExtents.y + glm::abs(glm::vec3(transform[2])) * localExtents.z;
+            bounds.Min = glm::min(bounds.Min, center - extents);
+            bounds.Max = glm::max(bounds.Max, center + extents);
+        }
+    } // namespace
+
     struct UBufCameraData // At binding 0 set 0
     {
         glm::mat4 ViewMatrix;
@@ -35,6 +54,7 @@ namespace Surge
         mData->ShaderSet.AddShader("ShadowMap.glsl");
         mData->ShaderSet.AddShader("PreDepth.glsl");
         mData->ShaderSet.AddShader("LightCulling.glsl");
+        mData->ShaderSet.AddShader("IndirectCulling.glsl");
         mData->ShaderSet.LoadAll();
 
         Ref<Shader> mainPBRShader = Core::GetRenderer()->GetShader("PBR");
@@ -43,9 +63,16 @@ namespace Surge
         mData->CameraUniformBuffer = UniformBuffer::Create(sizeof(UBufCameraData));
         mData->RendererDataUniformBuffer = UniformBuffer::Create(sizeof(UBufRendererData));
         mData->DescriptorSet0 = DescriptorSet::Create(mainPBRShader, 0, false);
+        mData->InstanceTransforms.resize(INITIAL_INSTANCE_CAPACITY);
+        mData->InstanceBuffer = StorageBuffer::Create(INITIAL_INSTANCE_CAPACITY * sizeof(glm::mat4), GPUMemoryUsage::CPUToGPU);
+        mData->GPUScene.Initialize(mData.get());
+        mData->CPUCuller.Initialize(mData.get());
+        mData->CommandRecorder.Initialize(mData.get());
 
         Uint whiteTextureData = 0xffffffff;
         mData->WhiteTexture = Texture2D::Create(ImageFormat::RGBA8, 1, 1, &whiteTextureData);
+        mData->MaterialTable.Initialize(mData.get()); // Before any Material is created
+        mData->PlaceholderMesh = Core::GetAssetManager()->LoadMesh(PLACEHOLDER_MESH_PATH);
 
         mProcManager.Init(mData);
         mProcManager.AddProcedure<PreDepthProcedure>();
@@ -53,6 +80,7 @@ namespace Surge
         mProcManager.AddProcedure<ShadowMapProcedure>();
         mProcManager.AddProcedure<GeometryProcedure>();
         mProcManager.Sort<PreDepthProcedure, LightCullingProcedure, ShadowMapProcedure, GeometryProcedure>();
+        mProcManager.BuildRenderGraph();
     }
 
     void Renderer::BeginFrame(const Camera& camera, const glm::mat4& transform)
@@ -65,7 +93,7 @@ namespace Surge
         mData->RenderCmdBuffer->BeginRecording();
 
         LightCullingProcedure::InternalData* lightCullingProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<LightCullingProcedure>();
-        GeometryProcedure::InternalData* geometryProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<GeometryProcedure>();
+        GeometryProcedure* geometryProc = Core::GetRenderer()->GetRenderProcManager()->GetProcedure<GeometryProcedure>();
 
         UBufCameraData camData = {mData->ViewMatrix, mData->ProjectionMatrix, mData->ViewProjection};
         UBufRendererData rendererData = {lightCullingProcData->TileCountX, lightCullingProcData->ShowLightComplexity, 0.0, 0.0};
@@ -77,7 +105,7 @@ namespace Surge
         mData->DescriptorSet0->SetBuffer(mData->RendererDataUniformBuffer, 1);
 
         mData->DescriptorSet0->UpdateForRendering();
-        mData->DescriptorSet0->Bind(mData->RenderCmdBuffer, geometryProcData->GeometryPipeline);
+        mData->DescriptorSet0->Bind(mData->RenderCmdBuffer, geometryProc->GetPipeline());
     }
 
     void Renderer::BeginFrame(const EditorCamera& camera)
@@ -90,7 +118,7 @@ namespace Surge
         mData->RenderCmdBuffer->BeginRecording();
 
         LightCullingProcedure::InternalData* lightCullingProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<LightCullingProcedure>();
-        GeometryProcedure::InternalData* geometryProcData = Core::GetRenderer()->GetRenderProcManager()->GetRenderProcData<GeometryProcedure>();
+        GeometryProcedure* geometryProc = Core::GetRenderer()->GetRenderProcManager()->GetProcedure<GeometryProcedure>();
 
         UBufCameraData camData = {mData->ViewMatrix, mData->ProjectionMatrix, mData->ViewProjection};
         UBufRendererData rendererData = {lightCullingProcData->TileCountX, lightCullingProcData->ShowLightComplexity, 0.0, 0.0};
@@ -102,21 +130,126 @@ namespace Surge
         mData->DescriptorSet0->SetBuffer(mData->RendererDataUniformBuffer, 1);
 
         mData->DescriptorSet0->UpdateForRendering();
-        mData->DescriptorSet0->Bind(mData->RenderCmdBuffer, geometryProcData->GeometryPipeline);
+        mData->DescriptorSet0->Bind(mData->RenderCmdBuffer, geometryProc->GetPipeline());
     }
 
     void Renderer::EndFrame()
     {
         SURGE_PROFILE_FUNC("Renderer::EndFrame()");
 
+        BuildDrawBatches();
+        if (mData->GPUDrivenRendering)
+        {
+            // The shadow cascades are culled by the ShadowMapProcedure, once it has calculated them
+            mData->GPUScene.Update();
+            mData->GPUScene.Cull(GPU_SCENE_CAMERA_VIEW, mData->ViewProjection);
+        }
+        else
+        {
+            mData->CPUCuller.Update();
+            mData->CPUCuller.Cull(GPU_SCENE_CAMERA_VIEW, mData->ViewProjection);
+        }
+        mData->DescriptorSet0->SetBuffer(mData->GetDrawInstanceBuffer(), INSTANCE_BUFFER_BINDING);
+        mData->DescriptorSet0->UpdateForRendering();
+
         mProcManager.UpdateAll();
+        mData->CommandRecorder.EndFrame();
+        if (!mData->GPUDrivenRendering)
+            mData->CPUCuller.Upload(); // All the views are culled now
         mData->RenderCmdBuffer->EndRecording();
 
         mData->RenderCmdBuffer->Submit();
         mData->DrawList.clear();
+        mData->DrawBatches.clear();
         mData->PointLights.clear();
     }
 
+    void Renderer::BuildDrawBatches()
+    {
+        SURGE_PROFILE_FUNC("Renderer::BuildDrawBatches()");
+        const Vector<DrawCommand>& drawList = mData->DrawList;
+
+        // One item per submesh of every DrawCommand
+        mBatchItems.clear();
+        for (Uint i = 0; i < drawList.size(); i++)
+        {
+            Mesh* mesh = drawList[i].Mesh;
+            const Vector<Submesh>& submeshes = mesh->GetSubmeshes();
+            Vector<Ref<Material>>& materials = mesh->GetMaterials();
+            const Vector<Ref<Material>>* entityMaterials = drawList[i].Materials;
+            for (Uint j = 0; j < submeshes.size(); j++)
+            {
+                // An entity with its own copy of the material gets batches of its own
+                const Uint materialIndex = submeshes[j].MaterialIndex;
+                Material* material = materials[materialIndex].Raw();
+                if (entityMaterials && materialIndex < entityMaterials->size() && (*entityMaterials)[materialIndex])
+                    material = (*entityMaterials)[materialIndex].Raw();
+                mBatchItems.push_back({material, mesh, j, i});
+            }
+        }
+
+        std::sort(mBatchItems.begin(), mBatchItems.end(), [](const BatchItem& a, const BatchItem& b) {
+            if (a.Material != b.Material)
+                return a.Material < b.Material;
+            if (a.Mesh != b.Mesh)
+                return a.Mesh < b.Mesh;
+            if (a.SubmeshIndex != b.SubmeshIndex)
+                return a.SubmeshIndex < b.SubmeshIndex;
+            return a.DrawIndex < b.DrawIndex; // Keeps the instance order stable from frame to frame
+        });
+
+        // The buffer is only reallocated when it grows, InstanceTransforms always matches its size since SetData copies all of it
+        const Uint instanceCount = static_cast<Uint>(mBatchItems.size());
+        mData->ChangedInstanceBounds.Reset();
+        if (instanceCount > mData->InstanceTransforms.size())
+        {
+            size_t newCapacity = mData->InstanceTransforms.size();
+            while (newCapacity < instanceCount)
+                newCapacity *= 2;
+
+            mData->InstanceTransforms.resize(newCapacity);
+            mData->InstanceBuffer->Resize(static_cast<Uint>(newCapacity * sizeof(glm::mat4)));
+        }
+
+        // Equal submeshes are next to each other now, each run of them becomes one instanced draw
+        mData->DrawBatches.clear();
+        for (Uint i = 0; i < instanceCount; i++)
+        {
+            const BatchItem& item = mBatchItems[i];
+            const Submesh& submesh = item.Mesh->GetSubmeshes()[item.SubmeshIndex];
+            const glm::mat4 transform = drawList[item.DrawIndex].Transform * submesh.Transform;
+
+            // Only meaningful if the instance is the same as last frame, which is checked once the batches are built
+            glm::mat4& lastTransform = mData->InstanceTransforms[i];
+            if (lastTransform != transform)
+            {
+                ExpandBounds(mData->ChangedInstanceBounds, submesh.BoundingBox, lastTransform);
+                ExpandBounds(mData->ChangedInstanceBounds, submesh.BoundingBox, transform);
+                lastTransform = transform;
+            }
+
+            if (!mData->DrawBatches.empty())
+            {
+                DrawBatch& last = mData->DrawBatches.back();
+                if (last.Mesh == item.Mesh && last.SubmeshIndex == item.SubmeshIndex && last.Material == item.Material)
+                {
+                    last.InstanceCount++;
+                    continue;
+                }
+            }
+            mData->DrawBatches.push_back({item.Mesh, item.SubmeshIndex, item.Material, i, 1});
+        }
+
+        const Vector<DrawBatch>& batches = mData->DrawBatches;
+        mData->InstancesRebatched = batches.size() != mLastDrawBatches.size() ||
+                                    !std::equal(batches.begin(), batches.end(), mLastDrawBatches.begin(), [](const DrawBatch& a, const DrawBatch& b) {
+                                        return a.Mesh == b.Mesh && a.SubmeshIndex == b.SubmeshIndex && a.FirstInstance == b.FirstInstance && a.InstanceCount == b.InstanceCount;
+                                    });
+        mLastDrawBatches = batches;
+
+        mData->InstanceBuffer->SetData(mData->InstanceTransforms.data());
+    }
+
     void Renderer::SetRenderArea(Uint width, Uint height)
     {
         if (width || height)
@@ -139,6 +272,12 @@ namespace Surge
     {
         SURGE_PROFILE_FUNC("Renderer::Shutdown()");
         mProcManager.Shutdown();
+        mData->CommandRecorder.Shutdown();
+        mData->GPUScene.Shutdown();
+        mData->CPUCuller.Shutdown();
+        mData->PlaceholderMesh.Reset(); // Its materials are in the MaterialTable
+        mData->MaterialTable.Shutdown();
+        mData->PipelineLibrary.Clear();
         mData->ShaderSet.Shutdown();
     }
 
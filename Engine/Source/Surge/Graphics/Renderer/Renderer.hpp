@@ -3,6 +3,11 @@
 #include "Surge/Core/Memory.hpp"
 #include "Surge/Graphics/Camera/EditorCamera.hpp"
 #include "Surge/Graphics/Mesh.hpp"
+#include "Surge/Graphics/PipelineLibrary.hpp"
+#include "Surge/Graphics/Renderer/GPUScene.hpp"
+#include "Surge/Graphics/Renderer/CPUCuller.hpp"
+#include "Surge/Graphics/Renderer/MaterialTable.hpp"
+#include "Surge/Graphics/Renderer/ParallelCommandRecorder.hpp"
 #include "Surge/Graphics/Interface/RenderCommandBuffer.hpp"
 #include "Surge/Graphics/Shader/Shader.hpp"
 #include "Surge/Graphics/Shader/ShaderSet.hpp"
@@ -13,30 +18,62 @@
 #include "Surge/ECS/Components.hpp"
 
 #define FRAMES_IN_FLIGHT 3
-#define BASE_SHADER_PATH "Engine/Assets/Shaders" //Sadkek, we don't have an asset manager yet
+#define INSTANCE_BUFFER_BINDING 5 // Binding of RendererData::InstanceBuffer in set 0 of the mesh shaders
+#define BASE_SHADER_PATH "Engine/Assets/Shaders" // Shaders are owned by the ShaderSet, the AssetManager only deals with meshes and textures
 
 namespace Surge
 {
     struct DrawCommand
     {
-        DrawCommand(MeshComponent* meshComp, const glm::mat4& transform) : MeshComp(meshComp), Transform(transform) {}
+        DrawCommand(Surge::Mesh* mesh, const glm::mat4& transform, const Vector<Ref<Material>>* materials = nullptr)
+            : Mesh(mesh), Transform(transform), Materials(materials) {}
 
-        MeshComponent* MeshComp;
+        Surge::Mesh* Mesh; // Always ready to be drawn, it is the placeholder if the submitted Mesh is still loading
         glm::mat4 Transform;
+        const Vector<Ref<Material>>* Materials; // MeshComponent::Materials, null entries (or no vector) use the materials of the Mesh
+    };
+
+    // Instanced draw of one submesh, built from the DrawList every frame
+    struct DrawBatch
+    {
+        Surge::Mesh* Mesh;
+        Uint SubmeshIndex;
+        Surge::Material* Material;
+        Uint FirstInstance; // Index of the first transform in RendererData::InstanceBuffer
+        Uint InstanceCount;
     };
 
     class SURGE_API Scene;
     struct RendererData
     {
         Ref<RenderCommandBuffer> RenderCmdBuffer;
+        ParallelCommandRecorder CommandRecorder;
+        bool ParallelRecording = true; // If false, the CommandRecorder records every render pass straight into RenderCmdBuffer
         Vector<DrawCommand> DrawList;
+
+        // Sorted by material, mesh and submesh, so consecutive batches share as many binds as possible
+        Vector<DrawBatch> DrawBatches;
+        Vector<glm::mat4> InstanceTransforms; // Always as big as the InstanceBuffer
+        Ref<StorageBuffer> InstanceBuffer;    // Transforms of every DrawBatch, before culling
+
+        // What changed in the DrawBatches since last frame, found by BuildDrawBatches while it writes the InstanceTransforms.
+        // If the batches are the same, ChangedInstanceBounds covers (in world space) where the instances that moved were and are now.
+        // Otherwise instances were added, removed or regrouped, and everything counts as changed
+        bool InstancesRebatched = true;
+        AABB ChangedInstanceBounds;
+        Surge::GPUScene GPUScene;
+        Surge::CPUCuller CPUCuller;
+        Surge::MaterialTable MaterialTable;
+        bool GPUDrivenRendering = true; // If false, the DrawBatches are culled by the CPUCuller and the mesh passes record its visible batches
         Surge::ShaderSet ShaderSet;
+        Surge::PipelineLibrary PipelineLibrary;
 
         Ref<UniformBuffer> CameraUniformBuffer;
         Ref<UniformBuffer> RendererDataUniformBuffer;
         Ref<DescriptorSet> DescriptorSet0;
 
         Ref<Texture2D> WhiteTexture;
+        Ref<Mesh> PlaceholderMesh; // Drawn in place of meshes that are still loading
         Scene* SceneContext;
 
         // Lights
@@ -50,6 +87,9 @@ namespace Surge
         glm::mat4 ViewMatrix;
         glm::mat4 ProjectionMatrix;
         glm::mat4 ViewProjection;
+
+        // The buffer the mesh passes read the instance transforms from, at INSTANCE_BUFFER_BINDING
+        const Ref<StorageBuffer>& GetDrawInstanceBuffer() const { return GPUDrivenRendering ? GPUScene.GetCulledInstanceBuffer() : CPUCuller.GetCulledInstanceBuffer(); }
     };
 
     class SURGE_API Renderer
@@ -66,7 +106,16 @@ namespace Surge
         void EndFrame();
         void SetRenderArea(Uint width, Uint height);
 
-        FORCEINLINE void SubmitMesh(MeshComponent& meshComp, const glm::mat4& transform) { mData->DrawList.push_back(DrawCommand(&meshComp, transform)); }
+        FORCEINLINE void SubmitMesh(MeshComponent& meshComp, const glm::mat4& transform)
+        {
+            switch (meshComp.Mesh->GetState())
+            {
+                case MeshState::Ready: mData->DrawList.push_back(DrawCommand(meshComp.Mesh.Raw(), transform, meshComp.Materials.empty() ? nullptr : &meshComp.Materials)); break;
+                case MeshState::Loading:
+                case MeshState::Imported: mData->DrawList.push_back(DrawCommand(mData->PlaceholderMesh.Raw(), transform)); break;
+                case MeshState::Failed: break;
+            }
+        }
         FORCEINLINE void SubmitPointLight(const PointLightComponent& pointLight, const glm::vec3& position)
         {
             PointLight light;
@@ -94,7 +143,20 @@ namespace Surge
         void SetSceneContext(Ref<Scene>& scene) { mData->SceneContext = scene.Raw(); }
 
     private:
+        void BuildDrawBatches();
+
+    private:
+        struct BatchItem
+        {
+            Surge::Material* Material;
+            Surge::Mesh* Mesh;
+            Uint SubmeshIndex;
+            Uint DrawIndex; // Into RendererData::DrawList
+        };
+
         RenderProcedureManager mProcManager;
         Scope<RendererData> mData;
+        Vector<BatchItem> mBatchItems; // Scratch space for BuildDrawBatches, kept around so it isn't reallocated every frame
+        Vector<DrawBatch> mLastDrawBatches; // Of the previous frame, to find out if the instances were regrouped
     };
 } // namespace Surge
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "Surge/Graphics/Shader/Shader.hpp"
 #include <map>
 
+// Number of descriptors of the runtime arrays ("uniform sampler2D uTextures[]"), they are partially bound so only the used ones are written
+#define RUNTIME_DESCRIPTOR_ARRAY_SIZE 4096
+
 namespace Surge
 {
     enum class SURGE_API ShaderType;
@@ -22,6 +25,7 @@ namespace Surge
         String Name;
         ShaderResource::Usage ShaderUsage;
         ShaderType ShaderStages {}; // Specify what shader stages the resource is being used for
+        Uint Count = 1;             // Number of descriptors in the binding, 0 for a runtime array
     };
 
     struct ShaderStageInput
@@ -58,6 +62,11 @@ namespace Surge
         ShaderBuffer::Usage ShaderUsage;
         ShaderType ShaderStages {}; // Specify what shader stages the buffer is being used for
 
+        // Storage buffers that end with a runtime array of structs, like "buffer Materials { Material Data[]; }": the members of one
+        // element, named after the type of the struct ("Material.Albedo"), and the size of one element
+        Vector<ShaderBufferMember> ElementMembers = {};
+        Uint ElementSize = 0;
+
         const ShaderBufferMember* GetMember(const String& name)
         {
             for (const ShaderBufferMember& member : Members)
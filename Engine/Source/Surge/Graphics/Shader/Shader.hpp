@@ -101,7 +101,8 @@ namespace Surge
         Shader() = default;
         virtual ~Shader() = default;
 
-        virtual void Load(const HashMap<ShaderType, bool>& compileStages = {}) = 0;
+        // If 'parallel' is false the stages are compiled one after the other on the calling thread
+        virtual void Load(const HashMap<ShaderType, bool>& compileStages = {}, bool parallel = true) = 0;
         virtual void Reload() = 0;
         NODISCARD virtual UUID AddReloadCallback(const std::function<void()> callback) = 0;
         virtual void RemoveReloadCallback(const UUID& id) = 0;
@@ -1,5 +1,6 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "ShaderReflector.hpp"
+#include "Surge/Core/Core.hpp"
 #include <SPIRV-Cross/spirv_glsl.hpp>
 
 namespace Surge
@@ -35,138 +36,184 @@ namespace Surge
             return ShaderDataType::None;
         }
 
+        // Arrays of descriptors have one dimension, runtime arrays ("uniform sampler2D uTextures[]") have a size of 0
+        Uint GetDescriptorCount(const spirv_cross::SPIRType& spvType)
+        {
+            if (spvType.array.empty())
+                return 1;
+
+            SG_ASSERT(spvType.array.size() == 1 && spvType.array_size_literal[0], "Only one dimensional arrays of descriptors with a literal size are supported!");
+            return spvType.array[0];
+        }
+
     }; // namespace Utils
 
     ShaderReflectionData ShaderReflector::Reflect(const Vector<SPIRVHandle>& spirvHandles)
     {
+        // Every stage is reflected on its own worker, into its own ShaderReflectionData. They are merged afterwards
+        // in the order of 'spirvHandles', so the result doesn't depend on which stage finished first
+        Vector<ShaderReflectionData> stageResults(spirvHandles.size());
+        Core::GetThreadPool()->ParallelFor<size_t>(0, spirvHandles.size(), [&](size_t i) { ReflectStage(spirvHandles[i], stageResults[i]); });
+
         ShaderReflectionData result;
-        for (auto& handle : spirvHandles)
+        for (ShaderReflectionData& stageResult : stageResults)
         {
-            spirv_cross::Compiler compiler(handle.SPIRV);
-            spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+            result.mShaderResources.insert(result.mShaderResources.end(), stageResult.mShaderResources.begin(), stageResult.mShaderResources.end());
+            result.mShaderBuffers.insert(result.mShaderBuffers.end(), stageResult.mShaderBuffers.begin(), stageResult.mShaderBuffers.end());
+            result.mPushConstants.insert(result.mPushConstants.end(), stageResult.mPushConstants.begin(), stageResult.mPushConstants.end());
+            for (auto& [stage, stageInputs] : stageResult.mStageInputs)
+                result.mStageInputs[stage] = std::move(stageInputs);
+        }
 
-            // Fetch the sampled textures
-            for (const spirv_cross::Resource& resource : resources.sampled_images)
-            {
-                ShaderResource res;
-                res.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-                res.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
-                res.Name = resource.name;
-                res.ShaderStages |= handle.Type;
-                res.ShaderUsage = ShaderResource::Usage::Sampled;
-                result.PushResource(res);
-            }
+        result.ClearRepeatedMembers();
+        result.CalculateDescriptorSetCount();
+        return result;
+    }
 
-            // Fetch the storage textures
-            for (const spirv_cross::Resource& resource : resources.storage_images)
+    void ShaderReflector::ReflectStage(const SPIRVHandle& handle, ShaderReflectionData& result)
+    {
+        spirv_cross::Compiler compiler(handle.SPIRV);
+        spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+
+        // Fetch the sampled textures
+        for (const spirv_cross::Resource& resource : resources.sampled_images)
+        {
+            ShaderResource res;
+            res.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            res.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            res.Name = resource.name;
+            res.ShaderStages |= handle.Type;
+            res.ShaderUsage = ShaderResource::Usage::Sampled;
+            res.Count = Utils::GetDescriptorCount(compiler.get_type(resource.type_id));
+            result.PushResource(res);
+        }
+
+        // Fetch the storage textures
+        for (const spirv_cross::Resource& resource : resources.storage_images)
+        {
+            ShaderResource res;
+            res.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            res.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            res.Name = resource.name;
+            res.ShaderStages |= handle.Type;
+            res.ShaderUsage = ShaderResource::Usage::Storage;
+            res.Count = Utils::GetDescriptorCount(compiler.get_type(resource.type_id));
+            result.PushResource(res);
+        }
+
+        // Fetch all the Uniform/Constant buffers
+        for (const spirv_cross::Resource& resource : resources.uniform_buffers)
+        {
+            ShaderBuffer buffer;
+            const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
+
+            buffer.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
+            buffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            buffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            buffer.BufferName = resource.name;
+            buffer.ShaderStages |= handle.Type;
+            buffer.ShaderUsage = ShaderBuffer::Usage::Uniform;
+
+            for (Uint i = 0; i < bufferType.member_types.size(); i++)
             {
-                ShaderResource res;
-                res.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-                res.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
-                res.Name = resource.name;
-                res.ShaderStages |= handle.Type;
-                res.ShaderUsage = ShaderResource::Usage::Storage;
-                result.PushResource(res);
+                const spirv_cross::SPIRType& spvType = compiler.get_type(bufferType.member_types[i]);
+
+                ShaderBufferMember bufferMember;
+                bufferMember.Name = buffer.BufferName + '.' + compiler.get_member_name(bufferType.self, i);
+                bufferMember.MemoryOffset = compiler.type_struct_member_offset(bufferType, i); // In bytes
+                bufferMember.DataType = Utils::SPVTypeToShaderDataType(spvType);
+                bufferMember.Size = ShaderDataTypeSize(bufferMember.DataType);
+                buffer.Members.emplace_back(bufferMember);
             }
+            result.PushBuffer(buffer);
+        }
 
-            // Fetch all the Uniform/Constant buffers
-            for (const spirv_cross::Resource& resource : resources.uniform_buffers)
-            {
-                ShaderBuffer buffer;
-                const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
+        // Fetch all the Storage buffers
+        for (const spirv_cross::Resource& resource : resources.storage_buffers)
+        {
+            ShaderBuffer buffer;
+            const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
 
-                buffer.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
-                buffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
-                buffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-                buffer.BufferName = resource.name;
-                buffer.ShaderStages |= handle.Type;
-                buffer.ShaderUsage = ShaderBuffer::Usage::Uniform;
+            buffer.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
+            buffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            buffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            buffer.BufferName = resource.name;
+            buffer.ShaderStages |= handle.Type;
+            buffer.ShaderUsage = ShaderBuffer::Usage::Storage;
 
-                for (Uint i = 0; i < bufferType.member_types.size(); i++)
-                {
-                    const spirv_cross::SPIRType& spvType = compiler.get_type(bufferType.member_types[i]);
-
-                    ShaderBufferMember bufferMember;
-                    bufferMember.Name = buffer.BufferName + '.' + compiler.get_member_name(bufferType.self, i);
-                    bufferMember.MemoryOffset = compiler.type_struct_member_offset(bufferType, i); // In bytes
-                    bufferMember.DataType = Utils::SPVTypeToShaderDataType(spvType);
-                    bufferMember.Size = ShaderDataTypeSize(bufferMember.DataType);
-                    buffer.Members.emplace_back(bufferMember);
-                }
-                result.PushBuffer(buffer);
+            for (Uint i = 0; i < bufferType.member_types.size(); i++)
+            {
+                const spirv_cross::SPIRType& spvType = compiler.get_type(bufferType.member_types[i]);
+
+                ShaderBufferMember bufferMember;
+                bufferMember.Name = buffer.BufferName + '.' + compiler.get_member_name(bufferType.self, i);
+                bufferMember.MemoryOffset = compiler.type_struct_member_offset(bufferType, i); // In bytes
+                bufferMember.DataType = Utils::SPVTypeToShaderDataType(spvType);
+                bufferMember.Size = ShaderDataTypeSize(bufferMember.DataType);
+                buffer.Members.emplace_back(bufferMember);
             }
 
-            // Fetch all the Storage buffers
-            for (const spirv_cross::Resource& resource : resources.storage_buffers)
+            // A runtime array of structs at the end of the block, its elements are written by the CPU one by one
+            const spirv_cross::SPIRType& lastType = compiler.get_type(bufferType.member_types.back());
+            if (lastType.basetype == spirv_cross::SPIRType::Struct && lastType.array.size() == 1 && lastType.array[0] == 0)
             {
-                ShaderBuffer buffer;
-                const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
-
-                buffer.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
-                buffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
-                buffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-                buffer.BufferName = resource.name;
-                buffer.ShaderStages |= handle.Type;
-                buffer.ShaderUsage = ShaderBuffer::Usage::Storage;
-
-                for (Uint i = 0; i < bufferType.member_types.size(); i++)
+                const spirv_cross::SPIRType& elementType = compiler.get_type(lastType.self);
+                const String elementName = compiler.get_name(elementType.self);
+                buffer.ElementSize = compiler.type_struct_member_array_stride(bufferType, static_cast<Uint>(bufferType.member_types.size() - 1));
+                for (Uint i = 0; i < elementType.member_types.size(); i++)
                 {
-                    const spirv_cross::SPIRType& spvType = compiler.get_type(bufferType.member_types[i]);
-
-                    ShaderBufferMember bufferMember;
-                    bufferMember.Name = buffer.BufferName + '.' + compiler.get_member_name(bufferType.self, i);
-                    bufferMember.MemoryOffset = compiler.type_struct_member_offset(bufferType, i); // In bytes
-                    bufferMember.DataType = Utils::SPVTypeToShaderDataType(spvType);
-                    bufferMember.Size = ShaderDataTypeSize(bufferMember.DataType);
-                    buffer.Members.emplace_back(bufferMember);
+                    const spirv_cross::SPIRType& spvType = compiler.get_type(elementType.member_types[i]);
+
+                    ShaderBufferMember elementMember;
+                    elementMember.Name = elementName + '.' + compiler.get_member_name(elementType.self, i);
+                    elementMember.MemoryOffset = compiler.type_struct_member_offset(elementType, i); // In bytes, from the start of the element
+                    elementMember.DataType = Utils::SPVTypeToShaderDataType(spvType);
+                    elementMember.Size = ShaderDataTypeSize(elementMember.DataType);
+                    buffer.ElementMembers.emplace_back(elementMember);
                 }
-
-                result.PushBuffer(buffer);
             }
 
-            // Fetch the StageInputs
-            for (const spirv_cross::Resource& resource : resources.stage_inputs)
-            {
-                ShaderStageInput stageInput;
+            result.PushBuffer(buffer);
+        }
 
-                const spirv_cross::SPIRType& spvType = compiler.get_type(resource.base_type_id);
-                Uint location = compiler.get_decoration(resource.id, spv::DecorationLocation);
-                stageInput.Name = resource.name;
-                stageInput.DataType = Utils::SPVTypeToShaderDataType(spvType);
-                stageInput.Size = stageInput.DataType == ShaderDataType::Struct ? 0 : ShaderDataTypeSize(stageInput.DataType);
-                stageInput.Offset = 0; // temporary, calculated later
+        // Fetch the StageInputs
+        for (const spirv_cross::Resource& resource : resources.stage_inputs)
+        {
+            ShaderStageInput stageInput;
 
-                result.PushStageInput(stageInput, handle.Type, location);
-            }
+            const spirv_cross::SPIRType& spvType = compiler.get_type(resource.base_type_id);
+            Uint location = compiler.get_decoration(resource.id, spv::DecorationLocation);
+            stageInput.Name = resource.name;
+            stageInput.DataType = Utils::SPVTypeToShaderDataType(spvType);
+            stageInput.Size = stageInput.DataType == ShaderDataType::Struct ? 0 : ShaderDataTypeSize(stageInput.DataType);
+            stageInput.Offset = 0; // temporary, calculated later
+
+            result.PushStageInput(stageInput, handle.Type, location);
+        }
 
-            // Calculating the offsets after the locations are sorted
+        // Calculating the offsets after the locations are sorted
 
-            Uint elementOffset = 0;
-            auto itr = result.mStageInputs.find(handle.Type);
-            if (itr != result.mStageInputs.end())
+        Uint elementOffset = 0;
+        auto itr = result.mStageInputs.find(handle.Type);
+        if (itr != result.mStageInputs.end())
+        {
+            for (auto& [location, stageInput] : result.mStageInputs.at(handle.Type))
             {
-                for (auto& [location, stageInput] : result.mStageInputs.at(handle.Type))
-                {
-                    stageInput.Offset = elementOffset;
-                    elementOffset += stageInput.Size;
-                }
+                stageInput.Offset = elementOffset;
+                elementOffset += stageInput.Size;
             }
+        }
 
-            // Fetch Push Constants
-            for (const spirv_cross::Resource& resource : resources.push_constant_buffers)
-            {
-                ShaderPushConstant pushConstant;
-                const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
+        // Fetch Push Constants
+        for (const spirv_cross::Resource& resource : resources.push_constant_buffers)
+        {
+            ShaderPushConstant pushConstant;
+            const spirv_cross::SPIRType& bufferType = compiler.get_type(resource.base_type_id);
 
-                pushConstant.BufferName = resource.name;
-                pushConstant.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
-                pushConstant.ShaderStages |= handle.Type;
-                result.PushBufferPushConstant(pushConstant);
-            }
+            pushConstant.BufferName = resource.name;
+            pushConstant.Size = static_cast<Uint>(compiler.get_declared_struct_size(bufferType));
+            pushConstant.ShaderStages |= handle.Type;
+            result.PushBufferPushConstant(pushConstant);
         }
-
-        result.ClearRepeatedMembers();
-        result.CalculateDescriptorSetCount();
-        return result;
     }
 } // namespace Surge
\ No newline at end of file
@@ -9,5 +9,8 @@ namespace Surge
     public:
         ShaderReflector() = default;
         ShaderReflectionData Reflect(const Vector<SPIRVHandle>& spirvHandles);
+
+    private:
+        static void ReflectStage(const SPIRVHandle& handle, ShaderReflectionData& result);
     };
 } // namespace Surge
@@ -1,11 +1,37 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Graphics/Shader/ShaderSet.hpp"
+#include "Surge/Core/Core.hpp"
+#include "Surge/Core/Hash.hpp"
 #include "Surge/Utility/Filesystem.hpp"
 #include <filesystem>
-#include <json/json.hpp>
+
+// "SGSI", little endian
+#define SHADER_CACHE_INDEX_MAGIC 0x49534753
+
+// Must be bumped whenever the layout of the index changes
+#define SHADER_CACHE_INDEX_VERSION 1
 
 namespace Surge
 {
+    namespace
+    {
+        // File layout: [IndexHeader][IndexRecord * EntryCount]
+        struct IndexHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t EntryCount;
+        };
+
+        struct IndexRecord
+        {
+            uint64_t NameKey;
+            HashCode SourceHash;
+        };
+
+        uint64_t GetIndexKey(const String& cacheName) { return Hash::GenerateFromBytes(cacheName.data(), cacheName.size()); }
+    } // namespace
+
     void ShaderSet::Initialize(const String& baseShaderPath)
     {
         mBaseShaderPath = baseShaderPath;
@@ -28,62 +54,173 @@ namespace Surge
         return mDummyShader;
     }
 
-    void ShaderSet::LoadAll()
+    void ShaderSet::LoadAll(bool parallel)
     {
         SCOPED_TIMER("ShaderSet::LoadAll");
-        for (Ref<Shader>& shader : mShaders)
+        LoadCacheIndex();
+
+        // Find which shader source needs to be reloaded
+        Vector<HashMap<ShaderType, bool>> compileStages(mShaders.size());
+        bool indexChanged = false;
+        for (size_t i = 0; i < mShaders.size(); i++)
         {
-            bool saveHash = false;
+            const Ref<Shader>& shader = mShaders[i];
+            for (auto& [stage, source] : shader->GetSources())
+            {
+                auto itr = mCacheIndex.find(GetIndexKey(GetCacheName(shader->GetPath(), stage)));
+
+                // Recompile if:
+                //-> Doesn't exist in cache |or| the hash codes are different
+                const bool upToDate = itr != mCacheIndex.end() && itr->second == shader->GetHash(stage) && Filesystem::Exists(GetCachePath(shader->GetPath(), stage));
+                compileStages[i][stage] = !upToDate;
+                indexChanged |= !upToDate;
+            }
+        }
 
-            const HashMap<ShaderType, String>& sources = shader->GetSources();
-            HashMap<ShaderType, bool> compileStages;
+        // Load only required shader stages
+        LoadShaders(mShaders, compileStages, parallel);
 
-            // Find which shader source needs to be reloaded
-            for (auto& source : sources)
+        // The SPIR-V cache and the index are shared by all the shaders, so they are written from this thread only
+        for (size_t i = 0; i < mShaders.size(); i++)
+        {
+            CacheRequiredSPIRVs(mShaders[i], compileStages[i]);
+            for (auto& [stage, compiled] : compileStages[i])
             {
-                const HashCode& currentHashCode = shader->GetHash(source.first);
-                const HashCode cacheHashCode = GetHashCodeFromCache(shader, source.first);
+                if (compiled)
+                    mCacheIndex[GetIndexKey(GetCacheName(mShaders[i]->GetPath(), stage))] = mShaders[i]->GetHash(stage);
+            }
+        }
 
-                const String cachePath = GetCachePath(shader->GetPath(), source.first);
-                const bool existsInCache = Filesystem::Exists(cachePath);
+        if (indexChanged)
+            WriteCacheIndex();
+    }
 
-                // Recompile if:
-                //-> Doesn't exist in cache |or| the hash codes are different
-                if (!existsInCache || (existsInCache && cacheHashCode != currentHashCode))
-                {
-                    compileStages[source.first] = true;
-                    saveHash = true;
-                }
-                else
-                    compileStages[source.first] = false;
+    ShaderBenchmarkResult ShaderSet::RunBenchmark()
+    {
+        SURGE_PROFILE_FUNC("ShaderSet::RunBenchmark");
+
+        // Every stage of every shader compiled, or none of them
+        auto getCompileStages = [this](bool compile) {
+            Vector<HashMap<ShaderType, bool>> compileStages(mShaders.size());
+            for (size_t i = 0; i < mShaders.size(); i++)
+            {
+                for (auto& [stage, source] : mShaders[i]->GetSources())
+                    compileStages[i][stage] = compile;
             }
+            return compileStages;
+        };
+        const Vector<HashMap<ShaderType, bool>> coldStages = getCompileStages(true);
+        const Vector<HashMap<ShaderType, bool>> warmStages = getCompileStages(false);
 
-            // Load only required shader stages
-            shader->Load(compileStages);
+        // New shaders for every run, the ones in the set are in use by the pipelines
+        auto run = [this](const Vector<HashMap<ShaderType, bool>>& compileStages, bool parallel) {
+            Vector<Ref<Shader>> shaders;
+            shaders.reserve(mShaders.size());
+            for (const Ref<Shader>& shader : mShaders)
+                shaders.push_back(Shader::Create(shader->GetPath()));
 
-            CacheRequiredSPIRVs(shader, compileStages);
+            Timer timer;
+            LoadShaders(shaders, compileStages, parallel);
+            const float millis = timer.ElapsedMillis();
 
-            if (saveHash)
-                WriteHashToFile(shader);
-        }
+            // The warm runs read the SPIR-V written here, it is the same as the one in the cache as long as the sources didn't change
+            for (size_t i = 0; i < shaders.size(); i++)
+                CacheRequiredSPIRVs(shaders[i], compileStages[i]);
+            return millis;
+        };
+
+        ShaderBenchmarkResult result = {};
+        result.ShaderCount = static_cast<Uint>(mShaders.size());
+        result.SerialColdMillis = run(coldStages, false);
+        result.SerialWarmMillis = run(warmStages, false);
+        result.ParallelColdMillis = run(coldStages, true);
+        result.ParallelWarmMillis = run(warmStages, true);
+
+        Log<Severity::Info>("Loaded {0} shaders, serial: {1} ms cold, {2} ms warm. Parallel: {3} ms cold, {4} ms warm",
+                            result.ShaderCount, result.SerialColdMillis, result.SerialWarmMillis, result.ParallelColdMillis, result.ParallelWarmMillis);
+        return result;
     }
 
     void ShaderSet::Shutdown()
     {
         mShaders.clear();
+        mCacheIndex.clear();
     }
 
-    HashCode ShaderSet::GetHashCodeFromCache(const Ref<Shader>& shader, ShaderType type)
+    void ShaderSet::LoadCacheIndex()
     {
-        String previousContents = Filesystem::ReadFile<String>(SHADER_HASH_CACHE_PATH);
-        String name = GetCacheName(shader->GetPath(), type);
+        mCacheIndex.clear();
+        if (!Filesystem::Exists(SHADER_CACHE_INDEX_PATH))
+            return;
 
-        nlohmann::json j = previousContents.empty() ? nlohmann::json() : nlohmann::json::parse(previousContents);
+        Filesystem::MappedFile file(SHADER_CACHE_INDEX_PATH);
+        if (!file.IsValid() || file.GetSize() < sizeof(IndexHeader))
+            return;
 
-        HashCode result = 0;
-        if (j.contains(name))
-            result = j[name];
-        return result;
+        IndexHeader header;
+        std::memcpy(&header, file.GetData(), sizeof(IndexHeader));
+        if (header.Magic != SHADER_CACHE_INDEX_MAGIC || header.Version != SHADER_CACHE_INDEX_VERSION ||
+            header.EntryCount > (file.GetSize() - sizeof(IndexHeader)) / sizeof(IndexRecord))
+        {
+            Log<Severity::Warn>("Shader cache index({0}) is outdated or corrupted, recompiling all the shaders", SHADER_CACHE_INDEX_PATH);
+            return;
+        }
+
+        mCacheIndex.reserve(header.EntryCount);
+        const Byte* records = file.GetData() + sizeof(IndexHeader);
+        for (uint64_t i = 0; i < header.EntryCount; i++)
+        {
+            IndexRecord record;
+            std::memcpy(&record, records + i * sizeof(IndexRecord), sizeof(IndexRecord));
+            mCacheIndex[record.NameKey] = record.SourceHash;
+        }
+    }
+
+    void ShaderSet::WriteCacheIndex() const
+    {
+        IndexHeader header = {SHADER_CACHE_INDEX_MAGIC, SHADER_CACHE_INDEX_VERSION, mCacheIndex.size()};
+        Vector<Byte> data(sizeof(IndexHeader) + mCacheIndex.size() * sizeof(IndexRecord));
+        std::memcpy(data.data(), &header, sizeof(IndexHeader));
+
+        size_t offset = sizeof(IndexHeader);
+        for (auto& [nameKey, sourceHash] : mCacheIndex)
+        {
+            const IndexRecord record = {nameKey, sourceHash};
+            std::memcpy(data.data() + offset, &record, sizeof(IndexRecord));
+            offset += sizeof(IndexRecord);
+        }
+
+        // Written under a temporary name and renamed, so a crash halfway through never leaves a broken index behind
+        const String tempPath = fmt::format("{0}.tmp", SHADER_CACHE_INDEX_PATH);
+        FILE* f = nullptr;
+        fopen_s(&f, tempPath.c_str(), "wb");
+        if (!f)
+        {
+            Log<Severity::Error>("Cannot open path({0}) for writing the shader cache index!", tempPath);
+            return;
+        }
+        fwrite(data.data(), sizeof(Byte), data.size(), f);
+        fclose(f);
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, SHADER_CACHE_INDEX_PATH, error);
+        if (error)
+        {
+            Log<Severity::Error>("Cannot write the shader cache index({0})! {1}", SHADER_CACHE_INDEX_PATH, error.message());
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+
+    void ShaderSet::LoadShaders(const Vector<Ref<Shader>>& shaders, const Vector<HashMap<ShaderType, bool>>& compileStages, bool parallel)
+    {
+        // All the shaders (and their stages) are compiled in parallel, unless 'parallel' is false: a grain size covering every
+        // shader makes a single chunk, which the ParallelFor runs on the calling thread.
+        // The Refs are only touched here, the workers get the raw pointers
+        const size_t grainSize = parallel ? 0 : shaders.size();
+        Core::GetThreadPool()->ParallelFor<size_t>(0, shaders.size(), [&](size_t i) {
+            Shader* shader = shaders[i].Raw();
+            shader->Load(compileStages[i], parallel);
+        }, grainSize);
     }
 
     void ShaderSet::CacheRequiredSPIRVs(const Ref<Shader>& shader, const HashMap<ShaderType, bool>& stagesToCache)
@@ -116,36 +253,6 @@ namespace Surge
         }
     }
 
-    void ShaderSet::WriteHashToFile(const Ref<Shader>& shader)
-    {
-        FILE* f = nullptr;
-
-        // Create the file if it doesn't exist
-        if (!Filesystem::Exists(SHADER_HASH_CACHE_PATH))
-            Filesystem::CreateOrEnsureFile(SHADER_HASH_CACHE_PATH);
-
-        // Load in the contents of the file, because we append to it later
-        String previousContents = Filesystem::ReadFile<String>(SHADER_HASH_CACHE_PATH);
-
-        // Create A JSON, from the previous file for writing the new contents
-        nlohmann::json j = previousContents.empty() ? nlohmann::json() : nlohmann::json::parse(previousContents);
-
-        // For each HashCodes, update it
-        for (auto& element : shader->GetHashCodes())
-        {
-            String name = GetCacheName(shader->GetPath(), element.first);
-            j[name] = element.second;
-        }
-
-        String result = j.dump(4);
-        fopen_s(&f, SHADER_HASH_CACHE_PATH, "w");
-        if (f)
-        {
-            fwrite(result.c_str(), sizeof(char), result.size(), f);
-            fclose(f);
-        }
-    }
-
     String ShaderSet::GetCachePath(const Path& shaderPath, const ShaderType& type) const
     {
         String path = fmt::format("{0}/{1}", SHADER_CACHE_PATH, GetCacheName(shaderPath, type));
@@ -5,10 +5,19 @@
 // TODO: Temporary, we don't have an asset manager yet
 #define TEMP_ASSET_PATH "Engine/Assets/Temp"
 #define SHADER_CACHE_PATH "Engine/Assets/Temp/ShaderCache"
-#define SHADER_HASH_CACHE_PATH "Engine/Assets/Temp/ShaderCache/ShaderHash.txt"
+#define SHADER_CACHE_INDEX_PATH "Engine/Assets/Temp/ShaderCache/ShaderCache.index"
 
 namespace Surge
 {
+    struct ShaderBenchmarkResult
+    {
+        Uint ShaderCount;
+        float SerialColdMillis; // Cold: every stage is compiled, warm: every stage is read from the SPIR-V cache
+        float SerialWarmMillis;
+        float ParallelColdMillis;
+        float ParallelWarmMillis;
+    };
+
     class SURGE_API ShaderSet
     {
     public:
@@ -17,16 +26,23 @@ namespace Surge
 
         void Initialize(const String& baseShaderPath);
         void AddShader(const String& shaderName);
-        void LoadAll();
+        // If 'parallel' is false the shaders and their stages are loaded one after the other on the calling thread
+        void LoadAll(bool parallel = true);
         void Shutdown();
 
+        // Loads new copies of all the shaders in the set cold and warm, serially and in parallel. Main thread only
+        ShaderBenchmarkResult RunBenchmark();
+
         Ref<Shader>& GetShader(const String& shaderName); // Name without extension
         Vector<Ref<Shader>>& GetAllShaders() { return mShaders; }
 
     private:
-        HashCode GetHashCodeFromCache(const Ref<Shader>& shader, ShaderType type);
+        // The cache index maps every cached SPIR-V file to the hash of the source it was compiled from,
+        // it is read once at the start of LoadAll() and written back (if needed) at the end
+        void LoadCacheIndex();
+        void WriteCacheIndex() const;
+        void LoadShaders(const Vector<Ref<Shader>>& shaders, const Vector<HashMap<ShaderType, bool>>& compileStages, bool parallel);
         void CacheRequiredSPIRVs(const Ref<Shader>& shader, const HashMap<ShaderType, bool>& stagesToCache);
-        void WriteHashToFile(const Ref<Shader>& shader);
         String GetCachePath(const Path& shaderPath, const ShaderType& type) const;
         String GetCacheName(const Path& shaderPath, const ShaderType& type) const;
 
@@ -34,6 +50,7 @@ namespace Surge
         String mBaseShaderPath;
         Vector<Ref<Shader>> mShaders;
         Ref<Shader> mDummyShader = nullptr;
+        HashMap<uint64_t, HashCode> mCacheIndex; // Hash of the cache name -> Shader::GetHash() of the cached stage
     };
 
 } // namespace Surge
@@ -103,6 +103,43 @@ namespace Surge
         std::filesystem::remove(path.Str());
     }
 
+    Filesystem::MappedFile::MappedFile(const Path& path)
+    {
+        HANDLE hFile = ::CreateFile(path.Str().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        SURGE_GET_WIN32_LAST_ERROR
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            Log<Severity::Error>("[Filesystem::MappedFile] Cannot open path({0}) for reading!", path);
+            return;
+        }
+        mFileHandle = hFile;
+
+        LARGE_INTEGER size;
+        if (::GetFileSizeEx(hFile, &size) == FALSE || size.QuadPart == 0)
+            return; // Empty files cannot be mapped
+
+        HANDLE hMapping = ::CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        SURGE_GET_WIN32_LAST_ERROR
+        if (!hMapping)
+            return;
+        mMappingHandle = hMapping;
+
+        mData = static_cast<const Byte*>(::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+        SURGE_GET_WIN32_LAST_ERROR
+        if (mData)
+            mSize = static_cast<uint64_t>(size.QuadPart);
+    }
+
+    Filesystem::MappedFile::~MappedFile()
+    {
+        if (mData)
+            ::UnmapViewOfFile(mData);
+        if (mMappingHandle)
+            ::CloseHandle(static_cast<HANDLE>(mMappingHandle));
+        if (mFileHandle)
+            ::CloseHandle(static_cast<HANDLE>(mFileHandle));
+    }
+
     template <typename T>
     T Filesystem::ReadFile(const Path& path)
     {
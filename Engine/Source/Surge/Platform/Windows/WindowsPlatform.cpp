@@ -2,6 +2,7 @@
 #include "Surge/Utility/Platform.hpp"
 #include "Surge/Utility/Filesystem.hpp"
 #include <ShlObj_core.h>
+#include <Psapi.h>
 
 namespace Surge
 {
@@ -125,4 +126,12 @@ namespace Surge
         return dir;
     }
 
+    uint64_t Platform::GetProcessMemoryUsage()
+    {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+        return static_cast<uint64_t>(counters.WorkingSetSize);
+    }
+
 } // namespace Surge
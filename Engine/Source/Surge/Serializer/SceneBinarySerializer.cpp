@@ -0,0 +1,495 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Serializer/SceneBinarySerializer.hpp"
+#include "Surge/ECS/Components.hpp"
+#include "Surge/Utility/Filesystem.hpp"
+#include <filesystem>
+
+// "SGSB", little endian
+#define SCENE_BINARY_MAGIC 0x42534753
+
+// Must be bumped whenever the file layout or any record changes, files with a different version are rejected
+#define SCENE_BINARY_VERSION 1
+
+// Every section starts at a multiple of this, so that records can be used in place from the mapped file
+#define SCENE_BINARY_ALIGNMENT 16
+
+namespace Surge::Serializer
+{
+    namespace
+    {
+        // File layout:
+        // [FileHeader][ColumnHeader * ColumnCount][padding][column sections...]
+        // A column section is [entity indices][records][blob], the entity indices are left out if every entity has the component.
+        // All offsets are from the start of the file. Strings and arrays live in the blob of their column and are referenced
+        // from the records with a BlobRef
+
+        enum class ColumnType : uint32_t
+        {
+            ID = 0,
+            Name,
+            Transform,
+            ParentChild,
+            Mesh,
+            Camera,
+            PointLight,
+            DirectionalLight,
+            Script
+        };
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t EntityCount;
+            uint32_t ColumnCount;
+            uint32_t Reserved;
+        };
+
+        struct ColumnHeader
+        {
+            ColumnType Type;
+            uint32_t Stride;       // Size of a single record
+            uint64_t Count;        // Number of entities having the component
+            uint64_t EntityOffset; // Uint indices into the entity list, 0 if every entity has the component
+            uint64_t DataOffset;
+            uint64_t BlobOffset;
+            uint64_t BlobSize;
+        };
+
+        struct BlobRef
+        {
+            uint32_t Offset;
+            uint32_t Size; // In bytes
+        };
+
+        struct ParentChildRecord
+        {
+            uint64_t ParentID;
+            BlobRef ChildIDs; // Array of uint64_t
+        };
+
+        struct CameraRecord
+        {
+            float VerticalFOV;
+            float PerspectiveNearClip;
+            float PerspectiveFarClip;
+            float OrthographicNearClip;
+            float OrthographicFarClip;
+            float OrthographicSize;
+            uint32_t Projection;
+            uint8_t Primary;
+            uint8_t FixedAspectRatio;
+            uint8_t Padding[2];
+        };
+
+        // These are stored as they are in memory and copied straight into the storages when loading
+        static_assert(std::is_trivially_copyable_v<TransformComponent>);
+        static_assert(std::is_trivially_copyable_v<PointLightComponent>);
+        static_assert(std::is_trivially_copyable_v<DirectionalLightComponent>);
+
+        uint64_t AlignUp(uint64_t value)
+        {
+            return (value + SCENE_BINARY_ALIGNMENT - 1) & ~static_cast<uint64_t>(SCENE_BINARY_ALIGNMENT - 1);
+        }
+
+        BlobRef WriteToBlob(Vector<Byte>& blob, const void* data, uint64_t size)
+        {
+            BlobRef ref = {static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(size)};
+            blob.insert(blob.end(), static_cast<const Byte*>(data), static_cast<const Byte*>(data) + size);
+            return ref;
+        }
+
+        BlobRef WriteToBlob(Vector<Byte>& blob, const String& string)
+        {
+            return WriteToBlob(blob, string.data(), string.size());
+        }
+
+        // Appends the sections of a column to 'data' (offsets relative to 'data', patched when the file is assembled).
+        // 'toRecord(component, blob)' converts a component to its trivially copyable on disk record
+        template <typename Component, typename F>
+        void WriteColumn(Vector<Byte>& data, Vector<ColumnHeader>& columns, ColumnType type, entt::registry& registry, const Vector<entt::entity>& entities, const F& toRecord)
+        {
+            using Record = std::invoke_result_t<F, Component&, Vector<Byte>&>;
+            static_assert(std::is_trivially_copyable_v<Record>, "Records are copied to/from the file byte by byte!");
+
+            auto& storage = registry.storage<Component>();
+            if (storage.empty())
+                return;
+
+            Vector<Uint> indices;
+            Vector<Record> records;
+            Vector<Byte> blob;
+            indices.reserve(storage.size());
+            records.reserve(storage.size());
+            for (Uint i = 0; i < static_cast<Uint>(entities.size()); i++)
+            {
+                if (!storage.contains(entities[i]))
+                    continue;
+
+                indices.push_back(i);
+                records.push_back(toRecord(storage.get(entities[i]), blob));
+            }
+
+            auto appendSection = [&data](const void* source, uint64_t size) -> uint64_t {
+                const uint64_t offset = AlignUp(data.size());
+                data.resize(offset + size);
+                if (size)
+                    std::memcpy(data.data() + offset, source, size);
+                return offset;
+            };
+
+            ColumnHeader& column = columns.emplace_back();
+            column.Type = type;
+            column.Stride = sizeof(Record);
+            column.Count = records.size();
+            column.EntityOffset = indices.size() == entities.size() ? 0 : appendSection(indices.data(), indices.size() * sizeof(Uint));
+            column.DataOffset = appendSection(records.data(), records.size() * sizeof(Record));
+            column.BlobOffset = appendSection(blob.data(), blob.size());
+            column.BlobSize = blob.size();
+        }
+
+        // Bounds checked access to the mapped file
+        class SceneFileView
+        {
+        public:
+            SceneFileView(const Byte* data, uint64_t size)
+                : mData(data), mSize(size) {}
+
+            template <typename T>
+            const T* Get(uint64_t offset, uint64_t count) const
+            {
+                if (offset % alignof(T) != 0 || offset > mSize || count > (mSize - offset) / sizeof(T))
+                    return nullptr;
+                return reinterpret_cast<const T*>(mData + offset);
+            }
+
+        private:
+            const Byte* mData;
+            uint64_t mSize;
+        };
+
+        class ColumnReader
+        {
+        public:
+            ColumnReader(const SceneFileView& file, const ColumnHeader& column)
+                : mColumn(column)
+            {
+                mIndices = column.EntityOffset ? file.Get<Uint>(column.EntityOffset, column.Count) : nullptr;
+                const bool sizeOverflows = column.Stride != 0 && column.Count > UINT64_MAX / column.Stride;
+                mData = sizeOverflows ? nullptr : file.Get<Byte>(column.DataOffset, column.Count * column.Stride);
+                mBlob = file.Get<Byte>(column.BlobOffset, column.BlobSize);
+            }
+
+            // Returns the entities the records belong to, 'scratch' is used if the column is sparse
+            const Vector<entt::entity>* ResolveEntities(const Vector<entt::entity>& entities, Vector<entt::entity>& scratch) const
+            {
+                if (!mColumn.EntityOffset)
+                    return mColumn.Count == entities.size() ? &entities : nullptr;
+
+                if (!mIndices)
+                    return nullptr;
+
+                scratch.resize(mColumn.Count);
+                for (uint64_t i = 0; i < mColumn.Count; i++)
+                {
+                    if (mIndices[i] >= entities.size())
+                        return nullptr;
+                    scratch[i] = entities[mIndices[i]];
+                }
+                return &scratch;
+            }
+
+            template <typename Record>
+            const Record* GetRecords() const
+            {
+                if (mColumn.Stride != sizeof(Record) || !mData || !mBlob)
+                    return nullptr;
+                return reinterpret_cast<const Record*>(mData);
+            }
+
+            bool IsValid(const BlobRef& ref) const { return static_cast<uint64_t>(ref.Offset) + ref.Size <= mColumn.BlobSize; }
+            String GetString(const BlobRef& ref) const { return String(reinterpret_cast<const char*>(mBlob + ref.Offset), ref.Size); }
+            const Byte* GetBlob(const BlobRef& ref) const { return mBlob + ref.Offset; }
+
+        private:
+            const ColumnHeader& mColumn;
+            const Uint* mIndices;
+            const Byte* mData;
+            const Byte* mBlob;
+        };
+
+        template <typename Component>
+        bool InsertTrivialColumn(entt::registry& registry, const ColumnReader& reader, const Vector<entt::entity>& entities)
+        {
+            const Component* records = reader.GetRecords<Component>();
+            if (!records)
+                return false;
+
+            registry.insert<Component>(entities.begin(), entities.end(), records);
+            return true;
+        }
+
+        bool ReadColumn(Scene* scene, const ColumnReader& reader, ColumnType type, const Vector<entt::entity>& entities, HashMap<String, Ref<Mesh>>& meshCache)
+        {
+            entt::registry& registry = scene->GetRegistry();
+            switch (type)
+            {
+                case ColumnType::ID:
+                {
+                    const uint64_t* records = reader.GetRecords<uint64_t>();
+                    if (!records)
+                        return false;
+
+                    registry.storage<IDComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                        registry.emplace<IDComponent>(entities[i], UUID(records[i]));
+                    return true;
+                }
+                case ColumnType::Name:
+                {
+                    const BlobRef* records = reader.GetRecords<BlobRef>();
+                    if (!records)
+                        return false;
+
+                    registry.storage<NameComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        if (!reader.IsValid(records[i]))
+                            return false;
+                        registry.emplace<NameComponent>(entities[i], reader.GetString(records[i]));
+                    }
+                    return true;
+                }
+                case ColumnType::ParentChild:
+                {
+                    const ParentChildRecord* records = reader.GetRecords<ParentChildRecord>();
+                    if (!records)
+                        return false;
+
+                    registry.storage<ParentChildComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        const ParentChildRecord& record = records[i];
+                        if (!reader.IsValid(record.ChildIDs) || record.ChildIDs.Size % sizeof(uint64_t) != 0)
+                            return false;
+
+                        ParentChildComponent& component = registry.emplace<ParentChildComponent>(entities[i], UUID(record.ParentID));
+                        const uint64_t* childIDs = reinterpret_cast<const uint64_t*>(reader.GetBlob(record.ChildIDs));
+                        component.ChildIDs.assign(childIDs, childIDs + record.ChildIDs.Size / sizeof(uint64_t));
+                    }
+                    return true;
+                }
+                case ColumnType::Mesh:
+                {
+                    const BlobRef* records = reader.GetRecords<BlobRef>();
+                    if (!records)
+                        return false;
+
+                    registry.storage<MeshComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        if (!reader.IsValid(records[i]))
+                            return false;
+
+                        // The AssetManager already shares the Mesh between entities, the local cache just skips its path lookup
+                        Ref<Mesh> mesh;
+                        String path = reader.GetString(records[i]);
+                        if (!path.empty())
+                        {
+                            Ref<Mesh>& cached = meshCache[path];
+                            if (!cached)
+                                cached = Core::GetAssetManager()->LoadMeshAsync(path);
+                            mesh = cached;
+                        }
+                        registry.emplace<MeshComponent>(entities[i], mesh);
+                    }
+                    return true;
+                }
+                case ColumnType::Camera:
+                {
+                    const CameraRecord* records = reader.GetRecords<CameraRecord>();
+                    if (!records)
+                        return false;
+
+                    registry.storage<CameraComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        const CameraRecord& record = records[i];
+                        CameraComponent& component = registry.emplace<CameraComponent>(entities[i]);
+                        component.Camera.SetPerspectiveVerticalFOV(record.VerticalFOV);
+                        component.Camera.SetPerspectiveNearClip(record.PerspectiveNearClip);
+                        component.Camera.SetPerspectiveFarClip(record.PerspectiveFarClip);
+                        component.Camera.SetOrthographicNearClip(record.OrthographicNearClip);
+                        component.Camera.SetOrthographicFarClip(record.OrthographicFarClip);
+                        component.Camera.SetOrthographicSize(record.OrthographicSize);
+                        component.Camera.SetProjectionType(static_cast<RuntimeCamera::ProjectionType>(record.Projection));
+                        component.Primary = record.Primary;
+                        component.FixedAspectRatio = record.FixedAspectRatio;
+                    }
+                    return true;
+                }
+                case ColumnType::Script:
+                {
+                    const BlobRef* records = reader.GetRecords<BlobRef>();
+                    if (!records)
+                        return false;
+
+                    const String& projectPath = scene->GetParentProject()->GetMetadata().ProjPath.Str();
+                    registry.storage<ScriptComponent>().reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        if (!reader.IsValid(records[i]))
+                            return false;
+
+                        Path scriptPath = fmt::format("{0}/{1}", projectPath, reader.GetString(records[i]));
+                        registry.emplace<ScriptComponent>(entities[i], scriptPath, NULL_UUID);
+                    }
+                    return true;
+                }
+                case ColumnType::Transform: return InsertTrivialColumn<TransformComponent>(registry, reader, entities);
+                case ColumnType::PointLight: return InsertTrivialColumn<PointLightComponent>(registry, reader, entities);
+                case ColumnType::DirectionalLight: return InsertTrivialColumn<DirectionalLightComponent>(registry, reader, entities);
+            }
+
+            Log<Severity::Warn>("Unknown column type: '{0}' in binary scene!", static_cast<uint32_t>(type));
+            return true;
+        }
+    } // namespace
+
+    bool IsBinaryScene(const Path& path)
+    {
+        return std::filesystem::path(path.Str()).extension() == SCENE_BINARY_EXTENSION;
+    }
+
+    void SerializeSceneBinary(const Path& path, Scene* in)
+    {
+        SG_ASSERT_NOMSG(in);
+        entt::registry& registry = in->GetRegistry();
+
+        // Entities are written in the (packed) order of the IDComponent storage, which is recreated as is when loading.
+        // Every other column refers to them by index
+        const auto& ids = registry.storage<IDComponent>();
+        const Vector<entt::entity> entities(ids.data(), ids.data() + ids.size());
+
+        Vector<ColumnHeader> columns;
+        Vector<Byte> data;
+        const String& projectPath = in->GetParentProject()->GetMetadata().ProjPath.Str();
+
+        WriteColumn<IDComponent>(data, columns, ColumnType::ID, registry, entities, [](IDComponent& c, Vector<Byte>&) { return c.ID.Get(); });
+        WriteColumn<NameComponent>(data, columns, ColumnType::Name, registry, entities, [](NameComponent& c, Vector<Byte>& blob) { return WriteToBlob(blob, c.Name); });
+        WriteColumn<TransformComponent>(data, columns, ColumnType::Transform, registry, entities, [](TransformComponent& c, Vector<Byte>&) { return c; });
+        WriteColumn<ParentChildComponent>(data, columns, ColumnType::ParentChild, registry, entities, [](ParentChildComponent& c, Vector<Byte>& blob) {
+            static_assert(sizeof(UUID) == sizeof(uint64_t));
+            return ParentChildRecord {c.ParentID.Get(), WriteToBlob(blob, c.ChildIDs.data(), c.ChildIDs.size() * sizeof(uint64_t))};
+        });
+        WriteColumn<MeshComponent>(data, columns, ColumnType::Mesh, registry, entities, [](MeshComponent& c, Vector<Byte>& blob) {
+            String meshPath;
+            if (c.Mesh)
+                meshPath = std::filesystem::relative(c.Mesh->GetPath().Str()).string();
+            return WriteToBlob(blob, meshPath);
+        });
+        WriteColumn<CameraComponent>(data, columns, ColumnType::Camera, registry, entities, [](CameraComponent& c, Vector<Byte>&) {
+            CameraRecord record = {};
+            record.VerticalFOV = c.Camera.GetPerspectiveVerticalFOV();
+            record.PerspectiveNearClip = c.Camera.GetPerspectiveNearClip();
+            record.PerspectiveFarClip = c.Camera.GetPerspectiveFarClip();
+            record.OrthographicNearClip = c.Camera.GetOrthographicNearClip();
+            record.OrthographicFarClip = c.Camera.GetOrthographicFarClip();
+            record.OrthographicSize = c.Camera.GetOrthographicSize();
+            record.Projection = static_cast<uint32_t>(c.Camera.GetProjectionType());
+            record.Primary = c.Primary;
+            record.FixedAspectRatio = c.FixedAspectRatio;
+            return record;
+        });
+        WriteColumn<PointLightComponent>(data, columns, ColumnType::PointLight, registry, entities, [](PointLightComponent& c, Vector<Byte>&) { return c; });
+        WriteColumn<DirectionalLightComponent>(data, columns, ColumnType::DirectionalLight, registry, entities, [](DirectionalLightComponent& c, Vector<Byte>&) { return c; });
+        WriteColumn<ScriptComponent>(data, columns, ColumnType::Script, registry, entities, [&projectPath](ScriptComponent& c, Vector<Byte>& blob) {
+            return WriteToBlob(blob, std::filesystem::relative(c.ScriptPath.Str(), projectPath).string());
+        });
+
+        // Column offsets were relative to 'data', make them absolute
+        const uint64_t dataStart = AlignUp(sizeof(FileHeader) + columns.size() * sizeof(ColumnHeader));
+        for (ColumnHeader& column : columns)
+        {
+            if (column.EntityOffset)
+                column.EntityOffset += dataStart;
+            column.DataOffset += dataStart;
+            column.BlobOffset += dataStart;
+        }
+
+        FileHeader header = {};
+        header.Magic = SCENE_BINARY_MAGIC;
+        header.Version = SCENE_BINARY_VERSION;
+        header.EntityCount = entities.size();
+        header.ColumnCount = static_cast<uint32_t>(columns.size());
+
+        Vector<Byte> file(dataStart + data.size(), 0);
+        std::memcpy(file.data(), &header, sizeof(FileHeader));
+        std::memcpy(file.data() + sizeof(FileHeader), columns.data(), columns.size() * sizeof(ColumnHeader));
+        std::memcpy(file.data() + dataStart, data.data(), data.size());
+
+        FILE* f;
+        errno_t e = fopen_s(&f, path, "wb");
+        if (f)
+        {
+            fwrite(file.data(), sizeof(Byte), file.size(), f);
+            fclose(f);
+        }
+        else
+            Log<Severity::Error>("Cannot open path({0}) for writing the scene!", path);
+    }
+
+    bool DeserializeSceneBinary(const Path& path, Scene* out)
+    {
+        SG_ASSERT_NOMSG(out);
+        Filesystem::MappedFile file(path);
+        if (!file.IsValid())
+            return false;
+
+        SceneFileView view(file.GetData(), file.GetSize());
+        const FileHeader* header = view.Get<FileHeader>(0, 1);
+        if (!header || header->Magic != SCENE_BINARY_MAGIC)
+        {
+            Log<Severity::Error>("'{0}' is not a binary scene!", path);
+            return false;
+        }
+        if (header->Version != SCENE_BINARY_VERSION)
+        {
+            Log<Severity::Error>("Binary scene '{0}' has version {1}, expected version {2}!", path, header->Version, SCENE_BINARY_VERSION);
+            return false;
+        }
+
+        const ColumnHeader* columns = view.Get<ColumnHeader>(sizeof(FileHeader), header->ColumnCount);
+        if (!columns || header->EntityCount > file.GetSize())
+        {
+            Log<Severity::Error>("Binary scene '{0}' is corrupted!", path);
+            return false;
+        }
+
+        entt::registry& registry = out->GetRegistry();
+        registry.clear();
+
+        Vector<entt::entity> entities(header->EntityCount);
+        registry.create(entities.begin(), entities.end());
+
+        // The ID column comes first, so that the Scene's UUID index is filled before anything else is added
+        HashMap<String, Ref<Mesh>> meshCache;
+        Vector<entt::entity> scratch;
+        for (uint32_t i = 0; i < header->ColumnCount; i++)
+        {
+            ColumnReader reader(view, columns[i]);
+            const Vector<entt::entity>* columnEntities = reader.ResolveEntities(entities, scratch);
+            if (!columnEntities || !ReadColumn(out, reader, columns[i].Type, *columnEntities, meshCache))
+            {
+                Log<Severity::Error>("Binary scene '{0}' is corrupted!", path);
+                registry.clear();
+                return false;
+            }
+        }
+
+        // Derived, not stored in the file
+        registry.insert<WorldTransformComponent>(entities.begin(), entities.end());
+        return true;
+    }
+
+} // namespace Surge::Serializer
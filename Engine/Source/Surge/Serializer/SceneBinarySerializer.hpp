@@ -0,0 +1,17 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "Surge/Core/Defines.hpp"
+#include "Surge/ECS/Scene.hpp"
+
+#define SCENE_BINARY_EXTENSION ".surgeb"
+
+namespace Surge::Serializer
+{
+    // Binary scene format (.surgeb). Components are stored per type in columns, so loading a scene is a handful of
+    // bulk copies from the memory mapped file into the entt storages instead of parsing a json DOM.
+    // Serialize/Deserialize<Scene> pick the format from the file extension, json (.surge) stays available for exporting and diffing
+    bool IsBinaryScene(const Path& path);
+    void SerializeSceneBinary(const Path& path, Scene* in);
+    bool DeserializeSceneBinary(const Path& path, Scene* out); // Returns false if the file is missing, corrupted or of an unsupported version
+
+} // namespace Surge::Serializer
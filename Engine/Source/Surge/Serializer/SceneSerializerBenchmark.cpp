@@ -0,0 +1,248 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#include "Surge/Serializer/Serializer.hpp"
+#include "Surge/Serializer/SceneBinarySerializer.hpp"
+#include "Surge/Graphics/Shader/ShaderSet.hpp"
+#include "Surge/Utility/Platform.hpp"
+#include <filesystem>
+
+// Number of entities under every root of the synthetic scene
+#define SCENE_BENCHMARK_CHILDREN_PER_ROOT 7
+
+// Every n-th entity of the synthetic scene gets a point light
+#define SCENE_BENCHMARK_LIGHT_STRIDE 10
+
+namespace Surge::Serializer
+{
+    namespace
+    {
+        // Samples the resident memory of the process on its own thread until Stop(), the save and load functions can't be instrumented
+        class MemorySampler
+        {
+        public:
+            MemorySampler()
+                : mBaseline(Platform::GetProcessMemoryUsage()), mPeak(mBaseline)
+            {
+                mThread = std::thread([this]() {
+                    while (mRunning.load(std::memory_order_relaxed))
+                    {
+                        Sample();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                });
+            }
+
+            // Returns the peak growth over the memory at construction, in bytes
+            uint64_t Stop()
+            {
+                mRunning = false;
+                mThread.join();
+                Sample();
+                return mPeak - mBaseline;
+            }
+
+        private:
+            void Sample() { mPeak = std::max(mPeak, Platform::GetProcessMemoryUsage()); }
+
+        private:
+            const uint64_t mBaseline;
+            uint64_t mPeak; // Only written by the sampling thread until it is joined
+            std::atomic<bool> mRunning = true;
+            std::thread mThread;
+        };
+
+        // Small hierarchies of SCENE_BENCHMARK_CHILDREN_PER_ROOT children, with a point light on some of the entities
+        void CreateSyntheticScene(Scene* scene, Uint entityCount)
+        {
+            Entity root;
+            for (Uint i = 0; i < entityCount; i++)
+            {
+                Entity entity;
+                scene->CreateEntity(entity, fmt::format("Entity {0}", i));
+
+                const float value = static_cast<float>(i);
+                TransformComponent& transform = entity.GetComponent<TransformComponent>();
+                transform.Position = {value, value * 0.5f, -value};
+                transform.Rotation = {value * 0.1f, value * 0.2f, value * 0.3f};
+
+                if (i % SCENE_BENCHMARK_LIGHT_STRIDE == 0)
+                    entity.AddComponent<PointLightComponent>(glm::vec3(1.0f, 0.5f, 0.25f), 2.0f, 5.0f, 0.5f);
+
+                // Set directly, Scene::ParentEntity would also convert the transform to the local space of the parent
+                if (i % (SCENE_BENCHMARK_CHILDREN_PER_ROOT + 1) == 0)
+                    root = entity;
+                else
+                {
+                    entity.GetComponent<ParentChildComponent>().ParentID = root.GetUUID();
+                    root.GetComponent<ParentChildComponent>().ChildIDs.push_back(entity.GetUUID());
+                }
+            }
+        }
+
+        // How the serializer checked the type of a field before type IDs: the name of T is built into a string and hashed
+        struct NameDispatch
+        {
+            template <typename T>
+            bool Is() const
+            {
+                const std::string name = std::string(SurgeReflect::TypeTraits::GetTypeName<T>());
+                if (name.size() > std::string().capacity()) // Longer than the small string buffer, so the string was heap allocated
+                    StringAllocations++;
+                return FieldType.GetHashCode() == SurgeReflect::Utility::GenerateStringHash(name);
+            }
+
+            const SurgeReflect::Type& FieldType;
+            Uint& StringAllocations;
+        };
+
+        struct TypeIDDispatch
+        {
+            template <typename T>
+            bool Is() const { return FieldType.EqualTo<T>(); }
+
+            const SurgeReflect::Type& FieldType;
+        };
+
+        // Walks the if/else chain the serializer went through for every field, in the same order. Returns the index of the match
+        template <typename Dispatch>
+        Uint DispatchField(const Dispatch& dispatch)
+        {
+            if (dispatch.template Is<bool>())
+                return 0;
+            if (dispatch.template Is<float>())
+                return 1;
+            if (dispatch.template Is<UUID>())
+                return 2;
+            if (dispatch.template Is<Vector<UUID>>())
+                return 3;
+            if (dispatch.template Is<String>())
+                return 4;
+            if (dispatch.template Is<Path>())
+                return 5;
+            if (dispatch.template Is<glm::vec3>())
+                return 6;
+            if (dispatch.template Is<RuntimeCamera>())
+                return 7;
+            if (dispatch.template Is<Ref<Mesh>>())
+                return 8;
+            return 9;
+        }
+
+        // Calls 'func' with the reflected class of every component of 'entity'
+        template <typename... Components, typename F>
+        void ForEachComponentClass(const entt::registry& registry, entt::entity entity, const SurgeReflect::Class* const* classes, const F& func)
+        {
+            Uint index = 0;
+            ((registry.any_of<Components>(entity) ? func(classes[index++]) : (void)index++), ...);
+        }
+
+        template <typename... Components>
+        std::array<const SurgeReflect::Class*, sizeof...(Components)> GetComponentClasses()
+        {
+            return {SurgeReflect::GetReflection<Components>()...};
+        }
+
+        SceneFormatBenchmarkResult RunFormat(Project* project, Scene* source, const Path& path)
+        {
+            SceneFormatBenchmarkResult result = {};
+            {
+                MemorySampler memory;
+                Timer timer;
+                Serialize<Scene>(path, source);
+                result.SaveMillis = timer.ElapsedMillis();
+                result.SavePeakMemory = memory.Stop();
+            }
+
+            std::error_code error;
+            result.FileSize = std::filesystem::file_size(path.Str(), error);
+
+            {
+                // The scene is destroyed before the sampler stops, only the peak matters
+                MemorySampler memory;
+                Timer timer;
+                {
+                    Ref<Scene> loaded = Ref<Scene>::Create(project, "Benchmark", path, false);
+                    Deserialize<Scene>(path, loaded.Raw());
+                    result.LoadMillis = timer.ElapsedMillis();
+                }
+                result.LoadPeakMemory = memory.Stop();
+            }
+
+            std::filesystem::remove(path.Str(), error);
+            return result;
+        }
+    } // namespace
+
+    SceneBenchmarkResult RunSceneBenchmark(Project* project, Uint entityCount)
+    {
+        SURGE_PROFILE_FUNC("Serializer::RunSceneBenchmark");
+        SG_ASSERT(project, "The scene serializers need a project!");
+        std::filesystem::create_directory(TEMP_ASSET_PATH);
+
+        SceneBenchmarkResult result = {};
+        result.EntityCount = entityCount;
+
+        Ref<Scene> source = Ref<Scene>::Create(project, "Benchmark", Path(), false);
+        CreateSyntheticScene(source.Raw(), entityCount);
+        result.Json = RunFormat(project, source.Raw(), fmt::format("{0}/SceneBenchmark.surge", TEMP_ASSET_PATH));
+        result.Binary = RunFormat(project, source.Raw(), fmt::format("{0}/SceneBenchmark{1}", TEMP_ASSET_PATH, SCENE_BINARY_EXTENSION));
+
+        constexpr float toMb = 1.0f / 1000000.0f;
+        Log<Severity::Info>("Scene benchmark, {0} entities:", entityCount);
+        Log<Severity::Info>("    json:   save {0} ms, load {1} ms, {2} Mb file, {3} Mb peak save memory, {4} Mb peak load memory", result.Json.SaveMillis, result.Json.LoadMillis, result.Json.FileSize * toMb, result.Json.SavePeakMemory * toMb, result.Json.LoadPeakMemory * toMb);
+        Log<Severity::Info>("    binary: save {0} ms, load {1} ms, {2} Mb file, {3} Mb peak save memory, {4} Mb peak load memory", result.Binary.SaveMillis, result.Binary.LoadMillis, result.Binary.FileSize * toMb, result.Binary.SavePeakMemory * toMb, result.Binary.LoadPeakMemory * toMb);
+        return result;
+    }
+
+    TypeDispatchBenchmarkResult RunTypeDispatchBenchmark(Uint entityCount)
+    {
+        SURGE_PROFILE_FUNC("Serializer::RunTypeDispatchBenchmark");
+
+        TypeDispatchBenchmarkResult result = {};
+        result.EntityCount = entityCount;
+
+        Ref<Scene> scene = Ref<Scene>::Create(nullptr, "Benchmark", Path(), false);
+        CreateSyntheticScene(scene.Raw(), entityCount);
+        const entt::registry& registry = scene->GetRegistry();
+        const auto& ids = registry.storage<IDComponent>();
+        const Vector<entt::entity> entities(ids.data(), ids.data() + ids.size());
+
+        // Looked up once, only the per field type checks are measured
+        const auto classes = GetComponentClasses<ALL_MAJOR_COMPONENTS>();
+
+        // Summed up and logged, so that the dispatch can't be optimized away
+        Uint checksum = 0;
+        Uint fieldCount = 0;
+        Uint stringAllocations = 0;
+        Timer timer;
+        for (entt::entity entity : entities)
+        {
+            ForEachComponentClass<ALL_MAJOR_COMPONENTS>(registry, entity, classes.data(), [&](const SurgeReflect::Class* clazz) {
+                for (const SurgeReflect::Variable& variable : clazz->GetVariables())
+                {
+                    checksum += DispatchField(NameDispatch {variable.GetType(), stringAllocations});
+                    fieldCount++;
+                }
+            });
+        }
+        result.NameDispatchMillis = timer.ElapsedMillis();
+
+        timer.Reset();
+        for (entt::entity entity : entities)
+        {
+            ForEachComponentClass<ALL_MAJOR_COMPONENTS>(registry, entity, classes.data(), [&](const SurgeReflect::Class* clazz) {
+                for (const SurgeReflect::Variable& variable : clazz->GetVariables())
+                    checksum += DispatchField(TypeIDDispatch {variable.GetType()});
+            });
+        }
+        result.TypeIDDispatchMillis = timer.ElapsedMillis();
+
+        const float perEntity = entityCount ? 1.0f / entityCount : 0.0f;
+        result.FieldsPerEntity = fieldCount * perEntity;
+        result.NameStringAllocationsPerEntity = stringAllocations * perEntity;
+
+        Log<Severity::Info>("Type dispatch of {0} entities ({1} fields each, checksum {2}): by name {3} ms with {4} string allocations per entity, by type ID {5} ms with none",
+                            entityCount, result.FieldsPerEntity, checksum, result.NameDispatchMillis, result.NameStringAllocationsPerEntity, result.TypeIDDispatchMillis);
+        return result;
+    }
+
+} // namespace Surge::Serializer
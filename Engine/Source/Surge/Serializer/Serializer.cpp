@@ -1,5 +1,6 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #include "Surge/Serializer/Serializer.hpp"
+#include "Surge/Serializer/SceneBinarySerializer.hpp"
 #include "Surge/ECS/Components.hpp"
 #include "Surge/Utility/Filesystem.hpp"
 #include <glm/gtc/type_ptr.hpp>
@@ -55,116 +56,58 @@ namespace Surge
     // Enum Mapping(s)
     NLOHMANN_JSON_SERIALIZE_ENUM(RuntimeCamera::ProjectionType, {{RuntimeCamera::ProjectionType::Perspective, "Perspective"}, {RuntimeCamera::ProjectionType::Orthographic, "Orthographic"}})
 
+    template <typename>
+    inline constexpr bool AlwaysFalse = false;
+
+    // The json key of a component is its reflected class name
+    template <typename XComponent>
+    FORCEINLINE static const String& GetComponentKey()
+    {
+        static const String key = SurgeReflect::GetReflection<XComponent>()->GetName();
+        return key;
+    }
+
     template <typename XComponent>
     FORCEINLINE static void SerializeComponent(nlohmann::json& j, Entity& e)
     {
-        if (e.HasComponent<XComponent>())
-        {
-            XComponent& comp = e.GetComponent<XComponent>();
-            const SurgeReflect::Class* clazz = SurgeReflect::GetReflection<XComponent>();
-            uint64_t offset = 0;
+        if (!e.HasComponent<XComponent>())
+            return;
+
+        const XComponent& comp = e.GetComponent<XComponent>();
+        nlohmann::json& out = j[GetComponentKey<XComponent>()];
 
-            nlohmann::json& out = j[clazz->GetName()];
+        SurgeReflect::ForEachField<XComponent>([&](const auto& field) {
+            using FieldType = typename std::decay_t<decltype(field)>::Type;
+            const FieldType& value = field.Get(comp);
+            const char* name = field.Name;
 
-            for (const auto& [name, var] : clazz->GetVariables())
+            if constexpr (std::is_same_v<FieldType, bool> || std::is_same_v<FieldType, float> || std::is_same_v<FieldType, String> || std::is_same_v<FieldType, glm::vec3>)
+                out[name] = value;
+            else if constexpr (std::is_same_v<FieldType, UUID>)
+                out[name] = value.Get();
+            else if constexpr (std::is_same_v<FieldType, Vector<UUID>>)
             {
-                uint64_t size = var.GetSize();
-                const Byte* source = reinterpret_cast<const Byte*>(&comp) + offset;
-
-                const SurgeReflect::Type& type = var.GetType();
-                if (type.EqualTo<bool>())
-                {
-                    bool destination;
-                    std::memcpy(&destination, reinterpret_cast<const bool*>(source), size);
-                    out[name] = destination;
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<float>())
-                {
-                    float destination;
-                    std::memcpy(&destination, reinterpret_cast<const float*>(source), size);
-                    out[name] = destination;
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<UUID>())
-                {
-                    uint64_t destination = *reinterpret_cast<const uint64_t*>(source);
-                    out[name] = destination;
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<Vector<UUID>>())
-                {
-                    Vector<uint64_t> destination;
-                    const Vector<UUID>* src = reinterpret_cast<const Vector<UUID>*>(source);
-                    destination.resize(src->size());
-                    size = src->size() * sizeof(uint64_t);
-                    std::memcpy(destination.data(), src->data(), size);
-                    out[name] = destination;
-                    continue;
-                }
-                else if (type.EqualTo<String>())
-                {
-                    // Get the string size; (we cannot use var.GetSize() as that uses sizeof())
-                    const String* src = reinterpret_cast<const String*>(source);
-                    size = src->size();
-
-                    String destination;
-                    destination.resize(size);
-                    std::memcpy(reinterpret_cast<void*>(destination.data()), reinterpret_cast<const String*>(source)->c_str(), size);
-                    out[name] = destination;
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<Path>())
-                {
-                    const Path* src = reinterpret_cast<const Path*>(source);
-                    size = src->Size();
-                    auto k = sizeof(Path);
-                    auto relativePath = std::filesystem::relative(src->Str(), e.GetScene()->GetParentProject()->GetMetadata().ProjPath.Str()).string();
-                    out[name] = relativePath;
-
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<glm::vec3>())
-                {
-                    glm::vec3 destination;
-                    std::memcpy(glm::value_ptr(destination), glm::value_ptr(*reinterpret_cast<const glm::vec3*>(source)), size);
-                    out[name] = destination;
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<RuntimeCamera>())
-                {
-                    const RuntimeCamera* cam = reinterpret_cast<const RuntimeCamera*>(source);
-
-                    out["Vertical FOV"] = cam->GetPerspectiveVerticalFOV();
-                    out["Perspective NearClip"] = cam->GetPerspectiveNearClip();
-                    out["Perspective FarClip"] = cam->GetPerspectiveFarClip();
-                    out["Orthographic NearClip"] = cam->GetOrthographicNearClip();
-                    out["Orthographic FarClip"] = cam->GetOrthographicFarClip();
-                    out["Orthographic Size"] = cam->GetOrthographicSize();
-                    out["Projection"] = cam->GetProjectionType();
-                    offset += size;
-                    continue;
-                }
-                else if (type.EqualTo<Ref<Mesh>>())
-                {
-                    const Ref<Mesh>* mesh = reinterpret_cast<const Ref<Mesh>*>(source);
-                    String path;
-                    if (*mesh)
-                        path = std::filesystem::relative((*mesh)->GetPath().Str()).string();
-
-                    out[name] = path;
-                    offset += size;
-                    continue;
-                }
-                Log<Severity::Warn>("Unhandled Variable of type: '{0}' while serializing!", type.GetFullName());
+                Vector<uint64_t> destination(value.size());
+                std::memcpy(destination.data(), value.data(), value.size() * sizeof(uint64_t));
+                out[name] = destination;
             }
-        }
+            else if constexpr (std::is_same_v<FieldType, Path>)
+                out[name] = std::filesystem::relative(value.Str(), e.GetScene()->GetParentProject()->GetMetadata().ProjPath.Str()).string();
+            else if constexpr (std::is_same_v<FieldType, RuntimeCamera>)
+            {
+                out["Vertical FOV"] = value.GetPerspectiveVerticalFOV();
+                out["Perspective NearClip"] = value.GetPerspectiveNearClip();
+                out["Perspective FarClip"] = value.GetPerspectiveFarClip();
+                out["Orthographic NearClip"] = value.GetOrthographicNearClip();
+                out["Orthographic FarClip"] = value.GetOrthographicFarClip();
+                out["Orthographic Size"] = value.GetOrthographicSize();
+                out["Projection"] = value.GetProjectionType();
+            }
+            else if constexpr (std::is_same_v<FieldType, Ref<Mesh>>)
+                out[name] = value ? std::filesystem::relative(value->GetPath().Str()).string() : String();
+            else
+                static_assert(AlwaysFalse<FieldType>, "Unhandled field type while serializing!");
+        });
     }
 
     template <typename... Components>
@@ -187,6 +130,12 @@ namespace Surge
     {
         SG_ASSERT_NOMSG(in);
         SCOPED_TIMER("Serialization");
+        if (IsBinaryScene(path))
+        {
+            SerializeSceneBinary(path, in);
+            return;
+        }
+
         nlohmann::json outJson = nlohmann::json();
 
         uint64_t index = 0;
@@ -216,104 +165,59 @@ namespace Surge
     template <typename XComponent>
     FORCEINLINE static void DeserializeComponent(nlohmann::json& j, Entity& e)
     {
-        const SurgeReflect::Class* clazz = SurgeReflect::GetReflection<XComponent>();
-
         // Check if the json contains the component name, if it does, then proceed with Deserialization
-        bool hasComponent = j.contains(clazz->GetName());
-        if (!hasComponent)
+        auto itr = j.find(GetComponentKey<XComponent>());
+        if (itr == j.end())
             return;
 
         if (!e.HasComponent<XComponent>())
             e.AddComponent<XComponent>();
 
-        nlohmann::json& inJson = j[clazz->GetName()];
+        nlohmann::json& inJson = *itr;
         XComponent& comp = e.GetComponent<XComponent>();
-        uint64_t offset = 0;
 
-        for (const auto& [name, var] : clazz->GetVariables())
-        {
-            const SurgeReflect::Type& type = var.GetType();
-            uint64_t size = var.GetSize();
-            Byte* destination = reinterpret_cast<Byte*>(&comp) + offset;
+        SurgeReflect::ForEachField<XComponent>([&](const auto& field) {
+            using FieldType = typename std::decay_t<decltype(field)>::Type;
+            FieldType& value = field.Get(comp);
+            const char* name = field.Name;
 
-            if (type.EqualTo<bool>())
-            {
-                const bool source = inJson[name];
-                bool* dst = reinterpret_cast<bool*>(destination);
-                std::memcpy(dst, &source, size);
-            }
-            else if (type.EqualTo<float>())
-            {
-                if (inJson.contains(name))
-                {
-                    const float source = inJson[name];
-                    float* dst = reinterpret_cast<float*>(destination);
-                    std::memcpy(dst, &source, size);
-                }
-            }
-            else if (type.EqualTo<UUID>())
-            {
-                const uint64_t source = inJson[name];
-                uint64_t* dst = reinterpret_cast<uint64_t*>(destination);
-                std::memcpy(dst, &source, size);
-            }
-            else if (type.EqualTo<Vector<UUID>>())
+            if constexpr (std::is_same_v<FieldType, RuntimeCamera>)
             {
-                const Vector<uint64_t> source = inJson[name];
-                size = source.size();
-                Vector<UUID>* dst = reinterpret_cast<Vector<UUID>*>(destination);
-                dst->resize(source.size());
-                std::memcpy(dst->data(), source.data(), (size * sizeof(UUID)));
+                // Stored as separate keys, not under the field name
+                value.SetPerspectiveVerticalFOV(inJson["Vertical FOV"]);
+                value.SetPerspectiveNearClip(inJson["Perspective NearClip"]);
+                value.SetPerspectiveFarClip(inJson["Perspective FarClip"]);
+                value.SetOrthographicNearClip(inJson["Orthographic NearClip"]);
+                value.SetOrthographicFarClip(inJson["Orthographic FarClip"]);
+                value.SetOrthographicSize(inJson["Orthographic Size"]);
+                value.SetProjectionType(inJson["Projection"]);
+                return;
             }
-            else if (type.EqualTo<String>())
-            {
-                const String source = inJson[name];
-                size = source.size(); // We cannot use var.GetSize() as that uses sizeof()
-
-                String* src = reinterpret_cast<String*>(destination);
-                src->resize(size);
-                std::memcpy(src->data(), source.c_str(), size);
-            }
-            else if (type.EqualTo<Path>())
-            {
-                const String source = inJson[name];
-                size = source.size();
 
-                Path* src = reinterpret_cast<Path*>(destination);
-                *src = Path(fmt::format("{0}/{1}", e.GetScene()->GetParentProject()->GetMetadata().ProjPath.Str(), source));
+            auto fieldItr = inJson.find(name);
+            if (fieldItr == inJson.end())
+                return;
 
-                size = src->Size();
-            }
-            else if (type.EqualTo<glm::vec3>())
+            const nlohmann::json& source = *fieldItr;
+            if constexpr (std::is_same_v<FieldType, bool> || std::is_same_v<FieldType, float> || std::is_same_v<FieldType, String> || std::is_same_v<FieldType, glm::vec3>)
+                source.get_to(value);
+            else if constexpr (std::is_same_v<FieldType, UUID>)
+                value = source.get<uint64_t>();
+            else if constexpr (std::is_same_v<FieldType, Vector<UUID>>)
             {
-                glm::vec3 source = inJson[name];
-                glm::vec3* dst = reinterpret_cast<glm::vec3*>(destination);
-                std::memcpy(dst, glm::value_ptr(source), size);
+                const Vector<uint64_t> ids = source.get<Vector<uint64_t>>();
+                value.assign(ids.begin(), ids.end());
             }
-            else if (type.EqualTo<RuntimeCamera>())
+            else if constexpr (std::is_same_v<FieldType, Path>)
+                value = Path(fmt::format("{0}/{1}", e.GetScene()->GetParentProject()->GetMetadata().ProjPath.Str(), source.get<String>()));
+            else if constexpr (std::is_same_v<FieldType, Ref<Mesh>>)
             {
-                RuntimeCamera cam;
-                cam.SetPerspectiveVerticalFOV(inJson["Vertical FOV"]);
-                cam.SetPerspectiveNearClip(inJson["Perspective NearClip"]);
-                cam.SetPerspectiveFarClip(inJson["Perspective FarClip"]);
-                cam.SetOrthographicNearClip(inJson["Orthographic NearClip"]);
-                cam.SetOrthographicFarClip(inJson["Orthographic FarClip"]);
-                cam.SetOrthographicSize(inJson["Orthographic Size"]);
-                cam.SetProjectionType(inJson["Projection"]);
-                std::memcpy(destination, &cam, size);
+                const String path = source.get<String>();
+                value = path.empty() ? nullptr : Core::GetAssetManager()->LoadMeshAsync(path);
             }
-            else if (type.EqualTo<Ref<Mesh>>())
-            {
-                String path = inJson[name];
-
-                Ref<Mesh>& src = *reinterpret_cast<Ref<Mesh>*>(destination);
-                path.empty() ? src = nullptr : src = Ref<Mesh>::Create(path);
-            }
-            else
-                Log<Severity::Warn>("Unhandled Variable of type: '{0}' while deserializing!", type.GetFullName());
-
-            offset += size;
-        }
+            else if constexpr (!std::is_same_v<FieldType, RuntimeCamera>)
+                static_assert(AlwaysFalse<FieldType>, "Unhandled field type while deserializing!");
+        });
     }
 
     template <typename... Components>
@@ -330,11 +234,29 @@ namespace Surge
         DeserializeComponents<ALL_MAJOR_COMPONENTS>(inJson, e);
     }
 
+    static void CreateSceneScripts(Scene* scene)
+    {
+        auto& registry = scene->GetRegistry();
+        const auto& view = registry.view<IDComponent, ScriptComponent>();
+        for (auto& entity : view)
+        {
+            const auto& [id, script] = view.get<IDComponent, ScriptComponent>(entity);
+            script.ScriptEngineID = Core::GetScriptEngine()->CreateScript(script.ScriptPath, id.ID);
+        }
+    }
+
     template <>
     void Serializer::Deserialize(const Path& path, Scene* out)
     {
         SG_ASSERT_NOMSG(out);
         auto& registry = out->GetRegistry();
+        if (IsBinaryScene(path))
+        {
+            if (DeserializeSceneBinary(path, out))
+                CreateSceneScripts(out);
+            return;
+        }
+
         registry.clear();
 
         String jsonContents = Filesystem::ReadFile<String>(path);
@@ -343,21 +265,21 @@ namespace Surge
         nlohmann::json parsedJson = nlohmann::json::parse(jsonContents);
         uint64_t size = parsedJson["Scene"]["Size"];
 
+        const String& idComponentName = GetComponentKey<IDComponent>();
         for (uint64_t i = 0; i < size; i++)
         {
+            // The entity has to be created with its final ID, the Scene indexes entities by their UUID when the IDComponent is added
             Entity newEntity;
-            out->CreateEntity(newEntity, "");
+            nlohmann::json& entityJson = parsedJson["Scene"][fmt::format("Entity{0}", i)];
+            if (entityJson.contains(idComponentName))
+                out->CreateEntityWithID(newEntity, entityJson[idComponentName]["ID"].get<uint64_t>(), "");
+            else
+                out->CreateEntity(newEntity, "");
+
             DeserializeEntity(parsedJson["Scene"], newEntity, i);
         }
 
-        { // Create all the scripts
-            const auto& view = registry.view<IDComponent, ScriptComponent>();
-            for (auto& entity : view)
-            {
-                const auto& [id, script] = view.get<IDComponent, ScriptComponent>(entity);
-                script.ScriptEngineID = Core::GetScriptEngine()->CreateScript(script.ScriptPath, id.ID);
-            }
-        }
+        CreateSceneScripts(out);
     }
 
     ///////////
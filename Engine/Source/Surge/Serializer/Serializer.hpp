@@ -6,6 +6,33 @@
 
 namespace Surge::Serializer
 {
+    // One scene format of RunSceneBenchmark
+    struct SceneFormatBenchmarkResult
+    {
+        float SaveMillis;
+        float LoadMillis;
+        uint64_t FileSize;
+        uint64_t SavePeakMemory; // Peak growth of the resident memory while saving, in bytes
+        uint64_t LoadPeakMemory; // Same while loading
+    };
+
+    struct SceneBenchmarkResult
+    {
+        Uint EntityCount;
+        SceneFormatBenchmarkResult Json;
+        SceneFormatBenchmarkResult Binary;
+    };
+
+    // Result of RunTypeDispatchBenchmark
+    struct TypeDispatchBenchmarkResult
+    {
+        Uint EntityCount;
+        float FieldsPerEntity;
+        float NameDispatchMillis;             // The type name is built and hashed for every check, like the serializer used to
+        float NameStringAllocationsPerEntity; // Type names too long for the small string buffer
+        float TypeIDDispatchMillis;           // SurgeReflect::Type::EqualTo, which compares the compile-time type IDs
+    };
+
     template <typename T>
     void Serialize(const Path& path, T* in)
     {
@@ -17,6 +44,7 @@ namespace Surge::Serializer
         static_assert(false);
     }
 
+    // Scenes are written/read in the binary format if the path ends with .surgeb, as json otherwise
     template <>
     SURGE_API void Serialize(const Path& path, Scene* in);
     template <>
@@ -27,4 +55,12 @@ namespace Surge::Serializer
     template <>
     SURGE_API void Deserialize(const Path& path, ProjectMetadata* out);
 
+    // Saves and loads a synthetic scene of 'entityCount' entities (transforms, hierarchy and point lights) in both formats.
+    // The files are written to TEMP_ASSET_PATH and deleted afterwards, 'project' is only used for the relative paths
+    SURGE_API SceneBenchmarkResult RunSceneBenchmark(Project* project, Uint entityCount);
+
+    // Checks the reflected type of every field of a synthetic scene of 'entityCount' entities against the field types the serializer
+    // handles, once by building and hashing the type names and once by type ID. Nothing is written
+    SURGE_API TypeDispatchBenchmarkResult RunTypeDispatchBenchmark(Uint entityCount);
+
 } // namespace Surge::Serializer
\ No newline at end of file
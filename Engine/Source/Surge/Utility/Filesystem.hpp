@@ -16,4 +16,24 @@ namespace Surge::Filesystem
     SURGE_API void RemoveFile(const Path& path);
     SURGE_API bool Exists(const Path& path);
 
+    // Read only view of a whole file, mapped into memory instead of being read into a buffer.
+    // Pages are loaded lazily by the OS, the view stays valid until the MappedFile is destroyed
+    class SURGE_API MappedFile
+    {
+    public:
+        MappedFile(const Path& path);
+        ~MappedFile();
+        SURGE_DISABLE_COPY_AND_MOVE(MappedFile);
+
+        bool IsValid() const { return mData != nullptr; }
+        const Byte* GetData() const { return mData; }
+        uint64_t GetSize() const { return mSize; }
+
+    private:
+        const Byte* mData = nullptr;
+        uint64_t mSize = 0;
+        void* mFileHandle = nullptr;
+        void* mMappingHandle = nullptr;
+    };
+
 } // namespace Surge::Filesystem
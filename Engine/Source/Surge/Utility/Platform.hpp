@@ -19,4 +19,7 @@ namespace Surge::Platform
     SURGE_API void UnloadSharedLibrary(void* library);
     SURGE_API String GetCurrentExecutablePath();
 
+    // Resident memory (working set) of the process, in bytes
+    SURGE_API uint64_t GetProcessMemoryUsage();
+
 } // namespace Surge::Platform
\ No newline at end of file
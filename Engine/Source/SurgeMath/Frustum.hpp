@@ -0,0 +1,58 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "SurgeMath/AABB.hpp"
+#include <glm/glm.hpp>
+
+namespace Surge
+{
+    enum class FrustumPlane
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far
+    };
+
+    struct Frustum
+    {
+    public:
+        Frustum() = default;
+
+        // Gribb-Hartmann extraction, the planes point inwards and are normalized. The near plane uses the [-1, 1] depth range,
+        // which is only more conservative for [0, 1] projections
+        explicit Frustum(const glm::mat4& viewProjection)
+        {
+            const glm::vec4 row0 = {viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]};
+            const glm::vec4 row1 = {viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]};
+            const glm::vec4 row2 = {viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]};
+            const glm::vec4 row3 = {viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]};
+
+            Planes[0] = row3 + row0;
+            Planes[1] = row3 - row0;
+            Planes[2] = row3 + row1;
+            Planes[3] = row3 - row1;
+            Planes[4] = row3 + row2;
+            Planes[5] = row3 - row2;
+            for (glm::vec4& plane : Planes)
+                plane /= glm::length(glm::vec3(plane));
+        }
+
+        const glm::vec4& GetPlane(FrustumPlane plane) const { return Planes[static_cast<int>(plane)]; }
+
+        // 'center' and 'extents' describe a world space AABB
+        bool IsBoxVisible(const glm::vec3& center, const glm::vec3& extents) const
+        {
+            for (const glm::vec4& plane : Planes)
+            {
+                const float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+                if (glm::dot(glm::vec3(plane), center) + plane.w + radius < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        glm::vec4 Planes[6];
+    };
+} // namespace Surge
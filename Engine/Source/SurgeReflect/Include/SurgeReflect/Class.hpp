@@ -3,7 +3,9 @@
 #include "SurgeReflect/Variable.hpp"
 #include "SurgeReflect/TypeTraits.hpp"
 #include "SurgeReflect/Function.hpp"
+#include "SurgeReflect/Field.hpp"
 #include <unordered_map>
+#include <vector>
 
 namespace SurgeReflect
 {
@@ -17,15 +19,24 @@ namespace SurgeReflect
 
         const std::string& GetName() const { return mName; }
         const ClassHash& GetHash() const { return mHash; }
-        const std::unordered_map<std::string, Variable>& GetVariables() const { return mVariables; }
+        const std::vector<Variable>& GetVariables() const { return mVariables; } // In the order they were added
         const std::unordered_map<std::string, Function>& GetFunctions() const { return mFunctions; }
 
+        // The offset is measured on a default constructed object, see TypeTraits::GetMemberOffset
         template <auto Var>
         Class& AddVariable(const std::string& name, AccessModifier accessModifier = AccessModifier::Public)
         {
-            Variable v(name, accessModifier);
-            v.Initialize<Var>();
-            mVariables[v.GetName()] = v;
+            return AddVariableAt<Var>(name, accessModifier, TypeTraits::GetMemberOffset<Var>());
+        }
+
+        // Adds every field listed with SURGE_REFLECT_FIELDS as a Variable, with the offsets of the list
+        template <typename T>
+        Class& AddFields()
+        {
+            ForEachField<T>([this](const auto& field) {
+                using FieldType = std::decay_t<decltype(field)>;
+                AddVariableAt<FieldType::Pointer>(field.Name, AccessModifier::Public, FieldType::Offset);
+            });
             return *this;
         }
 
@@ -40,9 +51,9 @@ namespace SurgeReflect
 
         const Variable* GetVariable(const std::string& name) const
         {
-            auto itr = mVariables.find(name);
-            if (itr != mVariables.end())
-                return &itr->second;
+            auto itr = mVariableIndices.find(name);
+            if (itr != mVariableIndices.end())
+                return &mVariables[itr->second];
 
             return nullptr;
         }
@@ -59,15 +70,31 @@ namespace SurgeReflect
         const bool& IsSetup() const { return mSetup; }
 
     private:
+        template <auto Var>
+        Class& AddVariableAt(const std::string& name, AccessModifier accessModifier, uint64_t offset)
+        {
+            Variable v(name, accessModifier);
+            v.Initialize<Var>(offset);
+
+            auto itr = mVariableIndices.find(name);
+            if (itr != mVariableIndices.end())
+                mVariables[itr->second] = std::move(v);
+            else
+            {
+                mVariableIndices[name] = mVariables.size();
+                mVariables.push_back(std::move(v));
+            }
+            return *this;
+        }
+
         void SetupClass(Class&& clazz)
         {
             if (mSetup)
                 return;
 
             mHash = Utility::GenerateStringHash(mName);
-            mVariables.reserve(clazz.GetVariables().size());
-            for (auto& [name, variable] : clazz.mVariables)
-                mVariables[name] = variable;
+            mVariables = std::move(clazz.mVariables);
+            mVariableIndices = std::move(clazz.mVariableIndices);
 
             mFunctions.reserve(clazz.GetFunctions().size());
             for (auto& [name, func] : clazz.mFunctions)
@@ -80,7 +107,8 @@ namespace SurgeReflect
         bool mSetup = false;
         std::string mName;
         ClassHash mHash;
-        std::unordered_map<std::string, Variable> mVariables;
+        std::vector<Variable> mVariables;
+        std::unordered_map<std::string, size_t> mVariableIndices; // Name -> index into mVariables
         std::unordered_map<std::string, Function> mFunctions;
         friend class Registry;
     };
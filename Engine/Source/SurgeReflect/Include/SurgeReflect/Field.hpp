@@ -0,0 +1,50 @@
+// Copyright (c) - SurgeTechnologies - All rights reserved
+#pragma once
+#include "SurgeReflect/TypeTraits.hpp"
+#include <tuple>
+#include <type_traits>
+
+namespace SurgeReflect
+{
+    // Compile time description of a data member, the member pointer is part of the type so accessing the field
+    // compiles down to a plain member access. The offset comes from offsetof in SURGE_REFLECT_FIELD
+    template <auto Member, size_t MemberOffset>
+    struct Field
+    {
+        using Traits = TypeTraits::VariableTraits<decltype(Member)>;
+        using ClassType = typename Traits::ClassType;
+        using Type = typename Traits::Type;
+        static constexpr auto Pointer = Member;
+
+        const char* Name;
+
+        static Type& Get(ClassType& object) { return object.*Member; }
+        static const Type& Get(const ClassType& object) { return object.*Member; }
+        static constexpr size_t Offset = MemberOffset;
+    };
+
+    // Specialized for every type through SURGE_REFLECT_FIELDS, 'Get()' returns a tuple of Field(s) in declaration order
+    template <typename T>
+    struct FieldList
+    {
+        static constexpr bool Defined = false;
+    };
+
+    template <typename T>
+    inline constexpr bool HasFields = FieldList<T>::Defined;
+
+    // Calls 'func(field)' for every field of T in the order they were listed, the loop is unrolled at compile time
+    template <typename T, typename F>
+    constexpr void ForEachField(F&& func)
+    {
+        static_assert(HasFields<T>, "The type has no field list! Maybe you forgot to use SURGE_REFLECT_FIELDS?");
+        std::apply([&func](const auto&... fields) { (func(fields), ...); }, FieldList<T>::Get());
+    }
+
+    template <typename T>
+    constexpr size_t GetFieldCount()
+    {
+        return std::tuple_size_v<decltype(FieldList<T>::Get())>;
+    }
+
+} // namespace SurgeReflect
@@ -3,6 +3,7 @@
 #include "SurgeReflect/SurgeReflectRegistry.hpp"
 #include "SurgeReflect/Type.hpp"
 #include "Surge/Core/Defines.hpp"
+#include <cstddef>
 
 #define SURGE_REFLECTION_ENABLE                         \
 private:                                                \
@@ -28,11 +29,34 @@ private:                                                \
 #define SURGE_REFLECT_CLASS_REGISTER_END(ClassName) ;}
 // clang-format on
 
+// Compile time field list of a type, must be used in the global namespace. The offsets come from offsetof, which compilers
+// only support on types that aren't standard layout as an extension (MSVC, and GCC/Clang with a -Winvalid-offsetof warning). Example:
+// SURGE_REFLECT_FIELDS(Surge::TransformComponent, SURGE_REFLECT_FIELD(Position), SURGE_REFLECT_FIELD(Rotation))
+#define SURGE_REFLECT_FIELDS(ClassName, ...)                 \
+    template <>                                              \
+    struct SurgeReflect::FieldList<ClassName>                \
+    {                                                        \
+        static constexpr bool Defined = true;                \
+        static constexpr auto Get()                          \
+        {                                                    \
+            using Class = ClassName;                         \
+            return std::make_tuple(__VA_ARGS__);             \
+        }                                                    \
+    };
+
+#define SURGE_REFLECT_FIELD(Member)             ::SurgeReflect::Field<&Class::Member, offsetof(Class, Member)> { #Member }
+#define SURGE_REFLECT_NAMED_FIELD(Member, Name) ::SurgeReflect::Field<&Class::Member, offsetof(Class, Member)> { Name }
+
 namespace SurgeReflect
 {
     template <typename T>
     Class* GetReflection()
     {
+        // Fast path, no string is built
+        Class* registered = Registry::Get()->GetClass(TypeTraits::GetClassID<T>());
+        if (registered && registered->IsSetup())
+            return registered;
+
         std::string className = std::string(TypeTraits::GetClassName<T>());
         Class* clazz = Registry::Get()->GetClass(className);
         if (!clazz->IsSetup())
@@ -46,6 +70,10 @@ namespace SurgeReflect
     template <typename T>
     Class* GetReflectionFromRegistry(Registry* reg)
     {
+        Class* registered = reg->GetClass(TypeTraits::GetClassID<T>());
+        if (registered && registered->IsSetup())
+            return registered;
+
         std::string className = std::string(TypeTraits::GetClassName<T>());
         Class* clazz = reg->GetClass(className);
         if (!clazz->IsSetup())
@@ -14,6 +14,7 @@ namespace SurgeReflect
 
         SURGE_API ~Registry();
         SURGE_API Class* GetClass(const std::string& name);
+        SURGE_API Class* GetClass(TypeID classID); // classID is TypeTraits::GetClassID<T>(), returns nullptr if not found
         SURGE_API void RegisterReflectionClass(Class&& clazz);
         SURGE_API void RemoveClass(std::string name);
         SURGE_API Class* GetIfExists(const std::string& name);
@@ -21,6 +22,7 @@ namespace SurgeReflect
 
     private:
         std::unordered_map<std::string, Class*> mClasses;
+        std::unordered_map<TypeID, Class*> mClassesByID; // Hash of the name -> Class, lookups without building a string
     };
 
 } // namespace SurgeReflect
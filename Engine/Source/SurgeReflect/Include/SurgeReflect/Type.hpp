@@ -3,6 +3,7 @@
 #include <string>
 #include <functional>
 #include "SurgeReflect/Utility.hpp"
+#include "SurgeReflect/TypeTraits.hpp"
 
 namespace SurgeReflect
 {
@@ -33,15 +34,12 @@ namespace SurgeReflect
         template <typename T>
         bool EqualTo() const
         {
-            const std::string givenTypeName = std::string(TypeTraits::GetTypeName<T>());
-            const int64_t givenTypeHash = Utility::GenerateStringHash(givenTypeName);
-
-            bool result = mHashCode == givenTypeHash;
-            return result;
+            return mTypeID == TypeTraits::GetTypeID<T>();
         }
 
         const std::string& GetFullName() const { return mFullName; }
         const int64_t& GetHashCode() const { return mHashCode; }
+        TypeID GetTypeID() const { return mTypeID; }
         const bool& IsEnum() const { return mIsEnum; }
         const bool& IsClass() const { return mIsClass; }
         const bool& IsUnion() const { return mIsUnion; }
@@ -57,11 +55,13 @@ namespace SurgeReflect
 
             mFullName = std::string(TypeTraits::GetTypeName<T>());
             mHashCode = Utility::GenerateStringHash(mFullName);
+            mTypeID = TypeTraits::GetTypeID<T>();
         }
 
     private:
         std::string mFullName;
         int64_t mHashCode;
+        TypeID mTypeID = 0;
 
         bool mIsEnum = false;
         bool mIsClass = false;
@@ -13,6 +13,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include "SurgeReflect/Utility.hpp"
 
 #if !COMPILETIME_TYPENAME_WRAPPER_SUPPORTED
 #include <typeinfo>
@@ -177,6 +178,21 @@ namespace SurgeReflect
             static constexpr size_t ParamCount = sizeof...(Params);
         };
 
+        // Byte offset of a data member from the start of its class, for when only the member pointer is known.
+        // A member pointer can't be turned into an offset at compile time, so it is measured once on a value initialized object
+        // and cached; the class must be default constructible. Field lists get their offsets at compile time from offsetof instead
+        template <auto Member>
+        inline size_t GetMemberOffset()
+        {
+            using ClassType = typename VariableTraits<decltype(Member)>::ClassType;
+            static_assert(std::is_default_constructible_v<ClassType>, "The offset of a member is measured on a default constructed object!");
+            static const size_t offset = [] {
+                const ClassType object {};
+                return static_cast<size_t>(reinterpret_cast<const char*>(&(object.*Member)) - reinterpret_cast<const char*>(&object));
+            }();
+            return offset;
+        }
+
         //////////////////////////////////////////////////////////////////////////
 
     } // namespace TypeTraits
@@ -222,6 +238,22 @@ namespace SurgeReflect
                 return typeName.substr(0, templateBegin);
         }
 
+        // Computed at compile time from the type's name, equal for the same type in every module
+        template <class T>
+        constexpr TypeID GetTypeID()
+        {
+            constexpr TypeID id = Utility::GenerateTypeID(GetTypeName<T>());
+            return id;
+        }
+
+        // ID of the class name a type is registered with in the Registry, see Registry::GetClass(TypeID)
+        template <class T>
+        constexpr TypeID GetClassID()
+        {
+            constexpr TypeID id = Utility::GenerateTypeID(GetClassName<T>());
+            return id;
+        }
+
     } // namespace TypeTraits
 
 } // namespace SurgeReflect
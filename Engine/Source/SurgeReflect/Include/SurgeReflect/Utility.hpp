@@ -1,9 +1,28 @@
 // Copyright (c) - SurgeTechnologies - All rights reserved
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+
+namespace SurgeReflect
+{
+    using TypeID = uint64_t;
+}
 
 namespace SurgeReflect::Utility
 {
+    // 64 bit FNV-1a, usable at compile time
+    constexpr TypeID GenerateTypeID(std::string_view name)
+    {
+        TypeID result = 14695981039346656037ull;
+        for (char c : name)
+        {
+            result ^= static_cast<uint8_t>(c);
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+
     inline int64_t GenerateStringHash(const std::string& s)
     {
         int64_t result = 0;
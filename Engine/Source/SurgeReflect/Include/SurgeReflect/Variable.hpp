@@ -16,21 +16,24 @@ namespace SurgeReflect
         const std::string& GetName() const { return mName; }
         const AccessModifier& GetAccessModifier() const { return mAccessModifier; }
         const uint64_t& GetSize() const { return mSize; }
+        const uint64_t& GetOffset() const { return mOffset; } // From the start of the owning class
         const Type& GetType() const { return mType; }
 
     private:
         template <auto Var>
-        void Initialize()
+        void Initialize(uint64_t offset)
         {
             using Traits = TypeTraits::VariableTraits<decltype(Var)>;
-            mSize = sizeof(Traits::Type);
-            mType.Initialize<Traits::Type>();
+            mSize = sizeof(typename Traits::Type);
+            mOffset = offset;
+            mType.Initialize<typename Traits::Type>();
         }
 
     private:
         std::string mName;
         AccessModifier mAccessModifier;
         uint64_t mSize = 0;
+        uint64_t mOffset = 0;
         Type mType;
 
         friend class Class;
@@ -31,7 +31,18 @@ namespace SurgeReflect
         if (itr != mClasses.end())
             return itr->second;
 
-        return mClasses.insert({name, new Class(name)}).first->second;
+        Class* clazz = mClasses.insert({name, new Class(name)}).first->second;
+        mClassesByID[Utility::GenerateTypeID(name)] = clazz;
+        return clazz;
+    }
+
+    Class* Registry::GetClass(TypeID classID)
+    {
+        auto itr = mClassesByID.find(classID);
+        if (itr != mClassesByID.end())
+            return itr->second;
+
+        return nullptr;
     }
 
     void Registry::RemoveClass(std::string name)
@@ -40,6 +51,7 @@ namespace SurgeReflect
         if (itr != mClasses.end())
         {
             delete itr->second;
+            mClassesByID.erase(Utility::GenerateTypeID(name));
             mClasses.erase(name);
             return;
         }